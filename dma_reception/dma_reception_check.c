@@ -0,0 +1,301 @@
+/*
+ * dma_reception_check.c
+ *
+ * Content : host check of the DMA reception of the modem lines (UART_DMA_RX_ACTIVATED). The real sgs/serial_sgs.c and
+ * peripheralManager/USART_manager.c are built in this file, the DMAC is simulated by writing in their circular buffer :
+ *   gcc -O2 -Istubs -I../tracker2 -I../tracker2/sgs -o dma_reception_check dma_reception_check.c
+ * Usage : ./dma_reception_check
+ *
+ * Byte streams are received in every chunk size and from every position of the circular buffer, and each check asserts
+ * gsm_buf, the final result of the command, the poll at which the final result is seen, the URC and the idle line notification.
+ * Also checked : an answer longer than gsm_buf, and an overrun of the circular buffer between two polls.
+ * Returns 1 if a check fails.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+/* The firmware headers that need the ASF are skipped : their guards are defined, the declarations used by the two files follow */
+#define MAIN_H_
+#define HELPER_SGS_H_
+#define PORT_SGS_H_
+#define GPS_MANAGER_H_
+#define _STDIO_IO_H_INCLUDED
+#define UART_REPLAY_H_
+#define TRACE_H_
+#define DEBUG_LOG_H_
+#define GLOBAL_VAR_H_
+#define USB_MANAGER_H_
+
+#define UNUSED(x)				(void)(x)
+#define UART_DMA_RX_ACTIVATED	1
+#define UART_REPLAY_ACTIVATED	0
+#define TRACE_ACTIVATED			0
+#define LOG_COMPILED_LEVEL		0
+#define LOG_LEVEL_INFO			3
+#define LOG_SINK_USB			1
+#define LOG_DEBUG(module, text)
+#define LOG_INFO(module, text)
+
+/* Keep in sync with port_sgs.h */
+#define UART_DMA_RX_CHANNEL_SER1_GPS	0
+#define UART_DMA_RX_CHANNEL_SER2_GSM	1
+#define UART_DMA_RX_NB_CHANNELS			2
+#define UART_DMA_RX_BUFFER_SIZE			256
+
+struct io_descriptor;
+struct usart_async_descriptor { int unused; };
+struct timer_task { int unused; };
+typedef void (*timer_cb_t)(const struct timer_task *const timer_task);
+
+bool seekiosManagerStarted = true;
+static struct usart_async_descriptor SER1_GPS, SER2_GSM;
+static int SER3_DEBUG, SER5_SPI_IMU_FLASH;
+static int _sercom1, _sercom2;
+#define SERCOM1					(&_sercom1)
+#define SERCOM2					(&_sercom2)
+#define SERCOM1_DMAC_ID_RX		7
+#define SERCOM2_DMAC_ID_RX		9
+#define USART_ASYNC_TXC_CB		0
+#define USART_ASYNC_RXC_CB		1
+
+static int32_t io_write(struct io_descriptor *io, const uint8_t *buf, uint16_t length) { UNUSED(io); UNUSED(buf); return length; }
+static int32_t io_read(struct io_descriptor *io, uint8_t *buf, uint16_t length) { UNUSED(io); UNUSED(buf); UNUSED(length); return 0; }
+static void delay_ms(uint16_t ms) { UNUSED(ms); }
+static void usart_async_register_callback(struct usart_async_descriptor *descr, int type, void (*cb)(const struct usart_async_descriptor *const)) { UNUSED(descr); UNUSED(type); UNUSED(cb); }
+static void usart_async_get_io_descriptor(struct usart_async_descriptor *descr, struct io_descriptor **io) { UNUSED(descr); UNUSED(io); }
+static void usart_async_enable(struct usart_async_descriptor *descr) { UNUSED(descr); }
+static void usart_sync_get_io_descriptor(int *descr, struct io_descriptor **io) { UNUSED(descr); UNUSED(io); }
+static void usart_sync_enable(int *descr) { UNUSED(descr); }
+static void spi_m_sync_get_io_descriptor(int *descr, struct io_descriptor **io) { UNUSED(descr); UNUSED(io); }
+static void spi_m_sync_enable(int *descr) { UNUSED(descr); }
+static void send_gsm_modem(const char *text) { UNUSED(text); }
+static void debugLog_init(void) {}
+static void debugLog_attachSink(int sink) { UNUSED(sink); }
+static void debugLog_detachSink(int sink) { UNUSED(sink); }
+
+/* GPS side, not checked here */
+typedef int NMEAChecksum;
+typedef enum { NMEA_CHECKSUM_PENDING, NMEA_CHECKSUM_VALID } E_NMEA_CHECKSUM_STATUS;
+#define GPS_BIT_NMEA_AVAILABLE		(1 << 6)
+#define GPS_BIT_REQ_GPS_USART_TEST	(1 << 7)
+static E_NMEA_CHECKSUM_STATUS GPSManager_updateNMEAChecksum(NMEAChecksum *checksumPtr, char readChar) { UNUSED(checksumPtr); UNUSED(readChar); return NMEA_CHECKSUM_PENDING; }
+static void GPSManager_setGPSBitsFromISR(uint32_t bits) { UNUSED(bits); }
+static uint32_t GPSManager_getGPSBitsFromISR(void) { return GPS_BIT_NMEA_AVAILABLE; }
+
+#include <FreeRTOS.h>
+#include <serial_sgs.h>
+#include <peripheralManager/USART_manager.h>
+
+/* Simulated DMAC */
+static uint16_t _dmaWriteIndexes[UART_DMA_RX_NB_CHANNELS];
+static void UART_DMA_RX_init(void) {}
+static void UART_DMA_RX_start(uint8_t channel, void *const hw, uint8_t triggerSource, uint8_t *buffer) { UNUSED(hw); UNUSED(triggerSource); UNUSED(buffer); _dmaWriteIndexes[channel] = 0; }
+static void UART_DMA_RX_startPolling(timer_cb_t pollCallback) { UNUSED(pollCallback); }
+static uint16_t UART_DMA_RX_getWriteIndex(uint8_t channel) { return _dmaWriteIndexes[channel]; }
+
+#include "../tracker2/sgs/serial_sgs.c"
+#include "../tracker2/peripheralManager/USART_manager.c"
+
+/* Event group of the USART manager : the bits set by the reception path are accumulated until read by the check */
+static EventBits_t _eventBits;
+
+EventGroupHandle_t xEventGroupCreate(void) { return &_eventBits; }
+EventBits_t xEventGroupClearBits(EventGroupHandle_t eventGroup, EventBits_t bitsToClear) { UNUSED(eventGroup); _eventBits &= ~bitsToClear; return _eventBits; }
+BaseType_t xEventGroupSetBitsFromISR(EventGroupHandle_t eventGroup, EventBits_t bitsToSet, BaseType_t* higherPriorityTaskWokenPtr) { UNUSED(eventGroup); UNUSED(higherPriorityTaskWokenPtr); _eventBits |= bitsToSet; return pdTRUE; }
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t eventGroup, EventBits_t bitsToWaitFor, BaseType_t clearOnExit, BaseType_t waitForAllBits, TickType_t ticksToWait) { UNUSED(eventGroup); UNUSED(bitsToWaitFor); UNUSED(clearOnExit); UNUSED(waitForAllBits); UNUSED(ticksToWait); return _eventBits; }
+TickType_t xTaskGetTickCount(void) { return 0; }
+
+static uint32_t _nbChecks;
+static uint32_t _nbFailures;
+
+#define CHECK(condition, ...) do { _nbChecks++; if(!(condition)) { if(_nbFailures++ < 20) { printf("FAILED %s:%d : ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); } } } while(0)
+
+/* Result of a stream received by the reception path */
+typedef struct {
+	uint16_t finalResultPoll;	// index of the poll where GSM_USART_BIT_FINAL_RESULT was first set, 0xFFFF if never
+	uint16_t urcPoll;			// same for GSM_USART_BIT_URC_RECEIVED
+	uint16_t nbPolls;
+} StreamResult;
+
+/* The DMAC writes the bytes in the circular buffer of the modem */
+static void dmaWrite(const char* bytes, uint16_t length)
+{
+	for(uint16_t i = 0; i < length; i++)
+	{
+		_gsmDmaBuffer[_dmaWriteIndexes[UART_DMA_RX_CHANNEL_SER2_GSM]] = bytes[i];
+		_dmaWriteIndexes[UART_DMA_RX_CHANNEL_SER2_GSM] = (_dmaWriteIndexes[UART_DMA_RX_CHANNEL_SER2_GSM] + 1) % UART_DMA_RX_BUFFER_SIZE;
+	}
+}
+
+/* Starts the reception from a position of the circular buffer, as after many previous answers */
+static void resetReception(uint16_t bufferPosition)
+{
+	startDmaReception(UART_DMA_RX_CHANNEL_SER2_GSM, SERCOM2, SERCOM2_DMAC_ID_RX, _gsmDmaBuffer);
+	_dmaWriteIndexes[UART_DMA_RX_CHANNEL_SER2_GSM] = bufferPosition;
+	_dmaReadIndexes[UART_DMA_RX_CHANNEL_SER2_GSM] = bufferPosition;
+	_dmaEmptyPolls[UART_DMA_RX_CHANNEL_SER2_GSM] = 0;
+	_gsmLineLength = 0;
+	_expectedUrc = NULL;
+	_eventBits = 0;
+}
+
+/* Sends the stream as the answer of a new command, chunkSize bytes between two polls */
+static StreamResult receiveStream(const char* stream, uint16_t chunkSize)
+{
+	StreamResult result = {0xFFFF, 0xFFFF, 0};
+	uint16_t length = strlen(stream);
+	initReception();
+	for(uint16_t offset = 0; offset < length; offset += chunkSize)
+	{
+		dmaWrite(&stream[offset], length - offset < chunkSize ? length - offset : chunkSize);
+		pollDmaBuffers(NULL);
+		if((_eventBits & GSM_USART_BIT_FINAL_RESULT) && result.finalResultPoll == 0xFFFF) result.finalResultPoll = result.nbPolls;
+		if((_eventBits & GSM_USART_BIT_URC_RECEIVED) && result.urcPoll == 0xFFFF) result.urcPoll = result.nbPolls;
+		result.nbPolls++;
+	}
+	return result;
+}
+
+/* The poll where the last '\n' of the stream arrives */
+static uint16_t lastLinePoll(const char* stream, uint16_t chunkSize)
+{
+	return (uint16_t)((strrchr(stream, '\n') - stream) / chunkSize);
+}
+
+/* The poll where the '\n' of the line arrives */
+static uint16_t linePoll(const char* stream, const char* line, uint16_t chunkSize)
+{
+	return (uint16_t)((strstr(stream, line) + strlen(line) - 1 - stream) / chunkSize);
+}
+
+/* Every chunk size and every start position : the same gsm_buf and the same final result, seen as soon as its line ends */
+static void checkAnswer(const char* stream, const char* finalResultLine, E_SERIAL_ANSWER expectedResult)
+{
+	uint16_t length = strlen(stream);
+	for(uint16_t position = 0; position < UART_DMA_RX_BUFFER_SIZE; position++)
+	{
+		for(uint16_t chunkSize = 1; chunkSize <= length; chunkSize++)
+		{
+			resetReception(position);
+			StreamResult result = receiveStream(stream, chunkSize);
+			CHECK(strcmp((const char*)gsm_buf, stream) == 0, "gsm_buf \"%s\" at position %d, chunks of %d", (const char*)gsm_buf, position, chunkSize);
+			CHECK(_finalResult == expectedResult, "final result %d instead of %d at position %d, chunks of %d", _finalResult, expectedResult, position, chunkSize);
+			uint16_t expectedPoll = linePoll(stream, finalResultLine, chunkSize);
+			CHECK(result.finalResultPoll == expectedPoll, "final result seen at poll %d instead of %d, chunks of %d", result.finalResultPoll, expectedPoll, chunkSize);
+		}
+	}
+}
+
+/* No final result in an incomplete line, nor in a line that only starts like a final result code */
+static void checkNoFinalResult(const char* stream)
+{
+	for(uint16_t chunkSize = 1; chunkSize <= strlen(stream); chunkSize++)
+	{
+		resetReception(UART_DMA_RX_BUFFER_SIZE - 3);
+		StreamResult result = receiveStream(stream, chunkSize);
+		CHECK(result.finalResultPoll == 0xFFFF && _finalResult == SERIAL_ANSWER_NONE, "final result %d in \"%s\", chunks of %d", _finalResult, stream, chunkSize);
+	}
+}
+
+static void checkUrc(void)
+{
+	const char* stream = "\r\nOK\r\n\r\n+HTTPACTION: 0,200,1234\r\n";
+	for(uint16_t chunkSize = 1; chunkSize <= strlen(stream); chunkSize++)
+	{
+		resetReception(UART_DMA_RX_BUFFER_SIZE - 10);
+		USARTManager_expectURC("+HTTPACTION:");
+		StreamResult result = receiveStream(stream, chunkSize);
+		CHECK(result.urcPoll == lastLinePoll(stream, chunkSize), "URC seen at poll %d instead of %d, chunks of %d", result.urcPoll, lastLinePoll(stream, chunkSize), chunkSize);
+		CHECK(_finalResult == SERIAL_ANSWER_OK, "final result %d before the URC", _finalResult);
+	}
+}
+
+/* GSM_USART_BIT_RX_IDLE is set once, after UART_DMA_RX_IDLE_POLLS polls without byte, and again after new bytes */
+static void checkIdleLine(void)
+{
+	resetReception(UART_DMA_RX_BUFFER_SIZE - 1);
+	receiveStream("\r\n+CSQ: 20,0\r\n", 4);
+	for(uint8_t round = 0; round < 2; round++)
+	{
+		for(uint8_t i = 1; i <= UART_DMA_RX_IDLE_POLLS + 3; i++)
+		{
+			_eventBits = 0;
+			pollDmaBuffers(NULL);
+			bool isIdleSet = (_eventBits & GSM_USART_BIT_RX_IDLE) != 0;
+			CHECK(isIdleSet == (i == UART_DMA_RX_IDLE_POLLS), "round %d, empty poll %d : idle bit %d", round, i, isIdleSet);
+		}
+		dmaWrite("\r\nOK\r\n", 6);
+		_eventBits = 0;
+		pollDmaBuffers(NULL);
+		CHECK((_eventBits & GSM_USART_BIT_RX_IDLE) == 0, "idle bit set with new bytes");
+	}
+}
+
+/* An answer longer than gsm_buf : gsm_buf keeps its start, and the final result is still seen */
+static void checkLongAnswer(void)
+{
+	static char stream[GSM_BUF_SIZE * 2];
+	strcpy(stream, "\r\n+HTTPREAD: 900\r\n");
+	while(strlen(stream) < GSM_BUF_SIZE + 300)
+	{
+		strcat(stream, "0123456789abcdefghijklmnopqrstuvwxyz\r\n");
+	}
+	strcat(stream, "\r\nOK\r\n");
+	uint16_t chunkSizes[] = {1, 7, 23, 64, 255};
+	for(uint8_t i = 0; i < sizeof(chunkSizes) / sizeof(chunkSizes[0]); i++)
+	{
+		resetReception(100);
+		StreamResult result = receiveStream(stream, chunkSizes[i]);
+		CHECK(strncmp((const char*)gsm_buf, stream, GSM_BUF_SIZE - 1) == 0 && gsm_buf[GSM_BUF_SIZE - 1] == '\0', "gsm_buf is not the start of the long answer, chunks of %d", chunkSizes[i]);
+		CHECK(_finalResult == SERIAL_ANSWER_OK && result.finalResultPoll == lastLinePoll(stream, chunkSizes[i]), "final result %d of the long answer at poll %d, chunks of %d", _finalResult, result.finalResultPoll, chunkSizes[i]);
+	}
+}
+
+/* More bytes than the circular buffer between two polls : the overwritten bytes are lost, the next answer is parsed again.
+With a poll every UART_DMA_RX_POLL_PERIOD ms, 115200 bauds bring 23 bytes : an overrun means the poll timer was stopped */
+static void checkOverrun(void)
+{
+	char overrun[UART_DMA_RX_BUFFER_SIZE + 40];
+	memset(overrun, 'x', sizeof(overrun));
+	memcpy(&overrun[sizeof(overrun) - 12], "\r\nERROR\r\nOK", 11); // the "OK" line is cut by the overrun
+	overrun[sizeof(overrun) - 1] = 'K';
+
+	resetReception(0);
+	initReception();
+	dmaWrite(overrun, sizeof(overrun));
+	pollDmaBuffers(NULL);
+	CHECK(strlen((const char*)gsm_buf) == sizeof(overrun) - UART_DMA_RX_BUFFER_SIZE, "%d bytes kept after the overrun", (int)strlen((const char*)gsm_buf));
+	CHECK(_finalResult == SERIAL_ANSWER_ERROR, "final result %d in the bytes left by the overrun", _finalResult);
+
+	/* Exactly the size of the buffer : the write index is back to the read index, the poll sees no byte */
+	resetReception(0);
+	initReception();
+	dmaWrite(overrun, UART_DMA_RX_BUFFER_SIZE);
+	pollDmaBuffers(NULL);
+	CHECK(gsm_buf[0] == '\0', "bytes seen after an overrun of the whole buffer");
+
+	/* The line cut by the overrun does not hide the next answer */
+	StreamResult result = receiveStream("\r\r\nOK\r\n", 2);
+	CHECK(_finalResult == SERIAL_ANSWER_OK && result.finalResultPoll == 3, "final result %d at poll %d after the overrun", _finalResult, result.finalResultPoll);
+}
+
+int main(void)
+{
+	USARTManager_init();
+	checkAnswer("AT\r\r\nOK\r\n", "\nOK\r\n", SERIAL_ANSWER_OK);
+	checkAnswer("\r\n+CSQ: 20,0\r\n\r\nOK\r\n", "\nOK\r\n", SERIAL_ANSWER_OK);
+	checkAnswer("\r\nERROR\r\n", "ERROR\r\n", SERIAL_ANSWER_ERROR);
+	checkAnswer("\r\n+CME ERROR: 3\r\n", "+CME ERROR: 3\r\n", SERIAL_ANSWER_ERROR);
+	checkAnswer("AT+CIPSTATUS\r\r\n\r\nOK\r\n\r\nSTATE: IP INITIAL\r\n", "\nOK\r\n", SERIAL_ANSWER_OK);
+	checkNoFinalResult("\r\nOK");
+	checkNoFinalResult("\r\nOKAY\r\n\r\nERRORS\r\n\r\n+COPS: 0\r\n");
+	checkUrc();
+	checkIdleLine();
+	checkLongAnswer();
+	checkOverrun();
+	printf("%u checks, %u failed\n", _nbChecks, _nbFailures);
+	return _nbFailures == 0 ? 0 : 1;
+}
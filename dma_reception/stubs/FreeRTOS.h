@@ -0,0 +1,39 @@
+/*
+ * FreeRTOS.h
+ *
+ * Content : host stand-in of the FreeRTOS API used by USART_manager.c and GPS_manager.c, see dma_reception_check.c
+ * and nmea_parser/nmea_parser_check.c
+ */
+
+#ifndef HOST_FREERTOS_H_
+#define HOST_FREERTOS_H_
+
+#include <stdint.h>
+
+typedef int32_t BaseType_t;
+typedef uint32_t UBaseType_t;
+typedef uint32_t TickType_t;
+typedef uint32_t EventBits_t;
+typedef void* EventGroupHandle_t;
+typedef void* TaskHandle_t;
+
+#define pdFALSE		0
+#define pdTRUE		1
+#define pdFAIL		0
+
+#define portYIELD_FROM_ISR(x)	(void)(x)
+#define taskENTER_CRITICAL()
+#define taskEXIT_CRITICAL()
+
+EventGroupHandle_t xEventGroupCreate(void);
+EventBits_t xEventGroupClearBits(EventGroupHandle_t eventGroup, EventBits_t bitsToClear);
+BaseType_t xEventGroupSetBitsFromISR(EventGroupHandle_t eventGroup, EventBits_t bitsToSet, BaseType_t* higherPriorityTaskWokenPtr);
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t eventGroup, EventBits_t bitsToWaitFor, BaseType_t clearOnExit, BaseType_t waitForAllBits, TickType_t ticksToWait);
+EventBits_t xEventGroupSetBits(EventGroupHandle_t eventGroup, EventBits_t bitsToSet);
+EventBits_t xEventGroupGetBits(EventGroupHandle_t eventGroup);
+EventBits_t xEventGroupGetBitsFromISR(EventGroupHandle_t eventGroup);
+TickType_t xTaskGetTickCount(void);
+void vTaskDelay(TickType_t ticksToDelay);
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task);
+
+#endif /* HOST_FREERTOS_H_ */
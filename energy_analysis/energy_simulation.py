@@ -0,0 +1,109 @@
+# Estimates the charge and the battery life of the Seekios per mode, with the current table of seekiosCore/energy_profiler.h
+# Usage : python energy_simulation.py [--power-saving]		simulates the modes
+#         python energy_simulation.py --report dump.txt		recomputes a report of the USB GET_ENERGY command with the table below
+# Keep the currents in sync with energy_profiler.h
+
+import sys
+
+BATTERY_CAPACITY = 500 # mAh
+
+# domain : {state : current in uA}
+CURRENTS = {
+	"MCU": {"RUN": 3000, "STANDBY": 40},
+	"GSM": {"OFF": 0, "SLEEP": 1500, "IDLE": 20000, "GPRS": 150000},
+	"GPS": {"OFF": 0, "STANDBY": 200, "WARMUP": 25000, "TRACKING": 20000},
+	"LED": {"0": 0, "1": 2000, "2": 4000, "3": 6000},
+}
+
+# Durations of one cycle of the firmware, in s
+GPS_MAX_FIXTIME		= 60	# the mode keeps the GPS on this time frame to get the best position
+GPS_TTFF			= 30	# average time to the first fix, the GPS is in warmup before it
+GSM_POWER_ON_TIME	= 12	# AT commands of powerOnModule and network registration
+GSM_GPRS_TIME		= 8		# bearer opening and HTTP request
+GSM_AWAKE_TIME		= 4		# AT commands around the HTTP session
+MCU_ACTIVE_OVERHEAD	= 3		# tasks running outside of the GPS and GSM uses
+LED_CYCLE_TIME		= 1		# one LED lit at each message
+
+# name : (cycle period in s, GPS used, message sent)
+MODES = [
+	("No mode", 24 * 3600, False, False),
+	("Don't move at rest", 24 * 3600, False, False),
+	("On demand 4/day", 6 * 3600, True, True),
+	("Tracking 1 min", 60, True, True),
+	("Tracking 10 min", 600, True, True),
+	("Tracking 60 min", 3600, True, True),
+	("Tracking 240 min", 4 * 3600, True, True),
+]
+
+# Time per domain and state over one cycle, in s
+def buildCycle(period, useGPS, sendMessage, powerSaving):
+	times = {domain: {state: 0.0 for state in states} for domain, states in CURRENTS.items()}
+	gpsTime = min(GPS_MAX_FIXTIME, period) if useGPS else 0.0
+	times["GPS"]["WARMUP"] = min(GPS_TTFF, gpsTime)
+	times["GPS"]["TRACKING"] = gpsTime - times["GPS"]["WARMUP"]
+	times["GPS"]["OFF"] = period - gpsTime
+
+	gsmActiveTime = 0.0
+	if sendMessage:
+		times["GSM"]["GPRS"] = GSM_GPRS_TIME
+		times["GSM"]["IDLE"] = GSM_AWAKE_TIME + (GSM_POWER_ON_TIME if powerSaving else 0.0)
+		gsmActiveTime = times["GSM"]["GPRS"] + times["GSM"]["IDLE"]
+	# Without the power saving, the GSM stays registered and sleeps between the AT commands
+	times["GSM"]["OFF" if powerSaving else "SLEEP"] = period - gsmActiveTime
+
+	activeTime = min(period, max(gpsTime, gsmActiveTime) + MCU_ACTIVE_OVERHEAD)
+	times["MCU"]["RUN"] = activeTime
+	times["MCU"]["STANDBY"] = period - activeTime
+
+	times["LED"]["1"] = LED_CYCLE_TIME if sendMessage else 0.0
+	times["LED"]["0"] = period - times["LED"]["1"]
+	return times
+
+# Returns the charge in uAh
+def computeCharge(times, currents):
+	return sum(times[domain][state] * currents[domain][state] for domain in times for state in times[domain]) / 3600.0
+
+def printBatteryLife(name, charge, duration):
+	averageCurrent = charge * 3600.0 / duration
+	batteryLife = BATTERY_CAPACITY * 1000.0 / averageCurrent if averageCurrent > 0 else float("inf")
+	print("%-20s | %12.3f | %12.0f | %8.1f h | %6.1f days" % (name, charge / 1000.0, averageCurrent, batteryLife, batteryLife / 24))
+
+def simulateModes(powerSaving):
+	print("Power saving : %s" % ("on" if powerSaving else "off"))
+	print("Mode                 | mAh per cycle | average uA | battery life")
+	for name, period, useGPS, sendMessage in MODES:
+		times = buildCycle(period, useGPS, sendMessage, powerSaving)
+		printBatteryLife(name, computeCharge(times, CURRENTS), period)
+
+# Reads the ENG_STATE lines : the times of the run are charged with the dumped currents and with the table of this file
+def recomputeReport(path):
+	times = {}
+	dumpedCurrents = {}
+	runTime = 0
+	with open(path) as f:
+		for line in f:
+			fields = line.strip().split(":")
+			if fields[0] == "ENG_RUN_TIME":
+				runTime = int(fields[1]) / 1000.0
+			elif fields[0] == "ENG_STATE" and len(fields) == 6:
+				domain, state = fields[1], fields[2]
+				times.setdefault(domain, {})[state] = int(fields[3]) / 1000.0
+				dumpedCurrents.setdefault(domain, {})[state] = int(fields[4])
+	if runTime <= 0:
+		print("No ENG_RUN_TIME in the report")
+		return 1
+	tableCurrents = {domain: {state: CURRENTS.get(domain, {}).get(state, dumpedCurrents[domain][state]) for state in states} for domain, states in times.items()}
+	print("Run of %.0f s" % runTime)
+	print("Currents             | mAh over run | average uA | battery life")
+	printBatteryLife("Seekios table", computeCharge(times, dumpedCurrents), runTime)
+	printBatteryLife("Simulation table", computeCharge(times, tableCurrents), runTime)
+	return 0
+
+def main(args):
+	if "--report" in args:
+		return recomputeReport(args[args.index("--report") + 1])
+	simulateModes("--power-saving" in args)
+	return 0
+
+if __name__ == "__main__":
+	sys.exit(main(sys.argv[1:]))
@@ -0,0 +1,455 @@
+/*
+ * geolocation_tools_check.c
+ *
+ * Content : host check and benchmark of the compiled zones of tracker2/tools/geolocation_tools.c against the former
+ * floating point zone functions, kept below as the reference (isPositionInZone, getShortestDistanceToZone) :
+ *   gcc -O2 -I../tracker2 -o geolocation_tools_check geolocation_tools_check.c -lm
+ * Usage : ./geolocation_tools_check [--zones n]
+ *
+ * Random star shaped zones of 3 to ZONE_MAX_VERTICES vertices, from 30 m to 3 km wide, are drawn at several latitudes, then
+ * random positions around each zone and close to its edges are checked. The exact answer is computed in doubles : ray casting
+ * in the lat/lon plane for the inside test, and the haversine distance to each edge minimized along the edge.
+ * The compiled zone must give the exact inside/outside answer for every position farther than MAX_BORDER_ERROR from an edge,
+ * and its distance to the zone must be within MAX_BORDER_ERROR + MAX_RELATIVE_ERROR of the exact one. The errors of the former
+ * functions are only reported : they measure in degrees, without the cos(lat) of the longitudes.
+ * The benchmark runs on the host FPU : on the Cortex-M0+, where the doubles are software routines, the gap is larger.
+ * Returns 1 if a check fails.
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+/* The firmware headers that need the ASF are skipped : their guards are defined, the declarations used by the file follow */
+#define GLOBAL_VAR_H_
+#define GPS_MANAGER_H_
+
+/* Keep in sync with GPS_manager.h */
+typedef struct {
+	double lat;
+	double lon;
+	float alt;	// in meter
+} Coordinate;
+
+#include "../tracker2/tools/geolocation_tools.c"
+
+#define NB_ZONES				5000
+#define NB_POSITIONS_PER_ZONE	50
+#define MAX_BORDER_ERROR		2.0		// m, the positions and the vertices are projected to the nearest meter
+#define MAX_RELATIVE_ERROR		0.005	// of the distance, equirectangular projection on the zone center
+#define NB_EXAMPLES				5
+#define BENCHMARK_ROUNDS		20
+
+/* Former zone functions, replaced by the compiled zones */
+typedef struct {
+	double x;
+	double y;
+} Vector;
+
+static int formerCrossProduct(Vector vector1,Vector vector2)
+{
+	double result=vector1.x*vector2.y-vector1.y*vector2.x;
+	if(result<0)
+	{
+		return -1;
+	}
+	else if (result>0)
+	{
+		return 1;
+	}
+	else return 0;
+}
+
+static void formerConstructVectors(Vector *vectors,int nbVectors, Coordinate *coordinates)
+{
+	for (int i=0;i<nbVectors;i++)
+	{
+		if(i<(nbVectors-1))
+		{
+			vectors[i].x=(coordinates[i+1].lat-coordinates[i].lat);
+			vectors[i].y=(coordinates[i+1].lon-coordinates[i].lon);
+		}
+		else
+		{
+			vectors[i].x=(coordinates[0].lat-coordinates[i].lat);
+			vectors[i].y=(coordinates[0].lon-coordinates[i].lon);
+		}
+	}
+}
+
+/* Counts the crossings of the zone edges with the segment between the position and the point lat=0, lon=0 */
+static bool formerIsPositionInZone(Coordinate *seekiosLocationPtr, int nbCoordinates, Coordinate *zoneCoordinates)
+{
+	Vector zoneVectors[ZONE_MAX_VERTICES];
+	formerConstructVectors(zoneVectors, nbCoordinates, zoneCoordinates);
+
+	Vector condition2_1;
+	Vector condition2_2;
+	Vector condition3_1;
+	Vector condition3_2;
+	Vector seekios;
+
+	int index=0;
+	seekios.x=-(seekiosLocationPtr->lat);
+	seekios.y=-(seekiosLocationPtr->lon);
+
+	for (int i=0;i<nbCoordinates;i++)
+	{
+		condition2_2.x=zoneCoordinates[i].lat-seekiosLocationPtr->lat;
+		condition2_2.y=zoneCoordinates[i].lon-seekiosLocationPtr->lon;
+		condition3_1.x=-zoneCoordinates[i].lat;
+		condition3_1.y=-zoneCoordinates[i].lon;
+		condition3_2.x=seekiosLocationPtr->lat-zoneCoordinates[i].lat;
+		condition3_2.y=seekiosLocationPtr->lon-zoneCoordinates[i].lon;
+		condition2_1.x=zoneCoordinates[(i+1)%nbCoordinates].lat-seekiosLocationPtr->lat;
+		condition2_1.y=zoneCoordinates[(i+1)%nbCoordinates].lon-seekiosLocationPtr->lon;
+
+		if(formerCrossProduct(seekios,zoneVectors[i])!=0
+		&& (formerCrossProduct(seekios,condition2_1)*formerCrossProduct(seekios,condition2_2))<=0
+		&&(formerCrossProduct(zoneVectors[i],condition3_1)*formerCrossProduct(zoneVectors[i],condition3_2))<=0)
+		{
+			index++;
+		}
+	}
+	return !((index%2)==0);
+}
+
+static double formerGeoCoordinateToMeterDistance(double xA, double yA, double xB, double yB)
+{
+	double xA_rad = DDtoRad(xA);
+	double xB_rad = DDtoRad(xB);
+	double yA_rad = DDtoRad(yA);
+	double yB_rad = DDtoRad(yB);
+
+	double sinXA = sin(xA_rad);
+	double sinXB = sin(xB_rad);
+	double cosXA = cos(xA_rad);
+	double cosXB = cos(xB_rad);
+	double cosDiffYAYB = cos(yA_rad	- yB_rad);
+
+	return	fabs(acos(sinXA*sinXB+cosXA*cosXB*cosDiffYAYB)*EARTH_RADIUS);
+}
+
+static double formerGetShortestDistanceFromEdge(double xA, double yA, double xB, double yB, Coordinate* point)
+{
+	double A = point->lat - xA;
+	double B = point->lon - yA;
+	double C = xB - xA;
+	double D = yB - yA;
+
+	double dot = A*C + B*D;
+	double squareLength = C*C + D*D;
+	double param = -1;
+	if(squareLength != 0)
+	{
+		param = dot/squareLength;
+	}
+
+	double xH, yH;
+	if(param < 0){
+		xH = xA;
+		yH = yA;
+	} else if(param > 1){
+		xH = xB;
+		yH = yB;
+	} else {
+		xH = xA + param * C;
+		yH = yA + param * D;
+	}
+	return formerGeoCoordinateToMeterDistance(point->lat, point->lon, xH, yH);
+}
+
+static double formerGetShortestDistanceToZone(Coordinate* zoneCoordinates, uint8_t nbCoordinates, Coordinate* pointPtr)
+{
+	double shortestDistance = formerGetShortestDistanceFromEdge(zoneCoordinates[0].lat, zoneCoordinates[0].lon, zoneCoordinates[1].lat, zoneCoordinates[1].lon, pointPtr);
+	for(int i=1; i<nbCoordinates; i++){
+		double distance = formerGetShortestDistanceFromEdge(
+			zoneCoordinates[i].lat,
+			zoneCoordinates[i].lon,
+			zoneCoordinates[(i+1)%nbCoordinates].lat,
+			zoneCoordinates[(i+1)%nbCoordinates].lon,
+			pointPtr
+		);
+		if(distance < shortestDistance){
+			shortestDistance = distance;
+		}
+	}
+	return shortestDistance;
+}
+
+/* Distance of the zone, as computed by geofencing.c before and after the compiled zones */
+static double formerGetMinDistanceFromZone(Coordinate* pointPtr, Coordinate* zoneCoordinates, uint8_t nbCoordinates)
+{
+	if(formerIsPositionInZone(pointPtr, nbCoordinates, zoneCoordinates))
+	{
+		return 0;
+	}
+	return formerGetShortestDistanceToZone(zoneCoordinates, nbCoordinates, pointPtr);
+}
+
+static uint32_t compiledGetMinDistanceFromZone(Coordinate* pointPtr, const CompiledZone* zonePtr)
+{
+	LocalPoint point;
+	geolocationTools_projectOnZone(zonePtr, pointPtr, &point);
+	return geolocationTools_getDistanceToCompiledZone(zonePtr, &point);
+}
+
+/* Exact answers */
+static double haversine(double latA, double lonA, double latB, double lonB)
+{
+	double dLat = DDtoRad(latB - latA);
+	double dLon = DDtoRad(lonB - lonA);
+	double a = sin(dLat / 2) * sin(dLat / 2) + cos(DDtoRad(latA)) * cos(DDtoRad(latB)) * sin(dLon / 2) * sin(dLon / 2);
+	return 2 * EARTH_RADIUS * asin(sqrt(a));
+}
+
+static double exactDistanceToEdge(const Coordinate* a, const Coordinate* b, const Coordinate* pointPtr)
+{
+	double low = 0;
+	double high = 1;
+	for(uint8_t i = 0; i < 60; i++)
+	{
+		double t1 = low + (high - low) / 3;
+		double t2 = high - (high - low) / 3;
+		double d1 = haversine(pointPtr->lat, pointPtr->lon, a->lat + t1 * (b->lat - a->lat), a->lon + t1 * (b->lon - a->lon));
+		double d2 = haversine(pointPtr->lat, pointPtr->lon, a->lat + t2 * (b->lat - a->lat), a->lon + t2 * (b->lon - a->lon));
+		if(d1 < d2) high = t2;
+		else low = t1;
+	}
+	double t = (low + high) / 2;
+	return haversine(pointPtr->lat, pointPtr->lon, a->lat + t * (b->lat - a->lat), a->lon + t * (b->lon - a->lon));
+}
+
+static double exactDistanceToBorder(const Coordinate* zoneCoordinates, uint8_t nbCoordinates, const Coordinate* pointPtr)
+{
+	double minDistance = INFINITY;
+	for(uint8_t i = 0; i < nbCoordinates; i++)
+	{
+		double distance = exactDistanceToEdge(&zoneCoordinates[i], &zoneCoordinates[(i + 1) % nbCoordinates], pointPtr);
+		if(distance < minDistance) minDistance = distance;
+	}
+	return minDistance;
+}
+
+static bool exactIsInZone(const Coordinate* zoneCoordinates, uint8_t nbCoordinates, const Coordinate* pointPtr)
+{
+	bool isInZone = false;
+	for(uint8_t i = 0, j = nbCoordinates - 1; i < nbCoordinates; j = i++)
+	{
+		const Coordinate* a = &zoneCoordinates[i];
+		const Coordinate* b = &zoneCoordinates[j];
+		if((a->lat > pointPtr->lat) != (b->lat > pointPtr->lat)
+		&& pointPtr->lon < (b->lon - a->lon) * (pointPtr->lat - a->lat) / (b->lat - a->lat) + a->lon)
+		{
+			isInZone = !isInZone;
+		}
+	}
+	return isInZone;
+}
+
+/* Deterministic draws, the same on every host */
+static uint64_t _randomState = 0x5EE4105;
+
+static double randomUniform(double min, double max)
+{
+	_randomState = _randomState * 6364136223846793005ULL + 1442695040888963407ULL;
+	return min + (max - min) * (double)(_randomState >> 11) / (double)(1ULL << 53);
+}
+
+typedef struct {
+	Coordinate coordinates[ZONE_MAX_VERTICES];
+	uint8_t nbCoordinates;
+	CompiledZone compiled;
+} Zone;
+
+typedef struct {
+	uint32_t nbPositions;
+	uint32_t nbWrongSides;			// compiled zone, farther than MAX_BORDER_ERROR from the border
+	uint32_t nbWrongDistances;		// compiled zone
+	uint32_t nbBorderSides;			// compiled zone, on the wrong side but within MAX_BORDER_ERROR of the border
+	double maxDistanceError;		// compiled zone, m
+	uint32_t nbFormerWrongSides;
+	double maxFormerDistanceError;
+	uint32_t nbExamples;
+} Result;
+
+static const double _latitudes[] = {0.5, 43.48, -33.87, 60.17, 69.65};
+
+static void drawZone(Zone* zonePtr, uint32_t zoneIndex)
+{
+	double centerLat = _latitudes[zoneIndex % (sizeof(_latitudes) / sizeof(_latitudes[0]))] + randomUniform(-0.5, 0.5);
+	double centerLon = randomUniform(-170, 170);
+	double radius = exp(randomUniform(log(15), log(1500))); // m
+	double angles[ZONE_MAX_VERTICES];
+	zonePtr->nbCoordinates = 3 + (uint8_t)randomUniform(0, ZONE_MAX_VERTICES - 2);
+	for(uint8_t i = 0; i < zonePtr->nbCoordinates; i++)
+	{
+		angles[i] = randomUniform(0, 2 * M_PI);
+	}
+	for(uint8_t i = 1; i < zonePtr->nbCoordinates; i++) // sorted : the star shaped zone is a simple polygon
+	{
+		for(uint8_t j = i; j > 0 && angles[j - 1] > angles[j]; j--)
+		{
+			double angle = angles[j];
+			angles[j] = angles[j - 1];
+			angles[j - 1] = angle;
+		}
+	}
+	double metersPerDegreeLat = DDtoRad(1) * EARTH_RADIUS;
+	for(uint8_t i = 0; i < zonePtr->nbCoordinates; i++)
+	{
+		double vertexRadius = radius * randomUniform(0.4, 1);
+		zonePtr->coordinates[i].lat = centerLat + vertexRadius * sin(angles[i]) / metersPerDegreeLat;
+		zonePtr->coordinates[i].lon = centerLon + vertexRadius * cos(angles[i]) / (metersPerDegreeLat * cos(DDtoRad(centerLat)));
+		zonePtr->coordinates[i].alt = 0;
+	}
+	geolocationTools_compileZone(&zonePtr->compiled, zonePtr->coordinates, zonePtr->nbCoordinates);
+}
+
+/* Half of the positions anywhere around the zone, half within 25 m of an edge */
+static void drawPosition(const Zone* zonePtr, Coordinate* positionPtr)
+{
+	double minLat = zonePtr->coordinates[0].lat, maxLat = minLat;
+	double minLon = zonePtr->coordinates[0].lon, maxLon = minLon;
+	for(uint8_t i = 1; i < zonePtr->nbCoordinates; i++)
+	{
+		minLat = fmin(minLat, zonePtr->coordinates[i].lat);
+		maxLat = fmax(maxLat, zonePtr->coordinates[i].lat);
+		minLon = fmin(minLon, zonePtr->coordinates[i].lon);
+		maxLon = fmax(maxLon, zonePtr->coordinates[i].lon);
+	}
+	if(randomUniform(0, 1) < 0.5)
+	{
+		double marginLat = maxLat - minLat;
+		double marginLon = maxLon - minLon;
+		positionPtr->lat = randomUniform(minLat - marginLat, maxLat + marginLat);
+		positionPtr->lon = randomUniform(minLon - marginLon, maxLon + marginLon);
+	}
+	else
+	{
+		uint8_t edge = (uint8_t)randomUniform(0, zonePtr->nbCoordinates);
+		const Coordinate* a = &zonePtr->coordinates[edge];
+		const Coordinate* b = &zonePtr->coordinates[(edge + 1) % zonePtr->nbCoordinates];
+		double t = randomUniform(0, 1);
+		double metersPerDegreeLat = DDtoRad(1) * EARTH_RADIUS;
+		positionPtr->lat = a->lat + t * (b->lat - a->lat) + randomUniform(-25, 25) / metersPerDegreeLat;
+		positionPtr->lon = a->lon + t * (b->lon - a->lon) + randomUniform(-25, 25) / (metersPerDegreeLat * cos(DDtoRad(a->lat)));
+	}
+	positionPtr->alt = 0;
+}
+
+static void checkPosition(Zone* zonePtr, Coordinate* positionPtr, Result* resultPtr)
+{
+	bool isInZone = exactIsInZone(zonePtr->coordinates, zonePtr->nbCoordinates, positionPtr);
+	double borderDistance = exactDistanceToBorder(zonePtr->coordinates, zonePtr->nbCoordinates, positionPtr);
+	double exactDistance = isInZone ? 0 : borderDistance;
+	resultPtr->nbPositions++;
+
+	LocalPoint point;
+	geolocationTools_projectOnZone(&zonePtr->compiled, positionPtr, &point);
+	bool isInCompiledZone = geolocationTools_isPointInCompiledZone(&zonePtr->compiled, &point);
+	uint32_t compiledDistance = geolocationTools_getDistanceToCompiledZone(&zonePtr->compiled, &point);
+	if(isInCompiledZone != isInZone)
+	{
+		if(borderDistance <= MAX_BORDER_ERROR)
+		{
+			resultPtr->nbBorderSides++;
+		}
+		else
+		{
+			resultPtr->nbWrongSides++;
+			if(resultPtr->nbExamples++ < NB_EXAMPLES)
+				printf("    compiled zone %s at %.1f m from the border, lat %.7f lon %.7f\n", isInCompiledZone ? "in" : "out", borderDistance, positionPtr->lat, positionPtr->lon);
+		}
+	}
+	double distanceError = fabs(compiledDistance - exactDistance);
+	if(isInCompiledZone == isInZone)
+	{
+		if(distanceError > resultPtr->maxDistanceError) resultPtr->maxDistanceError = distanceError;
+		if(distanceError > MAX_BORDER_ERROR + MAX_RELATIVE_ERROR * exactDistance)
+		{
+			resultPtr->nbWrongDistances++;
+			if(resultPtr->nbExamples++ < NB_EXAMPLES)
+				printf("    compiled zone distance %" PRIu32 " m instead of %.1f m, lat %.7f lon %.7f\n", compiledDistance, exactDistance, positionPtr->lat, positionPtr->lon);
+		}
+	}
+
+	bool isInFormerZone = formerIsPositionInZone(positionPtr, zonePtr->nbCoordinates, zonePtr->coordinates);
+	if(isInFormerZone != isInZone && borderDistance > MAX_BORDER_ERROR)
+	{
+		resultPtr->nbFormerWrongSides++;
+	}
+	else if(isInFormerZone == isInZone)
+	{
+		double formerDistance = isInFormerZone ? 0 : formerGetShortestDistanceToZone(zonePtr->coordinates, zonePtr->nbCoordinates, positionPtr);
+		if(fabs(formerDistance - exactDistance) > resultPtr->maxFormerDistanceError) resultPtr->maxFormerDistanceError = fabs(formerDistance - exactDistance);
+	}
+}
+
+static double getTime(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+/* Returns the time of one position check, in ns, as done by getMinDistanceFromZone of geofencing.c */
+static double benchmark(Zone* zones, Coordinate* positions, uint32_t nbZones, bool isCompiled)
+{
+	volatile double sink = 0;
+	double start = getTime();
+	for(uint32_t round = 0; round < BENCHMARK_ROUNDS; round++)
+	{
+		for(uint32_t i = 0; i < nbZones; i++)
+		{
+			sink += isCompiled ? compiledGetMinDistanceFromZone(&positions[i], &zones[i].compiled)
+				: formerGetMinDistanceFromZone(&positions[i], zones[i].coordinates, zones[i].nbCoordinates);
+		}
+	}
+	(void)sink;
+	return (getTime() - start) * 1e9 / ((double)BENCHMARK_ROUNDS * nbZones);
+}
+
+int main(int argc, char* argv[])
+{
+	uint32_t nbZones = NB_ZONES;
+	if(argc > 2 && strcmp(argv[1], "--zones") == 0) nbZones = atoi(argv[2]);
+
+	Zone* zones = malloc(nbZones * sizeof(Zone));
+	Coordinate* positions = malloc(nbZones * sizeof(Coordinate));
+	if(zones == NULL || positions == NULL || nbZones == 0)
+	{
+		return 1;
+	}
+
+	Result result;
+	memset(&result, 0, sizeof(result));
+	for(uint32_t i = 0; i < nbZones; i++)
+	{
+		drawZone(&zones[i], i);
+		for(uint32_t j = 0; j < NB_POSITIONS_PER_ZONE; j++)
+		{
+			drawPosition(&zones[i], &positions[i]);
+			checkPosition(&zones[i], &positions[i], &result);
+		}
+	}
+	printf("%" PRIu32 " zones, %" PRIu32 " positions, CompiledZone of %u bytes\n", nbZones, result.nbPositions, (unsigned)sizeof(CompiledZone));
+	printf("    compiled zone : %" PRIu32 " wrong sides, %" PRIu32 " wrong distances, %" PRIu32 " sides within %.0f m of the border, largest distance error %.2f m\n",
+		result.nbWrongSides, result.nbWrongDistances, result.nbBorderSides, MAX_BORDER_ERROR, result.maxDistanceError);
+	printf("    former functions : %" PRIu32 " wrong sides, largest distance error %.2f m\n", result.nbFormerWrongSides, result.maxFormerDistanceError);
+
+	printf("\nBenchmark, one position per zone\n");
+	printf("    former isPositionInZone + getShortestDistanceToZone : %7.1f ns\n", benchmark(zones, positions, nbZones, false));
+	printf("    projectOnZone + getDistanceToCompiledZone           : %7.1f ns\n", benchmark(zones, positions, nbZones, true));
+
+	bool isValid = result.nbWrongSides == 0 && result.nbWrongDistances == 0;
+	printf("\n%s\n", isValid ? "OK" : "FAILED");
+	free(zones);
+	free(positions);
+	return isValid ? 0 : 1;
+}
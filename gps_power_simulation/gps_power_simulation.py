@@ -0,0 +1,161 @@
+# Simulates the GPS of a Seekios in tracking mode and reports the GPS charge per fix
+# for the former fixed policy and for the adaptive policy of peripheralManager/GPS_power_policy.c
+# Usage : python gps_power_simulation.py [--weak-sky] [--power-saving] [--cycles N]
+# Keep the constants in sync with GPS_manager.h and GPS_power_policy.h
+
+import random
+import sys
+
+GPS_WARMUP_TIME				= 60.0	# s
+GPS_MAX_FIXTIME				= 60.0	# s, the tracking mode keeps the GPS on during this time frame to get the best position
+GPS_EXPIRATION_TIME			= 300.0	# s
+GPS_POWER_ON_DELAY			= 2.0	# s
+GPS_WAKEUP_DELAY			= 0.1	# s
+
+GPS_ACQUISITION_CURRENT		= 25000	# uA
+GPS_STANDBY_CURRENT			= 200	# uA
+GPS_EPHEMERIS_VALIDITY		= 7200	# s
+GPS_MIN_WARMUP_TIME			= 3.0	# s
+GPS_WARMUP_MARGIN			= 150	# %
+GPS_WEAK_SKY_WARMUP_MARGIN	= 200	# %
+GPS_WEAK_SKY_SATELLITES		= 6
+
+START_HOT	= 0
+START_WARM	= 1
+START_COLD	= 2
+DEFAULT_TTFF = [5.0, 35.0, 60.0]
+
+REFRESH_RATES = [1, 2, 5, 10, 15, 30, 60, 120, 240] # in min
+
+# Real time to first fix of the receiver (s), drawn for each session
+def drawTTFF(startType, weakSky):
+	ranges = [(1.0, 4.0), (25.0, 40.0), (32.0, 55.0)]
+	ttff = random.uniform(*ranges[startType])
+	return ttff * 1.8 if weakSky else ttff
+
+def drawSatellitesNumber(weakSky):
+	return random.randint(4, 6) if weakSky else random.randint(7, 12)
+
+# Same decisions as GPS_power_policy.c
+class AdaptivePolicy:
+	def __init__(self):
+		self.learnedTTFF = list(DEFAULT_TTFF)
+		self.averageSatellitesNumber = GPS_WEAK_SKY_SATELLITES
+		self.lastFixTime = None
+		self.plannedStartType = START_COLD
+
+	def isEphemerisFresh(self, atTime):
+		return self.lastFixTime is not None and atTime - self.lastFixTime < GPS_EPHEMERIS_VALIDITY
+
+	def isStandbyCheaper(self, gap):
+		standbyCharge = GPS_STANDBY_CURRENT * gap + GPS_ACQUISITION_CURRENT * self.learnedTTFF[START_HOT]
+		powerOffCharge = GPS_ACQUISITION_CURRENT * self.learnedTTFF[START_WARM]
+		return standbyCharge < powerOffCharge
+
+	def getStartTypeAfter(self, now, gap):
+		if not self.isEphemerisFresh(now + gap):
+			return START_COLD
+		return START_HOT if self.isStandbyCheaper(gap) else START_WARM
+
+	def computeWarmupTime(self, startType):
+		margin = GPS_WEAK_SKY_WARMUP_MARGIN if self.averageSatellitesNumber < GPS_WEAK_SKY_SATELLITES else GPS_WARMUP_MARGIN
+		return min(max(self.learnedTTFF[startType] * margin / 100.0, GPS_MIN_WARMUP_TIME), GPS_WARMUP_TIME)
+
+	def getWarmupTime(self, now, delay):
+		for startType in (START_HOT, START_WARM):
+			warmup = self.computeWarmupTime(startType)
+			if warmup < delay and self.getStartTypeAfter(now, delay - warmup) == startType:
+				self.plannedStartType = startType
+				return warmup
+		self.plannedStartType = START_COLD
+		return self.computeWarmupTime(START_COLD)
+
+	def shouldStandby(self, now, gap):
+		return self.plannedStartType == START_HOT and self.getStartTypeAfter(now, gap) == START_HOT
+
+	def learn(self, startType, ttff, satellitesNumber, now):
+		self.learnedTTFF[startType] = (self.learnedTTFF[startType] * 3 + ttff) / 4.0
+		self.averageSatellitesNumber = (self.averageSatellitesNumber * 3 + satellitesNumber + 2) // 4
+		self.lastFixTime = now
+
+# Runs the tracking loop of tracking.c. Returns the charge (uA.s), the time on (s) and the number of fixes
+def simulate(refreshRateMin, adaptive, weakSky, powerSaving, cycles):
+	policy = AdaptivePolicy()
+	refreshRate = refreshRateMin * 60.0
+	now = 0.0
+	charge = 0.0
+	timeOn = 0.0
+	fixes = 0
+	gpsState = "off"	# off, standby or on
+	lastFixTime = None
+
+	def addOn(duration):
+		return GPS_ACQUISITION_CURRENT * duration, duration
+
+	for cycle in range(cycles):
+		# Start of the session : the GPS was powered on or woken up during the warmup, or stayed on
+		sessionStart = now - warmup if cycle > 0 and gpsState != "on" else now
+		if gpsState == "on":
+			startType = START_HOT
+		elif lastFixTime is None or sessionStart - lastFixTime >= GPS_EPHEMERIS_VALIDITY:
+			startType = START_COLD
+		else:
+			startType = START_HOT if gpsState == "standby" else START_WARM
+		ttff = drawTTFF(startType, weakSky) if gpsState != "on" else 0.0
+		# The mode waits GPS_MAX_FIXTIME, or longer until the first fix
+		fixTime = sessionStart + ttff
+		modeEnd = max(now + GPS_MAX_FIXTIME, fixTime)
+		c, t = addOn(modeEnd - sessionStart + (GPS_POWER_ON_DELAY if gpsState == "off" else GPS_WAKEUP_DELAY if gpsState == "standby" else 0.0))
+		charge += c
+		timeOn += t
+		fixes += 1
+		lastFixTime = fixTime
+		if adaptive and gpsState != "on":
+			policy.learn(startType, ttff, drawSatellitesNumber(weakSky), fixTime)
+		now = modeEnd
+
+		# Wait until the next cycle
+		timeToWait = refreshRate - GPS_MAX_FIXTIME
+		warmup = policy.getWarmupTime(now, timeToWait) if adaptive else GPS_WARMUP_TIME
+		if timeToWait <= 0:
+			gpsState = "on"
+			continue
+		if timeToWait <= warmup:
+			# The GPS stays requested
+			c, t = addOn(timeToWait)
+			charge += c
+			timeOn += t
+			gpsState = "on"
+			now += timeToWait
+			continue
+		gap = timeToWait - warmup
+		if adaptive:
+			standby = policy.shouldStandby(now, gap)
+			charge += GPS_STANDBY_CURRENT * gap if standby else 0.0
+			gpsState = "standby" if standby else "off"
+		else:
+			# Expiration alarm : the GPS stays on, unless the power saving releases it at once
+			hold = 0.0 if powerSaving else min(GPS_EXPIRATION_TIME, gap)
+			c, t = addOn(hold)
+			charge += c
+			timeOn += t
+			gpsState = "on" if hold == gap else "off"
+		now += timeToWait
+	return charge, timeOn, fixes
+
+def main(args):
+	weakSky = "--weak-sky" in args
+	powerSaving = "--power-saving" in args
+	cycles = int(args[args.index("--cycles") + 1]) if "--cycles" in args else 200
+	random.seed(1)
+	print("Refresh rate | fixed policy : mAh/fix  on s/fix | adaptive policy : mAh/fix  on s/fix | gain")
+	for refreshRateMin in REFRESH_RATES:
+		oldCharge, oldOn, oldFixes = simulate(refreshRateMin, False, weakSky, powerSaving, cycles)
+		newCharge, newOn, newFixes = simulate(refreshRateMin, True, weakSky, powerSaving, cycles)
+		oldPerFix = oldCharge / oldFixes / 3.6e6
+		newPerFix = newCharge / newFixes / 3.6e6
+		print("%9d min | %20.4f %9.1f | %23.4f %9.1f | %3d %%" % (refreshRateMin, oldPerFix, oldOn / oldFixes, newPerFix, newOn / newFixes, round(100 * (1 - newPerFix / oldPerFix))))
+	return 0
+
+if __name__ == "__main__":
+	sys.exit(main(sys.argv[1:]))
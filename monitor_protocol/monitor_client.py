@@ -0,0 +1,182 @@
+# Talks to the USB test monitor of the Seekios with the binary frames of tests/monitor_frame.h.
+# Usage : python monitor_client.py <port> status
+#         python monitor_client.py <port> telemetry
+#         python monitor_client.py <port> trace <capture.txt>					writes the trace in the text format of trace_analysis/trace_decoder.py
+#         python monitor_client.py <port> flash <first page> <number of pages> <dump.bin>
+#         python monitor_client.py <port> report
+#         python monitor_client.py <port> trigger sos|off|on|instruction [instruction]
+# Needs pyserial.
+
+import struct
+import sys
+import time
+
+# Keep in sync with monitor_frame.h
+FRAME_SYNC = 0xA5
+ID_GET_STATUS		= 0x01
+ID_GET_TELEMETRY	= 0x02
+ID_GET_TRACE		= 0x03
+ID_READ_FLASH		= 0x04
+ID_GET_TEST_REPORT	= 0x05
+ID_TRIGGER			= 0x06
+ID_END				= 0x7F
+
+STATUS_NAMES = ["OK", "WRONG_CRC", "WRONG_LENGTH", "UNKNOWN_COMMAND", "DISABLED", "WRONG_PARAMETER", "FRAME_DROPPED"]
+TRIGGERS = {"sos" : 1, "off" : 2, "on" : 3, "instruction" : 4}
+
+TASK_NAME_LENGTH = 8	# configMAX_TASK_NAME_LEN
+PAGE_SIZE = 256			# EXT_FLASH_PAGE_SIZE
+ANSWER_TIMEOUT = 10		# s, a flash dump resets it at each page
+
+# Same CRC as computeCrc16 in monitor_frame.c
+def crc16(data):
+	crc = 0xFFFF
+	for byte in bytearray(data):
+		crc ^= byte << 8
+		for bit in range(8):
+			crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+			crc &= 0xFFFF
+	return crc
+
+def encodeFrame(frameId, payload = b""):
+	body = struct.pack("<BH", frameId, len(payload)) + payload
+	return struct.pack("<B", FRAME_SYNC) + body + struct.pack("<H", crc16(body))
+
+# Splits the received bytes in frames. The text lines printed meanwhile (debug logs) are skipped
+class FrameReader:
+	def __init__(self, port):
+		self.port = port
+		self.buffer = bytearray()
+
+	def readFrame(self, timeout):
+		endTime = time.time() + timeout
+		while time.time() < endTime:
+			frame = self.extractFrame()
+			if frame is not None:
+				return frame
+			self.buffer += self.port.read(512)
+		raise IOError("No answer from the Seekios")
+
+	def extractFrame(self):
+		start = self.buffer.find(bytes(bytearray([FRAME_SYNC])))
+		if start < 0:
+			del self.buffer[:]
+			return None
+		del self.buffer[:start]
+		if len(self.buffer) < 4:
+			return None
+		frameId, length = struct.unpack_from("<BH", self.buffer, 1)
+		if len(self.buffer) < 4 + length + 2:
+			return None
+		body = bytes(self.buffer[1:4 + length])
+		crc, = struct.unpack_from("<H", self.buffer, 4 + length)
+		if crc != crc16(body):
+			del self.buffer[:1] # not a frame, looks for the next sync byte
+			return self.extractFrame()
+		del self.buffer[:4 + length + 2]
+		return frameId, body[3:]
+
+# Sends the command and returns the payloads of its answer frames
+def request(port, frameId, payload = b""):
+	reader = FrameReader(port)
+	port.write(encodeFrame(frameId, payload))
+	payloads = []
+	while True:
+		answerId, answer = reader.readFrame(ANSWER_TIMEOUT)
+		if answerId == ID_END:
+			commandId, status = struct.unpack("<BB", answer)
+			if commandId != frameId or status != 0:
+				raise IOError("Command %d failed : %s" % (commandId, STATUS_NAMES[status] if status < len(STATUS_NAMES) else status))
+			return payloads
+		if answerId == frameId:
+			payloads.append(answer)
+
+def cString(data):
+	return bytes(data).split(b"\0")[0].decode("ascii", "replace")
+
+def printStatus(payloads):
+	version, subversion, requestMask, runningMask, interruptMask, tick = struct.unpack("<BBIIII", payloads[0])
+	print("Version        : %d.%03d" % (version, subversion))
+	print("Request mask   : 0x%08X" % requestMask)
+	print("Running mask   : 0x%08X" % runningMask)
+	print("Interrupt mask : 0x%08X" % interruptMask)
+	print("Tick           : %d" % tick)
+
+def printTelemetry(payloads):
+	payload = payloads[0]
+	names = ["Free heap", "Min free heap", "Largest free block", "Min largest free block", "Allocation failures"]
+	for name, value in zip(names, struct.unpack_from("<IIIII", payload)):
+		print("%-24s: %d" % (name, value))
+	nbTasks = payload[20] if isinstance(payload[20], int) else ord(payload[20])
+	for i in range(nbTasks):
+		offset = 21 + i * (TASK_NAME_LENGTH + 2)
+		freeStack, = struct.unpack_from("<H", payload, offset + TASK_NAME_LENGTH)
+		print("Stack %-18s: %d words free" % (cString(payload[offset:offset + TASK_NAME_LENGTH]), freeStack))
+
+# Writes the TRC_* lines of trace_printDump, so trace_decoder.py decodes both dumps
+def writeTrace(payloads, path):
+	header = payloads[0]
+	tick, nbTasks = struct.unpack_from("<IB", header)
+	with open(path, "w") as capture:
+		capture.write("TRC_NOW:%d\n" % tick)
+		for i in range(nbTasks):
+			offset = 5 + i * (4 + TASK_NAME_LENGTH)
+			taskId, = struct.unpack_from("<I", header, offset)
+			capture.write("TRC_TASK:%d:%s\n" % (taskId, cString(header[offset + 4:offset + 4 + TASK_NAME_LENGTH])))
+		for payload in payloads[1:]:
+			capture.write("TRC_DATA:%s\n" % "".join("%02X" % byte for byte in bytearray(payload)))
+		capture.write("TRC_OVER\n")
+	print("%d trace records written in %s" % (sum(len(payload) for payload in payloads[1:]) // 8, path))
+
+def dumpFlash(payloads, path):
+	with open(path, "wb") as dump:
+		for payload in payloads:
+			dump.write(payload[2:2 + PAGE_SIZE])
+	print("%d pages written in %s" % (len(payloads), path))
+
+def printReport(payloads):
+	fields = struct.unpack("<10s10sB10s20s20sHBB15sB3bBBBBiiHH", payloads[0])
+	uid, versionName, gsmFlags, rssiSamples, imei, imsi, batteryVoltage, gpsFlags, bleFlags, macAddress, imuFlag = fields[:11]
+	accelerations = fields[11:14]
+	ledFlag, buttonFlag, dfFlags, calendarFlags, usbVoltage, batVoltage, voltageMin, voltageMax = fields[14:]
+	flags = lambda value, count : ",".join(str((value >> i) & 1) for i in range(count))
+	print("TEST_RES_SKS:%s,%s" % (cString(uid), cString(versionName)))
+	print("TEST_RES_GSM:%s,%d,%s,%s,%s,%d" % (flags(gsmFlags, 3), len(rssiSamples), ",".join(str(rssi) for rssi in bytearray(rssiSamples)), cString(imei), cString(imsi), batteryVoltage))
+	print("TEST_RES_GPS:%s" % flags(gpsFlags, 3))
+	print("TEST_RES_BLE:%s,%s" % (flags(bleFlags, 3), cString(macAddress)))
+	print("TEST_RES_IMU:%s,%s" % (flags(imuFlag, 1), ",".join(str(acceleration) for acceleration in accelerations)))
+	print("TEST_RES_LED:%s" % flags(ledFlag, 1))
+	print("TEST_RES_BUT:%s" % flags(buttonFlag, 1))
+	print("TEST_RES_DF:%s" % flags(dfFlags, 2))
+	print("TEST_RES_CAL:%s" % flags(calendarFlags, 2))
+	print("TEST_RES_ADC:%d,%d,%d,%d" % (usbVoltage, batVoltage, voltageMin, voltageMax))
+
+def main(args):
+	if len(args) < 2:
+		print("Usage : python monitor_client.py <port> status|telemetry|report|trace <capture.txt>|flash <first page> <number of pages> <dump.bin>|trigger <sos|off|on|instruction> [instruction]")
+		return 1
+	import serial
+	port = serial.Serial(args[0], 115200, timeout = 0.1)
+	command = args[1]
+	if command == "status":
+		printStatus(request(port, ID_GET_STATUS))
+	elif command == "telemetry":
+		printTelemetry(request(port, ID_GET_TELEMETRY))
+	elif command == "trace" and len(args) == 3:
+		writeTrace(request(port, ID_GET_TRACE), args[2])
+	elif command == "flash" and len(args) == 5:
+		dumpFlash(request(port, ID_READ_FLASH, struct.pack("<HH", int(args[2]), int(args[3]))), args[4])
+	elif command == "report":
+		printReport(request(port, ID_GET_TEST_REPORT))
+	elif command == "trigger" and len(args) >= 3 and args[2] in TRIGGERS:
+		payload = struct.pack("<B", TRIGGERS[args[2]])
+		if args[2] == "instruction":
+			payload += " ".join(args[3:]).encode("ascii")
+		request(port, ID_TRIGGER, payload)
+	else:
+		print("Unknown command")
+		return 1
+	return 0
+
+if __name__ == "__main__":
+	sys.exit(main(sys.argv[1:]))
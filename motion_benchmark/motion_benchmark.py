@@ -0,0 +1,162 @@
+# Replays accelerometer traces through the movement detection of the Seekios and reports, for the former
+# O(n^2) detection and for each profile of tools/motion_classifier.c, the detection latency and the false wakes
+# Usage : python motion_benchmark.py [trace.csv ...] [--seed N]
+# A trace is a CSV file with the columns t_ms,x,y,z,moving : x, y and z are the BMA222 MSB registers (15.6mg per LSB),
+# moving is 1 when the Seekios is really moved. Without trace, synthetic traces are generated.
+# Keep the constants in sync with bma222_adapted.h and motion_classifier.c. The firmware default is the luggage profile (MOTION_DETECTION_PROFILE of seekios.h)
+
+import csv
+import math
+import random
+import sys
+
+MOTION_CLASSIFIER_WINDOW	= 16
+SAMPLE_PERIOD_MS			= 64	# 7.81Hz bandwidth of the BMA222
+FORMER_THRESHOLD			= 35	# %, the former MOTION_DETECTION_THRESHOLD
+
+# name : (maxStableVariance, nbMovingSamples)
+PROFILES = [
+	("pet", 3, 2),
+	("luggage", 4, 24),
+	("vehicle", 6, 24),
+]
+
+# Former isSeekiosInMovementFromAccelerations : an axis is stable when enough samples are within 1 LSB of one sample
+class FormerDetection:
+	def __init__(self):
+		self.window = []
+
+	def addSample(self, sample):
+		self.window.append(sample)
+		if len(self.window) > MOTION_CLASSIFIER_WINDOW:
+			self.window.pop(0)
+		if len(self.window) < MOTION_CLASSIFIER_WINDOW:
+			return False
+		nbSimilarValues = MOTION_CLASSIFIER_WINDOW * FORMER_THRESHOLD // 100
+		for axis in range(3):
+			values = [s[axis] for s in self.window]
+			if not any(sum(1 for w in values if abs(v - w) <= 1) >= nbSimilarValues for v in values):
+				return True
+		return False
+
+# Same computation as motion_classifier.c : variance of the window multiplied by MOTION_CLASSIFIER_WINDOW^2
+class MotionClassifier:
+	def __init__(self, maxStableVariance, nbMovingSamplesRequired):
+		self.maxStableVariance = maxStableVariance
+		self.nbMovingSamplesRequired = nbMovingSamplesRequired
+		self.window = []
+		self.sums = [0, 0, 0]
+		self.squareSums = [0, 0, 0]
+		self.nbMovingSamples = 0
+
+	def addSample(self, sample):
+		if len(self.window) == MOTION_CLASSIFIER_WINDOW:
+			oldest = self.window.pop(0)
+			for axis in range(3):
+				self.sums[axis] -= oldest[axis]
+				self.squareSums[axis] -= oldest[axis] * oldest[axis]
+		self.window.append(sample)
+		for axis in range(3):
+			self.sums[axis] += sample[axis]
+			self.squareSums[axis] += sample[axis] * sample[axis]
+		if len(self.window) < MOTION_CLASSIFIER_WINDOW:
+			return False
+		limit = self.maxStableVariance * MOTION_CLASSIFIER_WINDOW * MOTION_CLASSIFIER_WINDOW
+		moving = any(MOTION_CLASSIFIER_WINDOW * self.squareSums[axis] - self.sums[axis] * self.sums[axis] > limit for axis in range(3))
+		self.nbMovingSamples = self.nbMovingSamples + 1 if moving else 0
+		return self.nbMovingSamples >= self.nbMovingSamplesRequired
+
+def clamp(value):
+	return max(-128, min(127, int(round(value))))
+
+# Synthetic trace made of labelled episodes : (duration in s, moving, generator of the acceleration in LSB at t)
+def buildSyntheticTrace(rng):
+	gravity = (0.0, 3.0, 64.0)
+	def rest(t):
+		return (0.0, 0.0, 0.0)
+	def parkedVehicle(t):
+		return (1.2 * math.sin(2 * math.pi * 3.1 * t), 0.8 * math.sin(2 * math.pi * 2.3 * t), 1.5 * math.sin(2 * math.pi * 4.7 * t))
+	def knock(t):
+		return (25.0, -10.0, 12.0) if t < 0.13 else (0.0, 0.0, 0.0)
+	def petWalking(t):
+		return (3.0 * math.sin(2 * math.pi * 1.6 * t), 2.0 * math.sin(2 * math.pi * 0.8 * t), 4.0 * math.sin(2 * math.pi * 1.6 * t + 1))
+	def petRolling(t):
+		return (2.5 * math.sin(2 * math.pi * 0.4 * t), 2.5 * math.cos(2 * math.pi * 0.4 * t), 1.0)
+	def luggageCarried(t):
+		return (8.0 * math.sin(2 * math.pi * 1.9 * t), 6.0 * math.sin(2 * math.pi * 0.95 * t), 10.0 * math.sin(2 * math.pi * 1.9 * t + 0.5))
+	def vehicleDriving(t):
+		return (6.0 * math.sin(2 * math.pi * 0.2 * t) + 4.0 * math.sin(2 * math.pi * 5.3 * t), 4.0 * math.sin(2 * math.pi * 0.13 * t), 5.0 * math.sin(2 * math.pi * 6.1 * t))
+	episodes = [
+		(60, False, rest), (20, True, petWalking), (60, False, rest), (10, False, knock), (30, False, rest),
+		(120, False, parkedVehicle), (30, True, luggageCarried), (60, False, rest), (40, True, petRolling),
+		(60, False, rest), (10, False, knock), (60, False, parkedVehicle), (90, True, vehicleDriving), (60, False, rest),
+	]
+	trace = []
+	t = 0.0
+	for duration, moving, generator in episodes:
+		start = t
+		while t < start + duration:
+			acceleration = generator(t - start)
+			sample = tuple(clamp(gravity[axis] + acceleration[axis] + rng.gauss(0.0, 0.45)) for axis in range(3))
+			trace.append((int(t * 1000), sample, moving))
+			t += SAMPLE_PERIOD_MS / 1000.0
+	return trace
+
+def loadTrace(path):
+	trace = []
+	with open(path) as f:
+		for row in csv.DictReader(f):
+			trace.append((int(row["t_ms"]), (int(row["x"]), int(row["y"]), int(row["z"])), row["moving"].strip() == "1"))
+	return trace
+
+# The detection restarts after each wake, as a new significant move detection of the firmware
+def replay(trace, buildDetection):
+	detection = buildDetection()
+	latencies = []
+	missedEpisodes = 0
+	falseWakes = 0
+	stationaryTime = 0
+	episodeStart = None
+	episodeDetected = False
+	operations = 0
+	for index, (timeMs, sample, moving) in enumerate(trace):
+		if index > 0 and not trace[index - 1][2]:
+			stationaryTime += timeMs - trace[index - 1][0]
+		if moving and episodeStart is None:
+			episodeStart = timeMs
+			episodeDetected = False
+		elif not moving and episodeStart is not None:
+			missedEpisodes += 0 if episodeDetected else 1
+			episodeStart = None
+		if detection.addSample(sample):
+			if moving and not episodeDetected:
+				latencies.append(timeMs - episodeStart)
+				episodeDetected = True
+			elif not moving:
+				falseWakes += 1
+			detection = buildDetection()
+	if episodeStart is not None and not episodeDetected:
+		missedEpisodes += 1
+	return latencies, missedEpisodes, falseWakes, stationaryTime
+
+def printResults(name, results):
+	latencies, missedEpisodes, falseWakes, stationaryTime = results
+	averageLatency = "%8.2f" % (sum(latencies) / len(latencies) / 1000.0) if latencies else "       -"
+	worstLatency = "%8.2f" % (max(latencies) / 1000.0) if latencies else "       -"
+	falseWakeRate = falseWakes * 3600000.0 / stationaryTime if stationaryTime else 0.0
+	print("%-10s | %8d | %6d | %s s | %s s | %6d | %10.1f" % (name, len(latencies), missedEpisodes, averageLatency, worstLatency, falseWakes, falseWakeRate))
+
+def main(args):
+	seed = int(args[args.index("--seed") + 1]) if "--seed" in args else 1
+	paths = [a for i, a in enumerate(args) if not a.startswith("--") and (i == 0 or args[i - 1] != "--seed")]
+	traces = [(path, loadTrace(path)) for path in paths] if paths else [("synthetic", buildSyntheticTrace(random.Random(seed)))]
+	for traceName, trace in traces:
+		print("Trace %s : %d samples" % (traceName, len(trace)))
+		print("Detection  | detected | missed | average latency | worst latency | false wakes | per hour at rest")
+		printResults("former", replay(trace, FormerDetection))
+		for name, maxStableVariance, nbMovingSamples in PROFILES:
+			printResults(name, replay(trace, lambda: MotionClassifier(maxStableVariance, nbMovingSamples)))
+	return 0
+
+if __name__ == "__main__":
+	sys.exit(main(sys.argv[1:]))
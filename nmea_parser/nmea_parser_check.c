@@ -0,0 +1,553 @@
+/*
+ * nmea_parser_check.c
+ *
+ * Content : host check of the in-place NMEA parser of peripheralManager/GPS_manager.c against the former strtok_single
+ * + strtod parser. The real sgs/serial_sgs.c, peripheralManager/GPS_manager.c and tools/string_helper.c are built in this file :
+ *   gcc -O2 -D_GNU_SOURCE -I../dma_reception/stubs -I../tracker2 -I../tracker2/sgs -o nmea_parser_check nmea_parser_check.c -lm
+ * Usage : ./nmea_parser_check [transcript] [--passes n]
+ *
+ * The transcript has the format of replay_harness/uart_replay.py, only its GPS lines are used : a recording of a Seekios
+ * can be given directly. nmea_corpus.txt is used by default.
+ * Each GXGGA + GXRMC pair of the transcript goes through both reception and parsing paths :
+ *   former : the frame recorded without checksum, checked with validateChecksum then parsed by strtok_single + strtod
+ *   current : the bytes injected in the reception path (checksum computed on the fly), then parsed in place
+ * The check asserts that the same frames are accepted and parsed, with the same fix quality and satellites number, and the
+ * same coordinates, altitude, hDOP, speed and track angle as written by the firmware (stringHelper_toFixedPoint, with
+ * COORDINATE_DECIMALS for the coordinates, 2 decimals for the rest). The largest raw differences are reported.
+ * Then the throughput of both parsers is measured on the accepted frames.
+ * Returns 1 if a check fails.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+/* The firmware headers that need the ASF are skipped : their guards are defined, the declarations used by the files follow */
+#define MAIN_H_
+#define HELPER_SGS_H_
+#define PORT_SGS_H_
+#define _STDIO_IO_H_INCLUDED
+#define UART_REPLAY_H_
+#define TRACE_H_
+#define DEBUG_LOG_H_
+#define GLOBAL_VAR_H_
+#define USB_MANAGER_H_
+#define UTILS_H_
+#define MASK_UTILITIES_H_
+#define RTC_MANAGER_H_
+#define TRNG_MANAGER_H_
+#define TEST_MONITOR_H_
+#define GPS_POWER_POLICY_H_
+#define ENERGY_PROFILER_H_
+
+#define UNUSED(x)						(void)(x)
+#define FUNCTION_SUCCESS				1
+#define FUNCTION_FAILURE				0
+#define FAKE_POSITIONS_ACTIVATED		0
+#define ACTIVATE_NMEA_FRAME_PRINT		0
+#define ACTIVATE_WRONG_NMEA_FRAME_LOGS	0
+#define ACTIVATE_GPS_LOGS				0
+#define UART_DMA_RX_ACTIVATED			0
+#define UART_REPLAY_ACTIVATED			0
+#define TRACE_ACTIVATED					0
+#define ENERGY_PROFILER_ACTIVATED		0
+#define LOG_COMPILED_LEVEL				0
+#define LOG_LEVEL_INFO					3
+#define LOG_SINK_USB					1
+#define LOG_DEBUG(module, text)
+#define LOG_INFO(module, text)
+
+struct io_descriptor;
+struct usart_async_descriptor { int unused; };
+struct calendar_alarm { struct { uint32_t timestamp; } data; };
+typedef void (*alarm_cb_t)(void);
+
+bool seekiosManagerStarted = true;
+static struct usart_async_descriptor SER1_GPS, SER2_GSM;
+static int SER3_DEBUG, SER5_SPI_IMU_FLASH;
+#define USART_ASYNC_TXC_CB		0
+#define USART_ASYNC_RXC_CB		1
+#define GPS_power_enable		0
+
+static int32_t io_write(struct io_descriptor *io, const uint8_t *buf, uint16_t length) { UNUSED(io); UNUSED(buf); return length; }
+static int32_t io_read(struct io_descriptor *io, uint8_t *buf, uint16_t length) { UNUSED(io); UNUSED(buf); UNUSED(length); return 0; }
+static void delay_ms(uint16_t ms) { UNUSED(ms); }
+static void usart_async_register_callback(struct usart_async_descriptor *descr, int type, void (*cb)(const struct usart_async_descriptor *const)) { UNUSED(descr); UNUSED(type); UNUSED(cb); }
+static void usart_async_get_io_descriptor(struct usart_async_descriptor *descr, struct io_descriptor **io) { UNUSED(descr); UNUSED(io); }
+static void usart_async_enable(struct usart_async_descriptor *descr) { UNUSED(descr); }
+static void usart_sync_get_io_descriptor(int *descr, struct io_descriptor **io) { UNUSED(descr); UNUSED(io); }
+static void usart_sync_enable(int *descr) { UNUSED(descr); }
+static void spi_m_sync_get_io_descriptor(int *descr, struct io_descriptor **io) { UNUSED(descr); UNUSED(io); }
+static void spi_m_sync_enable(int *descr) { UNUSED(descr); }
+static bool gpio_get_pin_level(int pin) { UNUSED(pin); return false; }
+static void gpio_set_pin_level(int pin, bool level) { UNUSED(pin); UNUSED(level); }
+static void send_gps(const char *text) { UNUSED(text); }
+
+/* Firmware services called around the parser, not checked here */
+#define RUNNING_BIT_GPS_MANAGER			0
+#define REQUEST_BIT_GPS_EXPIRED			0
+#define EVENT_GPS_EXPIRATION_ALARM_OFF	0
+#define EVENT_GPS_STATE_OFF				0
+static void maskUtilities_setRunningMaskBits(uint32_t bits) { UNUSED(bits); }
+static void maskUtilities_clearRunningMaskBits(uint32_t bits) { UNUSED(bits); }
+static void maskUtilities_setRequestMaskBitsFromISR(uint32_t bits) { UNUSED(bits); }
+static void testMonitor_raiseEvent(int event) { UNUSED(event); }
+static bool RTCManager_isAlarmScheduled(struct calendar_alarm *alarm) { UNUSED(alarm); return false; }
+static bool RTCManager_removeAlarm(struct calendar_alarm *alarm) { UNUSED(alarm); return false; }
+static void RTCManager_setDelayedCallbackInWindow(uint32_t delay, uint32_t window, struct calendar_alarm *alarm, alarm_cb_t callback) { UNUSED(delay); UNUSED(window); UNUSED(alarm); UNUSED(callback); }
+static void RTCManager_printTimeFromTimestamp(uint32_t timestamp) { UNUSED(timestamp); }
+static void GPSPowerPolicy_init(void) {}
+static void GPSPowerPolicy_startSession(bool isHotStart) { UNUSED(isHotStart); }
+static void GPSPowerPolicy_endSession(void) {}
+static bool GPSPowerPolicy_shouldStandby(void) { return false; }
+static void GPSPowerPolicy_recordFix(uint8_t satellitesNumber) { UNUSED(satellitesNumber); }
+static bool maskUtilities_isGpsRequested(void) { return true; }
+
+#include <FreeRTOS.h>
+#include <serial_sgs.h>
+#include <peripheralManager/USART_manager.h>
+#include <peripheralManager/GPS_manager.h>
+
+#include "../tracker2/tools/string_helper.c"
+#include "../tracker2/sgs/serial_sgs.c"
+#include "../tracker2/peripheralManager/GPS_manager.c"
+
+/* Event group of the GPS manager, created by GPSManager_init */
+static EventBits_t _gpsBits;
+
+EventGroupHandle_t xEventGroupCreate(void) { return &_gpsBits; }
+EventBits_t xEventGroupClearBits(EventGroupHandle_t eventGroup, EventBits_t bitsToClear) { *(EventBits_t*)eventGroup &= ~bitsToClear; return *(EventBits_t*)eventGroup; }
+EventBits_t xEventGroupSetBits(EventGroupHandle_t eventGroup, EventBits_t bitsToSet) { *(EventBits_t*)eventGroup |= bitsToSet; return *(EventBits_t*)eventGroup; }
+BaseType_t xEventGroupSetBitsFromISR(EventGroupHandle_t eventGroup, EventBits_t bitsToSet, BaseType_t* higherPriorityTaskWokenPtr) { UNUSED(higherPriorityTaskWokenPtr); xEventGroupSetBits(eventGroup, bitsToSet); return pdTRUE; }
+EventBits_t xEventGroupGetBits(EventGroupHandle_t eventGroup) { return *(EventBits_t*)eventGroup; }
+EventBits_t xEventGroupGetBitsFromISR(EventGroupHandle_t eventGroup) { return *(EventBits_t*)eventGroup; }
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t eventGroup, EventBits_t bitsToWaitFor, BaseType_t clearOnExit, BaseType_t waitForAllBits, TickType_t ticksToWait) { UNUSED(bitsToWaitFor); UNUSED(clearOnExit); UNUSED(waitForAllBits); UNUSED(ticksToWait); return *(EventBits_t*)eventGroup; }
+TickType_t xTaskGetTickCount(void) { return 0; }
+void vTaskDelay(TickType_t ticksToDelay) { UNUSED(ticksToDelay); }
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) { UNUSED(task); return 0; }
+void USARTManager_printUsbWait(const char* string) { UNUSED(string); }
+void USARTManager_printByte(const uint8_t byte) { UNUSED(byte); }
+void USARTManager_printUsbWaitN(const char* text, uint16_t length) { UNUSED(text); UNUSED(length); }
+void USARTManager_gsmUsartMaskSetBitsFromISR(EventBits_t bitsToSet) { UNUSED(bitsToSet); }
+void USARTManager_parseGsmBytesFromISR(const uint8_t* data, uint16_t length) { UNUSED(data); UNUSED(length); }
+
+/* Former parser : the frame is checked once recorded, then cut in tokens by strtok_single and decoded with strtod */
+static uint8_t formerGetStarIndex(char* nmea,uint8_t nmeaIndex)
+{
+	uint8_t nmeaLength = strlen(nmea);
+	uint8_t starCounter=0;
+	
+	for(uint8_t i=0;i< nmeaLength - 2; i++)
+	{
+		if(nmea[i] == '*')
+		{
+			if (starCounter==nmeaIndex)
+			{
+				return i;
+			}
+			starCounter++;
+		}
+	}
+	return 0;
+}
+
+static int formerComputeChecksumFromNMEA(char *sentence,uint8_t nmeaIndex)
+{
+	uint8_t i;
+	uint8_t XOR;
+	uint8_t c;
+	uint8_t starCounter=0;
+	bool dollar=true;
+	
+	for (XOR = 0, i = 0; i < strlen(sentence); i++)
+	{
+		c = (unsigned char)sentence[i];
+		if (c == '$')
+		{
+			dollar=true;
+		}
+		if (c == '*')
+		{
+			dollar=false;
+			if (starCounter==nmeaIndex)
+			{
+				break;
+			}
+			else
+			{
+				starCounter++;
+				XOR=0;
+			}
+		}
+		if (c != '$' && dollar) XOR ^= c;
+	}
+	return XOR;
+}
+
+static int formerValidateChecksum( char * nmea, uint8_t numberOfNMEA)
+{
+	uint8_t nmeaIndex=0;
+	while (nmeaIndex<numberOfNMEA)
+	{
+		uint8_t computedCheckSum = formerComputeChecksumFromNMEA(nmea,nmeaIndex);
+		uint8_t starIndex = formerGetStarIndex(nmea,nmeaIndex);
+		if(starIndex == 0)
+		{
+			return false;
+		}
+		char gotSum[3];
+		gotSum[0] = nmea[starIndex + 1];
+		gotSum[1] = nmea[starIndex + 2];
+		gotSum[2] = '\0';
+		int givenChecksum = (int)strtol(gotSum, NULL, 16);
+		if(givenChecksum != computedCheckSum)
+		{
+			return false;
+		}
+		nmeaIndex++;
+	}
+	return true;
+}
+
+static double formerConvertNMEA(char * param, char * orientation)
+{
+	double f = strtod(param,NULL);
+	double deg, min, sec, res;
+
+	deg = (int)(f / 100.0);
+	min = (int)(f - deg*100.0);
+	sec = 60.0*(f - deg*100.0 - min);
+
+	res = deg + min / 60 + sec / 3600;
+
+	if (strlen(orientation) > 0 && (orientation[0] == 'S' || orientation[0] == 'W'))
+	{
+		res = res*-1;
+	}
+	return res;
+}
+
+static int formerParseSentence(char *sentenceBuffer, SatelliteCoordinate *currentlocationPtr)
+{
+	int paramTokenCounter=0;
+	char *token=NULL;
+	char orientationLatLong[4];
+	char tempLatLongAlt[16];
+
+	currentlocationPtr->coordinate.lat=90;
+	currentlocationPtr->coordinate.lon=180;
+
+	for (token = strtok_single(sentenceBuffer, ","); token != NULL; token = strtok_single(NULL, ","))
+	{
+		switch (paramTokenCounter)
+		{
+			case 2:
+			if(token[0]==0){return FUNCTION_FAILURE;}
+			strcpy(tempLatLongAlt,token);
+			break;
+			case 3:
+			if(token[0]==0){return FUNCTION_FAILURE;}
+			strcpy(orientationLatLong,token);
+			currentlocationPtr->coordinate.lat=formerConvertNMEA(tempLatLongAlt,orientationLatLong);
+			break;
+			case 4:
+			if(token[0]==0){return FUNCTION_FAILURE;}
+			strcpy(tempLatLongAlt,token);
+			break;
+			case 5:
+			if(token[0]==0){return FUNCTION_FAILURE;}
+			strcpy(orientationLatLong,token);
+			currentlocationPtr->coordinate.lon=formerConvertNMEA(tempLatLongAlt,orientationLatLong);
+			break;
+			case 6:
+			if (atoi(token) != FIX_QUALITY_GPS
+			&& atoi(token) != FIX_QUALITY_DGPS)
+			{
+				return FUNCTION_FAILURE;
+			}
+			currentlocationPtr->fixQuality = atoi(token);
+			break;
+			case 7:
+			if(token[0]==0){return FUNCTION_FAILURE;}
+			currentlocationPtr->satellitesNumber=atoi(token);
+			break;
+			case 8:
+			if(token[0]==0){return FUNCTION_FAILURE;}
+			currentlocationPtr->hDOP=strtod(token,NULL);
+			break;
+			case 9:
+			strcpy(tempLatLongAlt,token);
+			break;
+			case 10:
+			if (token[0]=='M'){
+				currentlocationPtr->coordinate.alt=strtod(tempLatLongAlt,NULL);
+			}
+			break;
+			case 21:
+			currentlocationPtr->speed=strtod(token,NULL);
+			currentlocationPtr->speed*=1.852;//noeuds->km/h
+			break;
+			case 22:
+			currentlocationPtr->trackAngle=strtod(token,NULL);
+			break;
+			default:break;
+		}
+		paramTokenCounter++;
+	}
+	
+	if (currentlocationPtr->coordinate.lon>-180 && currentlocationPtr->coordinate.lon<180
+	&& currentlocationPtr->coordinate.lat>-90 && currentlocationPtr->coordinate.lat<90)
+	{
+		return FUNCTION_SUCCESS;
+	}
+	else return FUNCTION_FAILURE;
+}
+
+#define MAX_NB_FRAMES		4096
+#define BENCHMARK_PASSES	200
+
+static uint32_t _nbChecks;
+static uint32_t _nbFailures;
+
+#define CHECK(condition, ...) do { _nbChecks++; if(!(condition)) { if(_nbFailures++ < 20) { printf("FAILED line %d : ", frame->line); printf(__VA_ARGS__); printf("\n"); } } } while(0)
+
+/* A GXGGA + GXRMC pair of the transcript, with the lines received between them */
+typedef struct {
+	char recorded[GPS_BUF_SIZE];	// GGA then RMC, as recorded in gps_buf
+	char* received;					// every line from the GGA to the RMC
+	uint32_t line;
+	bool isAccepted;
+} Frame;
+
+typedef struct {
+	double lat;
+	double lon;
+	double alt;
+	double hDOP;
+	double speed;
+	double trackAngle;
+} Differences;
+
+static Frame _frames[MAX_NB_FRAMES];
+static uint32_t _nbFrames;
+
+static bool isSentence(const char* line, const char* gpsType, const char* gnssType)
+{
+	return strncmp(line, gpsType, 6) == 0 || strncmp(line, gnssType, 6) == 0;
+}
+
+/* Pairs each GXGGA with the next GXRMC. A GGA without RMC is dropped, as the receiver would have lost it */
+static bool readTranscript(const char* path)
+{
+	FILE* transcript = fopen(path, "r");
+	if(transcript == NULL)
+	{
+		printf("Cannot open %s\n", path);
+		return false;
+	}
+	char line[512];
+	char received[4096];
+	uint32_t lineNumber = 0;
+	uint32_t ggaLine = 0;
+	bool ggaFound = false;
+	while(fgets(line, sizeof(line), transcript) != NULL && _nbFrames < MAX_NB_FRAMES)
+	{
+		lineNumber++;
+		line[strcspn(line, "\r\n")] = '\0';
+		char* sentence = strstr(line, " GPS ");
+		if(line[0] == '#' || sentence == NULL)
+		{
+			continue;
+		}
+		sentence += 5;
+		if(isSentence(sentence, "$GPGGA", "$GNGGA"))
+		{
+			ggaFound = true;
+			ggaLine = lineNumber;
+			received[0] = '\0';
+		}
+		if(!ggaFound || strlen(received) + strlen(sentence) + 3 > sizeof(received))
+		{
+			ggaFound = false;
+			continue;
+		}
+		strcat(received, sentence);
+		strcat(received, "\r\n");
+		if(isSentence(sentence, "$GPRMC", "$GNRMC"))
+		{
+			Frame* frame = &_frames[_nbFrames++];
+			const char* rmc = strstr(received, "\r\n") + 2;
+			while(!isSentence(rmc, "$GPRMC", "$GNRMC")) rmc = strstr(rmc, "\r\n") + 2;
+			snprintf(frame->recorded, sizeof(frame->recorded), "%.*s%s", (int)(strstr(received, "\r\n") + 2 - received), received, rmc);
+			frame->received = strdup(received);
+			frame->line = ggaLine;
+			ggaFound = false;
+		}
+	}
+	fclose(transcript);
+	return true;
+}
+
+static void updateDifference(double* maxDifferencePtr, double former, double current)
+{
+	double difference = fabs(former - current);
+	if(difference > *maxDifferencePtr) *maxDifferencePtr = difference;
+}
+
+static void checkFrame(Frame* frame, Differences* differencesPtr)
+{
+	char former[GPS_BUF_SIZE];
+	strcpy(former, frame->recorded);
+	bool isFormerAccepted = formerValidateChecksum(former, GPS_NMEA_NUMBER);
+
+	xEventGroupClearBits(_gpsMaskhandle, GPS_BIT_NMEA_AVAILABLE);
+	receiveGpsBytes((const uint8_t*)frame->received, strlen(frame->received));
+	frame->isAccepted = (xEventGroupGetBits(_gpsMaskhandle) & GPS_BIT_NMEA_AVAILABLE) != 0;
+	CHECK(frame->isAccepted == isFormerAccepted, "frame %s by the reception, %s by validateChecksum", frame->isAccepted ? "accepted" : "dropped", isFormerAccepted ? "accepted" : "dropped");
+	if(!frame->isAccepted || !isFormerAccepted)
+	{
+		return;
+	}
+	CHECK(strcmp((const char*)gps_buf, frame->recorded) == 0, "gps_buf \"%s\"", (const char*)gps_buf);
+
+	SatelliteCoordinate formerResult, currentResult;
+	memset(&formerResult, 0, sizeof(formerResult));
+	memset(&currentResult, 0, sizeof(currentResult));
+	int formerStatus = formerParseSentence(former, &formerResult);
+	int currentStatus = parse_sentence((char*)gps_buf, &currentResult);
+	CHECK(formerStatus == currentStatus, "parse_sentence returns %d instead of %d", currentStatus, formerStatus);
+	if(formerStatus != FUNCTION_SUCCESS || currentStatus != FUNCTION_SUCCESS)
+	{
+		return;
+	}
+	CHECK(formerResult.fixQuality == currentResult.fixQuality, "fix quality %d instead of %d", currentResult.fixQuality, formerResult.fixQuality);
+	CHECK(formerResult.satellitesNumber == currentResult.satellitesNumber, "%d satellites instead of %d", currentResult.satellitesNumber, formerResult.satellitesNumber);
+
+	/* As written in the messages */
+	CHECK(stringHelper_toFixedPoint(formerResult.coordinate.lat, COORDINATE_DECIMALS) == stringHelper_toFixedPoint(currentResult.coordinate.lat, COORDINATE_DECIMALS),
+		"lat %.9f instead of %.9f", currentResult.coordinate.lat, formerResult.coordinate.lat);
+	CHECK(stringHelper_toFixedPoint(formerResult.coordinate.lon, COORDINATE_DECIMALS) == stringHelper_toFixedPoint(currentResult.coordinate.lon, COORDINATE_DECIMALS),
+		"lon %.9f instead of %.9f", currentResult.coordinate.lon, formerResult.coordinate.lon);
+	CHECK(stringHelper_toFixedPoint(formerResult.coordinate.alt, 2) == stringHelper_toFixedPoint(currentResult.coordinate.alt, 2),
+		"alt %.4f instead of %.4f", currentResult.coordinate.alt, formerResult.coordinate.alt);
+	CHECK(stringHelper_toFixedPoint(formerResult.hDOP, 2) == stringHelper_toFixedPoint(currentResult.hDOP, 2),
+		"hDOP %.4f instead of %.4f", currentResult.hDOP, formerResult.hDOP);
+	CHECK(stringHelper_toFixedPoint(formerResult.speed, 2) == stringHelper_toFixedPoint(currentResult.speed, 2),
+		"speed %.4f instead of %.4f", currentResult.speed, formerResult.speed);
+	CHECK(stringHelper_toFixedPoint(formerResult.trackAngle, 2) == stringHelper_toFixedPoint(currentResult.trackAngle, 2),
+		"track angle %.4f instead of %.4f", currentResult.trackAngle, formerResult.trackAngle);
+
+	updateDifference(&differencesPtr->lat, formerResult.coordinate.lat, currentResult.coordinate.lat);
+	updateDifference(&differencesPtr->lon, formerResult.coordinate.lon, currentResult.coordinate.lon);
+	updateDifference(&differencesPtr->alt, formerResult.coordinate.alt, currentResult.coordinate.alt);
+	updateDifference(&differencesPtr->hDOP, formerResult.hDOP, currentResult.hDOP);
+	updateDifference(&differencesPtr->speed, formerResult.speed, currentResult.speed);
+	updateDifference(&differencesPtr->trackAngle, formerResult.trackAngle, currentResult.trackAngle);
+}
+
+static double getTime(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+/* Returns the time per accepted frame, in ns. The former parser cuts the frame, so both parse a copy */
+static double benchmarkParsers(bool isCurrent, uint32_t nbPasses, uint32_t* nbParsedFramesPtr)
+{
+	char buff[GPS_BUF_SIZE];
+	SatelliteCoordinate result;
+	volatile int sink = 0;
+	uint32_t nbParsedFrames = 0;
+	double start = getTime();
+	for(uint32_t pass = 0; pass < nbPasses; pass++)
+	{
+		for(uint32_t i = 0; i < _nbFrames; i++)
+		{
+			if(!_frames[i].isAccepted) continue;
+			strcpy(buff, _frames[i].recorded);
+			sink += isCurrent ? parse_sentence(buff, &result) : formerParseSentence(buff, &result);
+			nbParsedFrames++;
+		}
+	}
+	(void)sink;
+	*nbParsedFramesPtr = nbParsedFrames;
+	return nbParsedFrames > 0 ? (getTime() - start) * 1e9 / nbParsedFrames : 0;
+}
+
+/* Checksums : validateChecksum on the recorded frame against GPSManager_updateNMEAChecksum on each received char */
+static double benchmarkChecksums(bool isCurrent, uint32_t nbPasses)
+{
+	char buff[GPS_BUF_SIZE];
+	NMEAChecksum checksum;
+	volatile int sink = 0;
+	uint32_t nbFrames = 0;
+	double start = getTime();
+	for(uint32_t pass = 0; pass < nbPasses; pass++)
+	{
+		for(uint32_t i = 0; i < _nbFrames; i++)
+		{
+			if(!_frames[i].isAccepted) continue;
+			if(isCurrent)
+			{
+				GPSManager_initNMEAChecksum(&checksum);
+				for(const char* c = _frames[i].recorded; *c != '\0'; c++)
+				{
+					sink += GPSManager_updateNMEAChecksum(&checksum, *c);
+				}
+			}
+			else
+			{
+				strcpy(buff, _frames[i].recorded);
+				sink += formerValidateChecksum(buff, GPS_NMEA_NUMBER);
+			}
+			nbFrames++;
+		}
+	}
+	(void)sink;
+	return nbFrames > 0 ? (getTime() - start) * 1e9 / nbFrames : 0;
+}
+
+int main(int argc, char* argv[])
+{
+	const char* path = "nmea_corpus.txt";
+	uint32_t nbPasses = BENCHMARK_PASSES;
+	for(int i = 1; i < argc; i++)
+	{
+		if(strcmp(argv[i], "--passes") == 0 && i + 1 < argc) nbPasses = atoi(argv[++i]);
+		else path = argv[i];
+	}
+	if(!readTranscript(path))
+	{
+		return 1;
+	}
+
+	GPSManager_init();
+	Differences differences;
+	memset(&differences, 0, sizeof(differences));
+	uint32_t nbAccepted = 0;
+	for(uint32_t i = 0; i < _nbFrames; i++)
+	{
+		checkFrame(&_frames[i], &differences);
+		nbAccepted += _frames[i].isAccepted;
+	}
+	printf("%s : %u GGA + RMC frames, %u accepted\n", path, _nbFrames, nbAccepted);
+	printf("Largest differences with the former parser : lat %.2e deg, lon %.2e deg, alt %.2e m, hDOP %.2e, speed %.2e km/h, track angle %.2e deg\n",
+		differences.lat, differences.lon, differences.alt, differences.hDOP, differences.speed, differences.trackAngle);
+
+	uint32_t nbParsedFrames;
+	double formerParseTime = benchmarkParsers(false, nbPasses, &nbParsedFrames);
+	double currentParseTime = benchmarkParsers(true, nbPasses, &nbParsedFrames);
+	printf("\nBenchmark, %u frames parsed\n", nbParsedFrames);
+	printf("    former parse_sentence   : %7.1f ns/frame, %9.0f frames/s\n", formerParseTime, formerParseTime > 0 ? 1e9 / formerParseTime : 0);
+	printf("    current parse_sentence  : %7.1f ns/frame, %9.0f frames/s\n", currentParseTime, currentParseTime > 0 ? 1e9 / currentParseTime : 0);
+	printf("    former validateChecksum : %7.1f ns/frame\n", benchmarkChecksums(false, nbPasses));
+	printf("    checksum on reception   : %7.1f ns/frame\n", benchmarkChecksums(true, nbPasses));
+
+	printf("\n%u checks, %u failed\n", _nbChecks, _nbFailures);
+	return _nbFailures == 0 ? 0 : 1;
+}
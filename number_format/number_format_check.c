@@ -0,0 +1,176 @@
+/*
+ * number_format_check.c
+ *
+ * Content : host check and benchmark of stringHelper_fixedPointToString against the former stringHelper_doubleToString.
+ * Both are built from tracker2/tools/string_helper.c :
+ *   gcc -O2 -D_GNU_SOURCE -I../tracker2 -o number_format_check number_format_check.c ../tracker2/tools/string_helper.c -lm
+ * Usage : ./number_format_check [--full]
+ *
+ * For each range, every fixed-point value is written by stringHelper_fixedPointToString and compared with the exact decimal
+ * string, then with stringHelper_doubleToString of the same value as a double. The lat and lon ranges are walked with a
+ * stride, plus every value around 0, the powers of ten, the poles and the antimeridian, --full walks every
+ * 1/10^7 degree (about 45 minutes). Returns 1 if stringHelper_fixedPointToString or stringHelper_toFixedPoint is wrong once.
+ * The differences of stringHelper_doubleToString are only counted : it truncates, so a double just under the value loses
+ * its last digit, and it writes a wrong digit for the values from 10 and the powers of ten (see getCountOfNumBeforeDecimalPoint).
+ * The benchmark runs on the host FPU : on the Cortex-M0+, where floor and exp10 are software routines, the gap is larger.
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <tools/string_helper.h>
+
+#define COORDINATE_DECIMALS		7	// keep in sync with GPS_manager.h
+#define COORDINATE_STRIDE		9973
+#define EXHAUSTIVE_ZONE_SIZE	200000
+#define NB_EXAMPLES				3
+#define BENCHMARK_ROUNDS		2000000
+
+typedef struct {
+	const char* name;
+	int32_t min;
+	int32_t max;
+	uint8_t nbDecimal;
+	const int32_t* zones;	// centers of the exhaustive zones when walked with a stride
+	uint8_t nbZones;
+} Range;
+
+typedef struct {
+	uint32_t nbValues;
+	uint32_t nbWrong;			// stringHelper_fixedPointToString or stringHelper_toFixedPoint
+	uint32_t nbSame;
+	uint32_t nbTruncated;		// stringHelper_doubleToString is one unit under
+	uint32_t nbOtherDifferences;
+	uint8_t nbExamples;
+} Result;
+
+static const int32_t _latitudeZones[] = {0, 1000000, -1000000, 10000000, -10000000, 100000000, -100000000, 900000000, -900000000};
+static const int32_t _longitudeZones[] = {0, 1000000, -1000000, 10000000, -10000000, 100000000, -100000000, 1000000000, -1000000000, 1800000000, -1800000000};
+
+static const Range _ranges[] = {
+	{"lat (1e-7 deg)", -900000000, 900000000, COORDINATE_DECIMALS, _latitudeZones, 9},
+	{"lon (1e-7 deg)", -1800000000, 1800000000, COORDINATE_DECIMALS, _longitudeZones, 11},
+	{"alt (cm)", -100000, 2000000, 2, NULL, 0},
+	{"hDOP (1/100)", 0, 9999, 2, NULL, 0},
+	{"hDOP GPS logs (1/10)", 0, 999, 1, NULL, 0},
+	{"speed (1/100)", 0, 50000, 2, NULL, 0},
+	{"zone distance (cm)", 0, 10000000, 2, NULL, 0},
+};
+
+static const uint32_t _powersOfTen[10] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
+
+/* Exact decimal string, with the C library */
+static void writeReference(int32_t val, uint8_t nbDecimal, char* buff, size_t buffSize){
+	uint32_t magnitude = val < 0 ? 0 - (uint32_t)val : (uint32_t)val;
+	const char* sign = val < 0 ? "-" : "";
+	if(nbDecimal == 0) snprintf(buff, buffSize, "%s%" PRIu32, sign, magnitude);
+	else snprintf(buff, buffSize, "%s%" PRIu32 ".%0*" PRIu32, sign, magnitude / _powersOfTen[nbDecimal], (int)nbDecimal % 10, magnitude % _powersOfTen[nbDecimal]);
+}
+
+/* Value of a decimal string in 1/10^nbDecimal units, INT64_MIN if a character is not a digit */
+static int64_t parseFixedPoint(const char* string, uint8_t nbDecimal){
+	int64_t value = 0;
+	int8_t nbDecimalRead = -1;
+	const char* p = string[0] == '-' ? string + 1 : string;
+	for(; *p != '\0'; p++)
+	{
+		if(*p == '.' && nbDecimalRead < 0) { nbDecimalRead = 0; continue; }
+		if(*p < '0' || *p > '9') return INT64_MIN;
+		value = value * 10 + (*p - '0');
+		if(nbDecimalRead >= 0) nbDecimalRead++;
+	}
+	if(nbDecimalRead != nbDecimal) return INT64_MIN;
+	return string[0] == '-' ? -value : value;
+}
+
+static void checkValue(int32_t val, uint8_t nbDecimal, Result* resultPtr){
+	char fixedBuff[24], referenceBuff[24], doubleBuff[48];
+	double asDouble = (double)val / _powersOfTen[nbDecimal];
+	resultPtr->nbValues++;
+
+	stringHelper_fixedPointToString(val, fixedBuff, nbDecimal);
+	writeReference(val, nbDecimal, referenceBuff, sizeof(referenceBuff));
+	int32_t roundTrip = stringHelper_toFixedPoint(asDouble, nbDecimal);
+	if(strcmp(fixedBuff, referenceBuff) != 0 || roundTrip != val)
+	{
+		if(resultPtr->nbWrong++ < NB_EXAMPLES)
+			printf("    WRONG %" PRId32 " : \"%s\" instead of \"%s\", toFixedPoint %" PRId32 "\n", val, fixedBuff, referenceBuff, roundTrip);
+		return;
+	}
+
+	stringHelper_doubleToString(asDouble, doubleBuff, nbDecimal);
+	if(strcmp(doubleBuff, fixedBuff) == 0)
+	{
+		resultPtr->nbSame++;
+		return;
+	}
+	int64_t doubleValue = parseFixedPoint(doubleBuff, nbDecimal);
+	if(doubleValue != INT64_MIN && (doubleValue == (int64_t)val - 1 || (val < 0 && doubleValue == (int64_t)val + 1)))
+	{
+		resultPtr->nbTruncated++;
+		return;
+	}
+	resultPtr->nbOtherDifferences++;
+	if(resultPtr->nbExamples++ < NB_EXAMPLES)
+		printf("    former formatter %" PRId32 " : \"%s\" instead of \"%s\"\n", val, doubleBuff, fixedBuff);
+}
+
+static void checkInterval(int64_t first, int64_t last, int64_t step, const Range* rangePtr, Result* resultPtr){
+	if(first < rangePtr->min) first = rangePtr->min;
+	if(last > rangePtr->max) last = rangePtr->max;
+	for(int64_t val = first; val <= last; val += step)
+	{
+		checkValue((int32_t)val, rangePtr->nbDecimal, resultPtr);
+	}
+}
+
+static uint8_t checkRange(const Range* rangePtr, uint8_t isFull){
+	Result result;
+	memset(&result, 0, sizeof(result));
+	printf("%s, %d decimals\n", rangePtr->name, rangePtr->nbDecimal);
+	if(rangePtr->zones == NULL || isFull)
+	{
+		checkInterval(rangePtr->min, rangePtr->max, 1, rangePtr, &result);
+	}
+	else
+	{
+		checkInterval(rangePtr->min, rangePtr->max, COORDINATE_STRIDE, rangePtr, &result);
+		for(uint8_t i = 0; i < rangePtr->nbZones; i++)
+		{
+			checkInterval((int64_t)rangePtr->zones[i] - EXHAUSTIVE_ZONE_SIZE, (int64_t)rangePtr->zones[i] + EXHAUSTIVE_ZONE_SIZE, 1, rangePtr, &result);
+		}
+	}
+	printf("    %" PRIu32 " values : %" PRIu32 " wrong, former formatter %" PRIu32 " same, %" PRIu32 " truncated, %" PRIu32 " other differences\n",
+		result.nbValues, result.nbWrong, result.nbSame, result.nbTruncated, result.nbOtherDifferences);
+	return result.nbWrong == 0;
+}
+
+static double benchmark(uint8_t isFixedPoint){
+	char buff[48];
+	volatile char sink = 0;
+	clock_t start = clock();
+	for(uint32_t i = 0; i < BENCHMARK_ROUNDS; i++)
+	{
+		int32_t lat = 433000000 + (int32_t)(i * 7919 % 1000000);
+		if(isFixedPoint) stringHelper_fixedPointToString(lat, buff, COORDINATE_DECIMALS);
+		else stringHelper_doubleToString((double)lat / 10000000, buff, COORDINATE_DECIMALS);
+		sink ^= buff[5];
+	}
+	(void)sink;
+	return (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / BENCHMARK_ROUNDS;
+}
+
+int main(int argc, char* argv[]){
+	uint8_t isFull = argc > 1 && strcmp(argv[1], "--full") == 0;
+	uint8_t isValid = 1;
+	for(uint8_t i = 0; i < sizeof(_ranges) / sizeof(_ranges[0]); i++)
+	{
+		isValid &= checkRange(&_ranges[i], isFull);
+	}
+	printf("\nBenchmark, %d latitudes with %d decimals\n", BENCHMARK_ROUNDS, COORDINATE_DECIMALS);
+	printf("    stringHelper_doubleToString     : %6.1f ns\n", benchmark(0));
+	printf("    stringHelper_fixedPointToString : %6.1f ns\n", benchmark(1));
+	printf("\n%s\n", isValid ? "OK" : "FAILED");
+	return isValid ? 0 : 1;
+}
@@ -0,0 +1,222 @@
+# Records the GPS and GSM lines of a Seekios, or replays a transcript to it, over the USB test monitor (UART_REPLAY_ACTIVATED).
+# Usage : python uart_replay.py record <port> <transcript> [seconds]
+#         python uart_replay.py replay <port> <transcript> [--speed x] [--output run.txt] [--tolerance x] [--commands-only]
+#         python uart_replay.py check <expected transcript> <actual transcript> [--tolerance x] [--commands-only]
+# A transcript has one line per event : <time in ms> <GPS|GSM_RX|GSM_TX> <line>. The lines starting with # are comments.
+# While replaying, the GPS lines and the modem answers are injected in the reception path of the Seekios and the AT commands
+# are kept from the modem. A modem answer is injected after the AT command that precedes it in the transcript, with the same
+# delay, divided by the speed. The AT commands sent by the Seekios are then compared with the GSM_TX lines of the transcript,
+# and the delay between each AT command and the line received before it is compared with the transcript.
+# Needs pyserial for the record and replay commands.
+
+import sys
+import threading
+import time
+
+# Keep in sync with uart_replay.h and USB_manager.h
+CHANNELS = ["GPS", "GSM_RX", "GSM_TX"]
+INJECTED_CHANNELS = {"GPS" : "GPS", "GSM_RX" : "GSM"}
+MONITOR_PERIOD = 0.01 # UART_REPLAY_MONITOR_PERIOD
+
+DEFAULT_TOLERANCE = 1.5		# an AT command sent later than the transcript delay times the tolerance is reported
+LATENCY_SLACK = 50			# ms, delays shorter than this are not compared
+COMMAND_TIMEOUT = 60		# s, time to wait for an AT command of the transcript before giving up
+
+def readTranscript(path):
+	events = []
+	with open(path) as transcript:
+		for line in transcript:
+			line = line.rstrip("\r\n")
+			if not line or line.startswith("#"):
+				continue
+			fields = line.split(" ", 2)
+			if len(fields) < 3 or fields[1] not in CHANNELS:
+				raise ValueError("Wrong transcript line : " + line)
+			events.append((int(fields[0]), fields[1], fields[2]))
+	return events
+
+def writeTranscript(path, events):
+	with open(path, "w") as transcript:
+		startTime = events[0][0] if events else 0
+		for tick, channel, line in events:
+			transcript.write("%d %s %s\n" % (tick - startTime, channel, line))
+
+# Reads the RPL_LINE lines sent by the Seekios until RPL_OVER
+class MonitorReader(threading.Thread):
+	def __init__(self, port):
+		threading.Thread.__init__(self)
+		self.daemon = True
+		self.port = port
+		self.events = []
+		self.nbCommands = 0
+		self.nbLostLines = 0
+		self.isOver = threading.Event()
+		self.lock = threading.Lock()
+
+	def run(self):
+		while not self.isOver.is_set():
+			line = self.port.readline().decode("ascii", "replace").rstrip("\r\n")
+			if line.startswith("RPL_LINE:"):
+				fields = line.split(":", 3)
+				with self.lock:
+					self.events.append((int(fields[1]), fields[2], fields[3] if len(fields) > 3 else ""))
+					if fields[2] == "GSM_TX":
+						self.nbCommands += 1
+			elif line.startswith("RPL_LOST:"):
+				self.nbLostLines = int(line.split(":")[1])
+			elif line.startswith("RPL_OVER"):
+				self.isOver.set()
+
+	def waitCommands(self, nbCommands, timeout):
+		endTime = time.time() + timeout
+		while time.time() < endTime:
+			with self.lock:
+				if self.nbCommands >= nbCommands:
+					return True
+			time.sleep(MONITOR_PERIOD)
+		return False
+
+def openPort(portName):
+	import serial
+	return serial.Serial(portName, 115200, timeout = 0.1)
+
+def sendCommand(port, command):
+	port.write((command + "\r\n").encode("ascii"))
+	time.sleep(2 * MONITOR_PERIOD) # lets the monitor read the command alone
+
+def stopMonitor(port, reader):
+	sendCommand(port, "REPLAY_STOP")
+	if not reader.isOver.wait(5):
+		print("No RPL_OVER received")
+	if reader.nbLostLines > 0:
+		print("%d lines lost by the Seekios : the USB monitor was too slow" % reader.nbLostLines)
+
+def record(portName, path, seconds):
+	port = openPort(portName)
+	reader = MonitorReader(port)
+	reader.start()
+	sendCommand(port, "REPLAY_RECORD")
+	print("Recording, Ctrl+C to stop")
+	try:
+		time.sleep(seconds) if seconds else threading.Event().wait()
+	except KeyboardInterrupt:
+		pass
+	stopMonitor(port, reader)
+	writeTranscript(path, reader.events)
+	print("%d lines recorded in %s" % (len(reader.events), path))
+	return 0
+
+def replay(portName, path, speed, outputPath, tolerance, commandsOnly):
+	expectedEvents = readTranscript(path)
+	port = openPort(portName)
+	reader = MonitorReader(port)
+	reader.start()
+	sendCommand(port, "REPLAY_START")
+
+	anchorTime = expectedEvents[0][0] if expectedEvents else 0
+	anchorHostTime = time.time()
+	nbCommands = 0
+	isComplete = True
+	for eventTime, channel, line in expectedEvents:
+		if channel == "GSM_TX":
+			nbCommands += 1
+			if not reader.waitCommands(nbCommands, COMMAND_TIMEOUT):
+				print("AT command %d not sent after %d s : %s" % (nbCommands, COMMAND_TIMEOUT, line))
+				isComplete = False
+				break
+			anchorTime = eventTime
+			anchorHostTime = time.time()
+			continue
+		delay = anchorHostTime + (eventTime - anchorTime) / 1000.0 / speed - time.time()
+		if delay > 0:
+			time.sleep(delay)
+		port.write(("REPLAY_INJECT:%s:%s\r\n" % (INJECTED_CHANNELS[channel], line)).encode("ascii"))
+		time.sleep(MONITOR_PERIOD)
+	time.sleep(1) # the last AT commands
+	stopMonitor(port, reader)
+
+	if outputPath:
+		writeTranscript(outputPath, reader.events)
+	isValid = compare(expectedEvents, reader.events, tolerance, commandsOnly)
+	return 0 if isComplete and isValid else 1
+
+# Delay between each AT command and the last line received before it, in ms
+def commandDelays(events):
+	delays = []
+	lastReceptionTime = None
+	for eventTime, channel, line in events:
+		if channel == "GSM_TX":
+			delays.append((line, None if lastReceptionTime is None else eventTime - lastReceptionTime))
+		else:
+			lastReceptionTime = eventTime
+	return delays
+
+def commandName(command):
+	return command.split("=")[0].split("?")[0]
+
+def compare(expectedEvents, actualEvents, tolerance, commandsOnly):
+	expectedDelays = commandDelays(expectedEvents)
+	actualDelays = commandDelays(actualEvents)
+	nbMismatches = 0
+	nbSlowCommands = 0
+	print("%-4s %-32s %10s %10s" % ("#", "AT command", "expected", "measured"))
+	for i in range(max(len(expectedDelays), len(actualDelays))):
+		if i >= len(expectedDelays):
+			print("%-4d unexpected : %s" % (i + 1, actualDelays[i][0]))
+			nbMismatches += 1
+			continue
+		if i >= len(actualDelays):
+			print("%-4d missing : %s" % (i + 1, expectedDelays[i][0]))
+			nbMismatches += 1
+			continue
+		expectedCommand, expectedDelay = expectedDelays[i]
+		actualCommand, actualDelay = actualDelays[i]
+		if commandsOnly:
+			isSame = commandName(expectedCommand) == commandName(actualCommand)
+		else:
+			isSame = expectedCommand == actualCommand
+		if not isSame:
+			print("%-4d expected %s, sent %s" % (i + 1, expectedCommand, actualCommand))
+			nbMismatches += 1
+			continue
+		remark = ""
+		if expectedDelay is not None and actualDelay is not None and actualDelay > LATENCY_SLACK and actualDelay > expectedDelay * tolerance:
+			remark = "SLOWER"
+			nbSlowCommands += 1
+		print("%-4d %-32s %10s %10s %s" % (i + 1, commandName(actualCommand)[:32], formatDelay(expectedDelay), formatDelay(actualDelay), remark))
+
+	print("")
+	print("Duration : expected %s, measured %s" % (formatDelay(duration(expectedEvents)), formatDelay(duration(actualEvents))))
+	print("%d AT commands, %d mismatches, %d slower than %.1f times the transcript" % (len(expectedDelays), nbMismatches, nbSlowCommands, tolerance))
+	return nbMismatches == 0 and nbSlowCommands == 0
+
+def duration(events):
+	return events[-1][0] - events[0][0] if events else 0
+
+def formatDelay(delay):
+	return "-" if delay is None else "%d ms" % delay
+
+def main(args):
+	options = {"--speed" : "1", "--output" : None, "--tolerance" : str(DEFAULT_TOLERANCE)}
+	commandsOnly = "--commands-only" in args
+	args = [arg for arg in args if arg != "--commands-only"]
+	for option in list(options):
+		if option in args:
+			index = args.index(option)
+			options[option] = args[index + 1]
+			del args[index:index + 2]
+	tolerance = float(options["--tolerance"])
+
+	if len(args) in (3, 4) and args[0] == "record":
+		return record(args[1], args[2], float(args[3]) if len(args) == 4 else None)
+	if len(args) == 3 and args[0] == "replay":
+		return replay(args[1], args[2], float(options["--speed"]), options["--output"], tolerance, commandsOnly)
+	if len(args) == 3 and args[0] == "check":
+		return 0 if compare(readTranscript(args[1]), readTranscript(args[2]), tolerance, commandsOnly) else 1
+	print("Usage : python uart_replay.py record <port> <transcript> [seconds]")
+	print("        python uart_replay.py replay <port> <transcript> [--speed x] [--output run.txt] [--tolerance x] [--commands-only]")
+	print("        python uart_replay.py check <expected transcript> <actual transcript> [--tolerance x] [--commands-only]")
+	return 1
+
+if __name__ == "__main__":
+	sys.exit(main(sys.argv[1:]))
@@ -0,0 +1,157 @@
+# Decodes the trace dumped by the Seekios over the USB (GET_TRACE command) and prints a timeline.
+# Usage : python trace_decoder.py capture.txt
+# The capture is the text received on the COM port : TRC_NOW, TRC_TASK and TRC_DATA lines, ended by TRC_OVER.
+# The mask bits and the AT commands are named from the sources in ../tracker2.
+
+from os import walk
+from os.path import join
+import re
+import struct
+import sys
+
+# Keep in sync with E_TRACE_EVENT in seekiosCore/trace.h
+EVENT_TASK_CREATED				= 1
+EVENT_TASK_SWITCHED_IN			= 2
+EVENT_REQUEST_MASK_SET			= 3
+EVENT_REQUEST_MASK_CLEARED		= 4
+EVENT_RUNNING_MASK_SET			= 5
+EVENT_RUNNING_MASK_CLEARED		= 6
+EVENT_INTERRUPT_MASK_SET		= 7
+EVENT_INTERRUPT_MASK_CLEARED	= 8
+EVENT_AT_COMMAND_START			= 9
+EVENT_AT_COMMAND_END			= 10
+EVENT_HIBERNATE_ENTER			= 11
+EVENT_HIBERNATE_EXIT			= 12
+
+EVENT_NAMES = {
+	EVENT_TASK_CREATED : "TASK CREATED",
+	EVENT_TASK_SWITCHED_IN : "TASK IN",
+	EVENT_REQUEST_MASK_SET : "REQUEST +",
+	EVENT_REQUEST_MASK_CLEARED : "REQUEST -",
+	EVENT_RUNNING_MASK_SET : "RUNNING +",
+	EVENT_RUNNING_MASK_CLEARED : "RUNNING -",
+	EVENT_INTERRUPT_MASK_SET : "INTERRUPT +",
+	EVENT_INTERRUPT_MASK_CLEARED : "INTERRUPT -",
+	EVENT_AT_COMMAND_START : "AT START",
+	EVENT_AT_COMMAND_END : "AT END",
+	EVENT_HIBERNATE_ENTER : "HIBERNATE",
+	EVENT_HIBERNATE_EXIT : "WAKE UP",
+}
+
+MASK_PREFIXES = {
+	EVENT_REQUEST_MASK_SET : "REQUEST_BIT_",
+	EVENT_REQUEST_MASK_CLEARED : "REQUEST_BIT_",
+	EVENT_RUNNING_MASK_SET : "RUNNING_BIT_",
+	EVENT_RUNNING_MASK_CLEARED : "RUNNING_BIT_",
+	EVENT_INTERRUPT_MASK_SET : "INTERRUPT_BIT_",
+	EVENT_INTERRUPT_MASK_CLEARED : "INTERRUPT_BIT_",
+}
+
+SERIAL_ANSWERS = ["ERROR", "OK", "TIMEOUT", "NONE"] # E_SERIAL_ANSWER
+
+sourcePath = "../tracker2"
+
+# Same hash as hashATCommandName in trace.c
+def hashATCommandName(command):
+	hash = 2166136261
+	if command.startswith("AT"):
+		command = command[2:]
+	for char in command:
+		if char in "=?\r":
+			break
+		hash = ((hash ^ ord(char)) * 16777619) & 0xFFFFFFFF
+	return hash & 0xFFFFFF
+
+def getSourceFiles():
+	sourceFiles = []
+	for directory, subDirectories, files in walk(sourcePath):
+		if directory.find("thirdparty") > -1:
+			continue
+		for file in files:
+			if file.endswith(".c") or file.endswith(".h"):
+				sourceFiles.append(join(directory, file))
+	return sourceFiles
+
+def parseMaskBits():
+	maskBits = {}
+	with open(join(sourcePath, "seekiosManager", "mask_utilities.h"), 'rt', encoding="utf-8", errors='replace') as input:
+		for line in input:
+			match = re.match(r"#define\s+((REQUEST|RUNNING|INTERRUPT)_BIT_\w+)\s+\(1\s*<<\s*(\d+)\)", line)
+			if match:
+				maskBits[match.group(1)] = 1 << int(match.group(3))
+	return maskBits
+
+def parseATCommands():
+	atCommands = {}
+	for file in getSourceFiles():
+		with open(file, 'rt', encoding="utf-8", errors='replace') as input:
+			for line in input:
+				for command in re.findall(r'"(AT[^"]*)"', line):
+					command = command.replace("\\r", "\r")
+					name = re.split(r"[=?\r]", command)[0]
+					atCommands[hashATCommandName(command)] = name
+	return atCommands
+
+def getMaskBitNames(prefix, bits, maskBits):
+	names = [name[len(prefix):] for name, bit in maskBits.items() if name.startswith(prefix) and bits & bit]
+	return " ".join(sorted(names)) if names else hex(bits)
+
+def parseCapture(fileName):
+	now = 0
+	taskNames = {}
+	records = []
+	with open(fileName, 'rt', encoding="utf-8", errors='replace') as input:
+		for line in input:
+			fields = line.strip().split(":")
+			if fields[0] == "TRC_NOW":
+				now = int(fields[1])
+			elif fields[0] == "TRC_TASK":
+				taskNames[int(fields[1])] = fields[2]
+			elif fields[0] == "TRC_DATA":
+				data = bytes.fromhex(fields[1])
+				for i in range(0, len(data) - 7, 8):
+					tick, eventAndArg = struct.unpack("<II", data[i:i + 8])
+					records.append((tick, eventAndArg >> 24, eventAndArg & 0xFFFFFF))
+	return now, taskNames, records
+
+def printTimeline(now, taskNames, records, maskBits, atCommands):
+	currentTask = "?"
+	atStart = None
+	atCommand = ""
+	atTotals = {}
+	for tick, event, arg in records:
+		details = ""
+		if event == EVENT_TASK_CREATED or event == EVENT_TASK_SWITCHED_IN:
+			details = taskNames.get(arg, hex(arg))
+			if event == EVENT_TASK_SWITCHED_IN:
+				currentTask = details
+				continue # printed as the task column of the next events
+		elif event in MASK_PREFIXES:
+			details = getMaskBitNames(MASK_PREFIXES[event], arg, maskBits)
+		elif event == EVENT_AT_COMMAND_START:
+			atStart = tick
+			atCommand = atCommands.get(arg, hex(arg))
+			details = atCommand
+		elif event == EVENT_AT_COMMAND_END:
+			answer = SERIAL_ANSWERS[arg] if arg < len(SERIAL_ANSWERS) else str(arg)
+			if atStart is not None:
+				duration = tick - atStart
+				atTotals[atCommand] = atTotals.get(atCommand, 0) + duration
+				details = "{} {} in {} ms".format(atCommand, answer, duration)
+				atStart = None
+			else:
+				details = answer
+		elif event == EVENT_HIBERNATE_ENTER or event == EVENT_HIBERNATE_EXIT:
+			details = "RTC {}".format(arg)
+		print("{:>10.3f} s  {:<8} {:<12} {}".format((tick - now) / 1000.0, currentTask, EVENT_NAMES.get(event, str(event)), details))
+
+	if atTotals:
+		print("\r\nTime spent waiting the modem, per AT command :")
+		for command, total in sorted(atTotals.items(), key=lambda item: -item[1]):
+			print("{:<20} {:>8} ms".format(command, total))
+
+if len(sys.argv) < 2:
+	print("Usage : python trace_decoder.py capture.txt")
+	sys.exit(1)
+now, taskNames, records = parseCapture(sys.argv[1])
+printTimeline(now, taskNames, records, parseMaskBits(), parseATCommands())
@@ -97,7 +97,7 @@
 	// <q> Use maclloc failed hook
 	// <id> freertos_use_malloc_failed_hook
 #ifndef configUSE_MALLOC_FAILED_HOOK
-#    define configUSE_MALLOC_FAILED_HOOK            0
+#    define configUSE_MALLOC_FAILED_HOOK            1
 #endif
 
 	// <q> Use idle hook
@@ -263,6 +263,14 @@
 #define xPortPendSVHandler                      PendSV_Handler
 #define xPortSysTickHandler                     SysTick_Handler
 
+	/* Scheduler hooks of seekiosCore/trace.c, recording only when TRACE_ACTIVATED is set in seekios.h */
+#if defined ( __GNUC__ ) || defined ( __ICCARM__ )
+		void trace_recordTaskCreated( void *task, const char *taskName );
+		void trace_recordTaskSwitchedIn( void *task );
+#    define traceTASK_CREATE( pxNewTCB )	trace_recordTaskCreated( ( pxNewTCB ), ( pxNewTCB )->pcTaskName )
+#    define traceTASK_SWITCHED_IN()		trace_recordTaskSwitchedIn( pxCurrentTCB )
+#endif
+
 	/* Used when configGENERATE_RUN_TIME_STATS is 1. */
 #if configGENERATE_RUN_TIME_STATS
 		extern void     vConfigureTimerForRunTimeStats( void );
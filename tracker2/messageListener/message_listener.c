@@ -83,7 +83,6 @@ void task_messageListener(void* param){
 	volatile BaseType_t wm = uxTaskGetStackHighWaterMark(NULL);
 	UNUSED(wm);
 	maskUtilities_clearRunningMaskBits(RUNNING_BIT_LISTENER);
-	FreeRTOSOverlay_taskDelete(NULL);
 }
 
 /* Sets a fake predetermined frames when reading HTTP data from the server.
@@ -223,7 +222,7 @@ void messageListener_clearAlarmListenerRetryIfSet(){
 static void setAlarmListenerRetryDelay(int delaySec){
 	messageListener_clearAlarmListenerRetryIfSet();
 	USARTManager_printUsbWait("Listener retry alarm : ");
-	RTCManager_setDelayedCallback(delaySec, &_listenerRetryAlarm, listenerRetryCallback);
+	RTCManager_setDelayedCallbackInWindow(delaySec, LISTENER_RETRY_ALARM_WINDOW, &_listenerRetryAlarm, listenerRetryCallback);
 }
 
 static void listenerRetryCallback(struct calendar_descriptor *const calendar){
@@ -26,6 +26,7 @@
 #define LISTENER_FAIL_WAIT_7 180
 #define LISTENER_FAIL_WAIT_8 180
 #define LISTENER_FAIL_WAIT_9 180
+#define LISTENER_RETRY_ALARM_WINDOW 5 // in sec. The retry can be done earlier to wake up with another alarm
 
 void task_messageListener(void* param);
 void messageListener_init(void);
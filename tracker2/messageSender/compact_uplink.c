@@ -0,0 +1,81 @@
+/*
+ * compact_uplink.c
+ *
+ * Content : binary encoding of the output messages, sent in base64url instead of the decimal URL fields.
+ * Decoded by uplink_codec/uplink_codec.py
+ *
+ * Frame : [version << 4 | flags] [message type] [battery] [signal] [varint timestamp - COMPACT_UPLINK_EPOCH]
+ * then if COMPACT_UPLINK_FLAG_COORDINATE : [zigzag varint lat] [zigzag varint lon] [zigzag varint alt in m] [varint hDOP * 10]
+ * then if COMPACT_UPLINK_FLAG_MODE_ID : [varint mode id]
+ */ 
+
+#include <messageSender/compact_uplink.h>
+
+static uint8_t encodeVarint(uint32_t value, uint8_t* frame);
+static uint8_t encodeZigzagVarint(int32_t value, uint8_t* frame);
+static int32_t toFixedPoint(double value, uint32_t scale);
+
+/* Returns the size of the frame, at most COMPACT_UPLINK_MAX_FRAME_SIZE */
+uint8_t compactUplink_encodeFrame(CompactUplinkMessage* messagePtr, uint8_t* frame){
+	uint8_t flags = 0;
+	if(messagePtr->coordinatePtr != NULL)
+	{
+		flags |= COMPACT_UPLINK_FLAG_COORDINATE;
+	}
+	if(messagePtr->hasModeId)
+	{
+		flags |= COMPACT_UPLINK_FLAG_MODE_ID;
+	}
+
+	uint8_t size = 0;
+	frame[size++] = (COMPACT_UPLINK_VERSION << 4) | flags;
+	frame[size++] = messagePtr->messageType;
+	frame[size++] = messagePtr->battery;
+	frame[size++] = messagePtr->signal;
+	size += encodeVarint(messagePtr->timestamp > COMPACT_UPLINK_EPOCH ? (uint32_t)(messagePtr->timestamp - COMPACT_UPLINK_EPOCH) : 0, &frame[size]);
+
+	if(flags & COMPACT_UPLINK_FLAG_COORDINATE)
+	{
+		SatelliteCoordinate* coordinatePtr = messagePtr->coordinatePtr;
+		size += encodeZigzagVarint(toFixedPoint(coordinatePtr->coordinate.lat, COMPACT_UPLINK_COORDINATE_SCALE), &frame[size]);
+		size += encodeZigzagVarint(toFixedPoint(coordinatePtr->coordinate.lon, COMPACT_UPLINK_COORDINATE_SCALE), &frame[size]);
+		size += encodeZigzagVarint(toFixedPoint(coordinatePtr->coordinate.alt, 1), &frame[size]);
+		int32_t hDOP = toFixedPoint(coordinatePtr->hDOP, COMPACT_UPLINK_HDOP_SCALE);
+		size += encodeVarint(hDOP > 0 ? (uint32_t)hDOP : 0, &frame[size]);
+	}
+
+	if(flags & COMPACT_UPLINK_FLAG_MODE_ID)
+	{
+		size += encodeVarint(messagePtr->modeId, &frame[size]);
+	}
+	return size;
+}
+
+/* Appends the frame in base64url to the string */
+char* compactUplink_catFrame(char* resultBuf, CompactUplinkMessage* messagePtr){
+	uint8_t frame[COMPACT_UPLINK_MAX_FRAME_SIZE];
+	uint8_t frameSize = compactUplink_encodeFrame(messagePtr, frame);
+	stringHelper_bytesToBase64Url(frame, frameSize, resultBuf + strlen(resultBuf));
+	return resultBuf;
+}
+
+/* 7 bits per byte, least significant group first, the high bit set when another byte follows */
+static uint8_t encodeVarint(uint32_t value, uint8_t* frame){
+	uint8_t size = 0;
+	while(value >= 0x80)
+	{
+		frame[size++] = (value & 0x7F) | 0x80;
+		value >>= 7;
+	}
+	frame[size++] = value;
+	return size;
+}
+
+/* Small negative values are encoded on few bytes : 0, -1, 1, -2... become 0, 1, 2, 3... */
+static uint8_t encodeZigzagVarint(int32_t value, uint8_t* frame){
+	return encodeVarint(((uint32_t)value << 1) ^ (uint32_t)(value >> 31), frame);
+}
+
+static int32_t toFixedPoint(double value, uint32_t scale){
+	return (int32_t)lround(value * scale);
+}
@@ -0,0 +1,42 @@
+/*
+ * compact_uplink.h
+ *
+ * Content : binary encoding of the output messages, sent in base64url instead of the decimal URL fields.
+ * Decoded by uplink_codec/uplink_codec.py
+ */ 
+
+
+#ifndef COMPACT_UPLINK_H_
+#define COMPACT_UPLINK_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include <math.h>
+#include <peripheralManager/GPS_manager.h>
+
+#define COMPACT_UPLINK_VERSION				1
+#define COMPACT_UPLINK_EPOCH				1483228800 // 01/01/2017 : the timestamps are sent as seconds since this date
+#define COMPACT_UPLINK_COORDINATE_SCALE		100000 // lat and lon in 1/100000 degree, about 1 m
+#define COMPACT_UPLINK_HDOP_SCALE			10
+#define COMPACT_UPLINK_MAX_FRAME_SIZE		34 // 4 bytes header + 6 varints of at most 5 bytes
+#define COMPACT_UPLINK_MAX_STRING_SIZE		((COMPACT_UPLINK_MAX_FRAME_SIZE * 4 + 2) / 3 + 1) // base64url without padding
+
+/* Optional fields of the frame, flagged in the low nibble of its first byte */
+#define COMPACT_UPLINK_FLAG_COORDINATE		(1 << 0)
+#define COMPACT_UPLINK_FLAG_MODE_ID			(1 << 1)
+
+typedef struct{
+	uint8_t messageType;
+	uint8_t battery;	// in %
+	uint8_t signal;		// in %
+	time_t timestamp;
+	SatelliteCoordinate* coordinatePtr; // NULL if the message has no position
+	bool hasModeId;
+	uint32_t modeId;
+}CompactUplinkMessage;
+
+uint8_t compactUplink_encodeFrame(CompactUplinkMessage* messagePtr, uint8_t* frame);
+char* compactUplink_catFrame(char* resultBuf, CompactUplinkMessage* messagePtr);
+
+#endif /* COMPACT_UPLINK_H_ */
@@ -28,33 +28,39 @@ static uint8_t replaceLowestPriorityMessage(PrioritizedOutputMessage* pMsgPtr);
 static uint8_t addToOptimizedListAtIndex(PrioritizedOutputMessage *pMsgPtr, uint8_t index);
 static void serializeMessageUrl(OutputMessage msg, char* msgString);
 static bool getFirstMessage(OutputMessage *msgPtr);
+static bool isRetryableRequestStatus(E_HTTP_REQUEST_STATUS requestStatus);
+static void acknowledgeFirstMessage(OutputMessage *msgPtr, E_HTTP_REQUEST_STATUS requestStatus);
 static uint8_t replaceAlertMessage(PrioritizedOutputMessage *pMsgPtr);
 static E_MESSAGE_CATEGORY computeMessageCategoryFromMessageType(E_MESSAGE_TYPE type);
-static void extractFrontOutputMessageFromFlash(PrioritizedOutputMessage* result);
+static bool extractFrontOutputMessageFromFlash(PrioritizedOutputMessage* result);
 static bool isValidMessage(PrioritizedOutputMessage *pMsgPtr);
 static void catVersionMessage(char* resultBuf, uint8_t* battery, uint8_t* signal, OutputMessage* msgPtr);
 static void catModeId(char* resultBuf, uint32_t modeId);
 static void catAlertMessageWithMode(char* resultBuf, uint8_t* battery, uint8_t* signal, OutputMessage* msgPtr);
 static void catCoordinateMessageWithMode(char* resultBuf, uint8_t* battery, uint8_t* signal, OutputMessage* msgPtr);
+static void catTrackSegmentMessage(char* resultBuf, uint8_t* battery, uint8_t* signal, OutputMessage* msgPtr);
+#if (COMPACT_UPLINK_ACTIVATED == 1)
+static void catCompactMessage(char* resultBuf, uint8_t* battery, uint8_t* signal, OutputMessage* msgPtr);
+#endif
 
 static struct calendar_alarm _senderRetryAlarm;
 static OutputMessageArray	_optimizedSendList;
 static SemaphoreHandle_t	_optimizedSendListLock;
 static QueueHandle_t		_sendList;
 static uint8_t				_failSendCount;
-static uint8_t				_nbSavedMessagesInFlash;
-static uint8_t				_prioritizedOutputMessageSize;
-static uint8_t				_nbMaxSavedOutputMessagesInFlash;
+static uint16_t				_nbRecoveredMessagesInFlash;
 
 void messageSender_init(){
 	_failSendCount = 0;
-	_nbSavedMessagesInFlash = 0;
-	_nbMaxSavedOutputMessagesInFlash = EXT_FLASH_PAGE_SIZE/sizeof(PrioritizedOutputMessage);
-	_prioritizedOutputMessageSize = sizeof(PrioritizedOutputMessage);
+	_nbRecoveredMessagesInFlash = dataflashManager_getOutboxCount();
 	_optimizedSendList.nbMessages = 0;
 	_optimizedSendListLock = xSemaphoreCreateRecursiveMutex();
 	fakeSendingFailure = false;
 	initSendList();
+	if(_nbRecoveredMessagesInFlash > 0)
+	{
+		maskUtilities_setRequestMaskBits(REQUEST_BIT_SENDER);
+	}
 }
 
 /* cr la liste et son smaphore associ */
@@ -71,42 +77,40 @@ void task_messageSender(void *param){
 	bool httpOpen = GSMManager_useHTTP(statusManager_getGPRSExpirationTime());
 	volatile E_HTTP_REQUEST_STATUS httpRequestStatus = HTTP_REQUEST_STATUS_UNKNOWN_ERROR;
 	uint8_t serverResponse[16];
+	uint8_t nbProcessedMessages = 0;
+	bool retrySending = !httpOpen; // Case where we retry to send the message
 
 	OutputMessage msg;
 	if(httpOpen)
 	{
+		/* Sends up to SENDER_BATCH_SIZE messages while the HTTP session is open, each one being acknowledged on its own */
 		drainSendList();
-		if(getFirstMessage(&msg) == FUNCTION_SUCCESS)
+		reorganizeOptimizedSendList();
+		while(nbProcessedMessages < SENDER_BATCH_SIZE && getFirstMessage(&msg) == FUNCTION_SUCCESS)
 		{
 			httpRequestStatus = sendMessage(msg, serverResponse); // TODO : tant qu'on est en mode retry d'envoi, on ne retente pas d'envoyer les messages
+			if(isRetryableRequestStatus(httpRequestStatus))
+			{
+				retrySending = true;
+				break;
+			}
+			acknowledgeFirstMessage(&msg, httpRequestStatus);
+			nbProcessedMessages++;
+			drainSendList();
 		}
 		vTaskDelay(2000);
 	}
 
-	if(!httpOpen // Case where we retry to send the message
-	|| httpRequestStatus == HTTP_REQUEST_STATUS_NETWORK_ERROR
-	|| httpRequestStatus == HTTP_REQUEST_STATUS_REQUEST_TIMEOUT
-	|| httpRequestStatus == HTTP_REQUEST_STATUS_NONE)
+	if(retrySending)
 	{
 		USARTManager_printUsbWait("Sending message FAILED : retrying\r\n");
 		incrementSendFailCount();
 		setRetrySendAlarm();
 	}
-	else // Success or other error : we delete it
+	else
 	{
-		if(httpRequestStatus == HTTP_REQUEST_STATUS_OK)
-		{
-			USARTManager_printUsbWait("Sending message SUCCESS\r\n");
-			if(msg.onSendSuccess != NULL)
-			{
-				msg.onSendSuccess();
-			}
-		}
-		USARTManager_printUsbWait("Deleting message\r\n");
-		popOptimizedListFirstMessage();
 		resetSendFailCount();
-		reorganizeOptimizedSendList();
-		if(_optimizedSendList.nbMessages > 0)
+		if(messageSender_outboxHasMessages())
 		{
 			maskUtilities_setRequestMaskBits(REQUEST_BIT_SENDER);
 		}
@@ -115,7 +119,28 @@ void task_messageSender(void *param){
 	volatile BaseType_t wm = uxTaskGetStackHighWaterMark(NULL);
 	UNUSED(wm);
 	maskUtilities_clearRunningMaskBits(RUNNING_BIT_SENDER);
-	FreeRTOSOverlay_taskDelete(NULL);
+}
+
+/* Network errors and timeouts keep the message in the outbox : the sending is retried later */
+static bool isRetryableRequestStatus(E_HTTP_REQUEST_STATUS requestStatus){
+	return requestStatus == HTTP_REQUEST_STATUS_NETWORK_ERROR
+	|| requestStatus == HTTP_REQUEST_STATUS_REQUEST_TIMEOUT
+	|| requestStatus == HTTP_REQUEST_STATUS_NONE;
+}
+
+/* Success or other error : the first message of the outbox is deleted and replaced by a message from the flash if any */
+static void acknowledgeFirstMessage(OutputMessage *msgPtr, E_HTTP_REQUEST_STATUS requestStatus){
+	if(requestStatus == HTTP_REQUEST_STATUS_OK)
+	{
+		USARTManager_printUsbWait("Sending message SUCCESS\r\n");
+		if(msgPtr->onSendSuccess != NULL)
+		{
+			msgPtr->onSendSuccess();
+		}
+	}
+	USARTManager_printUsbWait("Deleting message\r\n");
+	popOptimizedListFirstMessage();
+	reorganizeOptimizedSendList();
 }
 
 static bool getFirstMessage(OutputMessage *msgPtr){
@@ -162,7 +187,7 @@ static void setRetrySendAlarm(){
 static void setAlarmSenderRetryDelay(int delayMin){
 	uint32_t delaySec = delayMin*60;
 	USARTManager_printUsbWait("Sender retry : ");
-	RTCManager_setDelayedCallback(delaySec, &_senderRetryAlarm, senderRetryCallback);
+	RTCManager_setDelayedCallbackInWindow(delaySec, SENDER_RETRY_ALARM_WINDOW, &_senderRetryAlarm, senderRetryCallback);
 }
 
 void messageSender_printSenderRetryAlarm()
@@ -223,27 +248,39 @@ static uint32_t computeWaitSendRetryTime(){
 	}
 }
 
-static void extractFrontOutputMessageFromFlash(PrioritizedOutputMessage* result){
-	dataflashManager_readPage(PAGE_INDEX_SAVE_MESSAGES, EXT_FLASH_PAGE_SIZE, genericBuf);
-	int startIndex = _prioritizedOutputMessageSize*(_nbSavedMessagesInFlash-1);
-	memcpy(result, genericBuf+startIndex, _prioritizedOutputMessageSize);
-	_nbSavedMessagesInFlash--;
+/* Takes the oldest message of the outbox log. Only the output message is saved : the priority and category are computed again */
+static bool extractFrontOutputMessageFromFlash(PrioritizedOutputMessage* result){
+	if(!dataflashManager_extractOutboxFront(&(result->outputMessage), sizeof(OutputMessage)))
+	{
+		return false;
+	}
+	if(_nbRecoveredMessagesInFlash > 0)
+	{
+		/* Messages saved before the reboot : the callbacks may point to another firmware */
+		result->outputMessage.onSendSuccess = NULL;
+		_nbRecoveredMessagesInFlash--;
+	}
+	result->messagePriority = computeMessagePriorityFromMessageType(result->outputMessage.messageType);
+	result->messageCategory = computeMessageCategoryFromMessageType(result->outputMessage.messageType);
+	return true;
 }
 
-/* If data is in flash, take the last message from the flash and put it in the optimizedSendList */
+/* If data is in flash, take the oldest message from the flash and put it in the optimizedSendList */
 void reorganizeOptimizedSendList(){
 	if(xSemaphoreTakeRecursive(_optimizedSendListLock, 0)==pdPASS){
-		while(_nbSavedMessagesInFlash > 0 && _optimizedSendList.nbMessages < OPTIMIZED_SENDLIST_SIZE){
+		while(dataflashManager_getOutboxCount() > 0 && _optimizedSendList.nbMessages < OPTIMIZED_SENDLIST_SIZE){
 			PrioritizedOutputMessage msg;
-			extractFrontOutputMessageFromFlash(&msg);
-			addToOptimizedList(&msg);
+			if(extractFrontOutputMessageFromFlash(&msg))
+			{
+				addToOptimizedList(&msg);
+			}
 		}
 		xSemaphoreGiveRecursive(_optimizedSendListLock);
 	}
 }
 
 bool messageSender_outboxHasMessages(){
-	return _optimizedSendList.nbMessages > 0;
+	return _optimizedSendList.nbMessages > 0 || dataflashManager_getOutboxCount() > 0;
 }
 
 /* This function encapsulates the action of adding elements to the sendList */
@@ -304,6 +341,14 @@ static void serializeMessageUrl(OutputMessage msg, char* msgString){
 	batteryManager_getBatteryPercentageStr(battery);
 	GSMManager_getSignalLevelPctage(signal);
 	strcpy(msgString, SEEKIOS_EMBEDDED_SERVICE_URL);
+	#if (COMPACT_UPLINK_ACTIVATED == 1)
+	if(COMPACT_UPLINK_MESSAGE_TYPES & (1UL << msg.messageType))
+	{
+		strcat(msgString, "CMPT/");
+		catCompactMessage(msgString, battery, signal, &msg);
+		return;
+	}
+	#endif
 	switch (msg.messageType)
 	{
 		case MESSAGE_TYPE_ON_DEMAND :
@@ -361,6 +406,10 @@ static void serializeMessageUrl(OutputMessage msg, char* msgString){
 		strcat(msgString, "PSD/");
 		catAlertMessageWithMode(msgString, battery, signal, &msg);
 		break;
+		case MESSAGE_TYPE_TRACK_SEGMENT:
+		strcat(msgString, "ATS/");
+		catTrackSegmentMessage(msgString, battery, signal, &msg);
+		break;
 		default:
 		break;
 	}
@@ -373,6 +422,9 @@ static void catVersionMessage(char* resultBuf, uint8_t* battery, uint8_t* signal
 	catSeekiosSignalAndBattery(resultBuf, battery, signal);
 	seekiosInfoManager_catSeekiosVersion(resultBuf);
 	catTimestamp(resultBuf, msgPtr->timestamp);
+	#if (TELEMETRY_IN_STATUS_MESSAGES == 1)
+	telemetry_catTelemetry(resultBuf);
+	#endif
 }
 
 static void catAlertMessage(char* resultBuf, uint8_t* battery, uint8_t* signal, OutputMessage* msgPtr)
@@ -413,6 +465,74 @@ static void catCoordinateMessageWithMode(char* resultBuf, uint8_t* battery, uint
 	catModeId(resultBuf, msgPtr->modeId);
 }
 
+/* FORMAT : ATS/<Seekios_ID>/<battery>/<signal>/<tracking message type>/<lat>/<lon>/<alt>/<timestamp>/<mode_id>/<time.lat.lon.alt>_<time.lat.lon.alt>...
+The lat and lon are in 1/TRACK_SEGMENT_COORDINATE_SCALE degree, each delta is relative to the previous fix */
+static void catTrackSegmentMessage(char* resultBuf, uint8_t* battery, uint8_t* signal, OutputMessage* msgPtr){
+	TrackSegment* segmentPtr = &msgPtr->content.trackSegment;
+	uint8_t buff[12] = "";
+	catSeekiosId((unsigned char*)resultBuf);
+	catSeekiosSignalAndBattery(resultBuf, battery, signal);
+	strcat(resultBuf, "/");
+	strcat(resultBuf, stringHelper_intToString(segmentPtr->trackingMessageType, buff));
+	strcat(resultBuf, "/");
+	strcat(resultBuf, stringHelper_intToString(segmentPtr->lat, buff));
+	strcat(resultBuf, "/");
+	strcat(resultBuf, stringHelper_intToString(segmentPtr->lon, buff));
+	strcat(resultBuf, "/");
+	strcat(resultBuf, stringHelper_intToString(segmentPtr->alt, buff));
+	catTimestamp(resultBuf, msgPtr->timestamp);
+	catModeId(resultBuf, msgPtr->modeId);
+	strcat(resultBuf, "/");
+	for(uint8_t i=0; i<segmentPtr->nbDeltas; i++)
+	{
+		if(i > 0) strcat(resultBuf, "_");
+		strcat(resultBuf, stringHelper_intToString(segmentPtr->deltas[i].time, buff));
+		strcat(resultBuf, ".");
+		strcat(resultBuf, stringHelper_intToString(segmentPtr->deltas[i].lat, buff));
+		strcat(resultBuf, ".");
+		strcat(resultBuf, stringHelper_intToString(segmentPtr->deltas[i].lon, buff));
+		strcat(resultBuf, ".");
+		strcat(resultBuf, stringHelper_intToString(segmentPtr->deltas[i].alt, buff));
+	}
+}
+
+#if (COMPACT_UPLINK_ACTIVATED == 1)
+/* FORMAT : CMPT/<Seekios_ID>/<base64url frame>, see compact_uplink.h */
+static void catCompactMessage(char* resultBuf, uint8_t* battery, uint8_t* signal, OutputMessage* msgPtr){
+	CompactUplinkMessage compactMessage;
+	compactMessage.messageType = msgPtr->messageType;
+	compactMessage.battery = atoi((char*)battery);
+	compactMessage.signal = atoi((char*)signal);
+	compactMessage.timestamp = msgPtr->timestamp;
+	compactMessage.coordinatePtr = NULL;
+	compactMessage.hasModeId = false;
+	switch (msgPtr->messageType)
+	{
+		case MESSAGE_TYPE_TRACKING :
+		case MESSAGE_TYPE_OUT_OF_ZONE :
+		case MESSAGE_TYPE_ZONE_TRACKING :
+		case MESSAGE_TYPE_DONT_MOVE_TRACKING :
+		compactMessage.hasModeId = true;
+		compactMessage.modeId = msgPtr->modeId;
+		/* no break : these messages have a position too */
+		case MESSAGE_TYPE_ON_DEMAND :
+		case MESSAGE_TYPE_SOS_LOCATION :
+		compactMessage.coordinatePtr = &msgPtr->content.satelliteCoordinate;
+		break;
+		case MESSAGE_TYPE_DONT_MOVE :
+		case MESSAGE_TYPE_POWER_SAVING_DISABLED :
+		compactMessage.hasModeId = true;
+		compactMessage.modeId = msgPtr->modeId;
+		break;
+		default:
+		break;
+	}
+	catSeekiosId((unsigned char*)resultBuf);
+	strcat(resultBuf, "/");
+	compactUplink_catFrame(resultBuf, &compactMessage);
+}
+#endif
+
 static void catSeekiosSignalAndBattery(char* resultBuf, uint8_t* battery, uint8_t* signal){
 	strcat(resultBuf,"/");
 	strcat(resultBuf, (char*)battery);
@@ -423,16 +543,16 @@ static void catSeekiosSignalAndBattery(char* resultBuf, uint8_t* battery, uint8_
 static void catCoordinate(char* resultBuf,OutputMessage* msgPtr){
 	char buff[20] = "";
 	strcat(resultBuf,"/");
-	stringHelper_doubleToString(msgPtr->content.satelliteCoordinate.coordinate.lat,buff,11);
+	stringHelper_fixedPointToString(stringHelper_toFixedPoint(msgPtr->content.satelliteCoordinate.coordinate.lat, COORDINATE_DECIMALS), buff, COORDINATE_DECIMALS);
 	strcat(resultBuf,buff);
 	strcat(resultBuf,"/");
-	stringHelper_doubleToString(msgPtr->content.satelliteCoordinate.coordinate.lon,buff,11);
+	stringHelper_fixedPointToString(stringHelper_toFixedPoint(msgPtr->content.satelliteCoordinate.coordinate.lon, COORDINATE_DECIMALS), buff, COORDINATE_DECIMALS);
 	strcat(resultBuf,buff);
 	strcat(resultBuf,"/");
-	stringHelper_doubleToString(msgPtr->content.satelliteCoordinate.coordinate.alt,buff,2);
+	stringHelper_fixedPointToString(stringHelper_toFixedPoint(msgPtr->content.satelliteCoordinate.coordinate.alt, 2), buff, 2);
 	strcat(resultBuf,buff);
 	strcat(resultBuf,"/");
-	stringHelper_doubleToString(msgPtr->content.satelliteCoordinate.hDOP,buff,2);
+	stringHelper_fixedPointToString(stringHelper_toFixedPoint(msgPtr->content.satelliteCoordinate.hDOP, 2), buff, 2);
 	strcat(resultBuf,buff);
 }
 
@@ -518,7 +638,8 @@ static bool isValidMessage(PrioritizedOutputMessage *pMsgPtr)
 	|| pMsgPtr->outputMessage.messageType == MESSAGE_TYPE_DAILY_TRACK_TRIANGULATION
 	|| pMsgPtr->outputMessage.messageType == MESSAGE_TYPE_SEEKIOS_VERSION_UPDATED
 	|| pMsgPtr->outputMessage.messageType == MESSAGE_TYPE_LOW_BATTERY
-	|| pMsgPtr->outputMessage.messageType == MESSAGE_TYPE_POWER_SAVING_DISABLED)
+	|| pMsgPtr->outputMessage.messageType == MESSAGE_TYPE_POWER_SAVING_DISABLED
+	|| pMsgPtr->outputMessage.messageType == MESSAGE_TYPE_TRACK_SEGMENT)
 	{
 		return true;
 	}
@@ -684,6 +805,7 @@ static E_MESSAGE_CATEGORY computeMessageCategoryFromMessageType(E_MESSAGE_TYPE t
 		case MESSAGE_TYPE_ZONE_TRACKING:
 		case MESSAGE_TYPE_DONT_MOVE_TRACKING:
 		case MESSAGE_TYPE_FOLLOW_ME_TRACKING:
+		case MESSAGE_TYPE_TRACK_SEGMENT:
 		return MESSAGE_CATEGORY_TRACKING;
 		break;
 	}
@@ -714,6 +836,7 @@ static E_MESSAGE_PRIORITY computeMessagePriorityFromMessageType(E_MESSAGE_TYPE t
 		case MESSAGE_TYPE_DAILY_TRACK_TRIANGULATION:
 		case MESSAGE_TYPE_DONT_MOVE_TRACKING:
 		case MESSAGE_TYPE_FOLLOW_ME_TRACKING:
+		case MESSAGE_TYPE_TRACK_SEGMENT:
 		case MESSAGE_TYPE_ON_DEMAND:
 		case MESSAGE_TYPE_ON_DEMAND_TRIANGULATION:
 		case MESSAGE_TYPE_NONE:
@@ -746,18 +869,10 @@ void messageSender_testWriteOutputMessageInFlash(){
 }
 
 static uint8_t saveMessageToFlash(PrioritizedOutputMessage* messagePtr){
-	if(_nbSavedMessagesInFlash < _nbMaxSavedOutputMessagesInFlash){
-		dataflashManager_readPage(PAGE_INDEX_SAVE_MESSAGES, EXT_FLASH_PAGE_SIZE, genericBuf);
-		int startIndex = _prioritizedOutputMessageSize*_nbSavedMessagesInFlash;
-		if(startIndex+_prioritizedOutputMessageSize<EXT_FLASH_PAGE_SIZE)
-		{
-			memcpy(genericBuf+startIndex, messagePtr, _prioritizedOutputMessageSize);
-			dataflashManager_writeToPage(PAGE_INDEX_SAVE_MESSAGES, EXT_FLASH_PAGE_SIZE, genericBuf);
-			_nbSavedMessagesInFlash++;
-			return FUNCTION_SUCCESS;
-		}
+	if(dataflashManager_appendToOutbox(&(messagePtr->outputMessage), sizeof(OutputMessage)))
+	{
+		return FUNCTION_SUCCESS;
 	}
-	
 	return FUNCTION_FAILURE;
 }
 
@@ -15,6 +15,8 @@
 #include <semphr.h>
 #include <task.h>
 #include <sgs/helper_sgs.h>
+#include <seekiosCore/telemetry.h>
+#include <messageSender/compact_uplink.h>
 
 /* Wait time for the next listening if getting the instructions from the cloud failed */
 /* Wait time IN MINUTES */
@@ -27,15 +29,39 @@
 #define SENDER_FAIL_WAIT_7 3
 #define SENDER_FAIL_WAIT_8 3
 #define SENDER_FAIL_WAIT_9 3
+#define SENDER_RETRY_ALARM_WINDOW 20 // in sec. The retry can be done earlier to wake up with another alarm
 
 #define OPTIMIZED_SENDLIST_SIZE 10 // TODO : for debug. Make bigger (10)
 #define SENDLIST_SIZE			4
 #define MAX_QUEUE_RECEIVE_TIME	500
 #define MAX_QUEUE_SEND_TIME		500
 #define SENDER_GSM_WAIT_TIME	120000
+#define SENDER_BATCH_SIZE		5 // max number of messages sent during the same HTTP session
+
+#define TRACK_SEGMENT_MAX_DELTAS			4 // the OutputMessage has to fit in OUTBOX_RECORD_MAX_SIZE
+#define TRACK_SEGMENT_COORDINATE_SCALE		100000 // lat and lon in 1/100000 degree, about 1 m
+
+/* Fix of a track segment, relative to the previous fix of the segment */
+typedef struct{
+	int16_t time;	// in sec
+	int16_t lat;	// in 1/TRACK_SEGMENT_COORDINATE_SCALE degree
+	int16_t lon;	// in 1/TRACK_SEGMENT_COORDINATE_SCALE degree
+	int16_t alt;	// in meter
+}TrackDelta;
+
+/* Successive tracking fixes sent in the same message. The first fix is taken at the timestamp of the message */
+typedef struct{
+	int32_t lat;	// in 1/TRACK_SEGMENT_COORDINATE_SCALE degree
+	int32_t lon;	// in 1/TRACK_SEGMENT_COORDINATE_SCALE degree
+	int16_t alt;	// in meter
+	uint8_t trackingMessageType;
+	uint8_t nbDeltas;
+	TrackDelta deltas[TRACK_SEGMENT_MAX_DELTAS];
+}TrackSegment;
 
 typedef union{
 	SatelliteCoordinate satelliteCoordinate;
+	TrackSegment trackSegment;
 }MessageContent;
 
 /* Message type, for the sender to know which cloud URL to send */
@@ -62,8 +88,12 @@ typedef enum{
 	MESSAGE_TYPE_SEEKIOS_VERSION_UPDATED =		20,
 	MESSAGE_TYPE_LOW_BATTERY =					21,
 	MESSAGE_TYPE_POWER_SAVING_DISABLED =		22,
+	MESSAGE_TYPE_TRACK_SEGMENT =				23,
 } E_MESSAGE_TYPE;
 
+/* Message types sent as a compact frame when COMPACT_UPLINK_ACTIVATED is 1. The other types keep their URL */
+#define COMPACT_UPLINK_MESSAGE_TYPES	((1UL << MESSAGE_TYPE_ON_DEMAND) | (1UL << MESSAGE_TYPE_TRACKING) | (1UL << MESSAGE_TYPE_ZONE_TRACKING) | (1UL << MESSAGE_TYPE_DONT_MOVE_TRACKING))
+
 // The message category
 typedef enum{
 	MESSAGE_CATEGORY_ALERT		=	0,
@@ -85,6 +115,9 @@ typedef struct{
 	void (*onSendSuccess)(void); // callback to be called once the OutputMessage is successFully send
 } OutputMessage;
 
+/* The messages are saved in the slots of the outbox log : "size of array is negative" means the OutputMessage grew over OUTBOX_RECORD_MAX_SIZE */
+typedef char OutputMessageFitsInOutboxSlot[(sizeof(OutputMessage) <= OUTBOX_RECORD_MAX_SIZE) ? 1 : -1];
+
 typedef struct{
 	OutputMessage outputMessage;
 	E_MESSAGE_PRIORITY messagePriority;
@@ -1,25 +1,25 @@
 #include <modesManager/modes.h>
-static double getMinDistanceFromEdges(Coordinate *seekiosLocationPtr,int nbEdges, Coordinate *zonePointsPtr);
-static bool checkIfSeekiosInZone(Coordinate zoneCoordinates[NB_MAX_COORDINATES], int nbCoordinates, SatelliteCoordinate *outOfZoneCoordinate);
-static double getMinDistanceFromZone(Coordinate *seekiosLocationPtr, int nbCoordinates, Coordinate* coordinates);
+static bool checkIfSeekiosInZone(CompiledZone *zonePtr, SatelliteCoordinate *outOfZoneCoordinate);
+static double getMinDistanceFromZone(Coordinate *seekiosLocationPtr, CompiledZone *zonePtr);
 static void setZoneWaitSignificantMotitionState(void);
 static void raiseMessageSentOutOfZone(void);
 
+static CompiledZone _zone; // 336 bytes, kept out of the stack of the zone task (STACK_SIZE_ZONE_TASK). Only one mode task runs at a time
+
 void modes_zoneMode(void* param){
 	UNUSED(param);
 	maskUtilities_setRunningMaskBits(RUNNING_BIT_MODE);
 	maskUtilities_requestGPSFromMode();
 
 	vTaskDelay(500);
-	Coordinate coordinates[NB_MAX_COORDINATES];
-	int nbCoordinates = statusManager_getRunningConfigCoordinates(coordinates);
+	statusManager_getRunningConfigCompiledZone(&_zone);
 	uint16_t refreshRate = statusManager_getRunningRefreshRate();
 	uint8_t state = statusManager_getRunningStatusState();
 	bool trackingWhenSeekiosOutOfZone = refreshRate > 0;
 	SatelliteCoordinate outOfZoneCoordinate;
 	if(state == ZONE_STATE_CHECK_POSITION)
 	{
-		if(checkIfSeekiosInZone(coordinates, nbCoordinates, &outOfZoneCoordinate))
+		if(checkIfSeekiosInZone(&_zone, &outOfZoneCoordinate))
 		{
 			// seekios in zone
 			setZoneWaitSignificantMotitionState();
@@ -63,7 +63,7 @@ Note : le counterOutOfZone est incr
 returns true if the seekios is in zone
 returns false otherwise
 */
-static bool checkIfSeekiosInZone(Coordinate zoneCoordinates[NB_MAX_COORDINATES], int nbZoneCoordinates, SatelliteCoordinate *outOfZoneCoordinatePtr)
+static bool checkIfSeekiosInZone(CompiledZone *zonePtr, SatelliteCoordinate *outOfZoneCoordinatePtr)
 {	
 	volatile SatelliteCoordinate lastSatelliteData;
 	GetPositionParameters params;
@@ -81,7 +81,7 @@ static bool checkIfSeekiosInZone(Coordinate zoneCoordinates[NB_MAX_COORDINATES],
 	do
 	{
 		GPSManager_getPositionFromMode(&lastSatelliteData, &params);
-		minDistanceFromZone=getMinDistanceFromZone(&(lastSatelliteData.coordinate), nbZoneCoordinates, zoneCoordinates);
+		minDistanceFromZone=getMinDistanceFromZone(&(lastSatelliteData.coordinate), zonePtr);
 		if (minDistanceFromZone<MAX_DISTANCE_FROM_ZONE)
 		{
 			USARTManager_printUsbWait("[zone ras] Seekios in or close to zone.\r\n");
@@ -115,11 +115,11 @@ static bool checkIfSeekiosInZone(Coordinate zoneCoordinates[NB_MAX_COORDINATES],
 		strcat(buf,"\r\n");
 		USARTManager_printUsbWait(buf);
 		USARTManager_printUsbWait("Distance: ");
-		stringHelper_doubleToString(minDistanceFromZone,buf,2);
+		stringHelper_fixedPointToString(stringHelper_toFixedPoint(minDistanceFromZone, 2), buf, 2);
 		strcat(buf,"\r\n");
 		USARTManager_printUsbWait(buf);
 		USARTManager_printUsbWait("Speed: ");
-		stringHelper_doubleToString(lastSatelliteData.speed,buf,2);
+		stringHelper_fixedPointToString(stringHelper_toFixedPoint(lastSatelliteData.speed, 2), buf, 2);
 		strcat(buf,"\r\n");
 		USARTManager_printUsbWait(buf);		
 		if (counterOutOfZone>=OUT_OF_ZONE_THRESHOLD)//on attend 60 itrations OutOfZone d'affile
@@ -141,45 +141,17 @@ static void setZoneWaitSignificantMotitionState()
 }
 
 /* Returns 0 if the seekios is in the zone, or the minimum distance from the zone if out of the zone */
-static double getMinDistanceFromZone(Coordinate *seekiosLocationPtr, int nbCoordinates, Coordinate* zoneCoordinates){
-	double minDistance;
-	
-	if(geolocationTools_isPositionInZone(seekiosLocationPtr,nbCoordinates,zoneCoordinates))
+static double getMinDistanceFromZone(Coordinate *seekiosLocationPtr, CompiledZone *zonePtr){
+	LocalPoint seekiosPoint;
+	geolocationTools_projectOnZone(zonePtr, seekiosLocationPtr, &seekiosPoint);
+	uint32_t minDistance = geolocationTools_getDistanceToCompiledZone(zonePtr, &seekiosPoint);
+	if(minDistance == 0)
 	{
 		return 0;
 	}
-	
-	minDistance=getMinDistanceFromEdges(seekiosLocationPtr, nbCoordinates, zoneCoordinates);
-		
-	return minDistance;
-}
-
-//On calcule la distance entre le Seekios et les segments de la zone (hauteur)
-static double getMinDistanceFromEdges(Coordinate *seekiosLocationPtr,int nbEdges, Coordinate *zonePointsPtr)
-{
-	double minDistance = geolocationTools_getShortestDistanceFromEdge(
-	zonePointsPtr[0].lat,
-	zonePointsPtr[0].lon,
-	zonePointsPtr[(1)%nbEdges].lat,
-	zonePointsPtr[(1)%nbEdges].lon,
-	seekiosLocationPtr);
-
-	for(int i=1; i<nbEdges; i++){
-
-		double tempDistance = geolocationTools_getShortestDistanceFromEdge(
-		zonePointsPtr[i].lat,
-		zonePointsPtr[i].lon,
-		zonePointsPtr[(i+1)%nbEdges].lat,
-		zonePointsPtr[(i+1)%nbEdges].lon,
-		seekiosLocationPtr);
-
-		if(tempDistance < minDistance){
-			minDistance = tempDistance;
-		}
-	}
 
 	char buff[16];
-	stringHelper_doubleToString(minDistance, buff, 0);
+	stringHelper_intToString(minDistance, (uint8_t*)buff);
 	USARTManager_printUsbWait("Shortest distance to zone : ");
 	USARTManager_printUsbWait(buff);
 	USARTManager_printUsbWait("m\r\n");
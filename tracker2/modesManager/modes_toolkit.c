@@ -2,11 +2,20 @@
 static void wakeUpModeCallback(struct calendar_descriptor *const calendar);
 static void wakeUpGpsCallback(struct calendar_descriptor *const calendar);
 static uint32_t convertMsToSec(int delayMs);
+static bool addTrackDelta(int32_t lat, int32_t lon, int16_t alt, time_t timestamp);
+static bool takeTrackSegment(OutputMessage* messagePtr);
 
 static struct calendar_alarm _wakeUpModeAlarm;		// used to wake-up modes (refresh rates, in time etc)
 static struct calendar_alarm _wakeUpGpsAlarm;		// used to wake-up modes (refresh rates, in time etc)
 static bool _seekiosMovedSinceLastCycle = true;
 static SatelliteCoordinate _lastTrackingCoordinate;
+static OutputMessage _trackSegmentMessage;	// fixes not sent yet by the tracking modes
+static bool _trackSegmentStarted = false;
+static int32_t _trackSegmentLastLat;			// last fix of the segment, in 1/TRACK_SEGMENT_COORDINATE_SCALE degree
+static int32_t _trackSegmentLastLon;
+static int16_t _trackSegmentLastAlt;
+static time_t _trackSegmentLastTimestamp;
+static float _trackSegmentFirstHDOP;			// kept for a segment sent as a single tracking message
 
 void modesToolkit_wrapMessageAndSend(SatelliteCoordinate *gpsDataPtr, E_MESSAGE_TYPE messageType, void (*callbackFunction)(void), uint32_t modeId){//, time_t timestamp){
 	OutputMessage message;
@@ -49,6 +58,11 @@ void modesToolkit_removeTrackingPeriodAlarm(void){
 void modesToolkit_removeGpsAlarm()
 {
 	RTCManager_removeAlarm(&_wakeUpGpsAlarm);
+	GPSPowerPolicy_clearNextUse();
+	if(GPSManager_isGPSInStandby())
+	{
+		GPSManager_powerOffGPS(); // no more scheduled use : the standby is not worth it
+	}
 }
 
 bool modesUtilities_isTrackingPeriodAlarmScheduled()
@@ -85,6 +99,7 @@ void modesToolkit_setAlarmGpsDelay(uint32_t delayMs)
 {
 	uint32_t delaySec = convertMsToSec(delayMs);
 	RTCManager_setDelayedCallback(delaySec, &_wakeUpGpsAlarm, wakeUpGpsCallback);
+	GPSPowerPolicy_setNextUse(delaySec);
 }
 
 static void wakeUpModeCallback(struct calendar_descriptor *const calendar){
@@ -154,4 +169,116 @@ void modesToolkit_setPreviousPosition(SatelliteCoordinate *gpsDataPtr)
 	_lastTrackingCoordinate.fixQuality = gpsDataPtr->fixQuality;
 	_lastTrackingCoordinate.hDOP = gpsDataPtr->hDOP;
 	_lastTrackingCoordinate.satellitesNumber = gpsDataPtr->satellitesNumber;
-}
\ No newline at end of file
+}
+
+/* Adds a tracking fix to the current track segment. The segment is sent when it is full, or when the next fix would make it older than TRACK_SEGMENT_MAX_AGE.
+A segment holding a single fix is sent as a normal tracking message */
+void modesToolkit_addToTrackSegment(SatelliteCoordinate *gpsDataPtr, E_MESSAGE_TYPE trackingMessageType, void (*callbackFunction)(void), uint32_t modeId, uint32_t nextFixDelaySec)
+{
+	int32_t lat = lround(gpsDataPtr->coordinate.lat * TRACK_SEGMENT_COORDINATE_SCALE);
+	int32_t lon = lround(gpsDataPtr->coordinate.lon * TRACK_SEGMENT_COORDINATE_SCALE);
+	int16_t alt = lround(gpsDataPtr->coordinate.alt);
+	time_t timestamp = RTCManager_getCurrentTimestamp();
+
+	taskENTER_CRITICAL();
+	if(_trackSegmentStarted
+	&& (_trackSegmentMessage.content.trackSegment.trackingMessageType != trackingMessageType
+	|| _trackSegmentMessage.modeId != modeId
+	|| !addTrackDelta(lat, lon, alt, timestamp)))
+	{
+		taskEXIT_CRITICAL();
+		/* This fix can't be added : the segment is sent and the fix starts a new one */
+		modesToolkit_flushTrackSegment();
+		taskENTER_CRITICAL();
+	}
+	if(!_trackSegmentStarted)
+	{
+		_trackSegmentMessage.messageType = MESSAGE_TYPE_TRACK_SEGMENT;
+		_trackSegmentMessage.timestamp = timestamp;
+		_trackSegmentMessage.onSendSuccess = callbackFunction;
+		_trackSegmentMessage.modeId = modeId;
+		_trackSegmentMessage.content.trackSegment.trackingMessageType = trackingMessageType;
+		_trackSegmentMessage.content.trackSegment.lat = lat;
+		_trackSegmentMessage.content.trackSegment.lon = lon;
+		_trackSegmentMessage.content.trackSegment.alt = alt;
+		_trackSegmentMessage.content.trackSegment.nbDeltas = 0;
+		_trackSegmentLastLat = lat;
+		_trackSegmentLastLon = lon;
+		_trackSegmentLastAlt = alt;
+		_trackSegmentLastTimestamp = timestamp;
+		_trackSegmentFirstHDOP = gpsDataPtr->hDOP;
+		_trackSegmentStarted = true;
+	}
+	bool segmentReady = _trackSegmentMessage.content.trackSegment.nbDeltas == TRACK_SEGMENT_MAX_DELTAS
+	|| timestamp + nextFixDelaySec - _trackSegmentMessage.timestamp > TRACK_SEGMENT_MAX_AGE;
+	taskEXIT_CRITICAL();
+
+	if(segmentReady)
+	{
+		modesToolkit_flushTrackSegment();
+	}
+}
+
+/* Sends the fixes of the current track segment. Called by the seekios manager when the mode is stopped */
+void modesToolkit_flushTrackSegment()
+{
+	OutputMessage message;
+	if(takeTrackSegment(&message))
+	{
+		messageSender_addToSendList(&message);
+	}
+}
+
+/* Returns false if the fix is too far from the previous one to be stored as a delta, or if the segment is full */
+static bool addTrackDelta(int32_t lat, int32_t lon, int16_t alt, time_t timestamp)
+{
+	TrackSegment* segmentPtr = &_trackSegmentMessage.content.trackSegment;
+	int32_t deltaTime = timestamp - _trackSegmentLastTimestamp;
+	int32_t deltaLat = lat - _trackSegmentLastLat;
+	int32_t deltaLon = lon - _trackSegmentLastLon;
+	int32_t deltaAlt = alt - _trackSegmentLastAlt;
+	if(segmentPtr->nbDeltas >= TRACK_SEGMENT_MAX_DELTAS
+	|| deltaTime < 0 || deltaTime > INT16_MAX
+	|| deltaLat < INT16_MIN || deltaLat > INT16_MAX
+	|| deltaLon < INT16_MIN || deltaLon > INT16_MAX
+	|| deltaAlt < INT16_MIN || deltaAlt > INT16_MAX)
+	{
+		return false;
+	}
+	segmentPtr->deltas[segmentPtr->nbDeltas].time = deltaTime;
+	segmentPtr->deltas[segmentPtr->nbDeltas].lat = deltaLat;
+	segmentPtr->deltas[segmentPtr->nbDeltas].lon = deltaLon;
+	segmentPtr->deltas[segmentPtr->nbDeltas].alt = deltaAlt;
+	segmentPtr->nbDeltas++;
+	_trackSegmentLastLat = lat;
+	_trackSegmentLastLon = lon;
+	_trackSegmentLastAlt = alt;
+	_trackSegmentLastTimestamp = timestamp;
+	return true;
+}
+
+/* Copies the current track segment to the message and empties it. Returns false if there was no fix to send */
+static bool takeTrackSegment(OutputMessage* messagePtr)
+{
+	taskENTER_CRITICAL();
+	bool started = _trackSegmentStarted;
+	float firstHDOP = _trackSegmentFirstHDOP;
+	if(started)
+	{
+		memcpy(messagePtr, &_trackSegmentMessage, sizeof(OutputMessage));
+		_trackSegmentStarted = false;
+	}
+	taskEXIT_CRITICAL();
+
+	if(started && messagePtr->content.trackSegment.nbDeltas == 0)
+	{
+		/* Single fix : sent like before, the server doesn't need to handle a segment */
+		TrackSegment segment = messagePtr->content.trackSegment;
+		messagePtr->messageType = segment.trackingMessageType;
+		messagePtr->content.satelliteCoordinate.coordinate.lat = (double)segment.lat / TRACK_SEGMENT_COORDINATE_SCALE;
+		messagePtr->content.satelliteCoordinate.coordinate.lon = (double)segment.lon / TRACK_SEGMENT_COORDINATE_SCALE;
+		messagePtr->content.satelliteCoordinate.coordinate.alt = segment.alt;
+		messagePtr->content.satelliteCoordinate.hDOP = firstHDOP;
+	}
+	return started;
+}
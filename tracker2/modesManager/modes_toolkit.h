@@ -2,6 +2,7 @@
 #define MODES_TOOLKIT_H_
 
 #include <string.h>
+#include <math.h>
 #include <peripheralManager/USART_manager.h>
 #include <statusManager/status_manager.h>
 #include <messageSender/message_sender.h>
@@ -9,6 +10,8 @@
 #include <peripheralManager/GPS_manager.h>
 #include <peripheralManager/bma222_adapted.h>
 
+#define TRACK_SEGMENT_MAX_AGE	900 // in sec. A track segment is sent before its first fix gets older, even if it is not full
+
 void modesToolkit_wrapMessageAndSend(SatelliteCoordinate *gpsDataPtr, E_MESSAGE_TYPE messageType, void (*callbackFunction)(void), uint32_t modeId);//, time_t timestamp);
 void test_setAlarmModeDelay(int delayMs);
 void modesToolkit_removeTrackingPeriodAlarm(void);
@@ -31,4 +34,6 @@ void modesToolkit_setPreviousPosition(SatelliteCoordinate *gpsDataPtr);
 void modesToolkit_sleepGpsUntilNextCycle(uint32_t timeToWaitms);
 void modesToolkit_sleepModeUntilNextCycle(uint32_t timeToWaitMs);
 void modesToolkit_printGpsAlarm(void);
+void modesToolkit_addToTrackSegment(SatelliteCoordinate *gpsDataPtr, E_MESSAGE_TYPE trackingMessageType, void (*callbackFunction)(void), uint32_t modeId, uint32_t nextFixDelaySec);
+void modesToolkit_flushTrackSegment(void);
 #endif /* MODES_TOOLKIT_H_ */
\ No newline at end of file
@@ -46,7 +46,11 @@ void tracking_infiniteTracking(E_MESSAGE_TYPE trackingMessageType, int refreshRa
 		GPSManager_addGPSLog(&gpsData);
 		#endif
 
+		#if (TRACK_SEGMENTS_ACTIVATED == 1)
+		modesToolkit_addToTrackSegment(&gpsData, trackingMessageType, raiseMessageSentTracking, statusManager_getRunningConfigModeId(), refreshRateMin * 60);
+		#else
 		modesToolkit_wrapMessageAndSend(&gpsData, trackingMessageType, raiseMessageSentTracking, statusManager_getRunningConfigModeId());//, gpsData.fixTimestamp);
+		#endif
 		
 		modesToolkit_startTrackingSlopeDetection();
 
@@ -59,12 +63,13 @@ void tracking_infiniteTracking(E_MESSAGE_TYPE trackingMessageType, int refreshRa
 			USARTManager_printInt(timeToWait);
 			USARTManager_printUsbWait("\r\n");
 			
-			bool gpsShouldSleep = timeToWait > GPS_WARMUP_TIME;
+			uint32_t gpsWarmupTime = GPSPowerPolicy_getWarmupTime(timeToWait);
+			bool gpsShouldSleep = timeToWait > gpsWarmupTime;
 			
 			if(gpsShouldSleep)
 			{
 				USARTManager_printUsbWait("Putting GPS to sleep.\r\n");
-				modesToolkit_sleepGpsUntilNextCycle(timeToWait - GPS_WARMUP_TIME);
+				modesToolkit_sleepGpsUntilNextCycle(timeToWait - gpsWarmupTime);
 			}
 			
 			USARTManager_printUsbWait("Putting mode to sleep.\r\n");
@@ -6,16 +6,22 @@ static void initCoordinate(SatelliteCoordinate *coordinatePtr);
 static void setCurrentPosition(SatelliteCoordinate *coordinatePtr);
 static bool waitCurrentPosition(SatelliteCoordinate *result, TickType_t timeout, EventBits_t bit);
 static void setAnswerCurrentPositionFlags(void);
-static int computeChecksumFromNMEA(char *sentence,uint8_t numberOfNMEA);
-static int validateChecksum(char * nmea,uint8_t numberOfNMEA);
-static uint8_t getStarIndex(char* nmea,uint8_t numberOfNMEA);
-static bool waitGGAFrame(uint8_t* resultBuf, uint32_t timeout);
+#if (FAKE_POSITIONS_ACTIVATED==1)
+static bool validateChecksum(const char* nmea, uint8_t numberOfNMEA);
+#endif
+static const char* nextNMEAField(const char* field);
+static bool isNMEAFieldEmpty(const char* field);
+static bool parseNMEAFixedPoint(const char* field, uint8_t nbDecimals, int32_t* resultPtr);
+static int parseGGA(const char* sentence, SatelliteCoordinate *currentlocationPtr);
+static void parseRMC(const char* sentence, SatelliteCoordinate *currentlocationPtr);
+static bool waitGGAFrame(uint32_t timeout);
 static void clearNMEAAvailableBit(void);
 
 static EventGroupHandle_t _gpsMaskhandle;
 static SatelliteCoordinate _currentPosition;
 static struct calendar_alarm _gpsExpirationAlarm;
 static bool _isGpsOn;
+static bool _isGpsInStandby;
 
 #if (ACTIVATE_GPS_LOGS == 1)
 #define GPS_LOG_COUNT 64
@@ -31,6 +37,8 @@ static uint8_t wrongNMEABuffer[100]={0};
 void GPSManager_init(){
 	_gpsMaskhandle = xEventGroupCreate();
 	_isGpsOn= false;
+	_isGpsInStandby = false;
+	GPSPowerPolicy_init();
 	clearAllcurPosRequestFlag();
 	clearAllcurPosAnswerFlag();
 }
@@ -50,7 +58,6 @@ void task_GPSManager(void* param){
 	UNUSED(wm);
 	USARTManager_printUsbWait("GPS Manager stopped !\r\n");
 	maskUtilities_clearRunningMaskBits(RUNNING_BIT_GPS_MANAGER);
-	FreeRTOSOverlay_taskDelete(NULL);
 }
 
 static void GPSSessionExpirationCallback(){
@@ -64,7 +71,7 @@ bool GPSManager_isGPSExpirationAlarmScheduled(){
 void GPSManager_scheduleGPSExpirationAlarm(){
 	GPSManager_removeGPSExpirationAlarm();
 	USARTManager_printUsbWait("GPS EXPIRATION : ");
-	RTCManager_setDelayedCallback(GPS_EXPIRATION_TIME*60, & _gpsExpirationAlarm, GPSSessionExpirationCallback);
+	RTCManager_setDelayedCallbackInWindow(GPS_EXPIRATION_TIME*60, GPS_EXPIRATION_WINDOW, & _gpsExpirationAlarm, GPSSessionExpirationCallback);
 }
 
 void GPSManager_removeGPSExpirationAlarm(){
@@ -107,6 +114,10 @@ void GPSManager_getGPSData()
 		if(GPSManager_waitCoordinate(&tempCoordinate, GPS_READING_TIMEOUT) == GPS_RESPONSE_STATUS_FRAME_PARSED)
 		{
 			setCurrentPosition(&tempCoordinate);
+			GPSPowerPolicy_recordFix(tempCoordinate.satellitesNumber);
+			#if (ENERGY_PROFILER_ACTIVATED == 1)
+			energyProfiler_setState(ENERGY_DOMAIN_GPS, ENERGY_STATE_GPS_TRACKING);
+			#endif
 			memset(gps_buf, 0, GPS_BUF_SIZE);
 			setAnswerCurrentPositionFlags();
 			initCoordinate(&tempCoordinate);
@@ -125,14 +136,13 @@ void GPSManager_getGPSData()
 E_GPS_RESPONSE_STATUS GPSManager_waitCoordinate(SatelliteCoordinate *resultCoordinatePtr, uint32_t timeout)
 {
 	E_GPS_RESPONSE_STATUS responseStatus = GPS_RESPONSE_STATUS_NONE;
-	//volatile char sentenceBuffer[256];
-	if(waitGGAFrame(gps_buf, timeout))
+	if(waitGGAFrame(timeout))
 	{
 		responseStatus = GPS_RESPONSE_STATUS_FRAME_RECEIVED;
 		#if (ACTIVATE_NMEA_FRAME_PRINT==1)
 		USARTManager_printUsbWait(gps_buf);
 		#endif
-		if (parse_sentence(gps_buf,resultCoordinatePtr) == FUNCTION_SUCCESS)
+		if (parse_sentence((char*)gps_buf,resultCoordinatePtr) == FUNCTION_SUCCESS) // parsed in place : gps_buf is not overwritten until the next wait
 		{
 			//volatile UBaseType_t wm = uxTaskGetStackHighWaterMark(NULL);
 			
@@ -142,93 +152,90 @@ E_GPS_RESPONSE_STATUS GPSManager_waitCoordinate(SatelliteCoordinate *resultCoord
 	return responseStatus;
 }
 
-/* Computes the checksum of the NMEA frame, then compares it to what was contained in the frame */
-static int validateChecksum( char * nmea, uint8_t numberOfNMEA)
+void GPSManager_initNMEAChecksum(NMEAChecksum* checksumPtr)
 {
-	uint8_t nmeaIndex=0;
-	while (nmeaIndex<numberOfNMEA)
+	checksumPtr->computed = 0;
+	checksumPtr->given = 0;
+	checksumPtr->nbGivenDigits = 0;
+	checksumPtr->starFound = false;
+	checksumPtr->status = NMEA_CHECKSUM_PENDING;
+}
+
+/* Updates the checksum with the next received char. Can be called from the reception interrupt.
+The XOR is done on the chars between $ and *, then compared to the 2 hex digits after the * */
+E_NMEA_CHECKSUM_STATUS GPSManager_updateNMEAChecksum(NMEAChecksum* checksumPtr, char receivedChar)
+{
+	if(receivedChar == '$')
 	{
-		volatile uint8_t computedCheckSum = computeChecksumFromNMEA(nmea,nmeaIndex);
-		volatile uint8_t starIndex = getStarIndex(nmea,nmeaIndex);
-		if(starIndex == 0)
+		GPSManager_initNMEAChecksum(checksumPtr);
+	}
+	else if(checksumPtr->status != NMEA_CHECKSUM_PENDING)
+	{
+		// already decided, waiting for the next sentence
+	}
+	else if(!checksumPtr->starFound)
+	{
+		if(receivedChar == '*')
 		{
-			return false;
+			checksumPtr->starFound = true;
 		}
-		char gotSum[3];
-		//On rcupre le checksum de la trame nmea
-		gotSum[0] = nmea[starIndex + 1];
-		gotSum[1] = nmea[starIndex + 2];
-		gotSum[2] = '\0';
-		
-		//On passe du format "HEX string"  int
-		int givenChecksum = (int)strtol(gotSum, NULL, 16);
-		//On compare le checksum calcul avec celui de la trame
-		if(givenChecksum != computedCheckSum)
+		else
 		{
-			USARTManager_printUsbWait("GPS MANAGER: checksum FAILED\r\n");
-			USARTManager_printUsbWait("Compu CS :");
-			USARTManager_printByte(computedCheckSum);
-			USARTManager_printUsbWait("\r\nGiven CS :");
-			USARTManager_printByte(givenChecksum);
-			USARTManager_printUsbWait("\r\n");
-			return false;
+			checksumPtr->computed ^= (uint8_t)receivedChar;
 		}
-		nmeaIndex++;
 	}
-	return true;
-}
-
-static uint8_t getStarIndex(char* nmea,uint8_t nmeaIndex)
-{
-	uint8_t nmeaLength = strlen(nmea);
-	uint8_t starCounter=0;
-	
-	for(uint8_t i=0;i< nmeaLength - 2; i++)
+	else
 	{
-		if(nmea[i] == '*')
+		uint8_t digit;
+		if(receivedChar >= '0' && receivedChar <= '9') digit = receivedChar - '0';
+		else if(receivedChar >= 'A' && receivedChar <= 'F') digit = receivedChar - 'A' + 10;
+		else if(receivedChar >= 'a' && receivedChar <= 'f') digit = receivedChar - 'a' + 10;
+		else
 		{
-			if (starCounter==nmeaIndex)
-			{
-				return i;
-			}
-			starCounter++;
+			checksumPtr->status = NMEA_CHECKSUM_INVALID;
+			return checksumPtr->status;
+		}
+		checksumPtr->given = (checksumPtr->given << 4) | digit;
+		checksumPtr->nbGivenDigits++;
+		if(checksumPtr->nbGivenDigits == 2)
+		{
+			checksumPtr->status = checksumPtr->given == checksumPtr->computed ? NMEA_CHECKSUM_VALID : NMEA_CHECKSUM_INVALID;
 		}
 	}
-	return 0;
+	return checksumPtr->status;
 }
 
-static int computeChecksumFromNMEA(char *sentence,uint8_t nmeaIndex)
+#if (FAKE_POSITIONS_ACTIVATED==1)
+/* Checks the checksum of the numberOfNMEA first sentences, in one pass.
+The real frames are already checked by the reception interrupt */
+static bool validateChecksum(const char* nmea, uint8_t numberOfNMEA)
 {
-	uint8_t i;
-	uint8_t XOR;
-	uint8_t c;
-	uint8_t starCounter=0;
-	bool dollar=true;
-	
-	for (XOR = 0, i = 0; i < strlen(sentence); i++)
+	NMEAChecksum checksum;
+	E_NMEA_CHECKSUM_STATUS status = NMEA_CHECKSUM_PENDING;
+	uint8_t nmeaIndex = 0;
+	GPSManager_initNMEAChecksum(&checksum);
+	for(; *nmea != '\0' && nmeaIndex < numberOfNMEA; nmea++)
 	{
-		c = (unsigned char)sentence[i];
-		if (c == '$')
+		if(*nmea != '\n')
 		{
-			dollar=true;
+			status = GPSManager_updateNMEAChecksum(&checksum, *nmea);
+			continue;
 		}
-		if (c == '*')
+		if(status != NMEA_CHECKSUM_VALID)
 		{
-			dollar=false;
-			if (starCounter==nmeaIndex)
-			{
-				break;
-			}
-			else
-			{
-				starCounter++;
-				XOR=0;
-			}
+			USARTManager_printUsbWait("GPS MANAGER: checksum FAILED\r\n");
+			USARTManager_printUsbWait("Compu CS :");
+			USARTManager_printByte(checksum.computed);
+			USARTManager_printUsbWait("\r\nGiven CS :");
+			USARTManager_printByte(checksum.given);
+			USARTManager_printUsbWait("\r\n");
+			return false;
 		}
-		if (c != '$' && dollar) XOR ^= c;
+		nmeaIndex++;
 	}
-	return XOR;
+	return nmeaIndex == numberOfNMEA;
 }
+#endif
 
 static void initCoordinate(SatelliteCoordinate *coordinate){
 	coordinate->hDOP=5;
@@ -268,124 +275,187 @@ void GPSManager_copySatelliteCoordinate(SatelliteCoordinate *dest, SatelliteCoor
 	dest->trackAngle		=src->trackAngle;
 }
 
+/* Parses the GXGGA sentence then the GXRMC sentence, in place : the fields are decoded directly from the buffer
+in fixed point, without copying the tokens */
 int parse_sentence(char *sentenceBuffer, SatelliteCoordinate *currentlocationPtr)
 {
-	int paramTokenCounter=0;
-	char *token=NULL;
-	char orientationLatLong[4];
-	char tempLatLongAlt[16];
-
 	currentlocationPtr->coordinate.lat=90;
 	currentlocationPtr->coordinate.lon=180;
 
-	for (token = strtok_single(sentenceBuffer, ","); token != NULL; token = strtok_single(NULL, ","))
-	{
-		//$GPGGA,064036.289,4836.5375,N,00740.9373,E,1,04,3.2,200.2,M,,,,0000*0E\r\n$GPRMC,181403.000,A,4327.8864,N,00129.5422,W,0.11,0.00,080317,,,A*75
-		// Pour chaque valeur de paramTokenCounter :
-		//	0 - $GPGGA       : Type de trame
-		//	1 - 064036.289   : Trame envoye  06h 40m 36,289s (heure UTC)
-		//	2 - 4836.5375	 : Latitude 48,608958	    }==>
-		//  3 - N			 : Nord					    }==> = 4836'32.25" Nord
-		//	4 - 00740.9373	 : Longitude 7,682288	    }==>
-		//  5 - E			 : Est						}==> = 740'56.238" Est
-		//	6 - 1            : Fix quality : 0 invalid, 1 GPS fix, 2 DGPS fix, 3 PPS Fix, 4 Real time Kinetic, 5 float RTK, 6 estimated, 7 Manual input mode, 8 Simulation mode
-		//	7 - 04           : Nombre de satellites utiliss pour calculer les coordonnes
-		//	8 - 3.2          : Prcision horizontale ou HDOP (Horizontal dilution of precision)
-		//	9 - 200.2		 : Altitude 200,2
-		// 10 - M			 : en mtres
-		//11+ -	,,,,,0000    : D'autres informations peuvent tre inscrites dans ces champs
-		//	  - *0E          : Somme de contrle de parit, un simple XOR sur les caractres entre $ et *3
-
-		switch (paramTokenCounter)
+	if(parseGGA(sentenceBuffer, currentlocationPtr) != FUNCTION_SUCCESS)
+	{
+		return FUNCTION_FAILURE;
+	}
+
+	const char* rmcSentence = strchr(sentenceBuffer, '\n');
+	if(rmcSentence != NULL && rmcSentence[1] == '$')
+	{
+		parseRMC(rmcSentence + 1, currentlocationPtr);
+	}
+	
+	if (currentlocationPtr->coordinate.lon>-180 && currentlocationPtr->coordinate.lon<180
+	&& currentlocationPtr->coordinate.lat>-90 && currentlocationPtr->coordinate.lat<90)
+	{
+		//Get actual date to set fix acquisition date
+		//currentlocationPtr->fixTimestamp = RTCManager_getCurrentTimestamp();
+		return FUNCTION_SUCCESS;
+	}
+	else return FUNCTION_FAILURE;
+}
+
+/* $GPGGA,064036.289,4836.5375,N,00740.9373,E,1,04,3.2,200.2,M,,,,0000*0E
+Pour chaque champ :
+	0 - $GPGGA       : Type de trame
+	1 - 064036.289   : Trame envoye  06h 40m 36,289s (heure UTC)
+	2 - 4836.5375	 : Latitude 48,608958	    }==>
+	3 - N			 : Nord					    }==> = 4836'32.25" Nord
+	4 - 00740.9373	 : Longitude 7,682288	    }==>
+	5 - E			 : Est						}==> = 740'56.238" Est
+	6 - 1            : Fix quality : 0 invalid, 1 GPS fix, 2 DGPS fix, 3 PPS Fix, 4 Real time Kinetic, 5 float RTK, 6 estimated, 7 Manual input mode, 8 Simulation mode
+	7 - 04           : Nombre de satellites utiliss pour calculer les coordonnes
+	8 - 3.2          : Prcision horizontale ou HDOP (Horizontal dilution of precision)
+	9 - 200.2		 : Altitude 200,2
+	10 - M			 : en mtres
+	11+ - ,,,,0000   : D'autres informations peuvent tre inscrites dans ces champs
+		- *0E        : Somme de contrle de parit, un simple XOR sur les caractres entre $ et * */
+static int parseGGA(const char* sentence, SatelliteCoordinate *currentlocationPtr)
+{
+	const char* field = sentence;
+	int32_t value = 0;
+	int32_t latitude = 0;
+	int32_t longitude = 0;
+
+	for(uint8_t fieldIndex = 0; field != NULL && fieldIndex <= 10; fieldIndex++, field = nextNMEAField(field))
+	{
+		switch (fieldIndex)
 		{
-			case 0:break;
-			case 1:break;
-			//	2 - 4836.5375	 : Latitude 48,608958
 			case 2:
-			if(token[0]==0){return FUNCTION_FAILURE;}
-			strcpy(tempLatLongAlt,token);
+			if(!parseNMEAFixedPoint(field, NMEA_LAT_LON_DECIMALS, &latitude)){return FUNCTION_FAILURE;}
 			break;
-			//  3 - N			 : Nord
 			case 3:
-			if(token[0]==0){return FUNCTION_FAILURE;}
-			strcpy(orientationLatLong,token);
-			currentlocationPtr->coordinate.lat=convertNMEA(tempLatLongAlt,orientationLatLong);
-			//currentlocationPtr->coordinate.latDMS=strtod(tempLatLongAlt,NULL);
+			if(isNMEAFieldEmpty(field)){return FUNCTION_FAILURE;}
+			currentlocationPtr->coordinate.lat=convertNMEA(latitude, field[0]);
 			break;
-			//	4 - 00740.9373	 : Longitude 7,682288
 			case 4:
-			if(token[0]==0){return FUNCTION_FAILURE;}
-			strcpy(tempLatLongAlt,token);
+			if(!parseNMEAFixedPoint(field, NMEA_LAT_LON_DECIMALS, &longitude)){return FUNCTION_FAILURE;}
 			break;
-			//  5 - E			 : Est
 			case 5:
-			if(token[0]==0){return FUNCTION_FAILURE;}
-			strcpy(orientationLatLong,token);
-			currentlocationPtr->coordinate.lon=convertNMEA(tempLatLongAlt,orientationLatLong);
-			//currentlocationPtr->coordinate.lonDMS=strtod(tempLatLongAlt,NULL);
+			if(isNMEAFieldEmpty(field)){return FUNCTION_FAILURE;}
+			currentlocationPtr->coordinate.lon=convertNMEA(longitude, field[0]);
 			break;
-			//	6 - 1            : Type de positionnement (le 1 est un positionnement GPS)
 			case 6:
-			if (atoi(token) != FIX_QUALITY_GPS 
-			&& atoi(token) != FIX_QUALITY_DGPS)
+			parseNMEAFixedPoint(field, 0, &value);
+			if (isNMEAFieldEmpty(field)
+			|| (value != FIX_QUALITY_GPS && value != FIX_QUALITY_DGPS))
 			{
 				#if (ACTIVATE_WRONG_NMEA_FRAME_LOGS == 1)
-				memcpy(wrongNMEABuffer, sentenceBuffer, 100);
+				memcpy(wrongNMEABuffer, sentence, 100);
 				#endif
 				return FUNCTION_FAILURE;
 			}
-			currentlocationPtr->fixQuality = atoi(token);
+			currentlocationPtr->fixQuality = value;
 			break;
-			//	7 - 04           : Nombre de satellites utiliss pour calculer les coordonnes
 			case 7:
-			if(token[0]==0){return FUNCTION_FAILURE;}
-			currentlocationPtr->satellitesNumber=atoi(token);
+			if(!parseNMEAFixedPoint(field, 0, &value)){return FUNCTION_FAILURE;}
+			currentlocationPtr->satellitesNumber=value;
 			break;
-			//	8 - 3.2          : Prcision horizontale ou HDOP (Horizontal dilution of precision)
 			case 8:
-			if(token[0]==0){return FUNCTION_FAILURE;}
-			currentlocationPtr->hDOP=strtod(token,NULL);
+			if(!parseNMEAFixedPoint(field, 2, &value)){return FUNCTION_FAILURE;}
+			currentlocationPtr->hDOP=value / 100.0f;
 			break;
-			//	9 - 200.2		 : Altitude 200,2
 			case 9:
-			strcpy(tempLatLongAlt,token);
+			if(!parseNMEAFixedPoint(field, NMEA_ALTITUDE_DECIMALS, &value)){value = 0;}
 			break;
-			// 10 - M			 : en mtres
 			case 10:
-			if (token[0]=='M'){
-				currentlocationPtr->coordinate.alt=strtod(tempLatLongAlt,NULL);
+			if (field[0]=='M'){
+				currentlocationPtr->coordinate.alt=value / 100.0f;
 			}
 			break;
-			case 11:break;
-			case 12:break;
-			case 13:break;
-			case 14:break;
-			case 15:break;
-			case 16:break;
-			case 17:break;
-			case 18:break;
-			case 19:break;
-			case 20:break;
-			case 21:
-			currentlocationPtr->speed=strtod(token,NULL);
-			currentlocationPtr->speed*=1.852;//noeuds->km/h
-			break;
-			case 22:
-			currentlocationPtr->trackAngle=strtod(token,NULL);
-			break;
 			default:break;
 		}
-		paramTokenCounter++;
 	}
-	
-	if (currentlocationPtr->coordinate.lon>-180 && currentlocationPtr->coordinate.lon<180
-	&& currentlocationPtr->coordinate.lat>-90 && currentlocationPtr->coordinate.lat<90)
+	return FUNCTION_SUCCESS;
+}
+
+/* $GPRMC,181403.000,A,4327.8864,N,00129.5422,W,0.11,0.00,080317,,,A*75
+Only the speed (7, in knots) and the track angle (8) are used, the position comes from the GGA */
+static void parseRMC(const char* sentence, SatelliteCoordinate *currentlocationPtr)
+{
+	const char* field = sentence;
+	int32_t value = 0;
+
+	for(uint8_t fieldIndex = 0; field != NULL && fieldIndex <= 8; fieldIndex++, field = nextNMEAField(field))
 	{
-		//Get actual date to set fix acquisition date
-		//currentlocationPtr->fixTimestamp = RTCManager_getCurrentTimestamp();
-		return FUNCTION_SUCCESS;
+		if(fieldIndex == 7)
+		{
+			parseNMEAFixedPoint(field, 2, &value);
+			currentlocationPtr->speed=value * 1.852f / 100;//noeuds->km/h
+		}
+		else if(fieldIndex == 8)
+		{
+			parseNMEAFixedPoint(field, 2, &value);
+			currentlocationPtr->trackAngle=value / 100.0f;
+		}
 	}
-	else return FUNCTION_FAILURE;
+}
+
+/* Returns the start of the next field, or NULL at the end of the sentence */
+static const char* nextNMEAField(const char* field)
+{
+	while(*field != ',' && *field != '*' && *field != '\n' && *field != '\0')
+	{
+		field++;
+	}
+	return *field == ',' ? field + 1 : NULL;
+}
+
+static bool isNMEAFieldEmpty(const char* field)
+{
+	return *field == ',' || *field == '*' || *field == '\r' || *field == '\n' || *field == '\0';
+}
+
+/* Decodes a decimal field as an integer scaled by 10^nbDecimals (ex : "3.27" with 2 decimals gives 327).
+The extra decimals are truncated. Returns false if the field has no digit, the result is then 0 */
+static bool parseNMEAFixedPoint(const char* field, uint8_t nbDecimals, int32_t* resultPtr)
+{
+	int32_t result = 0;
+	bool isNegative = false;
+	bool digitFound = false;
+	bool pointFound = false;
+	uint8_t nbReadDecimals = 0;
+
+	if(*field == '-')
+	{
+		isNegative = true;
+		field++;
+	}
+	for(; !isNMEAFieldEmpty(field); field++)
+	{
+		if(*field == '.')
+		{
+			pointFound = true;
+		}
+		else if(*field >= '0' && *field <= '9')
+		{
+			digitFound = true;
+			if(pointFound && nbReadDecimals >= nbDecimals)
+			{
+				continue;
+			}
+			if(pointFound)
+			{
+				nbReadDecimals++;
+			}
+			result = result * 10 + (*field - '0');
+		}
+		else break;
+	}
+	for(; nbReadDecimals < nbDecimals; nbReadDecimals++)
+	{
+		result *= 10;
+	}
+	*resultPtr = digitFound ? (isNegative ? -result : result) : 0;
+	return digitFound;
 }
 
 /* Returns true if GGA data was successfully taken, false if it failed */
@@ -426,6 +496,17 @@ uint8_t GPSManager_powerOnGPS()
 {
 	_isGpsOn = true;
 	USARTManager_printUsbWait("GPS Powered ON!\r\n");
+	if(_isGpsInStandby)
+	{
+		_isGpsInStandby = false;
+		send_gps(GPS_WAKEUP_COMMAND);
+		GPSPowerPolicy_startSession(true);
+		#if (ENERGY_PROFILER_ACTIVATED == 1)
+		energyProfiler_setState(ENERGY_DOMAIN_GPS, ENERGY_STATE_GPS_WARMUP);
+		#endif
+		vTaskDelay(GPS_WAKEUP_DELAY);
+		return FUNCTION_SUCCESS;
+	}
 	if (gpio_get_pin_level(GPS_power_enable))
 	{
 		return FUNCTION_FAILURE;
@@ -433,17 +514,57 @@ uint8_t GPSManager_powerOnGPS()
 	else
 	{
 		gpio_set_pin_level(GPS_power_enable, true);
-		vTaskDelay(2000);
+		GPSPowerPolicy_startSession(false);
+		#if (ENERGY_PROFILER_ACTIVATED == 1)
+		energyProfiler_setState(ENERGY_DOMAIN_GPS, ENERGY_STATE_GPS_WARMUP);
+		#endif
+		vTaskDelay(GPS_POWER_ON_DELAY);
 		return FUNCTION_SUCCESS;
 	}
 }
 
+/* Keeps the receiver powered in standby : the next start is a hot start */
+void GPSManager_standbyGPS()
+{
+	_isGpsOn = false;
+	testMonitor_raiseEvent(EVENT_GPS_STATE_OFF);
+	USARTManager_printUsbWait("GPS in standby!\r\n");
+	GPSPowerPolicy_endSession();
+	if(gpio_get_pin_level(GPS_power_enable))
+	{
+		send_gps(GPS_STANDBY_COMMAND);
+		_isGpsInStandby = true;
+		#if (ENERGY_PROFILER_ACTIVATED == 1)
+		energyProfiler_setState(ENERGY_DOMAIN_GPS, ENERGY_STATE_GPS_STANDBY);
+		#endif
+	}
+}
+
+bool GPSManager_isGPSInStandby(){
+	return _isGpsInStandby;
+}
+
+/* Standby or power off, whichever costs less until the next scheduled use of the GPS */
+void GPSManager_releaseGPS()
+{
+	if(GPSPowerPolicy_shouldStandby())
+	{
+		GPSManager_standbyGPS();
+	}
+	else
+	{
+		GPSManager_powerOffGPS();
+	}
+}
+
 /* Eteint le GPS et clear le flag correspondant au mode appelant */
 uint8_t GPSManager_powerOffGPS()
 {
 	_isGpsOn = false;
+	_isGpsInStandby = false;
 	testMonitor_raiseEvent(EVENT_GPS_STATE_OFF);
 	USARTManager_printUsbWait("GPS Powered OFF!\r\n");
+	GPSPowerPolicy_endSession();
 	if  (!gpio_get_pin_level(GPS_power_enable))
 	{
 		return FUNCTION_FAILURE;
@@ -451,6 +572,9 @@ uint8_t GPSManager_powerOffGPS()
 	else
 	{
 		gpio_set_pin_level(GPS_power_enable, false);
+		#if (ENERGY_PROFILER_ACTIVATED == 1)
+		energyProfiler_setState(ENERGY_DOMAIN_GPS, ENERGY_STATE_GPS_OFF);
+		#endif
 		vTaskDelay(200);
 		send_gps("at\n\r\0");
 		vTaskDelay(2000);
@@ -458,18 +582,18 @@ uint8_t GPSManager_powerOffGPS()
 	}
 }
 
-double convertNMEA(char * param, char * orientation)
+/* Converts a ddmm.mmmm value decoded with NMEA_LAT_LON_DECIMALS decimals to signed degrees */
+double convertNMEA(int32_t degreesMinutes, char orientation)
 {
-	double f = strtod(param,NULL);
-	double deg, min, sec, res;
-
-	deg = (int)(f / 100.0);
-	min = (int)(f - deg*100.0);
-	sec = 60.0*(f - deg*100.0 - min);
-
-	res = deg + min / 60 + sec / 3600;
+	int32_t minutesScale = 100;
+	for(uint8_t i = 0; i < NMEA_LAT_LON_DECIMALS; i++)
+	{
+		minutesScale *= 10;
+	}
+	int32_t deg = degreesMinutes / minutesScale;
+	double res = deg + (degreesMinutes - deg * minutesScale) / (60.0 * (minutesScale / 100));
 
-	if (strlen(orientation) > 0 && (orientation[0] == 'S' || orientation[0] == 'W'))
+	if (orientation == 'S' || orientation == 'W')
 	{
 		res = res*-1;
 	}
@@ -686,13 +810,13 @@ void GPSManager_printGPSLogs()
 		stringHelper_intToString(_GPSLogs[i].timestamp, (unsigned char*)buff);
 		USARTManager_printUsbWait(buff);
 		USARTManager_printUsbWait(",");
-		stringHelper_doubleToString(_GPSLogs[i].satCoordinate.coordinate.lat, (char*)buff, 9);
+		stringHelper_fixedPointToString(stringHelper_toFixedPoint(_GPSLogs[i].satCoordinate.coordinate.lat, COORDINATE_DECIMALS), (char*)buff, COORDINATE_DECIMALS);
 		USARTManager_printUsbWait(buff);
 		USARTManager_printUsbWait(",");
-		stringHelper_doubleToString(_GPSLogs[i].satCoordinate.coordinate.lon, (char*)buff, 9);
+		stringHelper_fixedPointToString(stringHelper_toFixedPoint(_GPSLogs[i].satCoordinate.coordinate.lon, COORDINATE_DECIMALS), (char*)buff, COORDINATE_DECIMALS);
 		USARTManager_printUsbWait(buff);
 		USARTManager_printUsbWait(",");
-		stringHelper_doubleToString(_GPSLogs[i].satCoordinate.coordinate.alt, (char*)buff, 2);
+		stringHelper_fixedPointToString(stringHelper_toFixedPoint(_GPSLogs[i].satCoordinate.coordinate.alt, 2), (char*)buff, 2);
 		USARTManager_printUsbWait(buff);
 		USARTManager_printUsbWait(",");
 		stringHelper_intToString(_GPSLogs[i].satCoordinate.fixQuality, (unsigned char*)buff);
@@ -701,7 +825,7 @@ void GPSManager_printGPSLogs()
 		stringHelper_intToString(_GPSLogs[i].satCoordinate.satellitesNumber, (unsigned char*)buff);
 		USARTManager_printUsbWait(buff);
 		USARTManager_printUsbWait(",");
-		stringHelper_doubleToString(_GPSLogs[i].satCoordinate.hDOP, (char*)buff, 1);
+		stringHelper_fixedPointToString(stringHelper_toFixedPoint(_GPSLogs[i].satCoordinate.hDOP, 1), (char*)buff, 1);
 		USARTManager_printUsbWait(buff);
 		USARTManager_printUsbWait("\r\n");
 	}
@@ -775,7 +899,7 @@ void GPSManager_printWrongNMEALog()
 }
 
 /* Waits for a valid GXGGA frame (with checksum validation) */
-static bool waitGGAFrame(uint8_t* resultBuf, uint32_t timeout)
+static bool waitGGAFrame(uint32_t timeout)
 {
 	bool nmeaFound = false;
 	#if (FAKE_POSITIONS_ACTIVATED==1)
@@ -783,45 +907,34 @@ static bool waitGGAFrame(uint8_t* resultBuf, uint32_t timeout)
 	vTaskDelay(1000);
 	uint32_t randNum = TRNGManager_getTRN(); // Use randnum num to randomly pick a frame
 
-	//strcpy(resultBuf, FAKE_NMEA_FRAME_15);
+	//strcpy((char*)gps_buf, FAKE_NMEA_FRAME_15);
 	
 	if(randNum % 3 == 0)
 	{
-		strcpy(resultBuf, FAKE_NMEA_FRAME_1);
+		strcpy((char*)gps_buf, FAKE_NMEA_FRAME_1);
 	}
 	else if(randNum % 3 == 1)
 	{
-		strcpy(resultBuf, FAKE_NMEA_FRAME_4);
+		strcpy((char*)gps_buf, FAKE_NMEA_FRAME_4);
 	}
 	else if(randNum % 3 == 2)
 	{
-		strcpy(resultBuf, FAKE_NMEA_FRAME_2);
+		strcpy((char*)gps_buf, FAKE_NMEA_FRAME_2);
 	}
 	
-	nmeaFound = true;
+	nmeaFound = validateChecksum((char*)gps_buf, GPS_NMEA_NUMBER);
 
 	#else
 
 	clearNMEAAvailableBit();
 	EventBits_t gpsMask = xEventGroupWaitBits(_gpsMaskhandle, GPS_BIT_NMEA_AVAILABLE, pdFALSE, pdTRUE, timeout); // we do NOT clear on exit to avoid overwrite until we copied the data
-	if(gpsMask & GPS_BIT_NMEA_AVAILABLE)
+	if(gpsMask & GPS_BIT_NMEA_AVAILABLE) // the checksums were validated by the reception interrupt
 	{
 		nmeaFound = true;
 	}
 	#endif
 
-	if(nmeaFound)
-	{
-		
-		if(validateChecksum(gps_buf, GPS_NMEA_NUMBER))
-		{
-			//
-			strcpy(resultBuf, gps_buf);
-			return true;
-		}
-	}
-
-	return false;
+	return nmeaFound;
 }
 
 static void clearNMEAAvailableBit()
@@ -836,8 +949,7 @@ void GPSManager_test()
 	while(1)
 	{
 		USARTManager_printUsbWait("Waiting for GGA data...\r\n");
-		char result[128];
-		if(waitGGAFrame(result, 10000))
+		if(waitGGAFrame(10000))
 		{
 			USARTManager_printUsbWait(gps_buf);
 		}
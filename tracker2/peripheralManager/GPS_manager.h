@@ -15,6 +15,8 @@
 #include <peripheralManager/RTC_manager.h>
 #include <peripheralManager/TRNG_Manager.h>
 #include <tests/test_monitor.h>
+#include <peripheralManager/GPS_power_policy.h>
+#include <seekiosCore/energy_profiler.h>
 
 #define FAKE_NMEA_FRAME_1 "$GPGGA,144841.000,4329.3827,N,00132.0499,W,1,13,0.7,1111,M,50.8,M,,*62\r\n$GNRMC,020911.000,A,4327.7170,N,00128.8516,W,14.42,114.61,280117,,,A*56\r\n" // precise, anglet
 #define FAKE_NMEA_FRAME_2 "$GPGGA,144841.000,4310.2827,N,00131.1499,W,1,5,1.77,-25.6,M,50.8,M,,*58\r\n$GNRMC,020911.000,A,4327.7170,N,00128.8516,W,14.42,114.61,280117,,,A*56\r\n" // very far from anglet
@@ -37,13 +39,20 @@
 //#define FAKE_NMEA_FRAME_15  "$GPGGA,174837.000,4327.8960,N,00129.5489,W,1,8,1.37,45.6,M,50.8,M,,*78\n$GNRMC,020911.000,A,4327.7170,N,00128.8516,W,14.42,114.61,280117,,,A*56\n" // technocit, milieu escaliers
 
 #define GPS_NMEA_NUMBER 2  //nombre de sentences nmea que l'on utilise (GGA & RMC)
-
-#define GPS_WARMUP_TIME			60000
+#define NMEA_LAT_LON_DECIMALS	5 // ddmm.mmmmm : the minutes are decoded in 1/100000 min, 17959.99999 still fits in an int32_t
+#define NMEA_ALTITUDE_DECIMALS	2
+
+#define GPS_WARMUP_TIME			60000 // maximum, the warmup is adapted by GPS_power_policy
+#define GPS_POWER_ON_DELAY		2000 // boot of the receiver after a power off
+#define GPS_WAKEUP_DELAY		100
+#define GPS_STANDBY_COMMAND		"$PMTK161,0*28\r\n"
+#define GPS_WAKEUP_COMMAND		"$PMTK000*32\r\n" // any byte wakes the receiver up from standby
 #define GPS_MAX_FIXTIME			60000
 #define GPS_MAX_FIXTIME_ZONE	120000
 #define GPS_READING_TIMEOUT		30000
 #define GPS_MAX_OCCURRENCE		50
 #define GPS_EXPIRATION_TIME		5 // After we stop using the GPS, expiration time (in min) before we shut down the GPS
+#define GPS_EXPIRATION_WINDOW	30 // in sec. The GPS can be shut down earlier to wake up with another alarm
 
 #define GPS_BIT_CURPOS_REQ_BIT_ON_DEMAND	(1 << 0)
 #define GPS_BIT_CURPOS_REQ_BIT_MODES		(1 << 1)
@@ -62,6 +71,8 @@ typedef enum {
 	GPS_TYPE_GPGLL,
 } E_GPS_TYPE;
 
+#define COORDINATE_DECIMALS		7 // lat and lon are written in 1/10^7 degree, about 1 cm, with stringHelper_fixedPointToString
+
 typedef struct {
 	double lat;
 	double lon;
@@ -90,6 +101,23 @@ typedef enum
 	GPS_RESPONSE_STATUS_FRAME_PARSED = 2, // Valid GXGGA frame received with position data
 }E_GPS_RESPONSE_STATUS;
 
+typedef enum
+{
+	NMEA_CHECKSUM_PENDING = 0,
+	NMEA_CHECKSUM_VALID = 1,
+	NMEA_CHECKSUM_INVALID = 2,
+}E_NMEA_CHECKSUM_STATUS;
+
+/* Checksum computed while the bytes of a sentence arrive */
+typedef struct
+{
+	uint8_t computed;
+	uint8_t given;
+	uint8_t nbGivenDigits;
+	bool starFound;
+	E_NMEA_CHECKSUM_STATUS status;
+}NMEAChecksum;
+
 #if (ACTIVATE_GPS_LOGS == 1)
 typedef struct  
 {
@@ -99,11 +127,6 @@ typedef struct
 }GPSLog;
 #endif
 
-typedef struct vector{
-	double x;
-	double y;
-} Vector;
-
 typedef struct {
 	double maxHdop;
 	double minSatNum;
@@ -122,8 +145,11 @@ void GPSManager_getGPSData(void);
 void task_GPSManager(void* param);
 uint8_t GPSManager_powerOnGPS(void);
 uint8_t GPSManager_powerOffGPS(void);
+void GPSManager_standbyGPS(void);
+bool GPSManager_isGPSInStandby(void);
+void GPSManager_releaseGPS(void);
 bool check_sentence_validity(char *sentence,uint16_t sentenceSIZE);
-double convertNMEA(char * param, char * orientation);
+double convertNMEA(int32_t degreesMinutes, char orientation);
 int parse_sentence(char *sentencebuffer,SatelliteCoordinate *currentlocationPtr);
 void GPSManager_requestCurrentPosition(uint8_t requestBit);
 bool GPSManager_isCurrentPositionAvailable(uint8_t requestBit);
@@ -159,5 +185,7 @@ bool GPSManager_respectsQualityCriteria(SatelliteCoordinate *coordinatePtr, Qual
 void GPSManager_askGPSUSARTTest(void);
 bool GPSManager_testGPSUSART(uint32_t timeout);
 void GPSManager_showAllGPSData(void);
+void GPSManager_initNMEAChecksum(NMEAChecksum* checksumPtr);
+E_NMEA_CHECKSUM_STATUS GPSManager_updateNMEAChecksum(NMEAChecksum* checksumPtr, char receivedChar);
 
 #endif /* GPS_MANAGER_H_ */
\ No newline at end of file
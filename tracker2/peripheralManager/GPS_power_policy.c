@@ -0,0 +1,158 @@
+/*
+ * GPS_power_policy.c
+ *
+ * Content : learns the time to first fix of the GPS sessions and decides, when the GPS is released,
+ * between keeping the receiver in standby (hot start) and powering it off until the next scheduled use.
+ */ 
+
+#include <peripheralManager/GPS_manager.h>
+
+static bool isEphemerisFresh(time_t atTimestamp);
+static bool isStandbyCheaper(uint32_t gapSec, E_GPS_START_TYPE startTypeFromOff);
+static E_GPS_START_TYPE getStartTypeAfter(uint32_t gapSec);
+static void learnTTFF(E_GPS_START_TYPE startType, uint32_t ttff);
+static uint32_t computeWarmupTime(E_GPS_START_TYPE startType);
+
+static uint32_t _learnedTTFF[GPS_START_TYPE_COUNT];	// in ms, moving average of the last sessions
+static uint8_t _averageSatellitesNumber;			// at the first fix of the last sessions
+static time_t _lastFixTimestamp;					// 0 : no fix since the boot
+static time_t _nextUseTimestamp;					// 0 : the next use of the GPS is not known
+static E_GPS_START_TYPE _sessionStartType;
+static E_GPS_START_TYPE _plannedStartType;			// start type the warmup of the next use was computed for
+static TickType_t _sessionStartTick;
+static bool _sessionFixFound;
+static bool _sessionStarted;
+
+void GPSPowerPolicy_init(){
+	_learnedTTFF[GPS_START_HOT] = GPS_DEFAULT_HOT_TTFF;
+	_learnedTTFF[GPS_START_WARM] = GPS_DEFAULT_WARM_TTFF;
+	_learnedTTFF[GPS_START_COLD] = GPS_DEFAULT_COLD_TTFF;
+	_averageSatellitesNumber = GPS_WEAK_SKY_SATELLITES;
+	_lastFixTimestamp = 0;
+	_nextUseTimestamp = 0;
+	_plannedStartType = GPS_START_COLD;
+	_sessionStarted = false;
+}
+
+/* Called when the GPS is powered on or woken up from standby */
+void GPSPowerPolicy_startSession(bool fromStandby){
+	bool ephemerisFresh = isEphemerisFresh(RTCManager_getCurrentTimestamp());
+	if(!ephemerisFresh)
+	{
+		_sessionStartType = GPS_START_COLD;
+	}
+	else
+	{
+		_sessionStartType = fromStandby ? GPS_START_HOT : GPS_START_WARM;
+	}
+	_sessionStartTick = xTaskGetTickCount();
+	_sessionFixFound = false;
+	_sessionStarted = true;
+	_nextUseTimestamp = 0;
+	_plannedStartType = GPS_START_COLD;
+}
+
+/* Called for each fix. Only the first fix of a session is learned */
+void GPSPowerPolicy_recordFix(uint8_t satellitesNumber){
+	_lastFixTimestamp = RTCManager_getCurrentTimestamp();
+	if(!_sessionStarted || _sessionFixFound)
+	{
+		return;
+	}
+	_sessionFixFound = true;
+	learnTTFF(_sessionStartType, xTaskGetTickCount() - _sessionStartTick);
+	_averageSatellitesNumber = (_averageSatellitesNumber * 3 + satellitesNumber + 2) / 4;
+}
+
+/* Called when the GPS is put in standby or powered off.
+A session without fix is learned with its duration : the real time to first fix is longer */
+void GPSPowerPolicy_endSession(){
+	if(_sessionStarted && !_sessionFixFound)
+	{
+		uint32_t sessionDuration = xTaskGetTickCount() - _sessionStartTick;
+		if(sessionDuration > _learnedTTFF[_sessionStartType])
+		{
+			learnTTFF(_sessionStartType, sessionDuration);
+		}
+	}
+	_sessionStarted = false;
+}
+
+/* Called by the modes when they schedule the next GPS wake-up */
+void GPSPowerPolicy_setNextUse(uint32_t delaySec){
+	_nextUseTimestamp = RTCManager_getCurrentTimestamp() + delaySec;
+}
+
+void GPSPowerPolicy_clearNextUse(){
+	_nextUseTimestamp = 0;
+}
+
+bool GPSPowerPolicy_isNextUseScheduled(){
+	return _nextUseTimestamp != 0;
+}
+
+/* True if keeping the receiver in standby until the next scheduled use costs less than a start from power off,
+and if the warmup of the next use was computed for a hot start */
+bool GPSPowerPolicy_shouldStandby(){
+	if(!GPSPowerPolicy_isNextUseScheduled() || _plannedStartType != GPS_START_HOT)
+	{
+		return false;
+	}
+	time_t now = RTCManager_getCurrentTimestamp();
+	uint32_t gapSec = _nextUseTimestamp > now ? _nextUseTimestamp - now : 0;
+	return getStartTypeAfter(gapSec) == GPS_START_HOT;
+}
+
+/* Time to power on the GPS before a fix is needed in delayMs.
+The start type depends on the wake-up time, which depends on the warmup : the first consistent start type is planned,
+or a cold start from power off */
+uint32_t GPSPowerPolicy_getWarmupTime(uint32_t delayMs){
+	for(uint8_t startType = GPS_START_HOT; startType < GPS_START_COLD; startType++)
+	{
+		uint32_t warmup = computeWarmupTime(startType);
+		if(warmup < delayMs && getStartTypeAfter((delayMs - warmup) / 1000) == startType)
+		{
+			_plannedStartType = startType;
+			return warmup;
+		}
+	}
+	_plannedStartType = GPS_START_COLD;
+	return computeWarmupTime(GPS_START_COLD);
+}
+
+uint32_t GPSPowerPolicy_getLearnedTTFF(E_GPS_START_TYPE startType){
+	return _learnedTTFF[startType];
+}
+
+static bool isEphemerisFresh(time_t atTimestamp){
+	return _lastFixTimestamp != 0 && atTimestamp - _lastFixTimestamp < GPS_EPHEMERIS_VALIDITY;
+}
+
+/* Start type of the next session if the GPS is released now and used again in gapSec, with the cheapest choice */
+static E_GPS_START_TYPE getStartTypeAfter(uint32_t gapSec){
+	if(!isEphemerisFresh(RTCManager_getCurrentTimestamp() + gapSec))
+	{
+		return GPS_START_COLD; // the standby would not keep valid ephemeris
+	}
+	return isStandbyCheaper(gapSec, GPS_START_WARM) ? GPS_START_HOT : GPS_START_WARM;
+}
+
+/* Charges in uA.s : standby during the gap then hot start, or warm start from power off */
+static bool isStandbyCheaper(uint32_t gapSec, E_GPS_START_TYPE startTypeFromOff){
+	uint64_t standbyCharge = (uint64_t)GPS_STANDBY_CURRENT * gapSec + (uint64_t)GPS_ACQUISITION_CURRENT * _learnedTTFF[GPS_START_HOT] / 1000;
+	uint64_t powerOffCharge = (uint64_t)GPS_ACQUISITION_CURRENT * _learnedTTFF[startTypeFromOff] / 1000;
+	return standbyCharge < powerOffCharge;
+}
+
+static uint32_t computeWarmupTime(E_GPS_START_TYPE startType){
+	uint32_t margin = _averageSatellitesNumber < GPS_WEAK_SKY_SATELLITES ? GPS_WEAK_SKY_WARMUP_MARGIN : GPS_WARMUP_MARGIN;
+	uint32_t warmup = _learnedTTFF[startType] * margin / 100;
+	if(warmup < GPS_MIN_WARMUP_TIME) warmup = GPS_MIN_WARMUP_TIME;
+	if(warmup > GPS_WARMUP_TIME) warmup = GPS_WARMUP_TIME;
+	return warmup;
+}
+
+/* Moving average on the last 4 sessions */
+static void learnTTFF(E_GPS_START_TYPE startType, uint32_t ttff){
+	_learnedTTFF[startType] = (_learnedTTFF[startType] * 3 + ttff) / 4;
+}
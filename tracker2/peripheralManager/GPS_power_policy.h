@@ -0,0 +1,51 @@
+/*
+ * GPS_power_policy.h
+ *
+ * Content : learns the time to first fix of the GPS sessions and decides, when the GPS is released,
+ * between keeping the receiver in standby (hot start) and powering it off until the next scheduled use.
+ * Simulated on the host by gps_power_simulation/gps_power_simulation.py
+ */ 
+
+
+#ifndef GPS_POWER_POLICY_H_
+#define GPS_POWER_POLICY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include <FreeRTOS.h>
+#include <task.h>
+#include <peripheralManager/RTC_manager.h>
+
+#define GPS_ACQUISITION_CURRENT		25000	// in uA, receiver on and tracking
+#define GPS_STANDBY_CURRENT			200		// in uA, receiver in standby : the ephemeris and the last position are kept
+#define GPS_EPHEMERIS_VALIDITY		7200	// in sec. After that, the ephemeris have to be downloaded again (cold start)
+#define GPS_MIN_WARMUP_TIME			3000	// in ms
+#define GPS_WARMUP_MARGIN			150		// in %, applied to the learned time to first fix
+#define GPS_WEAK_SKY_WARMUP_MARGIN	200		// in %, when the last fixes had few satellites
+#define GPS_WEAK_SKY_SATELLITES		6
+
+/* Default times to first fix, replaced by the learned ones (in ms) */
+#define GPS_DEFAULT_HOT_TTFF		5000
+#define GPS_DEFAULT_WARM_TTFF		35000
+#define GPS_DEFAULT_COLD_TTFF		60000
+
+typedef enum{
+	GPS_START_HOT	= 0, // from standby, ephemeris fresh
+	GPS_START_WARM	= 1, // from power off, ephemeris fresh
+	GPS_START_COLD	= 2, // ephemeris too old
+	GPS_START_TYPE_COUNT
+}E_GPS_START_TYPE;
+
+void GPSPowerPolicy_init(void);
+void GPSPowerPolicy_startSession(bool fromStandby);
+void GPSPowerPolicy_recordFix(uint8_t satellitesNumber);
+void GPSPowerPolicy_endSession(void);
+void GPSPowerPolicy_setNextUse(uint32_t delaySec);
+void GPSPowerPolicy_clearNextUse(void);
+bool GPSPowerPolicy_isNextUseScheduled(void);
+bool GPSPowerPolicy_shouldStandby(void);
+uint32_t GPSPowerPolicy_getWarmupTime(uint32_t delayMs);
+uint32_t GPSPowerPolicy_getLearnedTTFF(E_GPS_START_TYPE startType);
+
+#endif /* GPS_POWER_POLICY_H_ */
@@ -38,8 +38,10 @@ void task_GSMTask(void* param)
 			// Remove alarms linked to the GSM use
 			maskUtilities_clearRequestMaskBits(REQUEST_BIT_HTTP_SESSION_EXPIRED);
 			maskUtilities_clearRequestMaskBits(REQUEST_BIT_CHECK_NETWORK_STATUS);
+			#if (ADC_BATTERY_GAUGE_ACTIVATED == 0)
 			USARTManager_printUsbWait("DELETING BATTERY CHECK BIT\r\n");
 			maskUtilities_clearRequestMaskBits(REQUEST_BIT_CHECK_BATTERY);
+			#endif
 			_httpService.removeHttpSessionExpirationAlarm();
 			_csService.removeNetworkCheckAlarm();
 
@@ -52,7 +54,6 @@ void task_GSMTask(void* param)
 	}
 
 	maskUtilities_clearRunningMaskBits(RUNNING_BIT_GSM_TASK);
-	FreeRTOSOverlay_taskDelete(NULL);
 }
 
 /* Allume le GSM, et entame la configuration de base du GSM. 
@@ -186,9 +187,14 @@ uint8_t  GSMManager_getRSSIInt()
 	return RSSIInt;
 }
 
+/* Uses the last +CSQ answer if it is recent enough, otherwise asks the module */
 bool GSMManager_getSignalLevelPctage(uint8_t* buff)
 {
 	bool functionResult = false;
+	if(_moduleService.getCachedSignalLevelPctage(buff))
+	{
+		return true;
+	}
 	if(takeGsmMutexAndWakeModule()==pdPASS)
 	{
 		functionResult = _moduleService.getSignalLevelPctage(buff);
@@ -197,8 +203,13 @@ bool GSMManager_getSignalLevelPctage(uint8_t* buff)
 	return functionResult;
 }
 
+/* Uses the last +CBC answer if it is recent enough, otherwise asks the module */
 bool GSMManager_getGSMBatteryData(GSMBatData *batDataPtr)
 {
+	if(_moduleService.getCachedGSMBatteryData(batDataPtr))
+	{
+		return true;
+	}
 	if(takeGsmMutexAndWakeModule()==pdPASS)
 	{
 		_moduleService.getGSMBatteryData(batDataPtr);
@@ -7,7 +7,10 @@ static bool isNetworkDetached(void);
 static uint8_t parseNetworkRegistration(char* responseToParse);
 static void connectToFirstAvailableNetwork(uint32_t timeout);
 static void networkCheckAlarmCallback(struct calendar_descriptor *const calendar);
-static int getPreferedOperatorIndex(char* operator);
+static int getPreferedOperatorIndex(const char* operator);
+static void connectToLastGoodOperator(uint32_t timeout);
+static void loadLastGoodOperator(void);
+static void saveLastGoodOperator(const char* operator);
 static bool isNetworkAttached(void);
 static void setNetworkCheckAlarm(bool attachmentWorked);
 static bool attachSpecificNetworkManually(const char* networkIdentifier, uint32_t timeout);
@@ -25,147 +28,140 @@ static void setNetworkCheckAlarm(bool attachmentWorked);
 static struct calendar_alarm _networkCheckAlarm;
 #define NETWORK_NAME_MAX_LENGTH 32
 static char	_lastCheckedNetwork[NETWORK_NAME_MAX_LENGTH] = "NONE"; // the lastly checked network; can be shown as
+#define NETWORK_OPERATOR_CODE_MAX_LENGTH 8
+static char _lastGoodOperator[NETWORK_OPERATOR_CODE_MAX_LENGTH]; // last operator we were attached to, kept in flash
+static bool _isLastGoodOperatorLoaded = false;
 
-#define NETWORK_OPERATORS_COUNT 137
-static const char* _networkOperators[NETWORK_OPERATORS_COUNT] = {
-"27602", //Vodafone"},
-"722310", //Claro"},
-"722310", //Claro"},
-"28305", //VivaCell"},
-"50503", //Vodafone"},
-"23201", //Mobilkom"},
-"42602", //ZainBH"},
+/* Prefered operators (MCC + MNC, numeric format of AT+COPS). Kept sorted in strcmp order and without duplicates :
+it is searched by dichotomy */
+static const char* _networkOperators[] = {
+"20205", //Vodafone"},
+"20404", //Vodafone"},
 "20601", //Proximus"},
-"73601", //Nuevatel"},
-"72405", //Claro"},
-"28401", //M-Tel"},
-"302610", //BellMobility"},
-"302720", //RogersWireless"},
-"302780", //Sasktel"},
-"302220", //Telus"},
-"73003", //Claro"},
-"46000", //ChinaMobile"},
-"732101", //Claro"},
-"71203", //Claro"},
+"20801", //Orange"},
+"20810", //SFR"},
+"20820", //Bouygues"},
+"21401", //Vodafone"},
+"21670", //Vodafone"},
 "21910", //VIPnet"},
-"28001", //Cytamobile-Vodafone"},
+"22005", //VIP"},
+"22210", //Vodafone"},
+"22601", //Vodafone"},
+"22801", //Swisscom"},
 "23003", //Vodafone"},
+"23201", //Mobilkom"},
+"23403", //Airtel-Vodafone"},
+"23415", //Vodafone"},
 "23801", //TDC"},
-"37002", //Claro"},
-"74001", //Conecel"},
-"60202", //Vodafone"},
-"70601", //Claro"},
-"24802", //Elisa"},
-"28802", //Vodafone"},
+"24004", //Telenor"},
+"24008", //Telenor"},
+"24024", //Telenor(Net4Mobility)"},
+"24201", //Telenor"},
 "24405", //Elisa"},
-"20801", //Orange"},
-"20820", //Bouygues"},
-"20810", //SFR"},
-"54715", //Vodafone"},
+"24602", //BiteGSM"},
+"24705", //BiteLatvija"},
+"24802", //Elisa"},
+"25001", //MTS"},
+"26001", //Plus"},
 "26202", //Vodafone"},
-"62002", //Vodafone"},
-"20205", //Vodafone"},
-"70401", //Claro"},
-"23403", //Airtel-Vodafone"},
-"708001", //Claro"},
-"45403", //3"},
-"45404", //Hutchison"},
-"21670", //Vodafone"},
+"26801", //Vodafone"},
+"27077", //Tango"},
+"27201", //Vodafone"},
 "27402", //Vodafone"},
+"27602", //Vodafone"},
+"27801", //Vodafone"},
+"28001", //Cytamobile-Vodafone"},
+"28305", //VivaCell"},
+"28401", //M-Tel"},
+"28602", //Vodafone"},
+"28802", //Vodafone"},
+"29340", //SIMobil"},
+"302220", //Telus"},
+"302610", //BellMobility"},
+"302720", //RogersWireless"},
+"302780", //Sasktel"},
+"310160", //T-Mobile"},
+"310200", //T-Mobile"},
+"310210", //T-Mobile"},
+"310220", //T-Mobile"},
+"310230", //T-Mobile"},
+"310240", //T-Mobile"},
+"310250", //T-Mobile"},
+"310260", //T-Mobile"},
+"310270", //T-Mobile"},
+"310310", //T-Mobile"},
+"310380", //AT&T"},
+"310410", //AT&T"},
+"310490", //T-Mobile"},
+"330110", //Claro"},
+"334020", //Telcel"},
+"37002", //Claro"},
+"40401", //Vodafone"},
+"40405", //Vodafone"},
+"40411", //Vodafone"},
 "40413", //Vodafone"},
-"405752", //Vodafone"},
+"40415", //Vodafone"},
 "40420", //Vodafone"},
+"40427", //Vodafone"},
+"40430", //Vodafone"},
+"40443", //Vodafone"},
+"40446", //Vodafone"},
+"40460", //Vodafone"},
 "40484", //Vodafone"},
-"40411", //Vodafone"},
-"40405", //Vodafone"},
-"40401", //Vodafone"},
-"405754", //Vodafone"},
 "40486", //Vodafone"},
-"40446", //Vodafone"},
-"40430", //Vodafone"},
-"405756", //Vodafone"},
-"40427", //Vodafone"},
-"40420", //Vodafone"},
-"405753", //Vodafone"},
 "40488", //Vodafone"},
-"40460", //Vodafone"},
-"40443", //Vodafone"},
-"40415", //Vodafone"},
 "40566", //Vodafone"},
 "40567", //Vodafone"},
-"27201", //Vodafone"},
-"22210", //Vodafone"},
-"44010", //NTTDoCoMo"},
-"23403", //Airtel-Vodafone"},
+"405752", //Vodafone"},
+"405753", //Vodafone"},
+"405754", //Vodafone"},
+"405756", //Vodafone"},
+"41302", //Dialog"},
 "41601", //Zain"},
-"63902", //Safaricom"},
 "41902", //Zain"},
-"24705", //BiteLatvija"},
-"65101", //VODACOM"},
-"22801", //Swisscom"},
-"24602", //BiteGSM"},
-"27077", //Tango"},
+"42004", //Zain"},
+"42403", //du"},
+"42602", //ZainBH"},
+"42702", //Vodafone"},
+"44010", //NTTDoCoMo"},
+"45202", //Vinaphone"},
+"45403", //3"},
+"45404", //Hutchison"},
+"46000", //ChinaMobile"},
+"46692", //Chunghwa"},
 "50213", //Celcom"},
 "50219", //Celcom"},
-"27801", //Vodafone"},
-"334020", //Telcel"},
-"20810", //SFR"},
-"64304", //Vodacom"},
-"20404", //Vodafone"},
+"50503", //Vodafone"},
+"51503", //SMARTGold"},
+"52004", //RealFuture"},
+"52099", //TrueMove"},
+"52505", //StarHub"},
 "53001", //Vodafone"},
+"54715", //Vodafone"},
+"60202", //Vodafone"},
+"62002", //Vodafone"},
+"63902", //Safaricom"},
+"64004", //Vodacom"},
+"64304", //Vodacom"},
+"65101", //VODACOM"},
+"65501", //Vodacom"},
+"70401", //Claro"},
+"70601", //Claro"},
+"708001", //Claro"},
 "71021", //Claro"},
-"24201", //Telenor"},
+"71203", //Claro"},
 "71403", //Claro"},
-"74402", //Claro"},
 "71610", //Claro"},
-"51503", //SMARTGold"},
-"26001", //Plus"},
-"26801", //Vodafone"},
-"310380", //AT&T"},
-"310410", //AT&T"},
-"330110", //Claro"},
-"310260", //T-Mobile"},
-"42702", //Vodafone"},
-"22601", //Vodafone"},
-"25001", //MTS"},
-"22210", //Vodafone"},
-"42004", //Zain"},
-"22005", //VIP"},
-"52505", //StarHub"},
-"29340", //SIMobil"},
-"65501", //Vodacom"},
-"21401", //Vodafone"},
-"41302", //Dialog"},
-"24201", //Telenor"},
-"24008", //Telenor"},
-"24004", //Telenor"},
-"24024", //Telenor(Net4Mobility)"},
-"22801", //Swisscom"},
-"46692", //Chunghwa"},
-"64004", //Vodacom"},
-"52004", //RealFuture"},
-"52099", //TrueMove"},
-"28602", //Vodafone"},
-"42403", //du"},
-"23415", //Vodafone"},
-"310380", //AT&T"},
-"310410", //AT&T"},
-"310260", //T-Mobile"},
-"310160", //T-Mobile"},
-"310200", //T-Mobile"},
-"310210", //T-Mobile"},
-"310220", //T-Mobile"},
-"310230", //T-Mobile"},
-"310240", //T-Mobile"},
-"310250", //T-Mobile"},
-"310270", //T-Mobile"},
-"310310", //T-Mobile"},
-"310490", //T-Mobile"},
+"722310", //Claro"},
+"72405", //Claro"},
+"73003", //Claro"},
+"732101", //Claro"},
+"73601", //Nuevatel"},
+"74001", //Conecel"},
+"74402", //Claro"},
 "74810", //Claro"},
-"22210", //Vodafone"},
-"45202", //Vinaphone"},
-"310410", //AT&T"},
 };
+#define NETWORK_OPERATORS_COUNT (sizeof(_networkOperators) / sizeof(_networkOperators[0]))
 
 
 /* This task checks the network status : is it connected to a fully-working network, and if it is connected
@@ -191,6 +187,10 @@ static bool attachNetworkServiceManually(uint32_t timeout)
 	TickType_t startingTime = xTaskGetTickCount();
 	USARTManager_printUsbWait("Starting to attach the network services...\r\n");
 	USARTManager_sendATCommand(timeout, 1, "AT+COPS=3,2\r\n"); // Set operator format to 2 (numeric)
+	if(!isNetworkAttached())
+	{
+		connectToLastGoodOperator(timeout); // avoids the long AT+COPS=? scan when we come back to the same network
+	}
 	while(!isNetworkAttached())
 	{
 		TickType_t currentTime = xTaskGetTickCount();
@@ -209,9 +209,53 @@ static bool attachNetworkServiceManually(uint32_t timeout)
 		connectToFirstAvailableNetwork(timeout - elapsedTime);
 	}
 	USARTManager_printUsbWait("Network attached.\r\n");
+	saveLastGoodOperator(_lastCheckedNetwork);
 	return true;
 }
 
+/* Tries to register to the last operator we were attached to.
+The mode 4 of AT+COPS switches to the automatic mode if this operator is not available */
+static void connectToLastGoodOperator(uint32_t timeout)
+{
+	loadLastGoodOperator();
+	if(_lastGoodOperator[0] != '\0' && getPreferedOperatorIndex(_lastGoodOperator) != -1)
+	{
+		USARTManager_printUsbWait("Trying the last operator first...\r\n");
+		USARTManager_sendATCommand(timeout, 3, "AT+COPS=4,2,\"", _lastGoodOperator, "\"\r\n");
+	}
+}
+
+static void loadLastGoodOperator()
+{
+	if(_isLastGoodOperatorLoaded)
+	{
+		return;
+	}
+	dataflashManager_readPage(PAGE_INDEX_LAST_NETWORK_OPERATOR, NETWORK_OPERATOR_CODE_MAX_LENGTH, (unsigned char*)_lastGoodOperator);
+	_lastGoodOperator[NETWORK_OPERATOR_CODE_MAX_LENGTH-1] = '\0';
+	for(uint8_t i = 0; _lastGoodOperator[i] != '\0'; i++)
+	{
+		if(_lastGoodOperator[i] < '0' || _lastGoodOperator[i] > '9') // erased page or corrupted data
+		{
+			_lastGoodOperator[0] = '\0';
+			break;
+		}
+	}
+	_isLastGoodOperatorLoaded = true;
+}
+
+/* Writes the operator in flash, only if it changed */
+static void saveLastGoodOperator(const char* operator)
+{
+	loadLastGoodOperator();
+	if(strlen(operator) >= NETWORK_OPERATOR_CODE_MAX_LENGTH || strcmp(operator, _lastGoodOperator) == 0)
+	{
+		return;
+	}
+	strcpy(_lastGoodOperator, operator);
+	dataflashManager_writeToPage(PAGE_INDEX_LAST_NETWORK_OPERATOR, NETWORK_OPERATOR_CODE_MAX_LENGTH, _lastGoodOperator);
+}
+
 static bool attachSpecificNetworkManually(const char* networkIdentifier, uint32_t timeout)
 {
 		TickType_t startingTime = xTaskGetTickCount();
@@ -463,16 +507,33 @@ static bool isSpecificNetworkAttached(const char* networkIdentifier)
 }
 
 
-/* Returns the index of the prefered operator. Returns -1 if it wasn't found. */
-static int getPreferedOperatorIndex(char* operator)
+/* Returns the index of the prefered operator. Returns -1 if it wasn't found.
+Dichotomic search : _networkOperators must stay sorted */
+static int getPreferedOperatorIndex(const char* operator)
 {
-	uint32_t i = 0;
+	int first = 0;
+	int last = NETWORK_OPERATORS_COUNT - 1;
 
-	for(i=0;i<NETWORK_OPERATORS_COUNT;i++)
+	if(operator == NULL)
 	{
-		if(strcmp(_networkOperators[i], operator) == 0)
+		return -1;
+	}
+
+	while(first <= last)
+	{
+		int middle = (first + last) / 2;
+		int comparison = strcmp(_networkOperators[middle], operator);
+		if(comparison == 0)
+		{
+			return middle;
+		}
+		else if(comparison < 0)
+		{
+			first = middle + 1;
+		}
+		else
 		{
-			return i;
+			last = middle - 1;
 		}
 	}
 
@@ -523,7 +584,7 @@ static void setNetworkCheckAlarm(bool attachmentWorked)
 	{
 		networkCheckPeriod = NETWORK_SEARCH_PERIOD;
 	}
-	RTCManager_setDelayedCallback(networkCheckPeriod, & _networkCheckAlarm, networkCheckAlarmCallback);
+	RTCManager_setDelayedCallbackInWindow(networkCheckPeriod, NETWORK_CHECK_ALARM_WINDOW, & _networkCheckAlarm, networkCheckAlarmCallback);
 }
 
 static void removeNetworkCheckAlarm()
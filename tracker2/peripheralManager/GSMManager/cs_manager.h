@@ -5,9 +5,11 @@
 #include <peripheralManager/RTC_manager.h>
 #include <seekiosManager/mask_utilities.h>
 #include <peripheralManager/battery_manager.h>
+#include <peripheralManager/dataflash_manager.h>
 
 #define NETWORK_SEARCH_PERIOD	60 // 1 min // Period for trying to connect to the gsm network
 #define NETWORK_CHECK_PERIOD	300 // 5 min // Period in second for checking the GSM network status (check that it is still connected)
+#define NETWORK_CHECK_ALARM_WINDOW	60 // in sec. The network check can be done earlier to wake up with another alarm
 
 typedef enum{
 	NETWORK_REGISTRATION_NOT_REGISTERED = 			0,
@@ -21,7 +21,6 @@ static bool openBearer(uint32_t timeout);
 static bool closeBearer(uint32_t timeout);
 static E_HTTP_REQUEST_STATUS httpGET(char* url, char* httpMessage);
 static E_HTTP_REQUEST_STATUS getMessageLength(char* msgLength);
-static void httpReadTimerCallback(void);
 static E_HTTP_REQUEST_STATUS readHttpMessage(const char* msgLength, char* httpMessage);
 
 static EventGroupHandle_t _gprsStatusMaskHandle;
@@ -72,7 +71,14 @@ static uint8_t startHTTP()
 			return FUNCTION_FAILURE;
 		}
 
-		if(!openBearer(LONG_WAIT))
+		#if (ENERGY_PROFILER_ACTIVATED == 1)
+		energyProfiler_setState(ENERGY_DOMAIN_GSM, ENERGY_STATE_GSM_GPRS);
+		#endif
+		bool isBearerOpen = openBearer(LONG_WAIT);
+		#if (ENERGY_PROFILER_ACTIVATED == 1)
+		energyProfiler_setState(ENERGY_DOMAIN_GSM, ENERGY_STATE_GSM_IDLE);
+		#endif
+		if(!isBearerOpen)
 		{
 			return FUNCTION_FAILURE;
 		}
@@ -104,7 +110,7 @@ current Seekios Status (the GPRS Expiration time depends on the Running status *
 static void scheduleHttpSessionExpirationAlarm(uint8_t expirationTime){
 	removeHttpSessionExpirationAlarm();
 	USARTManager_printUsbWait("GPRS SESSION EXPIRATION : ");
-	RTCManager_setDelayedCallback(expirationTime*60, & _httpSessionExpirationAlarm, httpSessionExpirationCallback);
+	RTCManager_setDelayedCallbackInWindow(expirationTime*60, GPRS_EXPIRATION_ALARM_WINDOW, & _httpSessionExpirationAlarm, httpSessionExpirationCallback);
 }
 
 static void removeHttpSessionExpirationAlarm(){
@@ -331,6 +337,9 @@ static bool closeBearer(uint32_t timeout)
 static E_HTTP_REQUEST_STATUS httpGET(char* url, char* httpMessage){
 	
 	volatile E_HTTP_REQUEST_STATUS functionResult = HTTP_REQUEST_STATUS_NONE;
+	#if (ENERGY_PROFILER_ACTIVATED == 1)
+	energyProfiler_setState(ENERGY_DOMAIN_GSM, ENERGY_STATE_GSM_GPRS);
+	#endif
 
 	if(USARTManager_sendATCommand(LONG_WAIT, 3, "AT+HTTPPARA=\"URL\",\"", url, "\"\r\n")==SERIAL_ANSWER_OK)
 	{
@@ -346,6 +355,9 @@ static E_HTTP_REQUEST_STATUS httpGET(char* url, char* httpMessage){
 		functionResult = HTTP_REQUEST_STATUS_UNKNOWN_ERROR;
 	}
 
+	#if (ENERGY_PROFILER_ACTIVATED == 1)
+	energyProfiler_setState(ENERGY_DOMAIN_GSM, ENERGY_STATE_GSM_IDLE);
+	#endif
 	return functionResult;
 }
 
@@ -355,8 +367,9 @@ Le HTTP Action fonctionne s'il re
 static E_HTTP_REQUEST_STATUS getMessageLength(char* msgLength){
 
 	E_SERIAL_ANSWER answer;
+	USARTManager_expectURC("+HTTPACTION:"); // the URC can come right after the OK
 	if(USARTManager_sendATCommand(LONG_WAIT, 1, "AT+HTTPACTION=0\r\n")==SERIAL_ANSWER_OK){
-		answer = USARTManager_readAnswerAndValidate(VERY_LONG_WAIT, &httpReadTimerCallback);
+		answer = USARTManager_waitURC(VERY_LONG_WAIT);
 		if(answer==SERIAL_ANSWER_OK){ // attente de +HTTPACTION:0,200,XXX
 			if(strlen(gsm_buf)>0){
 				USARTManager_printUsbWait("parsing http response...\r\n");
@@ -411,25 +424,6 @@ static E_HTTP_REQUEST_STATUS getMessageLength(char* msgLength){
 	return HTTP_REQUEST_STATUS_UNKNOWN_ERROR;
 }
 
-static void httpReadTimerCallback(){
-	char* start = strstr(gsm_buf,"+HTTPACTION:");
-	if(start != NULL)
-	{
-		if(strstr(start,"\r\n"))
-		{
-			serialAnswerFlag = SERIAL_ANSWER_OK;
-		}
-	}
-	else if (strstr(gsm_buf,"ERROR"))
-	{
-		serialAnswerFlag = SERIAL_ANSWER_ERROR;
-	}
-	else
-	{
-		return;
-	}
-}
-
 /* Lit un message http d'une longueur msgLength et stocke le resultat dans result */
 static E_HTTP_REQUEST_STATUS readHttpMessage(const char* msgLength, char* httpMessage){
 	USARTManager_sendATCommand(LONG_WAIT, 3, "AT+HTTPREAD=0,", msgLength, "\r\n");
@@ -6,12 +6,14 @@
 #include <seekiosManager/mask_utilities.h>
 #include <seekiosCore/seekios.h>
 #include <peripheralManager/RTC_manager.h>
+#include <seekiosCore/energy_profiler.h>
 
 #define GPRS_STATUS_BIT_HTTP_CONFIGURED			(1 << 0) // http config process worked
 #define GPRS_STATUS_BIT_HTTP_INITIALIZED		(1 << 1) // http init successful
 
 #define GPRS_EXPIRATION_TIME_5_MIN		5
 #define GPRS_EXPIRATION_TIME_16_MIN		16
+#define GPRS_EXPIRATION_ALARM_WINDOW	30 // in sec. The session can expire earlier to wake up with another alarm
 
 typedef enum{
 	HTTP_REQUEST_STATUS_NONE,						// the code that executes the http request couldn't be executed
@@ -12,7 +12,10 @@ static void wakeModule(void);
 static bool getRSSI(uint8_t * result);
 static uint8_t getRSSIInt(void);
 static bool getSignalLevelPctage(uint8_t* buff);
+static bool getCachedSignalLevelPctage(uint8_t* buff);
 static void getGSMBatteryData(GSMBatData *batDataPtr);
+static bool getCachedGSMBatteryData(GSMBatData *batDataPtr);
+static bool isCacheFresh(bool isCached, time_t sampleTime, time_t now, time_t maxAge);
 static void parseBatteryLevel(char* batteryFrame, GSMBatData *batDataPtr);
 static bool  getIMSI(uint8_t* resultBuff);
 static bool getIMEI(char* result);
@@ -27,6 +30,15 @@ static bool isModuleStarted(void);
 static bool isModulePoweredOn(void);
 static uint8_t hasSMSBeenReceived(void);
 
+/* Last +CSQ and +CBC answers, refreshed each time such an answer is parsed, dropped when the module is powered off.
+Dated with the RTC : the tick count stops while the MCU hibernates */
+static uint8_t _cachedRSSI;
+static time_t _rssiSampleTime;
+static bool _isRSSICached = false;
+static GSMBatData _cachedBatData;
+static time_t _batDataSampleTime;
+static bool _isBatDataCached = false;
+
 void ModuleManager_init(ModuleService *moduleService)
 {
 	_moduleStatusMaskHandle = xEventGroupCreate();
@@ -37,7 +49,9 @@ void ModuleManager_init(ModuleService *moduleService)
 	moduleService->getRSSI = getRSSI;
 	moduleService->getRSSIInt = getRSSIInt;
 	moduleService->getSignalLevelPctage = getSignalLevelPctage;
+	moduleService->getCachedSignalLevelPctage = getCachedSignalLevelPctage;
 	moduleService->getGSMBatteryData = getGSMBatteryData;
+	moduleService->getCachedGSMBatteryData = getCachedGSMBatteryData;
 	moduleService->parseBatteryLevel = parseBatteryLevel;
 	moduleService->getIMSI = getIMSI;
 	moduleService->getIMEI = getIMEI;
@@ -57,6 +71,9 @@ static uint8_t powerOnModule(uint32_t timeout)
 	uint8_t functionResult = FUNCTION_SUCCESS;
 	USARTManager_printUsbWait("Powering ON GSM Module...\r\n");
 	gpio_set_pin_level(GSM_power_enable, true);
+	#if (ENERGY_PROFILER_ACTIVATED == 1)
+	energyProfiler_setState(ENERGY_DOMAIN_GSM, ENERGY_STATE_GSM_IDLE);
+	#endif
 	vTaskDelay(200);
 	uint32_t atCommandsTimeout = timeout / MAX_TRIES_AT_COMMAND;
 	uint8_t iteration = 0;
@@ -115,6 +132,13 @@ static void powerOffModule()
 	{
 		xEventGroupClearBits(_moduleStatusMaskHandle, MODULE_STATUS_BIT_STARTED);
 		gpio_set_pin_level(GSM_power_enable, false);
+		taskENTER_CRITICAL();
+		_isRSSICached = false;
+		_isBatDataCached = false;
+		taskEXIT_CRITICAL();
+		#if (ENERGY_PROFILER_ACTIVATED == 1)
+		energyProfiler_setState(ENERGY_DOMAIN_GSM, ENERGY_STATE_GSM_OFF);
+		#endif
 		USARTManager_printUsbWait("...GSM POWERED OFF.\r\n");
 	}
 	else
@@ -125,11 +149,17 @@ static void powerOffModule()
 
 static void sleepModule(){
 	gpio_set_pin_level(GSM_DTR_wake, true); // high = enter sleep
+	#if (ENERGY_PROFILER_ACTIVATED == 1)
+	energyProfiler_setState(ENERGY_DOMAIN_GSM, isModulePoweredOn() ? ENERGY_STATE_GSM_SLEEP : ENERGY_STATE_GSM_OFF);
+	#endif
 	vTaskDelay(100);
 }
 
 static void wakeModule(){
 	gpio_set_pin_level(GSM_DTR_wake, false); // low = wake
+	#if (ENERGY_PROFILER_ACTIVATED == 1)
+	energyProfiler_setState(ENERGY_DOMAIN_GSM, isModulePoweredOn() ? ENERGY_STATE_GSM_IDLE : ENERGY_STATE_GSM_OFF);
+	#endif
 	vTaskDelay(100);
 }
 
@@ -165,6 +195,46 @@ static bool getSignalLevelPctage(uint8_t* buff)
 	return false;
 }
 
+/* Same as getSignalLevelPctage, from the last +CSQ answer. Does not use the UART.
+Returns false if there is no answer younger than SIGNAL_CACHE_MAX_AGE */
+static bool getCachedSignalLevelPctage(uint8_t* buff)
+{
+	bool isFresh;
+	uint8_t rssi;
+	time_t now = RTCManager_getCurrentTimestamp();
+	taskENTER_CRITICAL();
+	isFresh = isCacheFresh(_isRSSICached, _rssiSampleTime, now, SIGNAL_CACHE_MAX_AGE);
+	rssi = _cachedRSSI;
+	taskEXIT_CRITICAL();
+	if(isFresh)
+	{
+		stringHelper_intToString(getSignalLevelPctageFromRSSI(rssi),(uint8_t*) buff);
+	}
+	return isFresh;
+}
+
+/* Same as getGSMBatteryData, from the last +CBC answer. Does not use the UART.
+Returns false if there is no answer younger than BATTERY_CACHE_MAX_AGE */
+static bool getCachedGSMBatteryData(GSMBatData *batDataPtr)
+{
+	bool isFresh;
+	time_t now = RTCManager_getCurrentTimestamp();
+	taskENTER_CRITICAL();
+	isFresh = isCacheFresh(_isBatDataCached, _batDataSampleTime, now, BATTERY_CACHE_MAX_AGE);
+	if(isFresh)
+	{
+		*batDataPtr = _cachedBatData;
+	}
+	taskEXIT_CRITICAL();
+	return isFresh;
+}
+
+/* A sample dated after now (the RTC was set back) is not used */
+static bool isCacheFresh(bool isCached, time_t sampleTime, time_t now, time_t maxAge)
+{
+	return isCached && now >= sampleTime && (now - sampleTime) < maxAge;
+}
+
 /* Stocke dans "values" la battery data perue par le GSM : respectivement le bat %age et le bat Vage*/
 static void getGSMBatteryData(GSMBatData *batDataPtr)
 {
@@ -215,6 +285,13 @@ static void parseBatteryLevel(char* batteryFrame, GSMBatData *batDataPtr){
 	}
 	// part = "3917" (bat voltage)
 	batDataPtr->batteryVoltage = atoi(part);
+
+	time_t sampleTime = RTCManager_getCurrentTimestamp();
+	taskENTER_CRITICAL();
+	_cachedBatData = *batDataPtr;
+	_batDataSampleTime = sampleTime;
+	_isBatDataCached = sampleTime != 0; // 0 : the calendar is not set yet, the sample cannot be dated
+	taskEXIT_CRITICAL();
 }
 
 /*
@@ -271,11 +348,20 @@ static uint8_t parseRSSI(char* signalFrame)
 {
 	//GSM_buf = [AT+CSQ\r\n+CSQ: 18,0\r\n\r\nOK\r\n]
 	char* start = strstr(signalFrame,"+CSQ:");
+	if(start == NULL) return 0;
 	//start = [+CSQ: 18,0\r\n\r\nOK\r\n]
 	start += 6;
 
 	if(strtok(start, ",") == NULL)	return 0;
-	return atoi(start);
+	uint8_t rssi = atoi(start);
+
+	time_t sampleTime = RTCManager_getCurrentTimestamp();
+	taskENTER_CRITICAL();
+	_cachedRSSI = rssi;
+	_rssiSampleTime = sampleTime;
+	_isRSSICached = sampleTime != 0;
+	taskEXIT_CRITICAL();
+	return rssi;
 }
 
 /* Returns the current rssi floor we are at with the command AT+CSQ. The RSSI Floor represents what you can do (sms, data etc.) with the current RSSI */
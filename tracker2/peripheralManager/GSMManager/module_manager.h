@@ -6,6 +6,7 @@
 #include <task.h>
 #include <event_groups.h>
 #include <semphr.h>
+#include <seekiosCore/energy_profiler.h>
 #include <stdbool.h>
 #include <sgs/port_sgs.h>
 #include <peripheralManager/USART_manager.h>
@@ -14,6 +15,9 @@
 
 #define MODULE_STATUS_BIT_STARTED		(1 << 0)
 
+#define SIGNAL_CACHE_MAX_AGE	60 // s, on the RTC. A +CSQ answer younger than that is used without asking the module
+#define BATTERY_CACHE_MAX_AGE	60 // s, on the RTC. Same for the +CBC answer
+
 /* The different RSSI floors (=what you can do with such RSSIs) that you can get with the AT command AT+CSQ. */
 typedef enum{
 	RSSI_FLOOR_UNEXPLOITABLE =	0,
@@ -38,8 +42,10 @@ typedef struct
 	bool (*getRSSI)(uint8_t* buff);
 	uint8_t (*getRSSIInt)(void);
 	bool (*getSignalLevelPctage)(uint8_t* buff);
+	bool (*getCachedSignalLevelPctage)(uint8_t* buff);
 	bool (*parseSignalLevel)(char* signalFrame, char* result);
 	void (*getGSMBatteryData)(GSMBatData *batDataPtr);
+	bool (*getCachedGSMBatteryData)(GSMBatData *batDataPtr);
 	void (*parseBatteryLevel)(char* batteryFrame, GSMBatData *batDataPtr);
 	bool (*getIMSI)(uint8_t* resultBuff);
 	bool (*getIMEI)(char* result);
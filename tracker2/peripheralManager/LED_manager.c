@@ -8,6 +8,7 @@ static bool isLedActionRunning(void);
 static void copyLEDInstruction(LEDInstruction *dest, LEDInstruction *src);
 static void launchAction(LEDAction *actionPtr);
 static void stopLeds(void);
+static void updateLedEnergyState(void);
 
 static TimerHandle_t _greenLedTimerHandle;
 static int _actualGreenLedBlink;
@@ -212,30 +213,37 @@ static void stopLeds(){
 	gpio_set_pin_level(LED_0_gn, false);
 	gpio_set_pin_level(LED_1_rd, false);
 	gpio_set_pin_level(LED_2_ye, false);
+	updateLedEnergyState();
 }
 
 void LEDManager_turnOnGreenLED(){
 	gpio_set_pin_level(LED_0_gn, true);
+	updateLedEnergyState();
 }
 
 void LEDManager_turnOffGreenLED(){
 	gpio_set_pin_level(LED_0_gn, false);
+	updateLedEnergyState();
 }
 
 void LEDManager_turnOnRedLED(){
 	gpio_set_pin_level(LED_1_rd, true);
+	updateLedEnergyState();
 }
 
 void LEDManager_turnOffRedLED(){
 	gpio_set_pin_level(LED_1_rd, false);
+	updateLedEnergyState();
 }
 
 void LEDManager_turnOnYellowLED(){
 	gpio_set_pin_level(LED_2_ye, true);
+	updateLedEnergyState();
 }
 
 void LEDManager_turnOffYellowLED(){
 	gpio_set_pin_level(LED_2_ye, false);
+	updateLedEnergyState();
 }
 
 /*0 : no blink, always off 1 : static. More : will blink several times, the timer runs anyway to notify the Seekios of the action*/
@@ -251,6 +259,7 @@ void LEDManager_blinkGreenLED(int countOfBlink) {
 		gpio_set_pin_level(LED_0_gn, true);
 	}
 	
+	updateLedEnergyState();
 	xTimerStart(_greenLedTimerHandle, 0);
 }
 
@@ -266,6 +275,7 @@ void LEDManager_blinkRedLED(int countOfBlink) {
 	{
 		gpio_set_pin_level(LED_1_rd, true);
 	}
+	updateLedEnergyState();
 	xTimerStart(_redLedTimerHandle, 0);
 }
 
@@ -282,6 +292,7 @@ void LEDManager_blinkYellowLED(int countOfBlink) {
 		gpio_set_pin_level(LED_2_ye, true);
 	}
 	
+	updateLedEnergyState();
 	xTimerStart(_yellowLedTimerHandle, 0);
 }
 
@@ -295,6 +306,7 @@ static void toggleGreenLedShining(TimerHandle_t xTimer){
 		gpio_set_pin_level(LED_0_gn, false);
 		xTimerStop( _greenLedTimerHandle, 0 );
 	}
+	updateLedEnergyState();
 	UNUSED(xTimer);
 }
 
@@ -308,6 +320,7 @@ static void toggleRedLedShining(TimerHandle_t xTimer){
 		gpio_set_pin_level(LED_1_rd, false);
 		xTimerStop( _redLedTimerHandle, 0 );
 	}
+	updateLedEnergyState();
 	UNUSED(xTimer);
 }
 
@@ -321,9 +334,18 @@ static void toggleYellowLedShining(TimerHandle_t xTimer){
 		gpio_set_pin_level(LED_2_ye, false);
 		xTimerStop( _yellowLedTimerHandle, 0 );
 	}
+	updateLedEnergyState();
 	UNUSED(xTimer);
 }
 
+/* The state of the LED domain of the energy profiler is the number of lit LEDs */
+static void updateLedEnergyState(){
+	#if (ENERGY_PROFILER_ACTIVATED == 1)
+	uint8_t nbLitLeds = gpio_get_pin_level(LED_0_gn) + gpio_get_pin_level(LED_1_rd) + gpio_get_pin_level(LED_2_ye);
+	energyProfiler_setState(ENERGY_DOMAIN_LED, nbLitLeds);
+	#endif
+}
+
 bool LEDManager_isInstructionRunning(uint32_t instructionID)
 {
 	if(_isInstructionRunning && _currentlyRunningLedInstruction.instructionId == instructionID)
@@ -6,6 +6,7 @@
 #include <sgs/port_sgs.h>
 #include <queue.h>
 #include <seekiosCore/seekios.h>
+#include <seekiosCore/energy_profiler.h>
 #include <string.h>
 
 #define MAX_LEDS_ACTIONS 3
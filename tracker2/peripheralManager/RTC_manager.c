@@ -5,6 +5,7 @@ static bool leapYear(uint16_t year);
 static uint32_t getSecsInMonth(uint32_t year, uint8_t month);
 static BaseType_t takeCalendarSem(void);
 static BaseType_t giveCalendarSem(void);
+static int getCoalescedDelay(int delaySec, int windowSec, struct calendar_alarm* alarm);
 
 static bool _isCalendarInitialized;
 extern struct calendar_descriptor CALENDAR_X;
@@ -358,23 +359,63 @@ static bool getDelayDateTime(int delaySec, struct calendar_date_time* dtPtr){
 
 /* Sets a oneshot alarm that is bound to trigger once the delay delaySec passed as a parameter is reached. */
 bool RTCManager_setDelayedCallback(int delaySec, struct calendar_alarm* alarm, calendar_cb_alarm_t callbackFunc){
+	return RTCManager_setDelayedCallbackInWindow(delaySec, 0, alarm, callbackFunc);
+}
+
+/* Same as RTCManager_setDelayedCallback, but the alarm can trigger up to windowSec earlier.
+If another alarm is already scheduled in this window, both are aligned so that the RTC wakes up the Seekios only once.
+All the alarms share the same RTC compare : the calendar keeps them sorted and only programs the first one */
+bool RTCManager_setDelayedCallbackInWindow(int delaySec, int windowSec, struct calendar_alarm* alarm, calendar_cb_alarm_t callbackFunc){
+	bool functionResult = false;
+	if(takeCalendarSem()!=pdPASS)
+	{
+		return false;
+	}
+	delaySec = getCoalescedDelay(delaySec, windowSec, alarm);
 	if(getDelayDateTime(delaySec, &(alarm->data.datetime)) == FUNCTION_SUCCESS){
 		USARTManager_printUsbWait("ALARM SET AT :");
 		RTCManager_printTime(&alarm->data.datetime);
 		USARTManager_printUsbWait("\r\n");
 		alarm->option = CALENDAR_ALARM_MATCH_YEAR;
 		alarm->mode = ONESHOT;
-		if(takeCalendarSem()==pdPASS)
+		calendar_set_alarm(&CALENDAR_X, alarm, callbackFunc);
+		functionResult = true;
+	}
+	giveCalendarSem();
+	return functionResult;
+}
+
+/* Returns the delay of the latest alarm scheduled between delaySec - windowSec and delaySec, or delaySec if there is none.
+Must be called with the calendar semaphore taken */
+static int getCoalescedDelay(int delaySec, int windowSec, struct calendar_alarm* alarm)
+{
+	if(windowSec <= 0)
+	{
+		return delaySec;
+	}
+	int coalescedDelay = delaySec;
+	int bestRemainingTime = -1;
+	uint32_t currentTimestamp = _calendar_get_counter(&CALENDAR_X.device);
+	for(struct calendar_alarm *it = (struct calendar_alarm *)list_get_head(&CALENDAR_X.alarms);
+	it != NULL;
+	it = (struct calendar_alarm *)list_get_next_element(it))
+	{
+		if(it == alarm || it->data.timestamp <= currentTimestamp)
 		{
-			calendar_set_alarm(&CALENDAR_X, alarm, callbackFunc);
-			giveCalendarSem();
-			return true;
+			continue;
+		}
+		int remainingTime = it->data.timestamp - currentTimestamp;
+		if(remainingTime >= delaySec - windowSec && remainingTime <= delaySec && remainingTime > bestRemainingTime)
+		{
+			bestRemainingTime = remainingTime;
+			coalescedDelay = remainingTime;
 		}
-		volatile uint32_t wm = uxTaskGetStackHighWaterMark(NULL);
-		UNUSED(wm);
-		vTaskDelay(500);
 	}
-	return false;
+	if(coalescedDelay != delaySec)
+	{
+		USARTManager_printUsbWait("Alarm aligned with another alarm\r\n");
+	}
+	return coalescedDelay;
 }
 
 static void tmToCalendarDateTime(struct tm *tmDate, struct calendar_date_time * dateTime){
@@ -28,6 +28,7 @@ void RTCManager_copyDateTime(struct tm* resultPtr, struct tm toCopy);
 bool RTCManager_isCalendarInitialized(void);
 void RTCManager_example(void);
 bool RTCManager_setDelayedCallback(int delaySec, struct calendar_alarm* alarm, calendar_cb_alarm_t callbackFunc);
+bool RTCManager_setDelayedCallbackInWindow(int delaySec, int windowSec, struct calendar_alarm* alarm, calendar_cb_alarm_t callbackFunc);
 void RTCManager_getCurrentTm(struct tm* resultPtr);
 bool RTCManager_getCurrentDateTime(struct calendar_date_time *currentDateTime);
 void RTCManager_setAlarmFromTm(struct tm* tmDatePtr,struct calendar_alarm *alarm, calendar_cb_alarm_t callback);
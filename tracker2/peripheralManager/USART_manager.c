@@ -1,31 +1,33 @@
 #include <peripheralManager/USART_manager.h>
 
-static E_SERIAL_ANSWER waitAnswer(unsigned int timeout, void (*validatationCallback)(void));
-void timeoutTimeCallback(void);
-static void checkATAnswerStatus(void);
+static E_SERIAL_ANSWER waitFinalResult(unsigned int timeout);
+static bool lineStartsWith(const char* prefix);
 static void initReception(void);
 static void initSerialAnswerFlag(void);
 static bool sendGsmModemSync(char* string);
 static bool waitGsmTxComplete(void);
 
-static SemaphoreHandle_t _debugUsartMutex;
 static EventGroupHandle_t _gsmUsartMaskHandle;
 
-static bool _USBOutputActivated = false;
+/* Incremental parsing of the modem output, done in the reception interrupt */
+static char _gsmLine[GSM_LINE_SIZE];
+static uint8_t _gsmLineLength;
+static volatile E_SERIAL_ANSWER _finalResult;
+static const char* volatile _expectedUrc;
 
 void USARTManager_init(){
-	_debugUsartMutex = xSemaphoreCreateMutex();
 	_gsmUsartMaskHandle = xEventGroupCreate();
+	debugLog_init();
 }
 
 void USARTManager_activateUSBOutput()
 {
-	_USBOutputActivated = true;
+	debugLog_attachSink(LOG_SINK_USB);
 }
 
 void USARTManager_deactivateUSBOutput()
 {
-	_USBOutputActivated = false;
+	debugLog_detachSink(LOG_SINK_USB);
 }
 
 void USARTManager_gsmUsartMaskSetBitsFromISR(EventBits_t bitsToSet)
@@ -61,7 +63,12 @@ R
 */
 static void initReception(){
 	memset(gsm_buf, '\0', GSM_BUF_SIZE);
+	taskENTER_CRITICAL();
+	_gsmLineLength = 0;
+	_finalResult = SERIAL_ANSWER_NONE;
 	gsm_answer = 1; // notify the usart interrupt that we wait for a new answer
+	taskEXIT_CRITICAL();
+	USARTManager_gsmUsartMaskClearBits(GSM_USART_BIT_FINAL_RESULT | GSM_USART_BIT_LINE_RECEIVED);
 	initSerialAnswerFlag();
 }
 
@@ -82,13 +89,26 @@ E_SERIAL_ANSWER USARTManager_sendATCommand(unsigned int timeout, uint8_t nbStrin
 	for(uint8_t i=0;i<nbStrings;i++)
 	{
 		volatile char* string = va_arg(stringList, char*);
+		#if (TRACE_ACTIVATED == 1)
+		if(i == 0)
+		{
+			trace_recordATCommandStart((char*)string);
+		}
+		#endif
 		if(!sendGsmModemSync(string)){
 			va_end(stringList);
+			#if (TRACE_ACTIVATED == 1)
+			trace_record(TRACE_EVENT_AT_COMMAND_END, SERIAL_ANSWER_NONE);
+			#endif
 			return SERIAL_ANSWER_NONE;
 		}
 	}
 	va_end(stringList);
-	return waitAnswer(timeout, &checkATAnswerStatus);
+	E_SERIAL_ANSWER answer = waitFinalResult(timeout);
+	#if (TRACE_ACTIVATED == 1)
+	trace_record(TRACE_EVENT_AT_COMMAND_END, answer);
+	#endif
+	return answer;
 }
 
 /* Repeats an AT Command numberTries times until the function successes */
@@ -104,102 +124,167 @@ bool USARTManager_repeatATCommandUntilSuccess(uint8_t numberTries, char* ATcomma
 
 static bool sendGsmModemSync(char* string)
 {
+	#if (UART_REPLAY_ACTIVATED == 1)
+	uartReplay_record(UART_REPLAY_CHANNEL_GSM_TX, (const uint8_t*)string, strlen(string));
+	if(uartReplay_isReplaying())
+	{
+		return true; // the command is kept from the modem : the answer comes from the transcript
+	}
+	#endif
 	USARTManager_gsmUsartMaskClearBits(GSM_USART_BIT_TRANSFER_COMPLETE);
 	send_gsm_modem(string);
 	return waitGsmTxComplete();
 }
 
-/* Lit un message sur le serial, et le valide avec la fonction de validation validate passe en paramtre
-La fonction validate DOIT et le answerFlag  OK, ERROR, TIMEOUT ou NONE*/
-E_SERIAL_ANSWER USARTManager_readAnswerAndValidate(unsigned int timeout, void (*validatationCallback)(void)){
-	initSerialAnswerFlag();
-	return waitAnswer(timeout, validatationCallback);
-}
-
-/* Attend une rponse pendant un timeout dfini, et
-la retourne, avec le status OK, ERROR ou TIMEOUT
-validate: fonction de validation du message cout
-retours : 1 = OK | 2 = ERROR | 0 = RAS
-The validate function MUST set the answerFlag to one of those 3 values
-*/
-static E_SERIAL_ANSWER waitAnswer(unsigned int timeout, void (*validatationCallback)(void)){
-	uint32_t i = 0;
-	while(serialAnswerFlag==SERIAL_ANSWER_NONE){
-		validatationCallback();
-		vTaskDelay(50);
-		i++;
-		if(timeout / 50 < i) timeoutTimeCallback();
+/* Attend le code de rponse final de la commande (OK ou ERROR) pendant un timeout dfini.
+The reception interrupt notifies the task as soon as the final result line is received */
+static E_SERIAL_ANSWER waitFinalResult(unsigned int timeout){
+	TickType_t startTime = xTaskGetTickCount();
+	TickType_t elapsedTime = 0;
+	serialAnswerFlag = SERIAL_ANSWER_TIMEOUT;
+	while(elapsedTime < timeout)
+	{
+		xEventGroupWaitBits(_gsmUsartMaskHandle, GSM_USART_BIT_FINAL_RESULT, pdTRUE, pdFALSE, timeout - elapsedTime);
+		if(_finalResult != SERIAL_ANSWER_NONE) // the bit may come from a previous command
+		{
+			serialAnswerFlag = _finalResult;
+			break;
+		}
+		elapsedTime = xTaskGetTickCount() - startTime;
 	}
-	USARTManager_printUsbWait(gsm_buf);
+	LOG_DEBUG(LOG_MODULE_GSM, (const char*)gsm_buf);
 	return serialAnswerFlag;
 }
 
-void timeoutTimeCallback(void){
-	serialAnswerFlag = SERIAL_ANSWER_TIMEOUT;
+/* Registers the prefix of an unsolicited result code (ex : "+HTTPACTION:"). Must be called before sending the command that triggers it */
+void USARTManager_expectURC(const char* urcPrefix)
+{
+	taskENTER_CRITICAL();
+	_expectedUrc = urcPrefix;
+	taskEXIT_CRITICAL();
+	USARTManager_gsmUsartMaskClearBits(GSM_USART_BIT_URC_RECEIVED);
 }
 
-/* Checks the GSM_buf on a regular basis, waiting for the OK or ERROR string */
-static void checkATAnswerStatus(){
-
-	if(strstr(gsm_buf,"OK"))
+/* Waits for the URC registered with USARTManager_expectURC. The URC line is kept in gsm_buf
+Returns OK when received, ERROR if the modem answered ERROR meanwhile, TIMEOUT otherwise */
+E_SERIAL_ANSWER USARTManager_waitURC(unsigned int timeout)
+{
+	E_SERIAL_ANSWER answer = SERIAL_ANSWER_TIMEOUT;
+	TickType_t startTime = xTaskGetTickCount();
+	TickType_t elapsedTime = 0;
+	while(elapsedTime < timeout)
 	{
-		serialAnswerFlag = SERIAL_ANSWER_OK;
+		EventBits_t uxBits = xEventGroupWaitBits(_gsmUsartMaskHandle, GSM_USART_BIT_URC_RECEIVED | GSM_USART_BIT_FINAL_RESULT, pdTRUE, pdFALSE, timeout - elapsedTime);
+		if(uxBits & GSM_USART_BIT_URC_RECEIVED)
+		{
+			answer = SERIAL_ANSWER_OK;
+			break;
+		}
+		if((uxBits & GSM_USART_BIT_FINAL_RESULT) && _finalResult == SERIAL_ANSWER_ERROR)
+		{
+			answer = SERIAL_ANSWER_ERROR;
+			break;
+		}
+		elapsedTime = xTaskGetTickCount() - startTime;
 	}
-	else if (strstr(gsm_buf,"ERROR"))
+	_expectedUrc = NULL;
+	LOG_DEBUG(LOG_MODULE_GSM, (const char*)gsm_buf);
+	return answer;
+}
+
+/* Called by the reception path with the new bytes of the modem. Only the bytes are scanned, never the whole gsm_buf :
+the lines are recognized incrementally and the waiting task is notified at the end of each line */
+void USARTManager_parseGsmBytesFromISR(const uint8_t* data, uint16_t length)
+{
+	EventBits_t bitsToSet = 0;
+	for(uint16_t i = 0; i < length; i++)
 	{
-		serialAnswerFlag = SERIAL_ANSWER_ERROR;
+		char receivedChar = data[i];
+		if(receivedChar == '\r')
+		{
+			continue;
+		}
+		if(receivedChar != '\n')
+		{
+			if(_gsmLineLength < GSM_LINE_SIZE)
+			{
+				_gsmLine[_gsmLineLength] = receivedChar;
+			}
+			if(_gsmLineLength < 255)
+			{
+				_gsmLineLength++;
+			}
+			continue;
+		}
+		if(_gsmLineLength == 0) // empty line
+		{
+			continue;
+		}
+
+		bitsToSet |= GSM_USART_BIT_LINE_RECEIVED;
+		if(_gsmLineLength == 2 && lineStartsWith("OK"))
+		{
+			_finalResult = SERIAL_ANSWER_OK;
+			bitsToSet |= GSM_USART_BIT_FINAL_RESULT;
+		}
+		else if((_gsmLineLength == 5 && lineStartsWith("ERROR"))
+		|| lineStartsWith("+CME ERROR")
+		|| lineStartsWith("+CMS ERROR"))
+		{
+			_finalResult = SERIAL_ANSWER_ERROR;
+			bitsToSet |= GSM_USART_BIT_FINAL_RESULT;
+		}
+		if(_expectedUrc != NULL && lineStartsWith(_expectedUrc))
+		{
+			bitsToSet |= GSM_USART_BIT_URC_RECEIVED;
+		}
+		_gsmLineLength = 0;
 	}
-	else
+
+	if(bitsToSet != 0 && seekiosManagerStarted)
 	{
-		return;
+		USARTManager_gsmUsartMaskSetBitsFromISR(bitsToSet);
 	}
 }
 
-/* Prints a string on the USART debug. Also prints on the USB port, if USB debugging is activated */
-void USARTManager_printUsbWait(const char* string){
-	#if (ACTIVATE_DEBUG_LOGS == 1)
-	if((string == NULL) || (strlen(string) <= 0)) return;
-	if(xSemaphoreTake( _debugUsartMutex, ( TickType_t ) 10000 ) == pdTRUE){
-		send_debug(string);
-		xSemaphoreGive(_debugUsartMutex);
-	}
-	#endif
-	if(_USBOutputActivated)
+static bool lineStartsWith(const char* prefix)
+{
+	for(uint8_t i = 0; prefix[i] != '\0'; i++)
 	{
-		USBManager_print(string);
+		if(i >= _gsmLineLength || i >= GSM_LINE_SIZE || _gsmLine[i] != prefix[i])
+		{
+			return false;
+		}
 	}
+	return true;
+}
+
+/* Prints a string on the USART debug. Also prints on the USB port, if USB debugging is activated.
+The string is copied in the log ring : the caller never waits for the USART or the USB */
+void USARTManager_printUsbWait(const char* string){
+	LOG_INFO(LOG_MODULE_SYSTEM, string);
 }
 
 void USARTManager_printUsbWaitN(const char* text, uint16_t length)
 {
-	#if (ACTIVATE_DEBUG_LOGS == 1)
-
-	if(xSemaphoreTake( _debugUsartMutex, ( TickType_t ) 10000 ) == pdTRUE){
-		io_write(usart_debug_io, (const uint8_t *) text, length);
-		xSemaphoreGive(_debugUsartMutex);
-	}
+	#if (LOG_COMPILED_LEVEL >= LOG_LEVEL_INFO)
+	debugLog_writeN(LOG_MODULE_SYSTEM, LOG_LEVEL_INFO, text, length);
 	#endif
 }
 
 /* Encapsulation de la fonction usart_write_buffer_wait pour l'usb */
 void USARTManager_printByte(const uint8_t byte){
-	#if (ACTIVATE_DEBUG_LOGS == 1)
-	if(xSemaphoreTake( _debugUsartMutex, ( TickType_t ) 10000 ) == pdTRUE){
-		char buff[10];
-		stringHelper_byteToHexString(byte, buff);
-		send_debug(buff);
-		xSemaphoreGive(_debugUsartMutex);
-	}
+	#if (LOG_COMPILED_LEVEL >= LOG_LEVEL_INFO)
+	char buff[10];
+	stringHelper_byteToHexString(byte, buff);
+	LOG_INFO(LOG_MODULE_SYSTEM, buff);
 	#endif
 }
 
 void USARTManager_printInt(const int integer){
-	#if (ACTIVATE_DEBUG_LOGS == 1)
-	if(xSemaphoreTake( _debugUsartMutex, ( TickType_t ) 10000 ) == pdTRUE){
-		char buff[16];
-		stringHelper_intToString(integer, (uint8_t*)buff);
-		send_debug(buff);
-		xSemaphoreGive(_debugUsartMutex);
-	}
+	#if (LOG_COMPILED_LEVEL >= LOG_LEVEL_INFO)
+	char buff[16];
+	stringHelper_intToString(integer, (uint8_t*)buff);
+	LOG_INFO(LOG_MODULE_SYSTEM, buff);
 	#endif
 }
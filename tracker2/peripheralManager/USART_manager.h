@@ -20,6 +20,9 @@
 #include <FreeRTOS.h>
 #include <event_groups.h>
 #include <stdbool.h>
+#include <seekiosCore/trace.h>
+#include <seekiosCore/debug_log.h>
+#include <tests/uart_replay.h>
 #include <seekiosCore/seekios.h>
 #include <peripheralManager/USB_manager.h>
 #include <sgs/helper_sgs.h>
@@ -44,15 +47,23 @@ typedef enum{
 } E_ANSWER_VALIDATION;
 
 #define GSM_USART_BIT_TRANSFER_COMPLETE (1 << 0)
+#define GSM_USART_BIT_RX_IDLE			(1 << 1) // No byte received from the modem during a few DMA polls (UART_DMA_RX_ACTIVATED)
+#define GSM_USART_BIT_FINAL_RESULT		(1 << 2) // OK, ERROR, +CME ERROR or +CMS ERROR line received
+#define GSM_USART_BIT_LINE_RECEIVED		(1 << 3) // Any complete line received
+#define GSM_USART_BIT_URC_RECEIVED		(1 << 4) // Line starting with the expected URC received
+
+#define GSM_LINE_SIZE	24 // Only the start of each line is kept to recognize the final result codes and the URCs
 
 E_SERIAL_ANSWER serialAnswerFlag;
 E_SERIAL_ANSWER USARTManager_sendATCommand(unsigned int timeout, uint8_t nbStrings, ...);
-E_SERIAL_ANSWER USARTManager_readAnswerAndValidate(unsigned int timeout, void (*validatationCallback)(void));
 void USARTManager_printUsbWait(const char* string);
 void USARTManager_printByte(const uint8_t byte);
 void USARTManager_printInt(const int integer);
 void USARTManager_gsmUsartMaskSetBitsFromISR(EventBits_t bitsToSet);
 void USARTManager_gsmUsartMaskClearBits(EventBits_t bitsToClear);
+void USARTManager_parseGsmBytesFromISR(const uint8_t* data, uint16_t length);
+void USARTManager_expectURC(const char* urcPrefix);
+E_SERIAL_ANSWER USARTManager_waitURC(unsigned int timeout);
 void USARTManager_init(void);
 void USARTManager_printUsbWaitN(const char* text, uint16_t length);
 bool USARTManager_repeatATCommandUntilSuccess(uint8_t numberTries, char* ATcommand, unsigned int timeout);
@@ -50,6 +50,27 @@ void USBManager_print(const char* string)
 	}
 }
 
+/* Sends binary data, which can hold '\0' bytes. Returns false if the data is dropped : too long, previous transfer not over or USB error */
+bool USBManager_write(const uint8_t* data, uint16_t length)
+{
+	if(length > USB_BUF_LEN)
+	{
+		return false;
+	}
+	if(xSemaphoreTake(_usbBufMutex, 100) == pdPASS) // Semaphore released in the TX callback
+	{
+		memcpy(usb_buf, data, length);
+		int32_t result = cdcdf_acm_write(usb_buf, length);
+		if(result != USB_OK)
+		{
+			xSemaphoreGive(_usbBufMutex);
+			return false;
+		}
+		return true;
+	}
+	return false;
+}
+
 void USBManager_println(const char* string)
 {
 	if(xSemaphoreTake(_usbBufMutex, 100) == pdPASS) // Semaphore released in the TX callback
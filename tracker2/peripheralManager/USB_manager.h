@@ -11,6 +11,7 @@ bool USBManager_start(void);
 bool USBManager_stop(void);
 void USBManager_print(const char* string);
 void USBManager_println(const char* string);
+bool USBManager_write(const uint8_t* data, uint16_t length);
 void USBManager_test(void);
 void USBManager_init(void);
 
@@ -25,10 +26,40 @@ void USBManager_init(void);
 	#define RX_TESTS_START						"TESTS_START"
 	#define RX_TESTS_STOP						"TESTS_STOP"
 	#define RX_TEST_TRIGGER						"TRIGGER"
+	#define RX_GET_TELEMETRY					"GET_TELEMETRY"
+	#define RX_GET_TRACE						"GET_TRACE"
+	#define RX_GET_ENERGY						"GET_ENERGY"
+	#define RX_RESET_ENERGY						"RESET_ENERGY"
+	#define RX_SET_ENERGY_CURRENT				"SET_ENERGY_CURRENT" // SET_ENERGY_CURRENT:domain:state:current in uA
+	#define RX_REPLAY_RECORD					"REPLAY_RECORD"
+	#define RX_REPLAY_START						"REPLAY_START"
+	#define RX_REPLAY_STOP						"REPLAY_STOP"
+	#define RX_REPLAY_INJECT					"REPLAY_INJECT" // REPLAY_INJECT:GPS|GSM:line without the CRLF
+	#define RX_SET_LOG_FILTER					"SET_LOG_FILTER" // SET_LOG_FILTER:max level:module mask, see debug_log.h
 
 	/* Sent commands */
 	#define TX_SEND_STATUS_FUNCTIONALITIES_TEST_PROD		"STATUS_FUNC_TEST_PROD"
 	#define TX_SEND_STATUS_FUNCTIONALITIES_TEST_SCENARIO	"STATUS_FUNC_TEST_SCENARIO"
+	#define TX_TELEMETRY_FREE_HEAP							"TLM_FREE_HEAP"
+	#define TX_TELEMETRY_MIN_FREE_HEAP						"TLM_MIN_FREE_HEAP"
+	#define TX_TELEMETRY_LARGEST_FREE_BLOCK					"TLM_LARGEST_FREE_BLOCK"
+	#define TX_TELEMETRY_MIN_LARGEST_FREE_BLOCK				"TLM_MIN_LARGEST_FREE_BLOCK"
+	#define TX_TELEMETRY_ALLOCATION_FAILURES				"TLM_ALLOC_FAILURES"
+	#define TX_TELEMETRY_TASK_STACK							"TLM_TASK_STACK"
+	#define TX_TELEMETRY_OVER								"TLM_OVER"
+	#define TX_TRACE_NOW									"TRC_NOW"
+	#define TX_TRACE_TASK									"TRC_TASK"
+	#define TX_TRACE_DATA									"TRC_DATA"
+	#define TX_TRACE_OVER									"TRC_OVER"
+	#define TX_ENERGY_RUN_TIME								"ENG_RUN_TIME"
+	#define TX_ENERGY_STATE									"ENG_STATE"
+	#define TX_ENERGY_TOTAL_CHARGE							"ENG_TOTAL_CHARGE"
+	#define TX_ENERGY_AVERAGE_CURRENT						"ENG_AVERAGE_CURRENT"
+	#define TX_ENERGY_BATTERY_LIFE							"ENG_BATTERY_LIFE"
+	#define TX_ENERGY_OVER									"ENG_OVER"
+	#define TX_REPLAY_LINE									"RPL_LINE" // RPL_LINE:tick:channel:line
+	#define TX_REPLAY_LOST									"RPL_LOST" // RPL_LOST:number of lines lost because the ring was full
+	#define TX_REPLAY_OVER									"RPL_OVER"
 
 /* Functionalities test commands */
 	/* Recieved commands */
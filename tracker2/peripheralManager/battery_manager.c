@@ -4,6 +4,9 @@
 
 static void batteryCheckTimerCallback(struct calendar_descriptor *const calendar);
 static uint16_t ADCGetUSB(void);
+static uint16_t convertADCChannel(uint16_t inputCtrl);
+static void takeADC(void);
+static void giveADC(void);
 static void analyzeBatteryLevel();
 static uint16_t selectBatValue();
 static void enqueueBatteryValue(uint16_t value);
@@ -13,10 +16,12 @@ static uint16_t getBatteryPercentage(void);
 static void sendLowBatteryMessage(void);
 static uint16_t convertConsumptionIndexToPeriod(uint8_t consumptionIndex);
 static uint16_t buildBatteryCheckPeriod(void);
+static bool sampleBatteryVoltage(uint16_t* voltagePtr);
 
 extern struct calendar_date_time _batteryLastCheckDateTime;
 static struct calendar_alarm _checkBatteryValueTimerAlarm;
 static E_CHARGE_STATUS _chargeStatus = CHARGE_STATUS_DISCHARGING;
+static SemaphoreHandle_t _adcMutex;
 
 /* The battery voltage is the voltage that will be shown to the user and used by the Seekios. It may be different from the regular battery voltage, because:
 - We don't update _lastSampledbatteryVoltage if the seekios is in charge and the newly sampled voltage is lower than the previous _lastSampledbatteryVoltage
@@ -26,6 +31,30 @@ static uint16_t _lastBatVoltageToBeSent;
 static uint16_t _batteryValues[BATTERY_BUFFER_SIZE];
 static bool _batteryValuesFilled = false;
 
+/* Discharge curve of the battery at the Seekios load, from BATTERY_LEVEL_0_VOLTAGE to BATTERY_LEVEL_100_VOLTAGE.
+The voltage is flat in the middle of the discharge : a linear conversion shows a percentage too low, then drops at the end */
+static const BatteryCurvePoint _batteryCurve[] = {
+	{ BATTERY_LEVEL_0_VOLTAGE, 0 },
+	{ 3610, 5 },
+	{ 3680, 10 },
+	{ 3730, 20 },
+	{ 3770, 30 },
+	{ 3800, 40 },
+	{ 3830, 50 },
+	{ 3870, 60 },
+	{ 3920, 70 },
+	{ 3980, 80 },
+	{ 4060, 90 },
+	{ BATTERY_LEVEL_100_VOLTAGE, 100 },
+};
+
+#if (ADC_BATTERY_GAUGE_ACTIVATED == 1)
+static uint16_t ADCGetBattery(void);
+static void calibrateBatteryGauge(uint16_t gsmBatteryVoltage, uint16_t adcBatteryVoltage);
+static int16_t _batteryGaugeOffset = 0; // +CBC voltage minus ADC voltage, in mV
+static bool _isBatteryGaugeCalibrated = false;
+#endif
+
 #if (ACTIVATE_BATTERY_LOG == 1)
 static void addBatteryLog(void);
 #define BATTERY_LOGS_COUNT 128
@@ -35,6 +64,7 @@ static uint32_t	_logId = 0;
 #endif
 
 void batteryLevel_init(){
+	_adcMutex = xSemaphoreCreateMutex();
 	_batteryValuesFilled = false;
 	_lowBatteryAlertAlreadySent = false;
 	_lastBatVoltageToBeSent = 0;
@@ -64,6 +94,71 @@ void batteryManager_updateChargeStatus()
 }
 
 static bool updateLastSampledBatteryVoltage()
+{
+	uint16_t batteryVoltage;
+	if(sampleBatteryVoltage(&batteryVoltage))
+	{
+		enqueueBatteryValue(batteryVoltage);
+		
+		if(!_batteryValuesFilled)
+		{
+			for(uint8_t i=1;i<BATTERY_BUFFER_SIZE;i++)
+			{
+				enqueueBatteryValue(batteryVoltage);
+			}
+			_batteryValuesFilled = true;
+		}
+		
+		volatile uint16_t selectedBatValue=selectBatValue();
+		
+		if ((batteryManager_isBatteryCharging() && selectedBatValue > _lastBatVoltageToBeSent)
+		|| (!batteryManager_isBatteryCharging() && selectedBatValue < _lastBatVoltageToBeSent)
+		|| _lastBatVoltageToBeSent == 0) //_batteryLevelToBeSent not initialized yet
+		{
+			_lastBatVoltageToBeSent = selectedBatValue;
+		}
+		
+		char buff[10];//TODO: delete
+		volatile uint32_t wm = uxTaskGetStackHighWaterMark(NULL);
+		USARTManager_printUsbWait("Battery voltage to be sent: ");
+		batteryManager_getBatteryPercentageStr(buff);
+		USARTManager_printUsbWait(buff);
+		USARTManager_printUsbWait("%\r\n");
+		return true;
+	}
+	return false;
+}
+
+#if (ADC_BATTERY_GAUGE_ACTIVATED == 1)
+/* Reads the ADC : the GSM is not powered on for a battery check.
+The +CBC is only asked when the GSM is already started, to calibrate the ADC */
+static bool sampleBatteryVoltage(uint16_t* voltagePtr)
+{
+	uint16_t adcBatteryVoltage = ADCGetBattery();
+	GSMBatData gsmBatData;
+	if(GSMManager_isModuleStarted()
+	&& GSMManager_getGSMBatteryData(&gsmBatData)
+	&& gsmBatData.batteryVoltage != 0)
+	{
+		calibrateBatteryGauge(gsmBatData.batteryVoltage, adcBatteryVoltage);
+	}
+	*voltagePtr = adcBatteryVoltage + _batteryGaugeOffset;
+	return true;
+}
+
+/* The offset follows the +CBC answers slowly, so that one wrong answer does not move the battery level */
+static void calibrateBatteryGauge(uint16_t gsmBatteryVoltage, uint16_t adcBatteryVoltage)
+{
+	int16_t offset = (int16_t)gsmBatteryVoltage - (int16_t)adcBatteryVoltage;
+	if(offset > BATTERY_GAUGE_MAX_OFFSET || offset < -BATTERY_GAUGE_MAX_OFFSET)
+	{
+		return;
+	}
+	_batteryGaugeOffset = _isBatteryGaugeCalibrated ? (_batteryGaugeOffset * 3 + offset) / 4 : offset;
+	_isBatteryGaugeCalibrated = true;
+}
+#else
+static bool sampleBatteryVoltage(uint16_t* voltagePtr)
 {
 	if(GSMManager_waitModuleUse())
 	{
@@ -71,37 +166,13 @@ static bool updateLastSampledBatteryVoltage()
 		
 		if(GSMManager_getGSMBatteryData(&gsmBatData))
 		{
-			enqueueBatteryValue(gsmBatData.batteryVoltage);
-			
-			if(!_batteryValuesFilled)
-			{
-				for(uint8_t i=1;i<BATTERY_BUFFER_SIZE;i++)
-				{
-					enqueueBatteryValue(gsmBatData.batteryVoltage);
-				}
-				_batteryValuesFilled = true;
-			}
-			
-			volatile uint16_t selectedBatValue=selectBatValue();
-			
-			if ((batteryManager_isBatteryCharging() && selectedBatValue > _lastBatVoltageToBeSent)
-			|| (!batteryManager_isBatteryCharging() && selectedBatValue < _lastBatVoltageToBeSent)
-			|| _lastBatVoltageToBeSent == 0) //_batteryLevelToBeSent not initialized yet
-			{
-				_lastBatVoltageToBeSent = selectedBatValue;
-			}
-			
-			char buff[10];//TODO: delete
-			volatile uint32_t wm = uxTaskGetStackHighWaterMark(NULL);
-			USARTManager_printUsbWait("Battery voltage to be sent: ");
-			batteryManager_getBatteryPercentageStr(buff);
-			USARTManager_printUsbWait(buff);
-			USARTManager_printUsbWait("%\r\n");
+			*voltagePtr = gsmBatData.batteryVoltage;
 			return true;
 		}
 	}
 	return false;
 }
+#endif
 
 /* Pops the first element of the list, and adds the new value at the end */
 static void enqueueBatteryValue(uint16_t value)
@@ -134,23 +205,58 @@ static uint16_t selectBatValue()
 
 static uint16_t ADCGetUSB()
 {
+	return (uint16_t)(convertADCChannel(0x0001)*4.7)+1;	//USB AIN1
+}
+
+#if (ADC_BATTERY_GAUGE_ACTIVATED == 1)
+/* Same conversion as ADC_read_BAT_USB. A result below the offset gives 0 instead of wrapping around */
+static uint16_t ADCGetBattery()
+{
+	uint16_t voltage = (uint16_t)(convertADCChannel(0x0000)*3.8);	//BAT AIN0
+	return voltage > 70 ? voltage - 70 : 0;
+}
+#endif
+
+/* Same channels and conversions as ADC_read_BAT_USB of the SGS, under the ADC mutex : for the tasks of the tests */
+void batteryManager_readADCVoltages(uint16_t* voltages)
+{
+	takeADC();
+	ADC_read_BAT_USB(voltages);
+	ADC->CTRLA.bit.ENABLE = 0x00;
+	giveADC();
+}
+
+/* The ADC is shared by the battery check, the charge detection of the Seekios manager and the tests : each conversion is
+configured and read under _adcMutex, or a task could read the channel selected by another one. The ADC is disabled once the
+conversion is done, to not draw current during the sleep */
+static uint16_t convertADCChannel(uint16_t inputCtrl)
+{
+	takeADC();
 	ADC->CTRLA.bit.ENABLE = 0x00;					// off for parametering // ADC zur Parametrierung abschalten
 	ADC->REFCTRL.reg = 0x05;						// reference voltage VDDANA //Referenzspannung VDDANA
-	ADC->SAMPCTRL.bit.SAMPLEN = 0x5;				// more sampling time // AMPCTRL.SAMPLEN Sampling Zeit erhhen
-	ADC->AVGCTRL.bit.SAMPLENUM =0x7 ;				// more samples, add individual values //Sample-anzahl erhhen, addiert die einzelnen Werte
-	ADC->AVGCTRL.bit.ADJRES =0x4 ;					// Division coeff of the result (divided by 8) //Durchschnittsbildung durch oversampling
+	ADC->SAMPCTRL.bit.SAMPLEN = 0x5;				// more sampling time
+	ADC->AVGCTRL.bit.SAMPLENUM =0x7 ;				// more samples, add individual values
+	ADC->AVGCTRL.bit.ADJRES =0x4 ;					// Division coeff of the result (divided by 8)
 	ADC->CTRLC.bit.RESSEL =0x1  ;
-	ADC->INPUTCTRL.reg = 0x0000;					// chose analog channel AI0 //Kanal AI0 whlen
+	ADC->INPUTCTRL.reg = inputCtrl;
 	ADC->CTRLB.reg= 0x04;							//set Timer prescaler /128 - 6
-	
-	ADC->SWTRIG.reg = 0x2;							// set conversion start bit //Wandlung Startbit setzen  ADC->SWTRIG.bit.START = 1;
-
-	ADC->CTRLA.bit.ENABLE = 0x00;
-	ADC->INPUTCTRL.reg = 0x0001;                   //USB AIN0 //BAT AIN1
 	ADC->CTRLA.bit.ENABLE = 0x01;
 	ADC->SWTRIG.bit.START = 1;
 	while(!ADC->INTFLAG.bit.RESRDY);
-	return (uint16_t)(ADC->RESULT.reg*4.7)+1;	//start conversion
+	uint16_t result = ADC->RESULT.reg;
+	ADC->CTRLA.bit.ENABLE = 0x00;
+	giveADC();
+	return result;
+}
+
+static void takeADC()
+{
+	xSemaphoreTake(_adcMutex, portMAX_DELAY);
+}
+
+static void giveADC()
+{
+	xSemaphoreGive(_adcMutex);
 }
 
 void task_checkBattery(void* param)
@@ -198,7 +304,7 @@ static void resetBatteryCheckTimer(){
 	USARTManager_printUsbWait("Battery check period : ");
 	USARTManager_printUsbWait(buf);
 	USARTManager_printUsbWait("\r\n");
-	RTCManager_setDelayedCallback(batteryCheckPeriodMin*60, &_checkBatteryValueTimerAlarm, batteryCheckTimerCallback);
+	RTCManager_setDelayedCallbackInWindow(batteryCheckPeriodMin*60, BATTERY_CHECK_ALARM_WINDOW, &_checkBatteryValueTimerAlarm, batteryCheckTimerCallback);
 }
 
 /* Builds the battery check period, in mins, depending on several parameters */
@@ -355,14 +461,14 @@ static void analyzeBatteryLevel(){
 		USARTManager_printUsbWait("Battery Empty Turning off !\r\n");
 		maskUtilities_setRequestTurnOffSeekios();
 	}
-	else if(_lastBatVoltageToBeSent <= BATTERY_LEVEL_20_VOLTAGE
+	else if(getBatteryPercentage() <= BATTERY_LEVEL_LOW_PERCENTAGE
 	&& !batteryManager_isBatteryCharging()
 	&& !_lowBatteryAlertAlreadySent) // Critical battery voltage. We don't send an alert if it's charging, of if the alert was already sent  when we were below 20%
 	{
 		sendLowBatteryMessage();
 		_lowBatteryAlertAlreadySent = true;
 	}
-	else if(_lastBatVoltageToBeSent > BATTERY_LEVEL_20_VOLTAGE)
+	else if(getBatteryPercentage() > BATTERY_LEVEL_LOW_PERCENTAGE)
 	{
 		_lowBatteryAlertAlreadySent = false;
 	}
@@ -377,11 +483,24 @@ static void sendLowBatteryMessage()
 	messageSender_addToSendList(&lowBatteryMessage); // TODO : fill this with the extinction message
 }
 
+/* Linear interpolation between the two points of the discharge curve around the voltage */
 static uint16_t getBatteryPercentage()
 {
-	volatile int batteryLevelPctage = ((float)(_lastBatVoltageToBeSent - BATTERY_LEVEL_0_VOLTAGE)/(float)(BATTERY_LEVEL_100_VOLTAGE - BATTERY_LEVEL_0_VOLTAGE))*100;
-	batteryLevelPctage = max(min(batteryLevelPctage, 100),0);
-	return batteryLevelPctage;
+	const uint8_t nbPoints = sizeof(_batteryCurve)/sizeof(BatteryCurvePoint);
+	if(_lastBatVoltageToBeSent <= _batteryCurve[0].voltage)
+	{
+		return 0;
+	}
+	for(uint8_t i=1;i<nbPoints;i++)
+	{
+		if(_lastBatVoltageToBeSent < _batteryCurve[i].voltage)
+		{
+			const BatteryCurvePoint* lowPointPtr = &_batteryCurve[i-1];
+			const BatteryCurvePoint* highPointPtr = &_batteryCurve[i];
+			return lowPointPtr->percentage + (uint32_t)(_lastBatVoltageToBeSent - lowPointPtr->voltage) * (highPointPtr->percentage - lowPointPtr->percentage) / (highPointPtr->voltage - lowPointPtr->voltage);
+		}
+	}
+	return 100;
 }
 
 void batteryManager_getBatteryPercentageStr(uint8_t* buff)
@@ -403,15 +522,16 @@ void batteryManager_printBatteryCheckAlarm()
 
 E_LED_BATTERY_TIER batteryManager_getLedPercentageTier()
 {
-	if(_lastBatVoltageToBeSent < BATTERY_LEVEL_33_VOLTAGE)
+	uint16_t percentage = getBatteryPercentage();
+	if(percentage < BATTERY_LEVEL_MEDIUM_PERCENTAGE)
 	{
 		return LED_BATTERY_TIER_LOW;
 	}
-	else if (_lastBatVoltageToBeSent >= BATTERY_LEVEL_33_VOLTAGE && _lastBatVoltageToBeSent < BATTERY_LEVEL_66_VOLTAGE)
+	else if (percentage < BATTERY_LEVEL_HIGH_PERCENTAGE)
 	{
 		return LED_BATTERY_TIER_MEDIUM;
 	}
-	else if(_lastBatVoltageToBeSent >= BATTERY_LEVEL_66_VOLTAGE && _lastBatVoltageToBeSent < BATTERY_LEVEL_100_VOLTAGE)
+	else if(percentage < 100)
 	{
 		return LED_BATTERY_TIER_HIGH;
 	}
@@ -2,21 +2,24 @@
 #define BATTERY_MANAGER_H_
 
 #include <sgs/port_sgs.h>
+#include <sgs/helper_sgs.h>
 #include <messageSender/message_sender.h>
 #include <seekiosCore/seekios.h>
 #include <tools/led_utilities.h>
 #include <seekiosManager/power_state_manager.h>
+#include <FreeRTOS.h>
+#include <semphr.h>
 
 #define USB_LEVEL_MINIMUM_CHARGE_VOLTAGE	4000
 
 #define BATTERY_LEVEL_100_VOLTAGE			4150 // 100% // The real 100% is 4200 but take too much time to reach ?
 #define BATTERY_LEVEL_0_VOLTAGE				3500 // Level threshold for extinction
 
-#define BATTERY_LEVEL_66_VOLTAGE			((BATTERY_LEVEL_100_VOLTAGE - BATTERY_LEVEL_0_VOLTAGE)*0.66666666)+BATTERY_LEVEL_0_VOLTAGE // 3960 // 66.6%
-#define BATTERY_LEVEL_40_VOLTAGE			((BATTERY_LEVEL_100_VOLTAGE - BATTERY_LEVEL_0_VOLTAGE)*0.40)+BATTERY_LEVEL_0_VOLTAGE //3810 // 40% // Used for as a threshold for checking more regularly the battery status
-#define BATTERY_LEVEL_33_VOLTAGE			((BATTERY_LEVEL_100_VOLTAGE - BATTERY_LEVEL_0_VOLTAGE)*0.33333333)+BATTERY_LEVEL_0_VOLTAGE //3730 // 33.3%
-#define BATTERY_LEVEL_20_VOLTAGE			((BATTERY_LEVEL_100_VOLTAGE - BATTERY_LEVEL_0_VOLTAGE)*0.20)+BATTERY_LEVEL_0_VOLTAGE //3630 // 33.3%
-#define BATTERY_LEVEL_10_VOLTAGE			((BATTERY_LEVEL_100_VOLTAGE - BATTERY_LEVEL_0_VOLTAGE)*0.1)+BATTERY_LEVEL_0_VOLTAGE // Critical level
+#define BATTERY_LEVEL_LOW_PERCENTAGE		20 // Critical level : the low battery message is sent
+#define BATTERY_LEVEL_MEDIUM_PERCENTAGE		33 // LED tiers
+#define BATTERY_LEVEL_HIGH_PERCENTAGE		66
+
+#define BATTERY_GAUGE_MAX_OFFSET			300 // in mV. A +CBC voltage further than that from the ADC voltage is not used to calibrate the ADC
 // We check the battery level on a regular basis (in minutes)
 #if (DEBUG_MODE==1)
 #define BATTERY_CHECK_PERIOD_LOW	10
@@ -25,6 +28,7 @@
 #define BATTERY_CHECK_PERIOD_LOW	10
 #define BATTERY_CHECK_PERIOD_HIGH	30
 #endif
+#define BATTERY_CHECK_ALARM_WINDOW	120 // in sec. The battery check can be done earlier to wake up with another alarm
 
 
 typedef enum{
@@ -47,6 +51,13 @@ typedef struct
 	uint16_t USBVoltage;
 }ADCData;
 
+/* Point of the discharge curve of the battery */
+typedef struct
+{
+	uint16_t voltage;	// in mV
+	uint8_t percentage;
+}BatteryCurvePoint;
+
 void batteryLevel_init(void);
 bool batteryManager_isBatteryLevelCritical(void);
 void batteryManager_convertVoltageToPercentage(uint16_t batVoltage, uint8_t* buff);
@@ -63,6 +74,7 @@ void batteryManager_removeBatteryCheckAlarm(void);
 void batteryManager_updateChargeStatus(void);
 void batteryManager_printBatteryLogs(void);
 void batteryManager_updateAndAnalyzeBattery(void);
+void batteryManager_readADCVoltages(uint16_t* voltages);
 
 
 #endif /* BATTERY_MANAGER_H_ */
\ No newline at end of file
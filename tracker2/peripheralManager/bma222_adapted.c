@@ -1,24 +1,28 @@
 #include <peripheralManager/bma222_adapted.h>
-static void stopFifoInterrupt(void);
-static bool isSeekiosInMovementFromAccelerations(int8_t accelerations[3][MOTION_DETECTION_SAMPLES]);
-static void buildFifo(int8_t accelerations[3][MOTION_DETECTION_SAMPLES]);
-static void updateFifo(int8_t accelerations[3][MOTION_DETECTION_SAMPLES]);
-static void printAccelerationArray(int8_t fifoAccelerations[][MOTION_DETECTION_SAMPLES]);
+static void stopDataInterrupt(void);
+static void printAccelerationArray(MotionClassifier* classifierPtr);
 static SemaphoreHandle_t	_bmaSemaphore;
 
+#if (IMU_DATA_INTERRUPT_ACTIVATED == 1)
+static void startDataInterrupt(void);
+static void readAccelerations(int8_t accelerations[3]);
+static bool detectSignificantMoveFromDataInterrupt(MotionClassifier* classifierPtr);
+
+static volatile TaskHandle_t _samplingTaskHandle = NULL; // task notified by the new data interrupt
+#else
+static bool detectSignificantMoveFromPolling(MotionClassifier* classifierPtr);
 static uint8_t getAccX(void);
 static uint8_t getAccY(void);
 static uint8_t getAccZ(void);
 static bool XnewData(void);
-static bool YnewData(void);
-static bool ZnewData(void);
+#endif
 
 void IMUManager_init(){
 	_bmaSemaphore = xSemaphoreCreateMutex();
 	bma222_set_sleep_duration(0b1101); // 100ms sleep interval
 	bma222_reg_overwrite(0x10, 0b00001000); // set Bandwidth for acceleration data sampling 1000 = 64ms  1001 = 32ms 1010 = 16ms ...  1111 = 0,5ms
 	bma222_reg_overwrite(0x12, 0x00); // Set the LPM1 (0x40) for LPM2
-	stopFifoInterrupt();
+	stopDataInterrupt();
 	bma222_set_sleepmode(BMA_POWERMODE_SUSPEND); // suspend
 	DELAY_MS(100);
 }
@@ -65,16 +69,57 @@ void IMUManager_startSlopeDetection()
 	}
 }
 
-static void stopFifoInterrupt()
+static void stopDataInterrupt()
 {
 	if(xSemaphoreTake(_bmaSemaphore, 100)==pdPASS)
 	{
-		bma222_reg_overwrite(0x17, 0b00000000); // deactivate fifo full interrupt
+		bma222_reg_overwrite(0x17, 0b00000000); // deactivate new data interrupt
 		bma222_reg_overwrite(0x1A, 0b00000000);// unmap to int2 pin
 		xSemaphoreGive(_bmaSemaphore);
 	}
 }
 
+#if (IMU_DATA_INTERRUPT_ACTIVATED == 1)
+static void startDataInterrupt()
+{
+	if(xSemaphoreTake(_bmaSemaphore, 100)==pdPASS)
+	{
+		bma222_reg_overwrite(0x17, 0b00010000); // activate new data interrupt
+		bma222_reg_overwrite(0x1A, 0b10000000);// map to int2 pin
+		xSemaphoreGive(_bmaSemaphore);
+	}
+}
+
+/* Reads the 3 axes in one SPI transfer : registers 0x02 to 0x07 (LSB with new data bit, then MSB, for x, y and z) */
+static void readAccelerations(int8_t accelerations[3])
+{
+	uint8_t registers[6] = {0};
+	if(xSemaphoreTake(_bmaSemaphore, 100)==pdPASS)
+	{
+		bma222_reg_burst_read(0x02, registers, 6);
+		xSemaphoreGive(_bmaSemaphore);
+	}
+	accelerations[0] = registers[1];
+	accelerations[1] = registers[3];
+	accelerations[2] = registers[5];
+}
+
+/* Called by the INT2 interrupt. The sample is read by the detection task : no SPI transfer in the interrupt */
+void IMUManager_dataReadyFromISR()
+{
+	if(_samplingTaskHandle != NULL)
+	{
+		BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+		vTaskNotifyGiveFromISR(_samplingTaskHandle, &xHigherPriorityTaskWoken);
+		portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+	}
+}
+#else
+void IMUManager_dataReadyFromISR()
+{
+}
+#endif
+
 void IMUManager_printSleepDuration()
 {
 	uint8_t sleepDuration = 0;
@@ -99,6 +144,7 @@ void IMUManager_stopSlopeDetection(){
 	}
 }
 
+#if (IMU_DATA_INTERRUPT_ACTIVATED == 0)
 static uint8_t getAccX()
 {
 	uint8_t accX = 0;
@@ -143,27 +189,7 @@ static bool XnewData()
 	return xNewData;
 }
 
-static bool YnewData()
-{
-	uint8_t yNewData = 0;
-	if(xSemaphoreTake(_bmaSemaphore, 100)==pdPASS)
-	{
-		yNewData = bma222_reg_read(0x4) & 0b00000001;
-		xSemaphoreGive(_bmaSemaphore);
-	}
-	return yNewData;
-}
-
-static bool ZnewData()
-{
-	uint8_t zNewData = 0;
-	if(xSemaphoreTake(_bmaSemaphore, 100)==pdPASS)
-	{
-		zNewData = bma222_reg_read(0x6) & 0b00000001;
-		xSemaphoreGive(_bmaSemaphore);
-	}
-	return zNewData;
-}
+#endif
 
 
 void task_detectSignificantMotion(void* param)
@@ -186,105 +212,65 @@ void task_detectSignificantMotion(void* param)
 	FreeRTOSOverlay_taskDelete(NULL);
 }
 
-static bool isSeekiosInMovementFromAccelerations(int8_t accelerations[3][MOTION_DETECTION_SAMPLES]){
-	bool axisStabilities[3] = {false};
+#if (IMU_DATA_INTERRUPT_ACTIVATED == 1)
+/* The MCU sleeps between the samples : the task waits for the new data interrupt */
+static bool detectSignificantMoveFromDataInterrupt(MotionClassifier* classifierPtr){
+	bool significantMoveDetected = false;
+	TickType_t startTime = xTaskGetTickCount();
+	TickType_t detectionTime = MOTION_DETECTION_TIMEOUT + MOTION_DETECTION_SAMPLES * MOTION_DETECTION_SAMPLE_TIMEOUT;
 
-	for(int i = 0;i<3;i++)
+	_samplingTaskHandle = xTaskGetCurrentTaskHandle();
+	ulTaskNotifyTake(pdTRUE, 0);
+	startDataInterrupt();
+
+	while(!significantMoveDetected && xTaskGetTickCount() - startTime < detectionTime)
 	{
-		uint8_t j=0;
-		while(j<MOTION_DETECTION_SAMPLES && axisStabilities[i]==false)
-		{
-			int8_t val = accelerations[i][j];
-			uint8_t occurences=0;
-			for(uint8_t k=0;k<MOTION_DETECTION_SAMPLES;k++)
-			{
-				if(val<=accelerations[i][k]+1
-				&& val>=accelerations[i][k]-1)
-				//if(val==accelerations[i][k])
-				{
-					occurences++;
-				}
-				if(occurences>=MOTION_DETECTION_NB_SIMILAR_VALUES)
-				{
-					axisStabilities[i]=true;
-					break;
-				}
-			}
-			j++;
-		}
+		ulTaskNotifyTake(pdTRUE, MOTION_DETECTION_SAMPLE_TIMEOUT); // read anyway on timeout, in case the interrupt was missed
+		int8_t sample[3];
+		readAccelerations(sample);
+		significantMoveDetected = motionClassifier_addSample(classifierPtr, sample);
 	}
 
-	//USARTManager_printUsbWait("Calculations done.");
-	return !axisStabilities[0] || !axisStabilities[1] || !axisStabilities[2];
+	stopDataInterrupt();
+	_samplingTaskHandle = NULL;
+	return significantMoveDetected;
 }
+#else
+static bool detectSignificantMoveFromPolling(MotionClassifier* classifierPtr){
+	bool significantMoveDetected = false;
+	TickType_t startTime = xTaskGetTickCount();
+	TickType_t detectionTime = MOTION_DETECTION_TIMEOUT + MOTION_DETECTION_SAMPLES * MOTION_DETECTION_REFRESH_RATE_MS;
 
-static void buildFifo(int8_t accelerations[3][MOTION_DETECTION_SAMPLES]){
-	uint8_t xValuesCount = 0;
-	uint8_t yValuesCount = 0;
-	uint8_t zValuesCount = 0;
-
-	while(xValuesCount < MOTION_DETECTION_SAMPLES
-	|| yValuesCount < MOTION_DETECTION_SAMPLES
-	|| zValuesCount < MOTION_DETECTION_SAMPLES)
+	while(!significantMoveDetected && xTaskGetTickCount() - startTime < detectionTime)
 	{
-		if(XnewData() && xValuesCount < MOTION_DETECTION_SAMPLES)
+		if(XnewData())
 		{
-			accelerations[0][xValuesCount++] = getAccX();
-		}
-		if(YnewData() && yValuesCount < MOTION_DETECTION_SAMPLES)
-		{
-			accelerations[1][yValuesCount++] = getAccY();
-		}
-		if(ZnewData() && zValuesCount < MOTION_DETECTION_SAMPLES)
-		{
-			accelerations[2][zValuesCount++] = getAccZ();
+			int8_t sample[3] = {getAccX(), getAccY(), getAccZ()};
+			significantMoveDetected = motionClassifier_addSample(classifierPtr, sample);
 		}
 		vTaskDelay(MOTION_DETECTION_REFRESH_RATE_MS);
 	}
+	return significantMoveDetected;
 }
+#endif
 
-static void updateFifo(int8_t accelerations[3][MOTION_DETECTION_SAMPLES]){
-
-	if(XnewData())
-	{
-		for(uint8_t j=0;j<MOTION_DETECTION_SAMPLES-1;j++){
-			accelerations[0][j] = accelerations[0][j+1];
-		}
-		accelerations[0][MOTION_DETECTION_SAMPLES-1] = getAccX();
-	}
-
-	if(YnewData())
-	{
-		for(uint8_t j=0;j<MOTION_DETECTION_SAMPLES-1;j++){
-			accelerations[1][j] = accelerations[1][j+1];
-		}
-		accelerations[1][MOTION_DETECTION_SAMPLES-1] = getAccY();
-	}
-
-	if(ZnewData())
-	{
-		for(uint8_t j=0;j<MOTION_DETECTION_SAMPLES-1;j++){
-			accelerations[2][j] = accelerations[2][j+1];
-		}
-		accelerations[2][MOTION_DETECTION_SAMPLES-1] = getAccZ();
-	}
-}
-
-static void printAccelerationArray(int8_t fifoAccelerations[][MOTION_DETECTION_SAMPLES])
+/* Prints the window of the classifier, from the oldest sample */
+static void printAccelerationArray(MotionClassifier* classifierPtr)
 {
 	USARTManager_printUsbWait("Accelerations : \r\n");
 	uint8_t i=0;
 	for(i=0;i<MOTION_DETECTION_SAMPLES; i++)
 	{
+		uint8_t index = (classifierPtr->nextSampleIndex + i) % MOTION_DETECTION_SAMPLES;
 		char buff[5];
 		USARTManager_printUsbWait("\tx:");
-		stringHelper_intToString(fifoAccelerations[0][i],(unsigned char*)buff);
+		stringHelper_intToString(classifierPtr->samples[0][index],(unsigned char*)buff);
 		USARTManager_printUsbWait(buff);
 		USARTManager_printUsbWait(" - y:");
-		stringHelper_intToString(fifoAccelerations[1][i],(unsigned char*)buff);
+		stringHelper_intToString(classifierPtr->samples[1][index],(unsigned char*)buff);
 		USARTManager_printUsbWait(buff);
 		USARTManager_printUsbWait(" - z:");
-		stringHelper_intToString(fifoAccelerations[2][i],(unsigned char*)buff);
+		stringHelper_intToString(classifierPtr->samples[2][index],(unsigned char*)buff);
 		USARTManager_printUsbWait(buff);
 		USARTManager_printUsbWait("\r\n");
 	}
@@ -296,35 +282,17 @@ bool IMUManager_detectSignificantMove()
 
 	IMUManager_powerModeNormal(); // We start the normal mode, because in low power it is only one sample per 100ms
 
-	uint32_t i=0;
-	bool isTimeout = false;
-	bool significantMoveDetected = false;
-	int8_t fifoAccelerations[3][MOTION_DETECTION_SAMPLES];
-
-	buildFifo(fifoAccelerations);
+	MotionClassifier classifier;
+	motionClassifier_init(&classifier, MOTION_DETECTION_PROFILE);
 
-	while(!isTimeout && !significantMoveDetected){
-		if(isSeekiosInMovementFromAccelerations(fifoAccelerations)){
-			printAccelerationArray(fifoAccelerations);
-			significantMoveDetected = true;
-		}
-		updateFifo(fifoAccelerations);
-//		#if (DEBUG_MODE == 1)
-// 		char buff[5];
-//  		USARTManager_printUsbWait("\tx:");
-//  		stringHelper_intToString(fifoAccelerations[0][MOTION_DETECTION_SAMPLES-1],(unsigned char*)buff);
-//  		USARTManager_printUsbWait(buff);
-//  		USARTManager_printUsbWait(" - y:");
-//  		stringHelper_intToString(fifoAccelerations[1][MOTION_DETECTION_SAMPLES-1],(unsigned char*)buff);
-//  		USARTManager_printUsbWait(buff);
-//  		USARTManager_printUsbWait(" - z:");
-//  		stringHelper_intToString(fifoAccelerations[2][MOTION_DETECTION_SAMPLES-1],(unsigned char*)buff);
-//  		USARTManager_printUsbWait(buff);
-//  		USARTManager_printUsbWait("\r\n");
-// 		#endif
-		i++;
-		isTimeout = i*MOTION_DETECTION_REFRESH_RATE_MS > MOTION_DETECTION_TIMEOUT;
-		vTaskDelay(MOTION_DETECTION_REFRESH_RATE_MS);
+	#if (IMU_DATA_INTERRUPT_ACTIVATED == 1)
+	bool significantMoveDetected = detectSignificantMoveFromDataInterrupt(&classifier);
+	#else
+	bool significantMoveDetected = detectSignificantMoveFromPolling(&classifier);
+	#endif
+	if(significantMoveDetected)
+	{
+		printAccelerationArray(&classifier);
 	}
 	return significantMoveDetected;
 }
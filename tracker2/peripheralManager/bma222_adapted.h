@@ -17,6 +17,7 @@
 #include <FreeRTOS.h>
 #include <task.h>
 #include <seekiosManager/mask_utilities.h>
+#include <tools/motion_classifier.h>
 
 void IMUManager_init();
 void IMUManager_startSlopeDetection(void);
@@ -28,6 +29,7 @@ void task_detectSignificantMotion(void* param);
 bool IMUManager_detectSignificantMove(void);
 void IMUManager_powerModeNormal(void);
 bool IMUManager_testNormalModeAccelerations(void);
+void IMUManager_dataReadyFromISR(void);
 //void BMA222_powerModeNormal(void);
 
 #define SLOPE_DETECTION_SENSITIVITY 3
@@ -36,9 +38,8 @@ bool IMUManager_testNormalModeAccelerations(void);
 #define BMA_POWERMODE_SUSPEND		2
 
 #define MOTION_DETECTION_TIMEOUT				10000
-#define MOTION_DETECTION_SAMPLES				16			// the number of samples that we use to compute movement detection
-#define MOTION_DETECTION_REFRESH_RATE_MS		20			// the refresh rate at which we take the samples. // TODO : use BMA interrupt that notifies new data
-#define MOTION_DETECTION_THRESHOLD				35			// the threshold is the percentage of values that equals in the buffer for "stable" state to be detected. If the threshold is not met, then it's a motion
-#define MOTION_DETECTION_NB_SIMILAR_VALUES		MOTION_DETECTION_SAMPLES*MOTION_DETECTION_THRESHOLD/100
+#define MOTION_DETECTION_SAMPLES				MOTION_CLASSIFIER_WINDOW	// the number of samples that we use to compute movement detection
+#define MOTION_DETECTION_REFRESH_RATE_MS		20			// the refresh rate at which we take the samples when IMU_DATA_INTERRUPT_ACTIVATED is 0
+#define MOTION_DETECTION_SAMPLE_TIMEOUT			150			// in ms. With the 7.81Hz bandwidth, a new sample comes every 64ms : after this time the sample is read without waiting for the interrupt
 
 #endif /* BMA222_TOS_H_ */
\ No newline at end of file
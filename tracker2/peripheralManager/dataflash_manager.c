@@ -1,24 +1,69 @@
 #include <peripheralManager/dataflash_manager.h>
 
 static void erasePage(uint32_t pageIndex);
+static uint16_t computeCrc16(uint8_t* data, uint8_t length);
+static unsigned int getOutboxPageAddress(uint16_t outboxPage);
+static bool readOutboxPageHeader(uint16_t outboxPage, uint16_t* sequencePtr);
+static uint8_t readOutboxSlotState(uint8_t slot);
+static uint8_t countWrittenSlots(uint8_t firstSlot, uint8_t* firstWrittenSlotPtr);
+static void openNextOutboxPage(void);
+static void advanceOutboxTail(void);
+static void takeDataflashMutex(void);
+static void giveDataflashMutex(void);
 
 const char emptyBuffer[EXT_FLASH_PAGE_SIZE]={0x0};
 
+#define OUTBOX_PAGE_MAGIC			0x5E
+#define OUTBOX_PAGE_HEADER_SIZE		4
+#define OUTBOX_SLOT_HEADER_SIZE		4
+#define OUTBOX_SLOT_SIZE			(OUTBOX_SLOT_HEADER_SIZE + OUTBOX_RECORD_MAX_SIZE)
+#define OUTBOX_SLOTS_PER_PAGE		((EXT_FLASH_PAGE_SIZE - OUTBOX_PAGE_HEADER_SIZE) / OUTBOX_SLOT_SIZE)
+
+/* Slot states. Any other value (erased page) is a free slot */
+#define OUTBOX_SLOT_STATE_WRITTEN	0xA5
+#define OUTBOX_SLOT_STATE_CONSUMED	0x5A
+
+/* Each outbox page starts with { magic, 0, sequence (2 bytes) } followed by OUTBOX_SLOTS_PER_PAGE slots { state, length, crc (2 bytes), record }.
+The sequence of the page is incremented each time the head moves to the next page, so the head and the tail can be found again at boot. */
+static uint16_t _outboxHeadPage;
+static uint8_t	_outboxHeadSlot;
+static uint16_t _outboxHeadSequence;
+static uint16_t _outboxTailPage;
+static uint8_t	_outboxTailSlot;
+static uint16_t _outboxCount;
+
+/* Taken by every public function : they all share the SRAM buffer 1 of the DataFlash and its power state.
+Recursive, because the public functions call each other. The DataFlash is powered down when the last powerUp is released */
+static SemaphoreHandle_t _dataflashMutex;
+static uint8_t _nbPowerUps;
+
 void dataflashManager_init(){
+	_dataflashMutex = xSemaphoreCreateRecursiveMutex();
+	_nbPowerUps = 0;
 	DF_Init();
 	uint8_t dummyBuff[3];
 	dataflashManager_readPage(PAGE_INDEX_TEST_DATAFLASH, 3, dummyBuff);
+	dataflashManager_initOutbox();
 }
 
+/* Takes the DataFlash until dataFlashManager_powerDown */
 void dataflashManager_powerUp(){
-	DF_PowerUp();
-	DELAY_MS(100);
+	takeDataflashMutex();
+	if(_nbPowerUps++ == 0)
+	{
+		DF_PowerUp();
+		DELAY_MS(100);
+	}
 }
 
 void dataFlashManager_powerDown(){
-	DELAY_MS(100);
-	DF_PowerDown();
-	DELAY_MS(100);
+	if(--_nbPowerUps == 0)
+	{
+		DELAY_MS(100);
+		DF_PowerDown();
+		DELAY_MS(100);
+	}
+	giveDataflashMutex();
 }
 
 void dataflashManager_writeToPage(unsigned int pageAdr, unsigned int dataLength, char* dataToWrite){
@@ -36,6 +81,23 @@ unsigned char* dataflashManager_readPage(unsigned int pageAdr, unsigned int data
 	return readBuf;
 }
 
+/* Reads EXT_FLASH_PAGE_SIZE bytes of each page with a single power up, and hands them to pageCallback.
+The mutex is only taken while a page is read : the other users of the DataFlash can run between two pages */
+void dataflashManager_readPages(unsigned int firstPageAdr, uint16_t nbPages, unsigned char* readBuf, void (*pageCallback)(unsigned int pageAdr, unsigned char* page)){
+	dataflashManager_powerUp();
+	giveDataflashMutex(); // the power up is kept until the last page
+	for(uint16_t i = 0; i < nbPages; i++)
+	{
+		takeDataflashMutex();
+		DF_PageToBuffer(1, firstPageAdr + i);
+		DF_BufferReadStr(1, 0, EXT_FLASH_PAGE_SIZE, readBuf);
+		giveDataflashMutex();
+		pageCallback(firstPageAdr + i, readBuf);
+	}
+	takeDataflashMutex();
+	dataFlashManager_powerDown();
+}
+
 /* Debug function : if requested, erases some pages in the ext flash at the start of the program.  */
 void dataflashManager_eraseUsedPages()
 {
@@ -46,6 +108,7 @@ void dataflashManager_eraseUsedPages()
 
 	#if (DELETE_FLASH_PAGE_INDEX_SAVE_MESSAGES			== 1)
 	erasePage(PAGE_INDEX_SAVE_MESSAGES);
+	dataflashManager_eraseOutbox();
 	#endif
 
 	#if (DELETE_FLASH_PAGE_PAGE_INDEX_SEEKIOS_VERSION	== 1)
@@ -67,9 +130,277 @@ void dataflashManager_eraseUsedPages()
 	#if (DELETE_FLASH_PAGE_INDEX_IN_POWER_SAVING	== 1)
 	erasePage(PAGE_INDEX_SEEKIOS_IN_POWER_SAVING);
 	#endif
+
+	#if (DELETE_FLASH_PAGE_INDEX_LAST_NETWORK_OPERATOR	== 1)
+	erasePage(PAGE_INDEX_LAST_NETWORK_OPERATOR);
+	#endif
 }
 
 static void erasePage(uint32_t pageIndex)
 {
 	dataflashManager_writeToPage(pageIndex, EXT_FLASH_PAGE_SIZE, emptyBuffer);
 }
+
+/* Finds back the head and the tail of the outbox log from the page headers and the slot states */
+void dataflashManager_initOutbox()
+{
+	uint16_t sequence;
+	bool headFound = false;
+
+	dataflashManager_powerUp();
+	for(uint16_t i = 0; i < OUTBOX_NB_PAGES; i++)
+	{
+		if(readOutboxPageHeader(i, &sequence)
+		&& (!headFound || (int16_t)(sequence - _outboxHeadSequence) > 0))
+		{
+			_outboxHeadPage = i;
+			_outboxHeadSequence = sequence;
+			headFound = true;
+		}
+	}
+
+	_outboxCount = 0;
+	if(!headFound)
+	{
+		/* Empty log : the first append opens the first page */
+		_outboxHeadPage = OUTBOX_NB_PAGES - 1;
+		_outboxHeadSlot = OUTBOX_SLOTS_PER_PAGE;
+		_outboxHeadSequence = 0xFFFF;
+	}
+	else
+	{
+		readOutboxPageHeader(_outboxHeadPage, &sequence);
+		_outboxHeadSlot = 0;
+		while(_outboxHeadSlot < OUTBOX_SLOTS_PER_PAGE && readOutboxSlotState(_outboxHeadSlot) != 0x00)
+		{
+			_outboxHeadSlot++;
+		}
+	}
+	_outboxTailPage = _outboxHeadPage;
+	_outboxTailSlot = _outboxHeadSlot;
+
+	/* The messages are consumed in FIFO order : we go back from the head until a page without pending record */
+	uint16_t page = _outboxHeadPage;
+	uint16_t expectedSequence = _outboxHeadSequence;
+	for(uint16_t i = 0; headFound && i < OUTBOX_NB_PAGES; i++)
+	{
+		uint8_t firstWrittenSlot;
+		if(!readOutboxPageHeader(page, &sequence) || sequence != expectedSequence)
+		{
+			break;
+		}
+		uint8_t nbWrittenSlots = countWrittenSlots(0, &firstWrittenSlot);
+		if(nbWrittenSlots == 0)
+		{
+			break;
+		}
+		_outboxCount += nbWrittenSlots;
+		_outboxTailPage = page;
+		_outboxTailSlot = firstWrittenSlot;
+		page = (page + OUTBOX_NB_PAGES - 1) % OUTBOX_NB_PAGES;
+		expectedSequence--;
+	}
+	dataFlashManager_powerDown();
+}
+
+/* Appends a record at the head of the outbox log. When the log is full, the oldest page is overwritten */
+bool dataflashManager_appendToOutbox(void* record, uint8_t length)
+{
+	if(length > OUTBOX_RECORD_MAX_SIZE)
+	{
+		return false;
+	}
+
+	dataflashManager_powerUp();
+	if(_outboxHeadSlot >= OUTBOX_SLOTS_PER_PAGE)
+	{
+		openNextOutboxPage();
+	}
+	else
+	{
+		DF_PageToBuffer(1, getOutboxPageAddress(_outboxHeadPage));
+	}
+
+	uint16_t crc = computeCrc16((uint8_t*)record, length);
+	uint8_t slotHeader[OUTBOX_SLOT_HEADER_SIZE] = {OUTBOX_SLOT_STATE_WRITTEN, length, (uint8_t)(crc >> 8), (uint8_t)crc};
+	unsigned int slotOffset = OUTBOX_PAGE_HEADER_SIZE + _outboxHeadSlot * OUTBOX_SLOT_SIZE;
+	DF_BufferWriteStr(1, slotOffset + OUTBOX_SLOT_HEADER_SIZE, length, (unsigned char*)record);
+	DF_BufferWriteStr(1, slotOffset, OUTBOX_SLOT_HEADER_SIZE, slotHeader);
+	DF_BufferToPage(1, getOutboxPageAddress(_outboxHeadPage));
+
+	if(_outboxCount == 0)
+	{
+		_outboxTailPage = _outboxHeadPage;
+		_outboxTailSlot = _outboxHeadSlot;
+	}
+	_outboxHeadSlot++;
+	_outboxCount++;
+	dataFlashManager_powerDown();
+	return true;
+}
+
+/* Copies the oldest valid record of the outbox log in result and marks it as consumed. Corrupted records are skipped */
+bool dataflashManager_extractOutboxFront(void* result, uint8_t length)
+{
+	bool found = false;
+	takeDataflashMutex();
+	if(_outboxCount == 0)
+	{
+		giveDataflashMutex();
+		return false;
+	}
+
+	dataflashManager_powerUp();
+	while(!found && _outboxCount > 0)
+	{
+		uint8_t slotHeader[OUTBOX_SLOT_HEADER_SIZE];
+		unsigned int slotOffset = OUTBOX_PAGE_HEADER_SIZE + _outboxTailSlot * OUTBOX_SLOT_SIZE;
+		DF_PageToBuffer(1, getOutboxPageAddress(_outboxTailPage));
+		DF_BufferReadStr(1, slotOffset, OUTBOX_SLOT_HEADER_SIZE, slotHeader);
+		if(slotHeader[0] == OUTBOX_SLOT_STATE_WRITTEN)
+		{
+			if(slotHeader[1] == length)
+			{
+				DF_BufferReadStr(1, slotOffset + OUTBOX_SLOT_HEADER_SIZE, length, (unsigned char*)result);
+				found = computeCrc16((uint8_t*)result, length) == ((slotHeader[2] << 8) | slotHeader[3]);
+			}
+			uint8_t consumedState = OUTBOX_SLOT_STATE_CONSUMED;
+			DF_BufferWriteStr(1, slotOffset, 1, &consumedState);
+			DF_BufferToPage(1, getOutboxPageAddress(_outboxTailPage));
+			_outboxCount--;
+		}
+		advanceOutboxTail();
+	}
+	dataFlashManager_powerDown();
+	giveDataflashMutex();
+	return found;
+}
+
+uint16_t dataflashManager_getOutboxCount()
+{
+	takeDataflashMutex();
+	uint16_t count = _outboxCount;
+	giveDataflashMutex();
+	return count;
+}
+
+/* Debug function : invalidates every page of the outbox log */
+void dataflashManager_eraseOutbox()
+{
+	dataflashManager_powerUp();
+	DF_BufferWriteStr(1, 0, EXT_FLASH_PAGE_SIZE, (unsigned char*)emptyBuffer);
+	for(uint16_t i = 0; i < OUTBOX_NB_PAGES; i++)
+	{
+		DF_BufferToPage(1, getOutboxPageAddress(i));
+	}
+	dataflashManager_initOutbox(); // still powered up and locked : no record can be appended in between
+	dataFlashManager_powerDown();
+}
+
+/* Moves the head to the next page and prepares it in the buffer 1. The records still pending in this page are dropped */
+static void openNextOutboxPage()
+{
+	uint16_t nextPage = (_outboxHeadPage + 1) % OUTBOX_NB_PAGES;
+	if(_outboxCount > 0 && _outboxTailPage == nextPage)
+	{
+		uint8_t firstWrittenSlot;
+		DF_PageToBuffer(1, getOutboxPageAddress(nextPage));
+		uint8_t nbDroppedRecords = countWrittenSlots(_outboxTailSlot, &firstWrittenSlot);
+		_outboxCount = _outboxCount > nbDroppedRecords ? _outboxCount - nbDroppedRecords : 0;
+		_outboxTailPage = (nextPage + 1) % OUTBOX_NB_PAGES;
+		_outboxTailSlot = 0;
+	}
+
+	_outboxHeadPage = nextPage;
+	_outboxHeadSlot = 0;
+	_outboxHeadSequence++;
+
+	uint8_t pageHeader[OUTBOX_PAGE_HEADER_SIZE] = {OUTBOX_PAGE_MAGIC, 0, (uint8_t)(_outboxHeadSequence >> 8), (uint8_t)_outboxHeadSequence};
+	DF_BufferWriteStr(1, 0, EXT_FLASH_PAGE_SIZE, (unsigned char*)emptyBuffer);
+	DF_BufferWriteStr(1, 0, OUTBOX_PAGE_HEADER_SIZE, pageHeader);
+}
+
+static void advanceOutboxTail()
+{
+	_outboxTailSlot++;
+	if(_outboxTailSlot >= OUTBOX_SLOTS_PER_PAGE && _outboxTailPage != _outboxHeadPage)
+	{
+		_outboxTailPage = (_outboxTailPage + 1) % OUTBOX_NB_PAGES;
+		_outboxTailSlot = 0;
+	}
+	if(_outboxTailPage == _outboxHeadPage && _outboxTailSlot >= _outboxHeadSlot)
+	{
+		_outboxCount = 0;
+	}
+}
+
+static unsigned int getOutboxPageAddress(uint16_t outboxPage)
+{
+	return PAGE_INDEX_OUTBOX_FIRST + outboxPage;
+}
+
+/* Loads the page in the buffer 1 and returns true if it belongs to the outbox log */
+static bool readOutboxPageHeader(uint16_t outboxPage, uint16_t* sequencePtr)
+{
+	uint8_t pageHeader[OUTBOX_PAGE_HEADER_SIZE];
+	DF_PageToBuffer(1, getOutboxPageAddress(outboxPage));
+	DF_BufferReadStr(1, 0, OUTBOX_PAGE_HEADER_SIZE, pageHeader);
+	*sequencePtr = (pageHeader[2] << 8) | pageHeader[3];
+	return pageHeader[0] == OUTBOX_PAGE_MAGIC && pageHeader[1] == 0;
+}
+
+/* Reads the state of a slot of the page loaded in the buffer 1. Returns 0x00 for a free slot */
+static uint8_t readOutboxSlotState(uint8_t slot)
+{
+	uint8_t state;
+	DF_BufferReadStr(1, OUTBOX_PAGE_HEADER_SIZE + slot * OUTBOX_SLOT_SIZE, 1, &state);
+	if(state != OUTBOX_SLOT_STATE_WRITTEN && state != OUTBOX_SLOT_STATE_CONSUMED)
+	{
+		return 0x00;
+	}
+	return state;
+}
+
+/* Counts the pending records of the page loaded in the buffer 1, starting at firstSlot */
+static uint8_t countWrittenSlots(uint8_t firstSlot, uint8_t* firstWrittenSlotPtr)
+{
+	uint8_t nbWrittenSlots = 0;
+	*firstWrittenSlotPtr = OUTBOX_SLOTS_PER_PAGE;
+	for(uint8_t slot = firstSlot; slot < OUTBOX_SLOTS_PER_PAGE; slot++)
+	{
+		if(readOutboxSlotState(slot) == OUTBOX_SLOT_STATE_WRITTEN)
+		{
+			if(nbWrittenSlots == 0)
+			{
+				*firstWrittenSlotPtr = slot;
+			}
+			nbWrittenSlots++;
+		}
+	}
+	return nbWrittenSlots;
+}
+
+/* CRC-16/CCITT of a record */
+static uint16_t computeCrc16(uint8_t* data, uint8_t length)
+{
+	uint16_t crc = 0xFFFF;
+	for(uint8_t i = 0; i < length; i++)
+	{
+		crc ^= (uint16_t)data[i] << 8;
+		for(uint8_t bit = 0; bit < 8; bit++)
+		{
+			crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+		}
+	}
+	return crc;
+}
+
+static void takeDataflashMutex()
+{
+	xSemaphoreTakeRecursive(_dataflashMutex, portMAX_DELAY);
+}
+
+static void giveDataflashMutex()
+{
+	xSemaphoreGiveRecursive(_dataflashMutex);
+}
@@ -11,8 +11,11 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <stdbool.h>
 #include <dataflash_sgs.h>
 #include <sgs/helper_sgs.h>
+#include <FreeRTOS.h>
+#include <semphr.h>
 
 #define PAGE_INDEX_SEEKOIS_ID					0
 #define PAGE_INDEX_SAVE_MESSAGES				1
@@ -21,14 +24,28 @@
 #define PAGE_INDEX_TEST_DATAFLASH				4
 #define PAGE_INDEX_SEEKIOS_PEERED				5
 #define PAGE_INDEX_SEEKIOS_IN_POWER_SAVING		6
+#define PAGE_INDEX_LAST_NETWORK_OPERATOR		7
 
 #define EXT_FLASH_PAGE_SIZE		256
 
+/* Outbox log : ring of pages holding the messages that could not be kept in RAM */
+#define PAGE_INDEX_OUTBOX_FIRST		16
+#define OUTBOX_NB_PAGES				512
+#define OUTBOX_RECORD_MAX_SIZE		80
+
+#define EXT_FLASH_NB_USED_PAGES		(PAGE_INDEX_OUTBOX_FIRST + OUTBOX_NB_PAGES) // the pages after the outbox are never written, whatever the density of the chip
+
 void dataflashManager_init(void);
 void dataflashManager_powerUp(void);
 void dataFlashManager_powerDown(void);
 void dataflashManager_writeToPage(unsigned int intPageAdr, unsigned int dataLength, char* dataToWrite);
 unsigned char* dataflashManager_readPage(unsigned int intPageAdr, unsigned int dataLength,unsigned char* readBuf);
+void dataflashManager_readPages(unsigned int firstPageAdr, uint16_t nbPages, unsigned char* readBuf, void (*pageCallback)(unsigned int pageAdr, unsigned char* page));
 void dataflashManager_eraseUsedPages(void);
+void dataflashManager_initOutbox(void);
+bool dataflashManager_appendToOutbox(void* record, uint8_t length);
+bool dataflashManager_extractOutboxFront(void* result, uint8_t length);
+uint16_t dataflashManager_getOutboxCount(void);
+void dataflashManager_eraseOutbox(void);
 
 #endif /* DATAFLASH_MANAGER_H_ */
\ No newline at end of file
@@ -7,6 +7,7 @@
  */ 
 
 #include <seekiosCore/FreeRTOS_overlay.h>
+#include <seekiosCore/telemetry.h>
 
 void FreeRTOSOverlay_taskDelete(TaskHandle_t taskToDelete)
 {
@@ -14,5 +15,6 @@ void FreeRTOSOverlay_taskDelete(TaskHandle_t taskToDelete)
 	USARTManager_printUsbWait("\t<<< Deleting task ");
 	USARTManager_printUsbWait(taskName);
 	USARTManager_printUsbWait("\r\n");
+	telemetry_recordTaskStack(taskToDelete);
 	vTaskDelete(taskToDelete);
 }
@@ -0,0 +1,173 @@
+/*
+ * debug_log.c
+ *
+ * Content : deferred debug logs. The messages are copied in a RAM ring and written to the sinks (debug USART, USB)
+ * by a low priority drain task, so the callers never wait for the USART or the USB
+ */ 
+
+#include <seekiosCore/debug_log.h>
+#include <peripheralManager/USB_manager.h>
+#include <tools/string_helper.h>
+#include <hpl_core_port.h>
+#include <serial_sgs.h>
+
+static bool writePiece(const char* text, uint16_t length);
+static void writeToSinks(const char* text, uint16_t length);
+static void notifyDrainTask(void);
+
+static char _logRing[LOG_RING_SIZE];
+static volatile uint16_t _logRingHead; // written by the producers, interrupts masked
+static volatile uint16_t _logRingTail; // written by the drain task only
+static volatile uint16_t _nbDroppedLogs;
+static volatile uint8_t _attachedSinks;
+static uint8_t _maxLevel = LOG_COMPILED_LEVEL;
+static uint8_t _moduleMask = LOG_MODULES_ALL;
+static TaskHandle_t _drainTask;
+
+void debugLog_init(){
+	_logRingHead = 0;
+	_logRingTail = 0;
+	_nbDroppedLogs = 0;
+	#if (ACTIVATE_DEBUG_LOGS == 1)
+	_attachedSinks = LOG_SINK_DEBUG_USART;
+	#else
+	_attachedSinks = 0;
+	#endif
+}
+
+void debugLog_registerDrainTask(TaskHandle_t drainTask){
+	_drainTask = drainTask;
+}
+
+void debugLog_write(E_LOG_MODULE module, uint8_t level, const char* text){
+	if(text != NULL)
+	{
+		debugLog_writeN(module, level, text, strlen(text));
+	}
+}
+
+/* Never blocks : can be called from the tasks and the interrupts. The message is copied in pieces of at most LOG_DRAIN_CHUNK
+bytes, so the interrupts are never masked for a long copy (the GSM answers). A long message can be interleaved with a log
+written by an interrupt between two of its pieces, and its end is dropped if the ring is full */
+void debugLog_writeN(E_LOG_MODULE module, uint8_t level, const char* text, uint16_t length){
+	if(_attachedSinks == 0 || level > _maxLevel || (_moduleMask & (1 << module)) == 0 || length == 0)
+	{
+		return;
+	}
+
+	while(length > 0)
+	{
+		uint16_t pieceLength = length > LOG_DRAIN_CHUNK ? LOG_DRAIN_CHUNK : length;
+		if(!writePiece(text, pieceLength))
+		{
+			break;
+		}
+		text += pieceLength;
+		length -= pieceLength;
+	}
+	notifyDrainTask();
+}
+
+/* The pending logs are drained as soon as a sink is attached */
+void debugLog_attachSink(E_LOG_SINK sink){
+	_attachedSinks |= sink;
+	notifyDrainTask();
+}
+
+void debugLog_detachSink(E_LOG_SINK sink){
+	_attachedSinks &= ~sink;
+}
+
+/* Runtime filter, within the levels kept by LOG_COMPILED_LEVEL */
+void debugLog_setFilter(uint8_t maxLevel, uint8_t moduleMask){
+	_maxLevel = maxLevel;
+	_moduleMask = moduleMask;
+}
+
+/* Lowest priority : only runs when no other task is ready. Sleeps while no sink is attached */
+void task_logDrain(void* param){
+	UNUSED(param);
+	static char chunk[LOG_DRAIN_CHUNK + 1]; // kept out of the STACK_SIZE_LOG_DRAIN_TASK stack
+	char buff[8];
+	while(1)
+	{
+		ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+		while(_attachedSinks != 0 && _logRingTail != _logRingHead)
+		{
+			uint16_t tail = _logRingTail;
+			uint16_t head = _logRingHead;
+			uint16_t length = (head > tail ? head : LOG_RING_SIZE) - tail;
+			if(length > LOG_DRAIN_CHUNK)
+			{
+				length = LOG_DRAIN_CHUNK;
+			}
+			memcpy(chunk, &_logRing[tail], length);
+			chunk[length] = '\0';
+			_logRingTail = (tail + length) % LOG_RING_SIZE; // the space is given back before the slow write
+			writeToSinks(chunk, length);
+		}
+		if(_attachedSinks != 0 && _nbDroppedLogs > 0)
+		{
+			strcpy(chunk, "[");
+			strcat(chunk, stringHelper_intToString(_nbDroppedLogs, (uint8_t*)buff));
+			strcat(chunk, " logs dropped]\r\n");
+			_nbDroppedLogs = 0;
+			writeToSinks(chunk, strlen(chunk));
+		}
+	}
+}
+
+/* The Cortex-M0+ has no exclusive access instructions : the producers reserve and copy with the interrupts masked.
+Returns false if the piece does not fit in the ring */
+static bool writePiece(const char* text, uint16_t length){
+	bool isWritten = false;
+	UBaseType_t savedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+	uint16_t head = _logRingHead;
+	uint16_t freeSpace = LOG_RING_SIZE - 1 - (uint16_t)((head + LOG_RING_SIZE - _logRingTail) % LOG_RING_SIZE);
+	if(length > freeSpace)
+	{
+		_nbDroppedLogs++;
+	}
+	else
+	{
+		uint16_t firstPartLength = LOG_RING_SIZE - head;
+		if(firstPartLength > length)
+		{
+			firstPartLength = length;
+		}
+		memcpy(&_logRing[head], text, firstPartLength);
+		memcpy(_logRing, &text[firstPartLength], length - firstPartLength);
+		_logRingHead = (head + length) % LOG_RING_SIZE;
+		isWritten = true;
+	}
+	portCLEAR_INTERRUPT_MASK_FROM_ISR(savedInterruptStatus);
+	return isWritten;
+}
+
+static void writeToSinks(const char* text, uint16_t length){
+	if(_attachedSinks & LOG_SINK_DEBUG_USART)
+	{
+		io_write(usart_debug_io, (const uint8_t *)text, length);
+	}
+	if(_attachedSinks & LOG_SINK_USB)
+	{
+		USBManager_print(text);
+	}
+}
+
+static void notifyDrainTask(){
+	if(_drainTask == NULL)
+	{
+		return;
+	}
+	if(_is_in_isr())
+	{
+		BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+		vTaskNotifyGiveFromISR(_drainTask, &xHigherPriorityTaskWoken);
+		portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+	}
+	else
+	{
+		xTaskNotifyGive(_drainTask);
+	}
+}
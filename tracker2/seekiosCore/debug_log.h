@@ -0,0 +1,77 @@
+/*
+ * debug_log.h
+ *
+ * Content : deferred debug logs. The messages are copied in a RAM ring and written to the sinks (debug USART, USB)
+ * by a low priority drain task, so the callers never wait for the USART or the USB
+ */ 
+
+
+#ifndef DEBUG_LOG_H_
+#define DEBUG_LOG_H_
+
+#include <seekiosCore/seekios.h>
+#include <FreeRTOS.h>
+#include <task.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#define LOG_LEVEL_NONE		0
+#define LOG_LEVEL_ERROR		1
+#define LOG_LEVEL_WARNING	2
+#define LOG_LEVEL_INFO		3 // USARTManager_printUsbWait
+#define LOG_LEVEL_DEBUG		4
+
+#define LOG_RING_SIZE		1024 // bytes of text waiting for the drain task
+#define LOG_DRAIN_CHUNK		128 // bytes written to the sinks at once
+
+typedef enum{
+	LOG_MODULE_SYSTEM	= 0,
+	LOG_MODULE_GSM		= 1,
+	LOG_MODULE_GPS		= 2,
+	LOG_MODULE_SENDER	= 3,
+	LOG_MODULE_LISTENER	= 4,
+	LOG_MODULE_MODES	= 5,
+	LOG_MODULE_BATTERY	= 6,
+	LOG_MODULE_TESTS	= 7,
+}E_LOG_MODULE;
+
+#define LOG_MODULES_ALL		0xFF
+
+typedef enum{
+	LOG_SINK_DEBUG_USART	= (1 << 0),
+	LOG_SINK_USB			= (1 << 1),
+}E_LOG_SINK;
+
+/* The levels above LOG_COMPILED_LEVEL (seekios.h) are removed at compile time, with their strings */
+#if (LOG_COMPILED_LEVEL >= LOG_LEVEL_ERROR)
+#define LOG_ERROR(module, text)		debugLog_write(module, LOG_LEVEL_ERROR, text)
+#else
+#define LOG_ERROR(module, text)
+#endif
+#if (LOG_COMPILED_LEVEL >= LOG_LEVEL_WARNING)
+#define LOG_WARNING(module, text)	debugLog_write(module, LOG_LEVEL_WARNING, text)
+#else
+#define LOG_WARNING(module, text)
+#endif
+#if (LOG_COMPILED_LEVEL >= LOG_LEVEL_INFO)
+#define LOG_INFO(module, text)		debugLog_write(module, LOG_LEVEL_INFO, text)
+#else
+#define LOG_INFO(module, text)
+#endif
+#if (LOG_COMPILED_LEVEL >= LOG_LEVEL_DEBUG)
+#define LOG_DEBUG(module, text)		debugLog_write(module, LOG_LEVEL_DEBUG, text)
+#else
+#define LOG_DEBUG(module, text)
+#endif
+
+void debugLog_init(void);
+void debugLog_registerDrainTask(TaskHandle_t drainTask);
+void task_logDrain(void* param);
+void debugLog_write(E_LOG_MODULE module, uint8_t level, const char* text);
+void debugLog_writeN(E_LOG_MODULE module, uint8_t level, const char* text, uint16_t length);
+void debugLog_attachSink(E_LOG_SINK sink);
+void debugLog_detachSink(E_LOG_SINK sink);
+void debugLog_setFilter(uint8_t maxLevel, uint8_t moduleMask);
+
+#endif /* DEBUG_LOG_H_ */
@@ -0,0 +1,148 @@
+/*
+ * energy_profiler.c
+ *
+ * Content : time spent in each power state of the MCU, the GSM, the GPS and the LEDs, turned into a charge
+ * with a table of currents. Reported over the USB, replayed by energy_analysis/energy_simulation.py
+ */ 
+
+#include <seekiosCore/energy_profiler.h>
+
+#if (ENERGY_PROFILER_ACTIVATED == 1)
+
+#include <peripheralManager/USB_manager.h>
+#include <tools/string_helper.h>
+
+static uint32_t getProfilerTime(void);
+static void printReportValue(const char* name, uint32_t value, char* line);
+
+static const char* const _domainNames[ENERGY_DOMAIN_COUNT] = { "MCU", "GSM", "GPS", "LED" };
+static const char* const _stateNames[ENERGY_DOMAIN_COUNT][ENERGY_MAX_STATES] = {
+	{ "RUN", "STANDBY", "", "" },
+	{ "OFF", "SLEEP", "IDLE", "GPRS" },
+	{ "OFF", "STANDBY", "WARMUP", "TRACKING" },
+	{ "0", "1", "2", "3" },
+};
+static const uint8_t _nbStates[ENERGY_DOMAIN_COUNT] = { 2, 4, 4, 4 };
+
+static uint32_t _currents[ENERGY_DOMAIN_COUNT][ENERGY_MAX_STATES] = {
+	{ ENERGY_MCU_RUN_CURRENT, ENERGY_MCU_STANDBY_CURRENT, 0, 0 },
+	{ 0, ENERGY_GSM_SLEEP_CURRENT, ENERGY_GSM_IDLE_CURRENT, ENERGY_GSM_GPRS_CURRENT },
+	{ 0, ENERGY_GPS_STANDBY_CURRENT, ENERGY_GPS_WARMUP_CURRENT, ENERGY_GPS_TRACKING_CURRENT },
+	{ 0, ENERGY_LED_CURRENT, 2 * ENERGY_LED_CURRENT, 3 * ENERGY_LED_CURRENT },
+};
+static uint32_t _stateTimes[ENERGY_DOMAIN_COUNT][ENERGY_MAX_STATES];	// in ms
+static uint8_t _currentStates[ENERGY_DOMAIN_COUNT];
+static uint32_t _stateStartTimes[ENERGY_DOMAIN_COUNT];
+static uint32_t _runStartTime;
+static uint32_t _hibernationTime;	// in ms. The ticks are stopped during sleep_deep
+/* No init function : at the power on, each domain is in its first state */
+
+/* The time spent in the previous state is recorded. Can be called before the scheduler starts */
+void energyProfiler_setState(E_ENERGY_DOMAIN domain, uint8_t state){
+	if(domain >= ENERGY_DOMAIN_COUNT || state >= _nbStates[domain])
+	{
+		return;
+	}
+	UBaseType_t savedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+	uint32_t now = getProfilerTime();
+	_stateTimes[domain][_currentStates[domain]] += now - _stateStartTimes[domain];
+	_stateStartTimes[domain] = now;
+	_currentStates[domain] = state;
+	portCLEAR_INTERRUPT_MASK_FROM_ISR(savedInterruptStatus);
+}
+
+/* Called when waking up from sleep_deep, with the time measured by the RTC, in sec */
+void energyProfiler_addHibernationTime(uint32_t hibernationTime){
+	UBaseType_t savedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+	_hibernationTime += hibernationTime * 1000;
+	portCLEAR_INTERRUPT_MASK_FROM_ISR(savedInterruptStatus);
+}
+
+/* The names are the ones of the report. The charge is computed when the report is printed : a new current applies to the whole run */
+bool energyProfiler_setCurrent(const char* domainName, const char* stateName, uint32_t current){
+	for(uint8_t domain = 0; domain < ENERGY_DOMAIN_COUNT; domain++)
+	{
+		for(uint8_t state = 0; state < _nbStates[domain]; state++)
+		{
+			if(strcmp(domainName, _domainNames[domain]) == 0 && strcmp(stateName, _stateNames[domain][state]) == 0)
+			{
+				_currents[domain][state] = current;
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+/* Starts a new run. The domains keep their current state */
+void energyProfiler_reset(){
+	UBaseType_t savedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+	uint32_t now = getProfilerTime();
+	memset(_stateTimes, 0, sizeof(_stateTimes));
+	for(uint8_t domain = 0; domain < ENERGY_DOMAIN_COUNT; domain++)
+	{
+		_stateStartTimes[domain] = now;
+	}
+	_runStartTime = now;
+	portCLEAR_INTERRUPT_MASK_FROM_ISR(savedInterruptStatus);
+}
+
+/* One line "ENG_STATE:domain:state:time in ms:current in uA:charge in uAh" per state, then the totals of the run */
+void energyProfiler_printReport(){
+	char line[64];
+	char buff[12];
+	uint64_t totalCharge = 0; // in uA.ms
+
+	for(uint8_t domain = 0; domain < ENERGY_DOMAIN_COUNT; domain++)
+	{
+		energyProfiler_setState(domain, _currentStates[domain]);
+	}
+	uint32_t runTime = getProfilerTime() - _runStartTime;
+	printReportValue(TX_ENERGY_RUN_TIME, runTime, line);
+
+	for(uint8_t domain = 0; domain < ENERGY_DOMAIN_COUNT; domain++)
+	{
+		for(uint8_t state = 0; state < _nbStates[domain]; state++)
+		{
+			uint64_t charge = (uint64_t)_stateTimes[domain][state] * _currents[domain][state];
+			totalCharge += charge;
+			strcpy(line, TX_ENERGY_STATE);
+			strcat(line, ":");
+			strcat(line, _domainNames[domain]);
+			strcat(line, ":");
+			strcat(line, _stateNames[domain][state]);
+			strcat(line, ":");
+			strcat(line, stringHelper_intToString(_stateTimes[domain][state], (uint8_t*)buff));
+			strcat(line, ":");
+			strcat(line, stringHelper_intToString(_currents[domain][state], (uint8_t*)buff));
+			printReportValue("", charge / 3600000, line);
+		}
+	}
+
+	printReportValue(TX_ENERGY_TOTAL_CHARGE, totalCharge / 3600000, line);
+	uint32_t averageCurrent = runTime > 0 ? totalCharge / runTime : 0;
+	printReportValue(TX_ENERGY_AVERAGE_CURRENT, averageCurrent, line);
+	if(averageCurrent > 0)
+	{
+		printReportValue(TX_ENERGY_BATTERY_LIFE, ENERGY_BATTERY_CAPACITY * 1000UL / averageCurrent, line); // in hours
+	}
+	USBManager_println(TX_ENERGY_OVER);
+}
+
+static uint32_t getProfilerTime(){
+	return xTaskGetTickCountFromISR() + _hibernationTime;
+}
+
+/* The line is "name:value". If name is empty, the value is appended to the line already started */
+static void printReportValue(const char* name, uint32_t value, char* line){
+	char buff[12];
+	if(name[0] != '\0')
+	{
+		strcpy(line, name);
+	}
+	strcat(line, ":");
+	strcat(line, stringHelper_intToString(value, (uint8_t*)buff));
+	USBManager_println(line);
+}
+
+#endif
@@ -0,0 +1,69 @@
+/*
+ * energy_profiler.h
+ *
+ * Content : time spent in each power state of the MCU, the GSM, the GPS and the LEDs, turned into a charge
+ * with a table of currents. Reported over the USB, replayed by energy_analysis/energy_simulation.py
+ */ 
+
+
+#ifndef ENERGY_PROFILER_H_
+#define ENERGY_PROFILER_H_
+
+#include <seekiosCore/seekios.h>
+#include <FreeRTOS.h>
+#include <task.h>
+#include <stdint.h>
+#include <string.h>
+
+#define ENERGY_MAX_STATES			4
+#define ENERGY_BATTERY_CAPACITY		500 // in mAh, used for the battery life estimate
+
+/* Default currents, in uA. They can be changed with the USB SET_ENERGY_CURRENT command.
+Keep them in sync with energy_simulation.py */
+#define ENERGY_MCU_RUN_CURRENT		3000
+#define ENERGY_MCU_STANDBY_CURRENT	40		// the whole board in sleep_deep
+#define ENERGY_GSM_SLEEP_CURRENT	1500	// AT+CSCLK=1 and DTR high
+#define ENERGY_GSM_IDLE_CURRENT		20000
+#define ENERGY_GSM_GPRS_CURRENT		150000	// bearer being opened or HTTP request, averaged over the bursts
+#define ENERGY_GPS_STANDBY_CURRENT	200		// as GPS_STANDBY_CURRENT
+#define ENERGY_GPS_WARMUP_CURRENT	25000	// as GPS_ACQUISITION_CURRENT
+#define ENERGY_GPS_TRACKING_CURRENT	20000
+#define ENERGY_LED_CURRENT			2000	// per lit LED
+
+typedef enum{
+	ENERGY_DOMAIN_MCU	= 0,
+	ENERGY_DOMAIN_GSM	= 1,
+	ENERGY_DOMAIN_GPS	= 2,
+	ENERGY_DOMAIN_LED	= 3,
+	ENERGY_DOMAIN_COUNT
+}E_ENERGY_DOMAIN;
+
+/* The first state of each domain is the state at the power on */
+typedef enum{
+	ENERGY_STATE_MCU_RUN		= 0,
+	ENERGY_STATE_MCU_STANDBY	= 1,
+}E_ENERGY_STATE_MCU;
+
+typedef enum{
+	ENERGY_STATE_GSM_OFF	= 0,
+	ENERGY_STATE_GSM_SLEEP	= 1,
+	ENERGY_STATE_GSM_IDLE	= 2,
+	ENERGY_STATE_GSM_GPRS	= 3,
+}E_ENERGY_STATE_GSM;
+
+typedef enum{
+	ENERGY_STATE_GPS_OFF		= 0,
+	ENERGY_STATE_GPS_STANDBY	= 1,
+	ENERGY_STATE_GPS_WARMUP		= 2, // powered, no fix yet
+	ENERGY_STATE_GPS_TRACKING	= 3,
+}E_ENERGY_STATE_GPS;
+
+/* The state of the LED domain is the number of lit LEDs */
+
+void energyProfiler_setState(E_ENERGY_DOMAIN domain, uint8_t state);
+void energyProfiler_addHibernationTime(uint32_t hibernationTime);
+bool energyProfiler_setCurrent(const char* domainName, const char* stateName, uint32_t current);
+void energyProfiler_reset(void);
+void energyProfiler_printReport(void);
+
+#endif /* ENERGY_PROFILER_H_ */
@@ -6,6 +6,7 @@ we also configure the peripherals
 */
 
 void init_init(){
+	telemetry_init();
 	USARTManager_init();
 	maskUtilities_init();
 	TRNGManager_init();
@@ -22,12 +23,12 @@ void init_init(){
 	statusManager_initStatusManager();
 	functionalitiesTest_init();
 	messageListener_init();
-	messageSender_init();
 	buttonManager_init();
 	GPSManager_init();
 	LEDManager_init();
 	dontMoveBle_init();
 	dataflashManager_init();
+	messageSender_init(); // after the dataflash : the outbox log is recovered at its init
 	ledUtilities_init();
 	IMUManager_init();
 	USBManager_init();
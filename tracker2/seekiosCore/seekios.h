@@ -35,6 +35,17 @@
 	#define ACTIVATE_GPS_LOGS								0	// GPS Logs : records all the position that the Seekios sent back to the user
 	#define TESTING_ACTIVATED								0 // Use the scenario_tests program to run with this version
 	#define USB_ACTIVATED									0 // Activate the USB from the beginning instead of waiting for an admin frame to authorize it
+	#define UART_DMA_RX_ACTIVATED							0 // 1 : GPS and GSM bytes received by the DMAC in circular buffers / 0 : one interrupt per received byte
+	#define TELEMETRY_IN_STATUS_MESSAGES					0 // 1 : heap and stack telemetry appended to the version messages
+	#define TRACE_ACTIVATED									1 // 1 : task switches, masks, AT commands and hibernation recorded in RAM, dumped with the USB GET_TRACE command
+	#define COMPACT_UPLINK_ACTIVATED						0 // 1 : the message types of COMPACT_UPLINK_MESSAGE_TYPES are sent as a binary frame to the CMPT endpoint
+	#define TRACK_SEGMENTS_ACTIVATED						0 // 1 : the tracking fixes are grouped in delta-encoded segments sent to the ATS endpoint
+	#define IMU_DATA_INTERRUPT_ACTIVATED					1 // 1 : the motion samples are read when the BMA222 new data interrupt (INT2) fires / 0 : polled every MOTION_DETECTION_REFRESH_RATE_MS
+	#define MOTION_DETECTION_PROFILE						MOTION_PROFILE_LUGGAGE // sensitivity of the significant move detection, MOTION_PROFILE_* of tools/motion_classifier.h. PET wakes at rest on knocks
+	#define ADC_BATTERY_GAUGE_ACTIVATED						1 // 1 : the battery checks read the ADC, calibrated with the +CBC answers when the GSM is started / 0 : the battery checks power on the GSM for a +CBC
+	#define ENERGY_PROFILER_ACTIVATED						1 // 1 : the time in each power state of the MCU, GSM, GPS and LEDs is recorded, reported with the USB GET_ENERGY command
+	#define UART_REPLAY_ACTIVATED							1 // 1 : the GPS and GSM lines can be recorded or replayed over the USB (replay_harness/uart_replay.py)
+	#define LOG_COMPILED_LEVEL								4 // LOG_LEVEL_* of seekiosCore/debug_log.h : the logs of a higher level are removed at compile time
 
 	/* Set to 1 to delete this part in flash */
 	#define DELETE_FLASH_PAGE_INDEX_SEEKIOS_ID				0
@@ -44,6 +55,7 @@
 	#define DELETE_FLASH_PAGE_PAGE_INDEX_TEST_DATAFLASH		0
 	#define DELETE_FLASH_PAGE_PAGE_INDEX_SEEKIOS_PEERED		0
 	#define DELETE_FLASH_PAGE_INDEX_IN_POWER_SAVING			0
+	#define DELETE_FLASH_PAGE_INDEX_LAST_NETWORK_OPERATOR	0
 
 	/* When cloud not available (see addFakeFrames in message listener) */
 	#define TEST_FAKE_DONT_MOVE								0
@@ -74,6 +86,17 @@
 	#define ACTIVATE_GPS_LOGS								0 
 	#define TESTING_ACTIVATED								0
 	#define USB_ACTIVATED									0
+	#define UART_DMA_RX_ACTIVATED							0
+	#define TELEMETRY_IN_STATUS_MESSAGES					0
+	#define TRACE_ACTIVATED									0
+	#define COMPACT_UPLINK_ACTIVATED						0
+	#define TRACK_SEGMENTS_ACTIVATED						0
+	#define IMU_DATA_INTERRUPT_ACTIVATED					0
+	#define MOTION_DETECTION_PROFILE						MOTION_PROFILE_LUGGAGE
+	#define ADC_BATTERY_GAUGE_ACTIVATED						0
+	#define ENERGY_PROFILER_ACTIVATED						0
+	#define UART_REPLAY_ACTIVATED							0
+	#define LOG_COMPILED_LEVEL								3 // the GSM answers (LOG_LEVEL_DEBUG) are removed
 
 	/* Set to 1 to delete this part in flash */
 	#define DELETE_FLASH_PAGE_INDEX_SEEKIOS_ID				0
@@ -83,6 +106,7 @@
 	#define DELETE_FLASH_PAGE_PAGE_INDEX_TEST_DATAFLASH		0
 	#define DELETE_FLASH_PAGE_PAGE_INDEX_SEEKIOS_PEERED		0
 	#define DELETE_FLASH_PAGE_INDEX_IN_POWER_SAVING			0
+	#define DELETE_FLASH_PAGE_INDEX_LAST_NETWORK_OPERATOR	0
 	
 	/* When cloud not available */
 	#define TEST_FAKE_DONT_MOVE			0
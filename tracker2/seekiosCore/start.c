@@ -16,6 +16,7 @@ int start_start(void)
 }
 
 static void startTasks(){
+	taskManagementUtilities_startLogDrainTask();
 	#if (POWER_TESTS_ACTIVATED==1)
 	taskManagementUtilities_startPowerTestTask();
 	#else
@@ -24,14 +25,16 @@ static void startTasks(){
 }
 
 static void startSeekiosManager(){
+	TaskHandle_t seekiosManagerTaskHandle;
 	if(xTaskCreate(
 	task_seekiosManager,
 	"Seekios manager task",
 	STACK_SIZE_SEEKIOS_MANAGER_TASK,
 	NULL,
 	TASK_DEFAULT_PRIORITY,
-	NULL
+	&seekiosManagerTaskHandle
 	) == pdPASS){
+		maskUtilities_registerDispatcher(seekiosManagerTaskHandle); // the seekios manager is woken up by the mask changes
 		vTaskStartScheduler();
 	}
 	else
@@ -42,6 +45,10 @@ static void startSeekiosManager(){
 
 
 
+void vApplicationMallocFailedHook(void){
+	telemetry_recordAllocationFailure();
+}
+
 void vApplicationStackOverflowHook( TaskHandle_t xTask, char *pcTaskName ){
 	// se dclenche en cas de stack overflow sur une task ?
 	send_debug("Tasks stack overflow on task ");
@@ -4,6 +4,7 @@
 #include <stdint.h>
 #include <seekiosManager/seekios_manager.h>
 #include <seekiosCore/init.h>
+#include <seekiosCore/telemetry.h>
 
 int start_start (void);
 
@@ -0,0 +1,149 @@
+/*
+ * telemetry.c
+ *
+ * Content : heap and stack usage recorded in the field, to size the heap and the task stacks
+ */ 
+
+#include <seekiosCore/telemetry.h>
+#include <peripheralManager/USB_manager.h>
+#include <tools/string_helper.h>
+#include <tests/monitor_frame.h>
+
+static void printTelemetryValue(const char* name, uint32_t value, char* line);
+
+static TaskStackTelemetry _tasksStack[TELEMETRY_MAX_TASKS];
+static uint8_t _nbTasksStack;
+static size_t _minLargestFreeBlock;
+static volatile uint32_t _allocationFailureCount;
+
+void telemetry_init(){
+	_nbTasksStack = 0;
+	_minLargestFreeBlock = configTOTAL_HEAP_SIZE;
+	_allocationFailureCount = 0;
+}
+
+/* The minimum ever free heap is kept by heap_4 itself : only the fragmentation has to be sampled */
+void telemetry_sampleHeap(){
+	size_t largestFreeBlock = xPortGetLargestFreeBlockSize();
+	if(largestFreeBlock < _minLargestFreeBlock)
+	{
+		_minLargestFreeBlock = largestFreeBlock;
+	}
+}
+
+/* Records the high water mark of the task (NULL for the calling task), keeping the lowest one for each task name.
+Must be called while the task still exists : before deleting it, or on a task that is never deleted */
+void telemetry_recordTaskStack(TaskHandle_t task){
+	char* taskName = pcTaskGetTaskName(task);
+	UBaseType_t freeStack = uxTaskGetStackHighWaterMark(task);
+
+	taskENTER_CRITICAL();
+	uint8_t i = 0;
+	while(i < _nbTasksStack && strncmp(_tasksStack[i].taskName, taskName, configMAX_TASK_NAME_LEN) != 0)
+	{
+		i++;
+	}
+	if(i == _nbTasksStack && _nbTasksStack < TELEMETRY_MAX_TASKS)
+	{
+		strncpy(_tasksStack[i].taskName, taskName, configMAX_TASK_NAME_LEN);
+		_tasksStack[i].taskName[configMAX_TASK_NAME_LEN - 1] = '\0';
+		_tasksStack[i].minFreeStack = freeStack;
+		_nbTasksStack++;
+	}
+	else if(i < _nbTasksStack && freeStack < _tasksStack[i].minFreeStack)
+	{
+		_tasksStack[i].minFreeStack = freeStack;
+	}
+	taskEXIT_CRITICAL();
+}
+
+/* Called by the malloc failed hook */
+void telemetry_recordAllocationFailure(){
+	_allocationFailureCount++;
+}
+
+size_t telemetry_getMinimumEverFreeHeap(){
+	return xPortGetMinimumEverFreeHeapSize();
+}
+
+size_t telemetry_getMinimumLargestFreeBlock(){
+	return _minLargestFreeBlock;
+}
+
+uint32_t telemetry_getAllocationFailureCount(){
+	return _allocationFailureCount;
+}
+
+UBaseType_t telemetry_getLowestFreeStack(){
+	UBaseType_t lowestFreeStack = 0;
+	for(uint8_t i = 0; i < _nbTasksStack; i++)
+	{
+		if(i == 0 || _tasksStack[i].minFreeStack < lowestFreeStack)
+		{
+			lowestFreeStack = _tasksStack[i].minFreeStack;
+		}
+	}
+	return lowestFreeStack;
+}
+
+/* Sends the telemetry to the USB test monitor, one value per line */
+void telemetry_printReport(){
+	char line[48];
+	printTelemetryValue(TX_TELEMETRY_FREE_HEAP, xPortGetFreeHeapSize(), line);
+	printTelemetryValue(TX_TELEMETRY_MIN_FREE_HEAP, xPortGetMinimumEverFreeHeapSize(), line);
+	printTelemetryValue(TX_TELEMETRY_LARGEST_FREE_BLOCK, xPortGetLargestFreeBlockSize(), line);
+	printTelemetryValue(TX_TELEMETRY_MIN_LARGEST_FREE_BLOCK, _minLargestFreeBlock, line);
+	printTelemetryValue(TX_TELEMETRY_ALLOCATION_FAILURES, _allocationFailureCount, line);
+	for(uint8_t i = 0; i < _nbTasksStack; i++)
+	{
+		strcpy(line, TX_TELEMETRY_TASK_STACK);
+		strcat(line, ":");
+		strcat(line, _tasksStack[i].taskName);
+		printTelemetryValue("", _tasksStack[i].minFreeStack, line);
+	}
+	USBManager_println(TX_TELEMETRY_OVER);
+}
+
+/* Binary version of telemetry_printReport : free heap, min free heap, largest free block, min largest free block,
+allocation failures (4 bytes each), number of tasks, then { task name (configMAX_TASK_NAME_LEN bytes), min free stack (2 bytes) } per task */
+void telemetry_sendFrame(uint8_t frameId){
+	uint8_t payload[21 + TELEMETRY_MAX_TASKS * (configMAX_TASK_NAME_LEN + 2)];
+	uint8_t* payloadPtr = payload;
+	payloadPtr = monitorFrame_putUint32(payloadPtr, xPortGetFreeHeapSize());
+	payloadPtr = monitorFrame_putUint32(payloadPtr, xPortGetMinimumEverFreeHeapSize());
+	payloadPtr = monitorFrame_putUint32(payloadPtr, xPortGetLargestFreeBlockSize());
+	payloadPtr = monitorFrame_putUint32(payloadPtr, _minLargestFreeBlock);
+	payloadPtr = monitorFrame_putUint32(payloadPtr, _allocationFailureCount);
+	*payloadPtr++ = _nbTasksStack;
+	for(uint8_t i = 0; i < _nbTasksStack; i++)
+	{
+		memcpy(payloadPtr, _tasksStack[i].taskName, configMAX_TASK_NAME_LEN);
+		payloadPtr = monitorFrame_putUint16(payloadPtr + configMAX_TASK_NAME_LEN, _tasksStack[i].minFreeStack);
+	}
+	monitorFrame_send(frameId, payload, payloadPtr - payload);
+}
+
+/* Appends "/minFreeHeap/minLargestFreeBlock/allocationFailures/lowestFreeStack" to the message */
+void telemetry_catTelemetry(char* resultBuf){
+	char buff[12];
+	strcat(resultBuf, "/");
+	strcat(resultBuf, stringHelper_intToString(xPortGetMinimumEverFreeHeapSize(), (uint8_t*)buff));
+	strcat(resultBuf, "/");
+	strcat(resultBuf, stringHelper_intToString(_minLargestFreeBlock, (uint8_t*)buff));
+	strcat(resultBuf, "/");
+	strcat(resultBuf, stringHelper_intToString(_allocationFailureCount, (uint8_t*)buff));
+	strcat(resultBuf, "/");
+	strcat(resultBuf, stringHelper_intToString(telemetry_getLowestFreeStack(), (uint8_t*)buff));
+}
+
+/* The line is "name:value". If name is empty, the value is appended to the line already started */
+static void printTelemetryValue(const char* name, uint32_t value, char* line){
+	char buff[12];
+	if(name[0] != '\0')
+	{
+		strcpy(line, name);
+	}
+	strcat(line, ":");
+	strcat(line, stringHelper_intToString(value, (uint8_t*)buff));
+	USBManager_println(line);
+}
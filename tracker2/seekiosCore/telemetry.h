@@ -0,0 +1,35 @@
+/*
+ * telemetry.h
+ *
+ * Content : heap and stack usage recorded in the field, to size the heap and the task stacks
+ */ 
+
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include <FreeRTOS.h>
+#include <task.h>
+#include <stdint.h>
+#include <string.h>
+
+#define TELEMETRY_MAX_TASKS		24
+
+typedef struct{
+	char taskName[configMAX_TASK_NAME_LEN];
+	UBaseType_t minFreeStack; // lowest high water mark recorded, in words
+}TaskStackTelemetry;
+
+void telemetry_init(void);
+void telemetry_sampleHeap(void);
+void telemetry_recordTaskStack(TaskHandle_t task);
+void telemetry_recordAllocationFailure(void);
+size_t telemetry_getMinimumEverFreeHeap(void);
+size_t telemetry_getMinimumLargestFreeBlock(void);
+uint32_t telemetry_getAllocationFailureCount(void);
+UBaseType_t telemetry_getLowestFreeStack(void);
+void telemetry_printReport(void);
+void telemetry_sendFrame(uint8_t frameId);
+void telemetry_catTelemetry(char* resultBuf);
+
+#endif /* TELEMETRY_H_ */
@@ -0,0 +1,190 @@
+/*
+ * trace.c
+ *
+ * Content : a RAM ring of timestamped records (task switches, masks changes, AT commands, hibernation),
+ * dumped over the USB and decoded by trace_analysis/trace_decoder.py
+ */ 
+
+#include <seekiosCore/trace.h>
+
+#if (TRACE_ACTIVATED == 1)
+
+#include <peripheralManager/USB_manager.h>
+#include <tools/string_helper.h>
+#include <tests/monitor_frame.h>
+
+#define TRACE_RECORDS_PER_LINE	8
+#define TRACE_RECORDS_PER_FRAME	(MONITOR_FRAME_MAX_PAYLOAD / sizeof(TraceRecord))
+
+static uint32_t hashATCommandName(const char* command);
+
+static TraceRecord _traceRing[TRACE_RING_SIZE];
+static uint16_t _traceRingIndex;
+static uint16_t _nbTraceRecords;
+static TraceTaskName _traceTaskNames[TRACE_MAX_TASK_NAMES];
+static uint8_t _nbTraceTaskNames;
+static uint8_t _nextTraceTaskNameIndex;
+static volatile bool _isTraceFrozen;
+static void* _lastSwitchedInTask;
+/* No init function : the tasks created before the seekios init are recorded in the zeroed ring */
+
+/* Can be called from the tasks, the interrupts and the kernel critical sections */
+void trace_record(E_TRACE_EVENT event, uint32_t arg){
+	if(_isTraceFrozen)
+	{
+		return;
+	}
+	UBaseType_t savedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+	_traceRing[_traceRingIndex].tick = xTaskGetTickCountFromISR();
+	_traceRing[_traceRingIndex].eventAndArg = ((uint32_t)event << 24) | (arg & TRACE_ARG_MASK);
+	_traceRingIndex = (_traceRingIndex + 1) % TRACE_RING_SIZE;
+	if(_nbTraceRecords < TRACE_RING_SIZE)
+	{
+		_nbTraceRecords++;
+	}
+	portCLEAR_INTERRUPT_MASK_FROM_ISR(savedInterruptStatus);
+}
+
+/* traceTASK_CREATE hook. The task id is the address of its TCB : the name of a recreated task replaces the old one */
+void trace_recordTaskCreated(void* task, const char* taskName){
+	uint32_t taskId = (uint32_t)task & TRACE_ARG_MASK;
+	uint8_t i = 0;
+	while(i < _nbTraceTaskNames && _traceTaskNames[i].taskId != taskId)
+	{
+		i++;
+	}
+	if(i == _nbTraceTaskNames)
+	{
+		i = _nextTraceTaskNameIndex;
+		_nextTraceTaskNameIndex = (_nextTraceTaskNameIndex + 1) % TRACE_MAX_TASK_NAMES;
+		if(_nbTraceTaskNames < TRACE_MAX_TASK_NAMES)
+		{
+			_nbTraceTaskNames++;
+		}
+	}
+	_traceTaskNames[i].taskId = taskId;
+	strncpy(_traceTaskNames[i].taskName, taskName, configMAX_TASK_NAME_LEN);
+	_traceTaskNames[i].taskName[configMAX_TASK_NAME_LEN - 1] = '\0';
+	trace_record(TRACE_EVENT_TASK_CREATED, taskId);
+}
+
+/* traceTASK_SWITCHED_IN hook, called by the scheduler even when the same task keeps running */
+void trace_recordTaskSwitchedIn(void* task){
+	if(task != _lastSwitchedInTask)
+	{
+		_lastSwitchedInTask = task;
+		trace_record(TRACE_EVENT_TASK_SWITCHED_IN, (uint32_t)task);
+	}
+}
+
+void trace_recordATCommandStart(const char* command){
+	trace_record(TRACE_EVENT_AT_COMMAND_START, hashATCommandName(command));
+}
+
+/* Sends the task names then the records, oldest first, as little endian hex.
+The recording is suspended during the dump */
+void trace_printDump(){
+	char line[24 + 2 * sizeof(TraceRecord) * TRACE_RECORDS_PER_LINE];
+	char buff[12];
+	_isTraceFrozen = true;
+
+	strcpy(line, TX_TRACE_NOW);
+	strcat(line, ":");
+	strcat(line, stringHelper_intToString(xTaskGetTickCount(), (uint8_t*)buff));
+	USBManager_println(line);
+
+	for(uint8_t i = 0; i < _nbTraceTaskNames; i++)
+	{
+		strcpy(line, TX_TRACE_TASK);
+		strcat(line, ":");
+		strcat(line, stringHelper_intToString(_traceTaskNames[i].taskId, (uint8_t*)buff));
+		strcat(line, ":");
+		strcat(line, _traceTaskNames[i].taskName);
+		USBManager_println(line);
+	}
+
+	uint16_t recordIndex = (_traceRingIndex + TRACE_RING_SIZE - _nbTraceRecords) % TRACE_RING_SIZE;
+	uint16_t nbDumpedRecords = 0;
+	while(nbDumpedRecords < _nbTraceRecords)
+	{
+		strcpy(line, TX_TRACE_DATA);
+		strcat(line, ":");
+		uint16_t lineLength = strlen(line);
+		for(uint8_t i = 0; i < TRACE_RECORDS_PER_LINE && nbDumpedRecords < _nbTraceRecords; i++)
+		{
+			stringHelper_byteArrayToHexString((uint8_t*)&_traceRing[recordIndex], sizeof(TraceRecord), (uint8_t*)&line[lineLength]);
+			lineLength += 2 * sizeof(TraceRecord);
+			recordIndex = (recordIndex + 1) % TRACE_RING_SIZE;
+			nbDumpedRecords++;
+		}
+		line[lineLength] = '\0';
+		USBManager_println(line);
+	}
+
+	USBManager_println(TX_TRACE_OVER);
+	_isTraceFrozen = false;
+}
+
+/* Binary version of trace_printDump. The first frame is the tick, the number of task names, then { task id, task name }
+per task (4 + configMAX_TASK_NAME_LEN bytes). The next frames are the records, oldest first, as in the ring */
+void trace_sendFrames(uint8_t frameId){
+	static uint8_t payload[MONITOR_FRAME_MAX_PAYLOAD];
+	uint8_t* payloadPtr = payload;
+	_isTraceFrozen = true;
+
+	payloadPtr = monitorFrame_putUint32(payloadPtr, xTaskGetTickCount());
+	*payloadPtr++ = _nbTraceTaskNames;
+	for(uint8_t i = 0; i < _nbTraceTaskNames; i++)
+	{
+		payloadPtr = monitorFrame_putUint32(payloadPtr, _traceTaskNames[i].taskId);
+		memcpy(payloadPtr, _traceTaskNames[i].taskName, configMAX_TASK_NAME_LEN);
+		payloadPtr += configMAX_TASK_NAME_LEN;
+	}
+	monitorFrame_send(frameId, payload, payloadPtr - payload);
+
+	uint16_t recordIndex = (_traceRingIndex + TRACE_RING_SIZE - _nbTraceRecords) % TRACE_RING_SIZE;
+	uint16_t nbSentRecords = 0;
+	while(nbSentRecords < _nbTraceRecords)
+	{
+		payloadPtr = payload;
+		for(uint8_t i = 0; i < TRACE_RECORDS_PER_FRAME && nbSentRecords < _nbTraceRecords; i++)
+		{
+			payloadPtr = monitorFrame_putUint32(payloadPtr, _traceRing[recordIndex].tick);
+			payloadPtr = monitorFrame_putUint32(payloadPtr, _traceRing[recordIndex].eventAndArg);
+			recordIndex = (recordIndex + 1) % TRACE_RING_SIZE;
+			nbSentRecords++;
+		}
+		monitorFrame_send(frameId, payload, payloadPtr - payload);
+	}
+	_isTraceFrozen = false;
+}
+
+/* FNV-1a hash of the command name : the characters after "AT", up to the parameters.
+trace_decoder.py computes the same hash on the AT commands found in the sources */
+static uint32_t hashATCommandName(const char* command){
+	uint32_t hash = 2166136261u;
+	if(strncmp(command, "AT", 2) == 0)
+	{
+		command += 2;
+	}
+	while(*command != '\0' && *command != '=' && *command != '?' && *command != '\r')
+	{
+		hash = (hash ^ (uint8_t)*command) * 16777619u;
+		command++;
+	}
+	return hash & TRACE_ARG_MASK;
+}
+
+#else
+
+/* The scheduler hooks are declared in FreeRTOSConfig.h : they are kept empty when the trace is disabled */
+void trace_recordTaskCreated(void* task, const char* taskName){
+	UNUSED(task);
+	UNUSED(taskName);
+}
+
+void trace_recordTaskSwitchedIn(void* task){
+	UNUSED(task);
+}
+
+#endif
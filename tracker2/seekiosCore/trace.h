@@ -0,0 +1,55 @@
+/*
+ * trace.h
+ *
+ * Content : a RAM ring of timestamped records (task switches, masks changes, AT commands, hibernation),
+ * dumped over the USB and decoded by trace_analysis/trace_decoder.py
+ */ 
+
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include <seekiosCore/seekios.h>
+#include <FreeRTOS.h>
+#include <task.h>
+#include <stdint.h>
+#include <string.h>
+
+#define TRACE_RING_SIZE			128 // number of records kept, 8 bytes each
+#define TRACE_MAX_TASK_NAMES	24
+#define TRACE_ARG_MASK			0x00FFFFFF // the argument of a record is on 24 bits
+
+/* Keep the values in sync with trace_decoder.py */
+typedef enum{
+	TRACE_EVENT_TASK_CREATED		= 1, // arg : task id
+	TRACE_EVENT_TASK_SWITCHED_IN	= 2, // arg : task id
+	TRACE_EVENT_REQUEST_MASK_SET	= 3, // arg : bits
+	TRACE_EVENT_REQUEST_MASK_CLEARED = 4,
+	TRACE_EVENT_RUNNING_MASK_SET	= 5,
+	TRACE_EVENT_RUNNING_MASK_CLEARED = 6,
+	TRACE_EVENT_INTERRUPT_MASK_SET	= 7,
+	TRACE_EVENT_INTERRUPT_MASK_CLEARED = 8,
+	TRACE_EVENT_AT_COMMAND_START	= 9, // arg : hash of the command name
+	TRACE_EVENT_AT_COMMAND_END		= 10, // arg : E_SERIAL_ANSWER
+	TRACE_EVENT_HIBERNATE_ENTER		= 11, // arg : RTC timestamp, the ticks are stopped during the sleep
+	TRACE_EVENT_HIBERNATE_EXIT		= 12, // arg : RTC timestamp
+}E_TRACE_EVENT;
+
+typedef struct{
+	uint32_t tick;
+	uint32_t eventAndArg; // event in the 8 upper bits, argument in the 24 lower bits
+}TraceRecord;
+
+typedef struct{
+	uint32_t taskId;
+	char taskName[configMAX_TASK_NAME_LEN];
+}TraceTaskName;
+
+void trace_record(E_TRACE_EVENT event, uint32_t arg);
+void trace_recordTaskCreated(void* task, const char* taskName);
+void trace_recordTaskSwitchedIn(void* task);
+void trace_recordATCommandStart(const char* command);
+void trace_printDump(void);
+void trace_sendFrames(uint8_t frameId);
+
+#endif /* TRACE_H_ */
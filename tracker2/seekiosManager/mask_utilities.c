@@ -3,11 +3,18 @@
 static EventGroupHandle_t _runningMaskHandle;
 static EventGroupHandle_t _requestMaskHandle;
 static EventGroupHandle_t _interruptMaskHandle;
+static TaskHandle_t _dispatcherTaskHandle;
+
+static EventBits_t setMaskBits(EventGroupHandle_t maskHandle, uint32_t bitsToSet, E_TRACE_EVENT traceEvent);
+static EventBits_t clearMaskBits(EventGroupHandle_t maskHandle, uint32_t bitsToClear, E_TRACE_EVENT traceEvent);
+static void setMaskBitsFromISR(EventGroupHandle_t maskHandle, uint32_t bitsToSet, E_TRACE_EVENT traceEvent);
+static void notifyDispatcher(void);
 
 void maskUtilities_init(){
 	_interruptMaskHandle		= xEventGroupCreate();
 	_runningMaskHandle			= xEventGroupCreate();
 	_requestMaskHandle			= xEventGroupCreate();
+	_dispatcherTaskHandle		= NULL;
 
 	maskUtilities_clearRunningMask();
 	maskUtilities_clearRequestMask();
@@ -15,93 +22,52 @@ void maskUtilities_init(){
 }
 
 EventBits_t maskUtilities_setRequestMaskBits(uint32_t bitsToSet){
-	return xEventGroupSetBits(
-	_requestMaskHandle,
-	bitsToSet
-	);
+	return setMaskBits(_requestMaskHandle, bitsToSet, TRACE_EVENT_REQUEST_MASK_SET);
 }
 
 EventBits_t maskUtilities_setRunningMaskBits(uint32_t bitsToSet){
-	return xEventGroupSetBits(
-	_runningMaskHandle,
-	bitsToSet
-	);
+	return setMaskBits(_runningMaskHandle, bitsToSet, TRACE_EVENT_RUNNING_MASK_SET);
 }
 
 void maskUtilities_setInterruptMaskBitsFromISR(uint32_t bitsToSet){
-	BaseType_t xHigherPriorityTaskWoken, xResult;
-
-	xHigherPriorityTaskWoken = pdFALSE;
-	xResult = xEventGroupSetBitsFromISR(
-	_interruptMaskHandle,
-	bitsToSet,
-	&xHigherPriorityTaskWoken
-	);
-
-	if( xResult != pdFAIL )
-	{
-		portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
-	}
+	setMaskBitsFromISR(_interruptMaskHandle, bitsToSet, TRACE_EVENT_INTERRUPT_MASK_SET);
 }
 
 void maskUtilities_setRequestMaskBitsFromISR(uint32_t bitsToSet){
-	BaseType_t xHigherPriorityTaskWoken, xResult;
-
-	xHigherPriorityTaskWoken = pdFALSE;
-	xResult = xEventGroupSetBitsFromISR(
-	_requestMaskHandle,
-	bitsToSet,
-	&xHigherPriorityTaskWoken
-	);
-
-	if( xResult != pdFAIL )
-	{
-		portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
-	}
+	setMaskBitsFromISR(_requestMaskHandle, bitsToSet, TRACE_EVENT_REQUEST_MASK_SET);
 }
 
 EventBits_t maskUtilities_setInterruptMaskBits(uint32_t bitsToSet){
-	return xEventGroupSetBits(
-	_interruptMaskHandle,
-	bitsToSet
-	);
+	return setMaskBits(_interruptMaskHandle, bitsToSet, TRACE_EVENT_INTERRUPT_MASK_SET);
 }
 
 EventBits_t maskUtilities_clearRequestMaskBits(uint32_t bitsToClear){
-	return xEventGroupClearBits(
-	_requestMaskHandle,
-	bitsToClear
-	);
+	return clearMaskBits(_requestMaskHandle, bitsToClear, TRACE_EVENT_REQUEST_MASK_CLEARED);
 }
 
 EventBits_t maskUtilities_clearRunningMaskBits(uint32_t bitsToClear){
-	return xEventGroupClearBits(
-	_runningMaskHandle,
-	bitsToClear
-	);
+	return clearMaskBits(_runningMaskHandle, bitsToClear, TRACE_EVENT_RUNNING_MASK_CLEARED);
 }
 
 EventBits_t maskUtilities_clearInterruptMaskBits(uint32_t bitsToClear){
-	return xEventGroupClearBits(
-	_interruptMaskHandle,
-	bitsToClear
-	);
+	return clearMaskBits(_interruptMaskHandle, bitsToClear, TRACE_EVENT_INTERRUPT_MASK_CLEARED);
 }
 
 EventBits_t maskUtilities_clearInterruptMask(){
-	return xEventGroupClearBits(
+	return clearMaskBits(
 	_interruptMaskHandle,
 	INTERRUPT_BIT_MOTION_DETECTED
 	| INTERRUPT_BIT_TAP_DETECTED
 	| INTERRUPT_BIT_DOUBLE_TAP_DETECTED
 	| INTERRUPT_BIT_RING_INDICATOR
 	| INTERRUPT_BIT_BUTTON
-	| INTERRUPT_BIT_CALENDAR_MODE_WAKEUP
+	| INTERRUPT_BIT_CALENDAR_MODE_WAKEUP,
+	TRACE_EVENT_INTERRUPT_MASK_CLEARED
 	);
 }
 
 EventBits_t maskUtilities_clearRunningMask(){
-	return xEventGroupClearBits(
+	return clearMaskBits(
 	_runningMaskHandle,
 	RUNNING_BIT_LISTENER
 	| RUNNING_BIT_MODE
@@ -109,13 +75,14 @@ EventBits_t maskUtilities_clearRunningMask(){
 	| RUNNING_BIT_SENDER
 	| RUNNING_BIT_GPS_MANAGER
 	| RUNNING_BIT_LED_INSTRUCTION
-	| RUNNING_BIT_GSM_TASK
+	| RUNNING_BIT_GSM_TASK,
+	TRACE_EVENT_RUNNING_MASK_CLEARED
 	);
 }
 
 
 EventBits_t maskUtilities_clearRequestMask(){
-	return xEventGroupClearBits(
+	return clearMaskBits(
 	_requestMaskHandle,
 	REQUEST_BIT_START_MODE_FROM_LPC
 	| REQUEST_BIT_START_MODE_FROM_RC
@@ -126,8 +93,80 @@ EventBits_t maskUtilities_clearRequestMask(){
 	| REQUEST_BIT_GPS_SOS
 	| REQUEST_BIT_GPS_EXPIRED
 	| REQUEST_BIT_SEEKIOS_TURN_OFF
-	| REQUEST_BIT_SEEKIOS_TURN_ON
+	| REQUEST_BIT_SEEKIOS_TURN_ON,
+	TRACE_EVENT_REQUEST_MASK_CLEARED
+	);
+}
+
+/* The dispatcher is the task notified each time a mask changes (the seekios manager) */
+void maskUtilities_registerDispatcher(TaskHandle_t dispatcherTaskHandle){
+	_dispatcherTaskHandle = dispatcherTaskHandle;
+}
+
+/* Blocks the dispatcher until a mask changes or the timeout expires.
+Returns true if a mask has changed since the last call */
+bool maskUtilities_waitMasksChange(TickType_t timeout){
+	return ulTaskNotifyTake(pdTRUE, timeout) > 0;
+}
+
+/* The dispatcher is only notified when a bit really changes : a task clearing an already cleared bit would wake it up for nothing */
+static EventBits_t setMaskBits(EventGroupHandle_t maskHandle, uint32_t bitsToSet, E_TRACE_EVENT traceEvent){
+	UNUSED(traceEvent);
+	bool isChanging = (xEventGroupGetBits(maskHandle) & bitsToSet) != bitsToSet;
+	EventBits_t maskBits = xEventGroupSetBits(maskHandle, bitsToSet);
+	if(isChanging)
+	{
+		#if (TRACE_ACTIVATED == 1)
+		trace_record(traceEvent, bitsToSet);
+		#endif
+		notifyDispatcher();
+	}
+	return maskBits;
+}
+
+static EventBits_t clearMaskBits(EventGroupHandle_t maskHandle, uint32_t bitsToClear, E_TRACE_EVENT traceEvent){
+	UNUSED(traceEvent);
+	EventBits_t previousMaskBits = xEventGroupClearBits(maskHandle, bitsToClear);
+	if(previousMaskBits & bitsToClear)
+	{
+		#if (TRACE_ACTIVATED == 1)
+		trace_record(traceEvent, previousMaskBits & bitsToClear);
+		#endif
+		notifyDispatcher();
+	}
+	return previousMaskBits;
+}
+
+/* The bits are set by the timer daemon, which has a higher priority than the dispatcher : they are set when the dispatcher wakes up */
+static void setMaskBitsFromISR(EventGroupHandle_t maskHandle, uint32_t bitsToSet, E_TRACE_EVENT traceEvent){
+	BaseType_t xHigherPriorityTaskWoken, xResult;
+	UNUSED(traceEvent);
+
+	xHigherPriorityTaskWoken = pdFALSE;
+	xResult = xEventGroupSetBitsFromISR(
+	maskHandle,
+	bitsToSet,
+	&xHigherPriorityTaskWoken
 	);
+
+	if( xResult != pdFAIL )
+	{
+		#if (TRACE_ACTIVATED == 1)
+		trace_record(traceEvent, bitsToSet);
+		#endif
+		if(_dispatcherTaskHandle != NULL)
+		{
+			vTaskNotifyGiveFromISR(_dispatcherTaskHandle, &xHigherPriorityTaskWoken);
+		}
+		portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+	}
+}
+
+static void notifyDispatcher(){
+	if(_dispatcherTaskHandle != NULL)
+	{
+		xTaskNotifyGive(_dispatcherTaskHandle);
+	}
 }
 
 EventBits_t maskUtilities_requestGPSFromMode(){
@@ -4,6 +4,8 @@
 #include <stdint.h>
 #include <FreeRTOS.h>
 #include <event_groups.h>
+#include <task.h>
+#include <seekiosCore/trace.h>
 #include <stdbool.h>
 
 #define INTERRUPT_BIT_MOTION_DETECTED		(1 << 0)
@@ -97,5 +99,7 @@ void maskUtilities_printRunningMask(void);
 void maskUtilities_printInterruptMask(void);
 void maskUtilities_setRequestTurnOffSeekios(void);
 void maskUtilities_setRequestTurnOnSeekios(void);
+void maskUtilities_registerDispatcher(TaskHandle_t dispatcherTaskHandle);
+bool maskUtilities_waitMasksChange(TickType_t timeout);
 
 #endif /* MASK_UTILITIES_H_ */
\ No newline at end of file
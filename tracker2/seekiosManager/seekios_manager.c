@@ -48,8 +48,6 @@ static void gpsLifeCycle(void);
 
 static bool _allMaskClearedDoubleCheck;
 
-static size_t fh;
-static BaseType_t wm;
 /*TODO: delete line*/volatile char sentenceBuffer[128];
 static void init(){
 	seekiosManagerStarted = true;
@@ -65,6 +63,7 @@ static void init(){
 
 
 	dataflashManager_eraseUsedPages();
+	taskManagementUtilities_initWorkers();
 	taskManagementUtilities_startButtonManagerTask();
 	taskManagementUtilities_startLedManagerTask();
 	bool isSeekiosFirstRun = seekiosInfoManager_isSeekiosFirstRun();
@@ -215,18 +214,18 @@ void task_seekiosManager(void* param){
 		
 		handleUSBPlug();
 
-		fh = xPortGetFreeHeapSize();
-		wm = uxTaskGetStackHighWaterMark(NULL);
+		telemetry_sampleHeap();
+		telemetry_recordTaskStack(NULL);
 
+		/* Sleeps until a mask changes : the handlers run as soon as their bits are set or a running task ends */
 		if(maskUtilities_areAllMaskCleared() && !_allMaskClearedDoubleCheck){
-			_allMaskClearedDoubleCheck = true;
-			vTaskDelay(1000);
+			_allMaskClearedDoubleCheck = !maskUtilities_waitMasksChange(SEEKIOS_MANAGER_HIBERNATION_DELAY);
 			continue;
 		}
 		else if(!maskUtilities_areAllMaskCleared())
 		{
 			_allMaskClearedDoubleCheck = false;
-			vTaskDelay(1000);
+			maskUtilities_waitMasksChange(SEEKIOS_MANAGER_USB_POLL_TIME);
 			continue;
 		}
 
@@ -254,8 +253,10 @@ static void gsmLifeCycle()
 				|| messageSender_outboxHasMessages()\
 				|| (requestMask & REQUEST_BIT_LISTENER)\
 				|| (runningMask & RUNNING_BIT_LISTENER)\
-				|| (runningMask & RUNNING_BIT_SENDER)\
-				|| (requestMask & REQUEST_BIT_CHECK_BATTERY);
+				|| (runningMask & RUNNING_BIT_SENDER);
+				#if (ADC_BATTERY_GAUGE_ACTIVATED == 0)
+				isGsmNeeded = isGsmNeeded || (requestMask & REQUEST_BIT_CHECK_BATTERY);
+				#endif
 								
 				if(!GSMManager_isModuleStarted() && isGsmNeeded)
 				{
@@ -343,7 +344,7 @@ static void handleRequestSignificantMotionDetection()
 
 /* When the USB is plugged, we : show the current charge level.
 We change the USB charge status every 30 seconds only : to avoid weird led showing when the battery is going up and down all the time
-This function is called by the seekiosManager every seconds, so the secondsCount is updating to 1 each time the function is called.*/
+This function is called by the seekiosManager at each mask change, and at least every SEEKIOS_MANAGER_USB_POLL_TIME.*/
 static void handleUSBPlug()
 {
 	static uint32_t currentlyRunningChargeLevelInstructionID = 0;
@@ -644,6 +645,7 @@ static void restoreMasks()
 /* Terminates the GPS and all activity related to it */
 static void terminateGPSUse()
 {
+	GPSPowerPolicy_clearNextUse(); // powered off, not in standby
 	handleGPSExpired();
 	GPSManager_removeGPSExpirationAlarm();
 }
@@ -689,7 +691,21 @@ This function enters the MCU in deep sleep/hibernation state, deactivating many
 void seekiosManager_hibernate(){
 
 	USARTManager_printUsbWait("deep sleep\r\n");
+	#if (TRACE_ACTIVATED == 1)
+	trace_record(TRACE_EVENT_HIBERNATE_ENTER, RTCManager_getCurrentTimestamp());
+	#endif
+	#if (ENERGY_PROFILER_ACTIVATED == 1)
+	uint32_t hibernationStart = RTCManager_getCurrentTimestamp();
+	energyProfiler_setState(ENERGY_DOMAIN_MCU, ENERGY_STATE_MCU_STANDBY);
+	#endif
 	sleep_deep(); // TODO : put deep sleep instead of normal sleep
+	#if (ENERGY_PROFILER_ACTIVATED == 1)
+	energyProfiler_addHibernationTime(RTCManager_getCurrentTimestamp() - hibernationStart);
+	energyProfiler_setState(ENERGY_DOMAIN_MCU, ENERGY_STATE_MCU_RUN);
+	#endif
+	#if (TRACE_ACTIVATED == 1)
+	trace_record(TRACE_EVENT_HIBERNATE_EXIT, RTCManager_getCurrentTimestamp());
+	#endif
 
 	vTaskDelay(1000);
 }
@@ -754,7 +770,7 @@ static void handleGPSRequest(){
 /* While the GPS manager stops itself because there is no GPS needs,
 we set an alarm to wake up the seekios and determine that it has expired */
 static void handleGPSUnused(){
-	if(powerStateManager_isPowerSavingEnabled())
+	if(powerStateManager_isPowerSavingEnabled() || GPSPowerPolicy_isNextUseScheduled()) // the GPS is released until its next scheduled use
 	{
 		maskUtilities_setRequestMaskBits(REQUEST_BIT_GPS_EXPIRED);
 	}
@@ -771,7 +787,7 @@ static void handleGPSReused(){
 
 static void handleGPSExpired(){
 	USARTManager_printUsbWait("GPS Expired !\r\n");
-	GPSManager_powerOffGPS();
+	GPSManager_releaseGPS();
 	maskUtilities_clearRequestMaskBits(REQUEST_BIT_GPS_EXPIRED);
 }
 
@@ -1011,6 +1027,11 @@ static bool terminateRunningMode(){
 		maskUtilities_clearRunningMaskBits(RUNNING_BIT_MODE);
 	}
 
+	#if (TRACK_SEGMENTS_ACTIVATED == 1)
+	/* The fixes of the stopped mode are not kept waiting for a segment to fill */
+	modesToolkit_flushTrackSegment();
+	#endif
+
 	if(modesUtilities_isTrackingPeriodAlarmScheduled())
 	{
 		modesToolkit_removeTrackingPeriodAlarm();
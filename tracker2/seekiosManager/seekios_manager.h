@@ -31,6 +31,10 @@
 #include <seekiosManager/seekios_info_manager.h>
 #include <peripheralManager/NVM_Manager.h>
 #include <sgs/powersaving_sgs.h>
+#include <seekiosCore/energy_profiler.h>
+
+#define SEEKIOS_MANAGER_HIBERNATION_DELAY	1000 // the masks have to stay cleared during this time before hibernating
+#define SEEKIOS_MANAGER_USB_POLL_TIME		2000 // the USB plug has no interrupt : its voltage is still sampled while the seekios is awake
 
 void task_seekiosManager(void* param);
 void preSleepConfig(void);
@@ -7,10 +7,22 @@
 
 #include <seekiosManager/task_management_utilities.h>
 
-static TaskHandle_t _messageListenerHandle;
-static TaskHandle_t _GPSManagerHandle;
-static TaskHandle_t _messageSenderHandle;
-static TaskHandle_t _gsmTaskHandle;
+/* A worker is a task created once at start-up, which runs its job each time it is notified */
+typedef struct{
+	TaskFunction_t job;
+	void* jobParam;
+	TaskHandle_t handle;
+	volatile bool isBusy;
+}Worker;
+
+static BaseType_t createWorker(Worker* workerPtr, TaskFunction_t job, const char * const pcName, const uint16_t usStackDepth);
+static BaseType_t startWorker(Worker* workerPtr, void* jobParam);
+static void task_worker(void* param);
+
+static Worker _messageListenerWorker;
+static Worker _GPSManagerWorker;
+static Worker _messageSenderWorker;
+static Worker _gsmWorker;
 static TaskHandle_t _ringIndicatorTaskHandle;
 static TaskHandle_t	_currentlyRunningModeTaskHandle;
 static TaskHandle_t _onDemandTaskHandle;
@@ -25,42 +37,112 @@ static TaskHandle_t _gsmTestTaskHandle;
 static TaskHandle_t _gpsTestTaskHandle;
 static TaskHandle_t _calendarTestTaskHandle;
 static TaskHandle_t _usbMonitorTaskHandle;
+static TaskHandle_t _buttonManagerTaskHandle;
+static TaskHandle_t _ledManagerTaskHandle;
+static TaskHandle_t _logDrainTaskHandle;
+
+/* Creates the workers of the listener, sender, GPS and GSM jobs.
+Called once at start-up, before the heap gets fragmented by the other tasks */
+void taskManagementUtilities_initWorkers(){
+	createWorker(&_messageListenerWorker, task_messageListener, "u-list", STACK_SIZE_LISTENING_TASK);
+	createWorker(&_messageSenderWorker, task_messageSender, "u-send", STACK_SIZE_SENDING_TASK);
+	createWorker(&_GPSManagerWorker, task_GPSManager, "u-GPS", STACK_SIZE_GPS_TASK);
+	createWorker(&_gsmWorker, task_GSMTask, "u-gsm", STACK_SIZE_MODULE_TASK);
+}
+
+/* The memory of a deleted task is only freed by the idle task.
+If the allocation fails, the running tasks are suspended to let the idle task run, and the creation is retried */
+BaseType_t taskManagementUtilities_createTask(TaskFunction_t pxTaskCode, const char * const pcName, const uint16_t usStackDepth, void * const pvParameters, UBaseType_t uxPriority, TaskHandle_t * const pxCreatedTask){
+	BaseType_t result = xTaskCreate(pxTaskCode, pcName, usStackDepth, pvParameters, uxPriority, pxCreatedTask);
+	if(result == errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY)
+	{
+		taskManagementUtilities_suspendRunningTasks();
+		vTaskDelay(TASK_CREATION_RETRY_DELAY);
+		taskManagementUtilities_resumeRunningTasks();
+		volatile int fh = xPortGetFreeHeapSize();
+		char buff[16];
+		stringHelper_intToString(fh, (unsigned char*)buff);
+		USARTManager_printUsbWait("Remaining HEAP Before creating ");
+		USARTManager_printUsbWait(pcName);
+		USARTManager_printUsbWait(" : ");
+		USARTManager_printUsbWait(buff);
+		USARTManager_printUsbWait("\r\n");
+		result = xTaskCreate(pxTaskCode, pcName, usStackDepth, pvParameters, uxPriority, pxCreatedTask);
+	}
+	return result;
+}
+
+/* Records the stack of the tasks that are never deleted. The deleted tasks are recorded by FreeRTOSOverlay_taskDelete */
+void taskManagementUtilities_recordPersistentTasksStack(){
+	Worker* workers[] = {&_messageListenerWorker, &_messageSenderWorker, &_GPSManagerWorker, &_gsmWorker};
+	for(uint8_t i = 0; i < sizeof(workers)/sizeof(Worker*); i++)
+	{
+		if(workers[i]->handle != NULL)
+		{
+			telemetry_recordTaskStack(workers[i]->handle);
+		}
+	}
+	if(_buttonManagerTaskHandle != NULL)
+	{
+		telemetry_recordTaskStack(_buttonManagerTaskHandle);
+	}
+	if(_ledManagerTaskHandle != NULL)
+	{
+		telemetry_recordTaskStack(_ledManagerTaskHandle);
+	}
+	if(_logDrainTaskHandle != NULL)
+	{
+		telemetry_recordTaskStack(_logDrainTaskHandle);
+	}
+}
+
+static BaseType_t createWorker(Worker* workerPtr, TaskFunction_t job, const char * const pcName, const uint16_t usStackDepth){
+	workerPtr->job = job;
+	workerPtr->jobParam = NULL;
+	workerPtr->isBusy = false;
+	return xTaskCreate(task_worker, pcName, usStackDepth, workerPtr, TASK_DEFAULT_PRIORITY, &workerPtr->handle);
+}
 
-BaseType_t taskManagementUtilities_suspendTasksAndCreateTask(TaskFunction_t pxTaskCode, const char * const pcName, const uint16_t usStackDepth, void * const pvParameters, UBaseType_t uxPriority, TaskHandle_t * const pxCreatedTask){
-	taskManagementUtilities_suspendRunningTasks();
-	volatile UBaseType_t wm = uxTaskGetStackHighWaterMark(NULL);
-	UNUSED(wm);
-	vTaskDelay(200);
-	taskManagementUtilities_resumeRunningTasks();
-	volatile int fh = xPortGetFreeHeapSize();
-	char buff[16];
-	stringHelper_intToString(fh, (unsigned char*)buff);
-	USARTManager_printUsbWait("Remaining HEAP Before creating ");
-	USARTManager_printUsbWait(pcName);
-	USARTManager_printUsbWait(" : ");
-	USARTManager_printUsbWait(buff);
-	USARTManager_printUsbWait("\r\n");
-	return xTaskCreate(pxTaskCode, pcName, usStackDepth, pvParameters, uxPriority, pxCreatedTask);
+/* Fails if the job of the worker is already pending or running */
+static BaseType_t startWorker(Worker* workerPtr, void* jobParam){
+	if(workerPtr->handle == NULL || workerPtr->isBusy)
+	{
+		return pdFAIL;
+	}
+	workerPtr->isBusy = true;
+	workerPtr->jobParam = jobParam;
+	xTaskNotifyGive(workerPtr->handle);
+	return pdPASS;
+}
+
+static void task_worker(void* param){
+	Worker* workerPtr = (Worker*)param;
+	while(1)
+	{
+		ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+		workerPtr->job(workerPtr->jobParam);
+		workerPtr->isBusy = false;
+	}
 }
 
 void taskManagementUtilities_suspendRunningTasks(){
 	EventBits_t runningMask = maskUtilities_getRunningMask();
 
 	if(runningMask & RUNNING_BIT_GPS_MANAGER){
-		if(eTaskGetState(_GPSManagerHandle) != eBlocked){ // we don't suspend the task if it is already in the blocked state
-			vTaskSuspend(_GPSManagerHandle);
+		if(eTaskGetState(_GPSManagerWorker.handle) != eBlocked){ // we don't suspend the task if it is already in the blocked state
+			vTaskSuspend(_GPSManagerWorker.handle);
 		}
 	}
 
 	if(runningMask & RUNNING_BIT_GSM_TASK){
-		if(eTaskGetState(_gsmTaskHandle) != eBlocked){
-			vTaskSuspend(_gsmTaskHandle);
+		if(eTaskGetState(_gsmWorker.handle) != eBlocked){
+			vTaskSuspend(_gsmWorker.handle);
 		}
 	}
 
 	if(runningMask & RUNNING_BIT_LISTENER){
-		if(eTaskGetState(_messageListenerHandle) != eBlocked){
-			vTaskSuspend(_messageListenerHandle);
+		if(eTaskGetState(_messageListenerWorker.handle) != eBlocked){
+			vTaskSuspend(_messageListenerWorker.handle);
 		}
 	}
 
@@ -71,8 +153,8 @@ void taskManagementUtilities_suspendRunningTasks(){
 	}
 
 	if(runningMask & RUNNING_BIT_SENDER){
-		if(eTaskGetState(_messageSenderHandle) != eBlocked){
-			vTaskSuspend(_messageSenderHandle);
+		if(eTaskGetState(_messageSenderWorker.handle) != eBlocked){
+			vTaskSuspend(_messageSenderWorker.handle);
 		}
 	}
 
@@ -122,15 +204,15 @@ void taskManagementUtilities_suspendRunningTasks(){
 void taskManagementUtilities_resumeRunningTasks(){
 	EventBits_t runningMask = maskUtilities_getRunningMask();
 	if(runningMask & RUNNING_BIT_GPS_MANAGER){
-		vTaskResume(_GPSManagerHandle);
+		vTaskResume(_GPSManagerWorker.handle);
 	}
 
 	if(runningMask & RUNNING_BIT_GSM_TASK){
-		vTaskResume(_gsmTaskHandle);
+		vTaskResume(_gsmWorker.handle);
 	}
 
 	if(runningMask & RUNNING_BIT_LISTENER){
-		vTaskResume(_messageListenerHandle);
+		vTaskResume(_messageListenerWorker.handle);
 	}
 
 	if(runningMask & RUNNING_BIT_ON_DEMAND){
@@ -138,7 +220,7 @@ void taskManagementUtilities_resumeRunningTasks(){
 	}
 
 	if(runningMask & RUNNING_BIT_SENDER){
-		vTaskResume(_messageSenderHandle);
+		vTaskResume(_messageSenderWorker.handle);
 	}
 
 	if(runningMask & RUNNING_BIT_SOS){
@@ -171,49 +253,49 @@ void taskManagementUtilities_resumeRunningTasks(){
 }
 
 BaseType_t taskManagementUtilities_startOnDemandTask(){
-	return taskManagementUtilities_suspendTasksAndCreateTask(modes_onDemand, "m-OD", STACK_SIZE_ONDEMAND_TASK, NULL, TASK_DEFAULT_PRIORITY, &_onDemandTaskHandle);
+	return taskManagementUtilities_createTask(modes_onDemand, "m-OD", STACK_SIZE_ONDEMAND_TASK, NULL, TASK_DEFAULT_PRIORITY, &_onDemandTaskHandle);
 }
 
 BaseType_t taskManagementUtilities_startSOSTask(){
-	return taskManagementUtilities_suspendTasksAndCreateTask(modes_SOS, "m-SOS", STACK_SIZE_SOS, NULL, TASK_DEFAULT_PRIORITY, &_SOSTaskHandle);
+	return taskManagementUtilities_createTask(modes_SOS, "m-SOS", STACK_SIZE_SOS, NULL, TASK_DEFAULT_PRIORITY, &_SOSTaskHandle);
 }
 
 BaseType_t taskManagementUtilities_startTrackingModeTask(){
-	return taskManagementUtilities_suspendTasksAndCreateTask(modes_trackingMode, "m-track", STACK_SIZE_TRACKING_TASK, NULL, TASK_DEFAULT_PRIORITY, &_currentlyRunningModeTaskHandle);
+	return taskManagementUtilities_createTask(modes_trackingMode, "m-track", STACK_SIZE_TRACKING_TASK, NULL, TASK_DEFAULT_PRIORITY, &_currentlyRunningModeTaskHandle);
 }
 
 BaseType_t taskManagementUtilities_startDontMoveModeMotionDetectedTask(){
-	return taskManagementUtilities_suspendTasksAndCreateTask(modes_dontMoveModeMotionDetected, "m-DM", STACK_SIZE_DONT_MOVE_TASK, NULL, TASK_DEFAULT_PRIORITY, &_currentlyRunningModeTaskHandle);
+	return taskManagementUtilities_createTask(modes_dontMoveModeMotionDetected, "m-DM", STACK_SIZE_DONT_MOVE_TASK, NULL, TASK_DEFAULT_PRIORITY, &_currentlyRunningModeTaskHandle);
 }
 
 BaseType_t taskManagementUtilities_startZoneModeTask(){
-	return taskManagementUtilities_suspendTasksAndCreateTask(modes_zoneMode, "m-zone", STACK_SIZE_ZONE_TASK, NULL, TASK_DEFAULT_PRIORITY, &_currentlyRunningModeTaskHandle);
+	return taskManagementUtilities_createTask(modes_zoneMode, "m-zone", STACK_SIZE_ZONE_TASK, NULL, TASK_DEFAULT_PRIORITY, &_currentlyRunningModeTaskHandle);
 }
 
 BaseType_t taskManagementUtilities_startDailyTrackingModeTask(){
-	return taskManagementUtilities_suspendTasksAndCreateTask(modes_dailyTrackingMode, "m-DT", STACK_SIZE_DAILY_TRACKING_TASK, NULL, TASK_DEFAULT_PRIORITY, &_currentlyRunningModeTaskHandle);
+	return taskManagementUtilities_createTask(modes_dailyTrackingMode, "m-DT", STACK_SIZE_DAILY_TRACKING_TASK, NULL, TASK_DEFAULT_PRIORITY, &_currentlyRunningModeTaskHandle);
 }
 
 BaseType_t taskManagementUtilities_startGPSTask(){
-	return taskManagementUtilities_suspendTasksAndCreateTask(task_GPSManager,"u-GPS",STACK_SIZE_GPS_TASK,NULL,TASK_DEFAULT_PRIORITY,&_GPSManagerHandle	);
+	return startWorker(&_GPSManagerWorker, NULL);
 }
 
 BaseType_t taskManagementUtilities_startSenderTask(){
-	return taskManagementUtilities_suspendTasksAndCreateTask(task_messageSender,"u-send",STACK_SIZE_SENDING_TASK,NULL,TASK_DEFAULT_PRIORITY,&_messageSenderHandle);
+	return startWorker(&_messageSenderWorker, NULL);
 }
 
 BaseType_t taskManagementUtilities_startListenerTask(){
-	return taskManagementUtilities_suspendTasksAndCreateTask(task_messageListener,"u-list",STACK_SIZE_LISTENING_TASK,NULL,TASK_DEFAULT_PRIORITY,&_messageListenerHandle);
+	return startWorker(&_messageListenerWorker, NULL);
 }
 
 BaseType_t taskManagementUtilities_startGSMTask(E_GSM_TASK_PARAM gsmTaskParam){
 	if (gsmTaskParam == GSM_TASK_PARAM_POWER_ON_NORM_FUNCT)
 	{
-		return taskManagementUtilities_suspendTasksAndCreateTask(task_GSMTask,"u-pong",STACK_SIZE_MODULE_TASK,"PON-NORMAL",TASK_DEFAULT_PRIORITY,&_gsmTaskHandle);
+		return startWorker(&_gsmWorker, "PON-NORMAL");
 	}
 	else if(gsmTaskParam == GSM_TASK_PARAM_POWER_OFF)
 	{
-		return taskManagementUtilities_suspendTasksAndCreateTask(task_GSMTask,"u-pofg",STACK_SIZE_MODULE_TASK,"POFF",TASK_DEFAULT_PRIORITY,&_gsmTaskHandle);
+		return startWorker(&_gsmWorker, "POFF");
 	}
 	return pdFAIL;
 }
@@ -257,34 +339,34 @@ void taskManagementUtilities_terminateUsbMonitorTask(){
 }
 
 void taskManagementUtilities_startButtonManagerTask(){
-	if(taskManagementUtilities_suspendTasksAndCreateTask(task_buttonManager,"u-but",STACK_SIZE_BUTTON_TASK,NULL,TASK_DEFAULT_PRIORITY,NULL)==pdPASS){
+	if(taskManagementUtilities_createTask(task_buttonManager,"u-but",STACK_SIZE_BUTTON_TASK,NULL,TASK_DEFAULT_PRIORITY,&_buttonManagerTaskHandle)==pdPASS){
 		USARTManager_printUsbWait("Button manager ready.\r\n");
 	}
 }
 
 void taskManagementUtilities_startLedManagerTask(){
-	if(taskManagementUtilities_suspendTasksAndCreateTask(task_LEDManager,"u-led",STACK_SIZE_LED_TASK,NULL,TASK_DEFAULT_PRIORITY,NULL)==pdPASS){
+	if(taskManagementUtilities_createTask(task_LEDManager,"u-led",STACK_SIZE_LED_TASK,NULL,TASK_DEFAULT_PRIORITY,&_ledManagerTaskHandle)==pdPASS){
 		USARTManager_printUsbWait("LED manager ready.\r\n");
 	}
 }
 
 void taskManagementUtilities_startHttpSessionExpiredTask(){
-	taskManagementUtilities_suspendTasksAndCreateTask(task_HttpSession,"http-e",STACK_SIZE_HTTP_SESSION_TASK,"EXPIRED",TASK_DEFAULT_PRIORITY,&_httpSessionTaskHandle);
+	taskManagementUtilities_createTask(task_HttpSession,"http-e",STACK_SIZE_HTTP_SESSION_TASK,"EXPIRED",TASK_DEFAULT_PRIORITY,&_httpSessionTaskHandle);
 }
 
 void taskManagementUtilities_startGPSTestTask()
 {
-	taskManagementUtilities_suspendTasksAndCreateTask(task_testGPS,"u-gpst", STACK_SIZE_TEST_GPS_TASK,NULL, TASK_DEFAULT_PRIORITY, &_gpsTestTaskHandle);
+	taskManagementUtilities_createTask(task_testGPS,"u-gpst", STACK_SIZE_TEST_GPS_TASK,NULL, TASK_DEFAULT_PRIORITY, &_gpsTestTaskHandle);
 }
 
 void taskManagementUtilities_startCalendarsTestTask()
 {
-	taskManagementUtilities_suspendTasksAndCreateTask(task_testCalendars,"u-calt", STACK_SIZE_TEST_CALENDARS_TASK,NULL, TASK_DEFAULT_PRIORITY, &_calendarTestTaskHandle);
+	taskManagementUtilities_createTask(task_testCalendars,"u-calt", STACK_SIZE_TEST_CALENDARS_TASK,NULL, TASK_DEFAULT_PRIORITY, &_calendarTestTaskHandle);
 }
 
 void taskManagementUtilities_startGSMTestTask()
 {
-	taskManagementUtilities_suspendTasksAndCreateTask(task_testGSM,"u-gsmt", STACK_SIZE_TEST_GSM_TASK,NULL, TASK_DEFAULT_PRIORITY, &_gsmTestTaskHandle);
+	taskManagementUtilities_createTask(task_testGSM,"u-gsmt", STACK_SIZE_TEST_GSM_TASK,NULL, TASK_DEFAULT_PRIORITY, &_gsmTestTaskHandle);
 }
 
 void taskManagementUtilities_startPowerTestTask(){
@@ -306,25 +388,36 @@ void taskManagementUtilities_startPowerTestTask(){
 
 void taskManagementUtilities_startCheckNetworkStatusTask()
 {
-	taskManagementUtilities_suspendTasksAndCreateTask(task_checkNetworkStatus,"u-nets", STACK_SIZE_CHECK_NETWORK_STATUS_TASK,NULL, TASK_DEFAULT_PRIORITY, &_checkNetworkStatusTaskHandle);
+	taskManagementUtilities_createTask(task_checkNetworkStatus,"u-nets", STACK_SIZE_CHECK_NETWORK_STATUS_TASK,NULL, TASK_DEFAULT_PRIORITY, &_checkNetworkStatusTaskHandle);
 }
 
 BaseType_t taskManagementUtilities_startRingInterruptTask()
 {
-	return taskManagementUtilities_suspendTasksAndCreateTask(task_handleRingInterrupt,"u-hrii",STACK_SIZE_RING_INTERRUPT_TASK,NULL,TASK_DEFAULT_PRIORITY,&_ringIndicatorTaskHandle);
+	return taskManagementUtilities_createTask(task_handleRingInterrupt,"u-hrii",STACK_SIZE_RING_INTERRUPT_TASK,NULL,TASK_DEFAULT_PRIORITY,&_ringIndicatorTaskHandle);
 }
 
 BaseType_t taskManagementUtilities_startCheckBatteryValueTask()
 {
-	return taskManagementUtilities_suspendTasksAndCreateTask(task_checkBattery,"u-cbl",STACK_SIZE_CHECK_BATTERY_LEVEL,NULL,TASK_DEFAULT_PRIORITY,&_checkBatteryTaskHandle);
+	return taskManagementUtilities_createTask(task_checkBattery,"u-cbl",STACK_SIZE_CHECK_BATTERY_LEVEL,NULL,TASK_DEFAULT_PRIORITY,&_checkBatteryTaskHandle);
 }
 
 BaseType_t taskManagementUtilities_startSignificantMoveDetectionTask()
 {
-	return taskManagementUtilities_suspendTasksAndCreateTask(task_detectSignificantMotion, "u-dsm", STACK_SIZE_SIGNIFICANT_MOTION_DETECTION, NULL, TASK_DEFAULT_PRIORITY, &_significantMoveDetectionTaskHandle);
+	return taskManagementUtilities_createTask(task_detectSignificantMotion, "u-dsm", STACK_SIZE_SIGNIFICANT_MOTION_DETECTION, NULL, TASK_DEFAULT_PRIORITY, &_significantMoveDetectionTaskHandle);
 }
 
 BaseType_t taskManagementUtilities_startTestMonitorTask()
 {
-	return taskManagementUtilities_suspendTasksAndCreateTask(task_testMonitor, "t-tm", STACK_SIZE_TEST_MONITOR, NULL, TASK_DEFAULT_PRIORITY, &_usbMonitorTaskHandle);
-}
\ No newline at end of file
+	return taskManagementUtilities_createTask(task_testMonitor, "t-tm", STACK_SIZE_TEST_MONITOR, NULL, TASK_DEFAULT_PRIORITY, &_usbMonitorTaskHandle);
+}
+
+/* Runs at the idle priority : the logs are written when no other task is ready */
+BaseType_t taskManagementUtilities_startLogDrainTask()
+{
+	BaseType_t result = taskManagementUtilities_createTask(task_logDrain, "u-log", STACK_SIZE_LOG_DRAIN_TASK, NULL, tskIDLE_PRIORITY, &_logDrainTaskHandle);
+	if(result == pdPASS)
+	{
+		debugLog_registerDrainTask(_logDrainTaskHandle);
+	}
+	return result;
+}
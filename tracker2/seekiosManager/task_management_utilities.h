@@ -22,6 +22,8 @@
 #include <tests/powerTests.h>
 #include <peripheralManager/BLE_manager_adapted.h>
 #include <seekiosManager/seekios_info_manager.h>
+#include <seekiosCore/telemetry.h>
+#include <seekiosCore/debug_log.h>
 
 #define TASK_DEFAULT_PRIORITY	tskIDLE_PRIORITY+1
 
@@ -53,6 +55,7 @@
 #define STACK_SIZE_CHECK_NETWORK_STATUS_TASK	120
 #define STACK_SIZE_CHECK_BATTERY_LEVEL			130
 #define STACK_SIZE_SIGNIFICANT_MOTION_DETECTION	110
+#define STACK_SIZE_LOG_DRAIN_TASK				100
 
 /* Testing tasks */
 #define STACK_SIZE_FUNCTIONALITIES_TEST	200
@@ -62,8 +65,12 @@
 #define STACK_SIZE_TEST_CALENDARS_TASK	100
 #define STACK_SIZE_TEST_MONITOR			500
 
+#define TASK_CREATION_RETRY_DELAY		200 // time given to the idle task to free the deleted tasks before retrying a creation
 
-BaseType_t taskManagementUtilities_suspendTasksAndCreateTask(TaskFunction_t pxTaskCode, const char * const pcName, const uint16_t usStackDepth, void * const pvParameters, UBaseType_t uxPriority, TaskHandle_t * const pxCreatedTask);
+
+void taskManagementUtilities_initWorkers(void);
+void taskManagementUtilities_recordPersistentTasksStack(void);
+BaseType_t taskManagementUtilities_createTask(TaskFunction_t pxTaskCode, const char * const pcName, const uint16_t usStackDepth, void * const pvParameters, UBaseType_t uxPriority, TaskHandle_t * const pxCreatedTask);
 void taskManagementUtilities_suspendRunningTasks(void);
 void taskManagementUtilities_resumeRunningTasks(void);
 void FreeRTOSOverlay_taskDelete(TaskHandle_t taskToDelete);
@@ -100,5 +107,6 @@ void taskManagementUtilities_terminateGSMTestTask(void);
 void taskManagementUtilities_terminateGPSTestTask(void);
 void taskManagementUtilities_terminateCalendarTestTask(void);
 BaseType_t taskManagementUtilities_startTestMonitorTask(void);
+BaseType_t taskManagementUtilities_startLogDrainTask(void);
 
 #endif /* TASK_MANAGEMENT_UTILITIES_H_ */
\ No newline at end of file
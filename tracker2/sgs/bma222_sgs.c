@@ -26,6 +26,17 @@ uint8_t bma222_reg_read(char reg)
 
 
 
+void bma222_reg_burst_read(char reg, uint8_t* data, uint8_t length)
+{
+	uint8_t tmp_reg;
+	bma222_cs(1);
+	DELAY_MS(1);
+	tmp_reg = reg|0x80;  //register address plus read-bit, the address is incremented for each byte read
+	io_write(spi_io, &tmp_reg, 1);
+	io_read(spi_io, data, length);
+	bma222_cs(0);
+}
+
 uint8_t bma222_reg_overwrite(char reg, uint8_t val);
 
 uint8_t bma222_cs(uint8_t mode)
@@ -153,4 +153,13 @@ uint8_t bma222_reg_overwrite(char reg, uint8_t val);
 
 uint8_t bma222_reg_read(char reg);
 
+	/**
+	 * \brief read consecutive registers in one SPI transfer
+	 *
+	 * \param[in] reg  first register
+	 * \param[out] data  values of the registers
+	 * \param[in] length  number of registers
+	 */
+void bma222_reg_burst_read(char reg, uint8_t* data, uint8_t length);
+
 void bma222_set_slope_motion_interrupt(uint8_t sensitivity);
\ No newline at end of file
@@ -12,6 +12,7 @@
 #include <seekiosManager/seekios_manager.h>
 #include <utils.h>
 #include <hal_init.h>
+#include <hal_atomic.h>
 #include <hpl_irq.h>
 #include <hri_gclk2_v111.h>
 #include <hri_mclk_v101.h>
@@ -20,6 +21,8 @@
 #if CONF_DMAC_MAX_USED_DESC > 0
 #endif
 
+static void TIMER__init(void);
+
 /*! The buffer size for SER0*/
 #define BLE_FC_UART_BUFFER_SIZE 16
 /*! The buffer size for SER1 */
@@ -170,6 +173,118 @@ void SER2_GSM_init(void)
 	SER2_GSM_PORT_init();
 }
 
+#if (UART_DMA_RX_ACTIVATED == 1)
+static DmacDescriptor _dmacDescriptors[UART_DMA_RX_NB_CHANNELS] __attribute__((aligned(16)));
+static DmacDescriptor _dmacWritebackDescriptors[UART_DMA_RX_NB_CHANNELS] __attribute__((aligned(16)));
+static struct timer_task _uartDmaRxPollTask;
+static bool _isUartDmaRxPolling = false;
+static bool _isUartDmaRxTimerInitialized = false;
+
+/**
+* \brief DMAC initialization function
+*
+* Enables the DMAC clock and sets the descriptor memory sections
+*/
+void UART_DMA_RX_init(void)
+{
+	hri_mclk_set_AHBMASK_DMAC_bit(MCLK);
+	DMAC->CTRL.reg &= ~DMAC_CTRL_DMAENABLE;
+	DMAC->CTRL.reg = DMAC_CTRL_SWRST;
+	while(DMAC->CTRL.reg & DMAC_CTRL_SWRST);
+	DMAC->BASEADDR.reg = (uint32_t)_dmacDescriptors;
+	DMAC->WRBADDR.reg = (uint32_t)_dmacWritebackDescriptors;
+	DMAC->CTRL.reg = DMAC_CTRL_DMAENABLE | DMAC_CTRL_LVLEN(0xF);
+}
+
+/**
+* \brief Starts the circular reception of an USART
+*
+* The descriptor is linked to itself : the channel fills the buffer endlessly and
+* the consumer follows the write index. The RXC interrupt of the async driver is disabled.
+*/
+void UART_DMA_RX_start(uint8_t channel, void *const hw, uint8_t triggerSource, uint8_t *buffer)
+{
+	DmacDescriptor *descriptor = &_dmacDescriptors[channel];
+	descriptor->BTCTRL.reg = DMAC_BTCTRL_VALID | DMAC_BTCTRL_BEATSIZE_BYTE | DMAC_BTCTRL_DSTINC | DMAC_BTCTRL_BLOCKACT_NOACT;
+	descriptor->BTCNT.reg = UART_DMA_RX_BUFFER_SIZE;
+	descriptor->SRCADDR.reg = (uint32_t)&((Sercom *)hw)->USART.DATA.reg;
+	descriptor->DSTADDR.reg = (uint32_t)buffer + UART_DMA_RX_BUFFER_SIZE; // end address when the destination is incremented
+	descriptor->DESCADDR.reg = (uint32_t)descriptor;
+	_dmacWritebackDescriptors[channel].BTCNT.reg = UART_DMA_RX_BUFFER_SIZE;
+
+	hri_sercomusart_clear_INTEN_RXC_bit(hw);
+
+	DMAC->CHID.reg = DMAC_CHID_ID(channel);
+	DMAC->CHCTRLA.reg &= ~DMAC_CHCTRLA_ENABLE;
+	DMAC->CHCTRLA.reg = DMAC_CHCTRLA_SWRST;
+	while(DMAC->CHCTRLA.reg & DMAC_CHCTRLA_SWRST);
+	DMAC->CHCTRLB.reg = DMAC_CHCTRLB_TRIGSRC(triggerSource) | DMAC_CHCTRLB_TRIGACT_BEAT | DMAC_CHCTRLB_LVL(0);
+	DMAC->CHCTRLA.reg = DMAC_CHCTRLA_ENABLE | DMAC_CHCTRLA_RUNSTDBY;
+}
+
+/**
+* \brief Stops the channels and the polling timer before the deep sleep
+*/
+void UART_DMA_RX_stop(void)
+{
+	for(uint8_t channel = 0; channel < UART_DMA_RX_NB_CHANNELS; channel++)
+	{
+		DMAC->CHID.reg = DMAC_CHID_ID(channel);
+		DMAC->CHCTRLA.reg &= ~DMAC_CHCTRLA_ENABLE;
+	}
+	if(_isUartDmaRxPolling)
+	{
+		timer_stop(&TIMER_);
+		timer_remove_task(&TIMER_, &_uartDmaRxPollTask);
+		_isUartDmaRxPolling = false;
+	}
+}
+
+/**
+* \brief Returns the index of the next byte the DMAC will write in the buffer
+*
+* The beat count is read in the ACTIVE register when the channel is busy, otherwise in its write-back descriptor.
+*/
+uint16_t UART_DMA_RX_getWriteIndex(uint8_t channel)
+{
+	uint16_t remainingBeats;
+	CRITICAL_SECTION_ENTER();
+	uint32_t active = DMAC->ACTIVE.reg;
+	if((active & DMAC_ACTIVE_ABUSY) && ((active & DMAC_ACTIVE_ID_Msk) >> DMAC_ACTIVE_ID_Pos) == channel)
+	{
+		remainingBeats = (active & DMAC_ACTIVE_BTCNT_Msk) >> DMAC_ACTIVE_BTCNT_Pos;
+	}
+	else
+	{
+		remainingBeats = _dmacWritebackDescriptors[channel].BTCNT.reg;
+	}
+	CRITICAL_SECTION_LEAVE();
+	return (UART_DMA_RX_BUFFER_SIZE - remainingBeats) % UART_DMA_RX_BUFFER_SIZE;
+}
+
+/**
+* \brief Calls pollCallback every UART_DMA_RX_POLL_PERIOD to consume the received bytes
+*/
+void UART_DMA_RX_startPolling(timer_cb_t pollCallback)
+{
+	if(_isUartDmaRxPolling)
+	{
+		return;
+	}
+	if(!_isUartDmaRxTimerInitialized)
+	{
+		TIMER__init();
+		_isUartDmaRxTimerInitialized = true;
+	}
+	_uartDmaRxPollTask.interval = UART_DMA_RX_POLL_PERIOD;
+	_uartDmaRxPollTask.cb = pollCallback;
+	_uartDmaRxPollTask.mode = TIMER_TASK_REPEAT;
+	timer_add_task(&TIMER_, &_uartDmaRxPollTask);
+	timer_start(&TIMER_);
+	_isUartDmaRxPolling = true;
+}
+#endif
+
 /**
 * \brief USART Clock initialization function
 *
@@ -848,6 +963,10 @@ static void irq_PA10_IMU1(void)
 static void irq_PA11_IMU2(void)
 {
 	imu2_count++;
+	if(seekiosManagerStarted)
+	{
+		IMUManager_dataReadyFromISR();
+	}
 }
 
 static void irq_PA12_gsm_ring(void)
@@ -125,6 +125,19 @@ extern "C" {
 	void SER2_GSM_CLOCK_init(void);
 	void SER2_GSM_init(void);
 
+	/* Circular reception of SER1 and SER2 by the DMAC (UART_DMA_RX_ACTIVATED) */
+	#define UART_DMA_RX_CHANNEL_SER1_GPS	0
+	#define UART_DMA_RX_CHANNEL_SER2_GSM	1
+	#define UART_DMA_RX_NB_CHANNELS			2
+	#define UART_DMA_RX_BUFFER_SIZE			256
+	#define UART_DMA_RX_POLL_PERIOD			2 // in TIMER_ ticks (ms)
+
+	void UART_DMA_RX_init(void);
+	void UART_DMA_RX_start(uint8_t channel, void *const hw, uint8_t triggerSource, uint8_t *buffer);
+	void UART_DMA_RX_stop(void);
+	uint16_t UART_DMA_RX_getWriteIndex(uint8_t channel);
+	void UART_DMA_RX_startPolling(timer_cb_t pollCallback);
+
 
 	void SER3_DEBUG_PORT_init(void);
 	void SER3_DEBUG_CLOCK_init(void);
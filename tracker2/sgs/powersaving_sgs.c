@@ -64,6 +64,9 @@ void sleep_deep(void)
   	//NVIC_DisableIRQ(2);  //RTC
   	NVIC_DisableIRQ(11); // Sercom 3
   	
+	#if (UART_DMA_RX_ACTIVATED == 1)
+	UART_DMA_RX_stop();
+	#endif
     usart_async_disable(&SER1_GPS);
   	usart_async_disable(&SER2_GSM);
   	usart_sync_disable(&SER3_DEBUG);
@@ -9,6 +9,7 @@
 #include "helper_sgs.h"
 #include <peripheralManager/GPS_manager.h>
 #include <stdio_redirect/stdio_io.h>
+#include <tests/uart_replay.h>
 
 void process_data(const uint8_t *text)
 {
@@ -25,90 +26,195 @@ volatile char tmp5;
 #define STARTGNGGA		"$GNGGA"
 #define STARTGPRMC		"$GPRMC"
 #define STARTGNRMC		"$GNRMC"
+
+/* Records the GXGGA frame then the GXRMC frame in gps_buf. Returns true once both frames are recorded.
+The checksum of each frame is computed while the chars arrive : a frame with a wrong checksum is dropped */
+static bool recordGpsChar(char readChar)
+{
+	static uint8_t nmeaIndex = 0;
+	static bool ggaFound=false;
+	static uint8_t ggalenght = 0;
+	static NMEAChecksum checksum;
+
+	E_NMEA_CHECKSUM_STATUS checksumStatus = GPSManager_updateNMEAChecksum(&checksum, readChar);
+
+	if (!ggaFound)
+	{
+		if(nmeaIndex < START_LENGTH) // if first 6 char of the frame corresponds to GXGGA, we keep recording. Otherwise we restart it.
+		{
+			if(readChar == STARTGPGGA[nmeaIndex] || readChar == STARTGNGGA[nmeaIndex])
+			{
+				gps_buf[nmeaIndex] = readChar;
+				nmeaIndex++;
+			}
+			else
+			{
+				nmeaIndex = 0;
+			}
+		}
+		else // if the start was OK, we record the rest of the frame until the EOL
+		{
+			gps_buf[nmeaIndex] = readChar;
+			nmeaIndex++;
+			gps_buf[nmeaIndex] = '\0';
+			if(readChar == '\n' && checksumStatus != NMEA_CHECKSUM_VALID)
+			{
+				nmeaIndex = 0;
+			}
+			else if(readChar == '\n')
+			{
+				ggalenght=nmeaIndex;
+				ggaFound=true;
+			}
+		}
+	}
+	else if (ggaFound)
+	{
+		if(nmeaIndex <ggalenght + START_LENGTH) // if first 6 char of the frame corresponds to GXGGA, we keep recording. Otherwise we restart it.
+		{
+			if(readChar == STARTGPRMC[nmeaIndex-ggalenght] || readChar == STARTGNRMC[nmeaIndex-ggalenght])
+			{
+				gps_buf[nmeaIndex] = readChar;
+				nmeaIndex++;
+			}
+			else
+			{
+				nmeaIndex = ggalenght;
+			}
+		}
+		else // if the start was OK, we record the rest of the frame until the EOL
+		{
+			gps_buf[nmeaIndex] = readChar;
+			nmeaIndex++;
+			gps_buf[nmeaIndex] = '\0';
+			if(readChar == '\n' && checksumStatus != NMEA_CHECKSUM_VALID)
+			{
+				ggaFound=false;
+				nmeaIndex = 0;
+			}
+			else if(readChar == '\n')
+			{
+				ggaFound=false;
+				GPSManager_setGPSBitsFromISR(GPS_BIT_NMEA_AVAILABLE);
+				nmeaIndex = 0;
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+/* Filters the GGA and RMC frames in the received bytes */
+static void processGpsBytes(const uint8_t *data, uint16_t length)
+{
+	EventBits_t gpsBits = GPSManager_getGPSBitsFromISR();
+	bool shouldRecordGGA = (gpsBits & GPS_BIT_NMEA_AVAILABLE) == 0;
+	if((gpsBits & GPS_BIT_REQ_GPS_USART_TEST) != 0)
+	{
+		GPSManager_setGPSBitsFromISR(GPS_BIT_REQ_GPS_USART_TEST);
+	}
+	for(uint16_t i = 0; i < length && shouldRecordGGA; i++)
+	{
+		shouldRecordGGA = !recordGpsChar(data[i]);
+	}
+}
+
+#define GSM_ANSWER_EXPECTED		1 // set by the USART manager before each command
+#define GSM_ANSWER_RECORDING	2
+#define GSM_ANSWER_BUFFER_FULL	3 // the rest of the answer is dropped, but its lines are still parsed to see the final result
+
+/* Appends the received bytes to gsm_buf and parses the modem lines */
+static void processGsmBytes(const uint8_t *data, uint16_t length)
+{
+	static uint16_t gsmDataReceived;
+
+	if(gsm_answer == GSM_ANSWER_EXPECTED){
+		gsmDataReceived=0;
+		gsm_answer=GSM_ANSWER_RECORDING;
+	}
+
+	if(gsm_answer >= GSM_ANSWER_RECORDING)
+	{
+		USARTManager_parseGsmBytesFromISR(data, length);
+	}
+
+	for(uint16_t i = 0; i < length && gsm_answer == GSM_ANSWER_RECORDING; i++)
+	{
+		gsm_buf[gsmDataReceived++] = data[i];
+		gsm_buf[gsmDataReceived] = '\0';
+		if(gsmDataReceived >= GSM_BUF_SIZE-1)
+		{
+			gsm_answer = GSM_ANSWER_BUFFER_FULL;
+			gsmDataReceived = 0; // Reset received data counter
+		}
+	}
+}
+
+/* Entry of the bytes received from the GPS, by interrupt or by the DMAC */
+static void receiveGpsBytes(const uint8_t *data, uint16_t length)
+{
+	#if (UART_REPLAY_ACTIVATED == 1)
+	if(uartReplay_isReplaying())
+	{
+		return; // the transcript lines are injected instead
+	}
+	uartReplay_record(UART_REPLAY_CHANNEL_GPS_RX, data, length);
+	#endif
+	processGpsBytes(data, length);
+}
+
+/* Entry of the bytes received from the GSM, by interrupt or by the DMAC */
+static void receiveGsmBytes(const uint8_t *data, uint16_t length)
+{
+	#if (UART_REPLAY_ACTIVATED == 1)
+	if(uartReplay_isReplaying())
+	{
+		return;
+	}
+	uartReplay_record(UART_REPLAY_CHANNEL_GSM_RX, data, length);
+	#endif
+	processGsmBytes(data, length);
+}
+
+#if (UART_REPLAY_ACTIVATED == 1)
+/* Injects a replayed GPS line in the reception path, as if it was received by the USART. Called by the tasks */
+void serial_injectGpsBytes(const uint8_t *data, uint16_t length)
+{
+	UBaseType_t savedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+	processGpsBytes(data, length);
+	portCLEAR_INTERRUPT_MASK_FROM_ISR(savedInterruptStatus);
+}
+
+/* Injects a replayed modem line in the reception path, as if it was received by the USART. Called by the tasks */
+void serial_injectGsmBytes(const uint8_t *data, uint16_t length)
+{
+	UBaseType_t savedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+	processGsmBytes(data, length);
+	portCLEAR_INTERRUPT_MASK_FROM_ISR(savedInterruptStatus);
+}
+#endif
+
+#if (UART_DMA_RX_ACTIVATED == 0)
 /* Callback that gets the GPS data and filters only the GGA data */
 static void rx_cb_SER1_GPS_GGA(const struct usart_async_descriptor *const io_descr)
 {
-	static uint8_t nmeaIndex = 0;
-	static uint32_t recordAllBitIndex = 0;
 	EventBits_t gpsBits = GPSManager_getGPSBitsFromISR();
 	bool shouldRecordGGA = (gpsBits & GPS_BIT_NMEA_AVAILABLE) == 0;
 	bool testUsartBit = (gpsBits & GPS_BIT_REQ_GPS_USART_TEST) != 0;
-	volatile char readChar;
-	static bool ggaFound=false;
-	static uint8_t ggalenght = 0;
+	uint8_t readChar;
 	if(shouldRecordGGA || testUsartBit)
 	{
 		uint8_t nbRead = io_read(usart_gps_io, &readChar,  1);
 
 		if(nbRead > 0)
 		{
-			if(testUsartBit)
-			{
-				GPSManager_setGPSBitsFromISR(GPS_BIT_REQ_GPS_USART_TEST);
-			}
-
-			if(shouldRecordGGA)
-			{
-				if (!ggaFound)
-				{
-					if(nmeaIndex < START_LENGTH) // if first 6 char of the frame corresponds to GXGGA, we keep recording. Otherwise we restart it.
-					{
-						if(readChar == STARTGPGGA[nmeaIndex] || readChar == STARTGNGGA[nmeaIndex])
-						{
-							gps_buf[nmeaIndex] = readChar;
-							nmeaIndex++;
-						}
-						else
-						{
-							nmeaIndex = 0;
-						}
-					}
-					else // if the start was OK, we record the rest of the frame until the EOL
-					{
-						gps_buf[nmeaIndex] = readChar;
-						nmeaIndex++;
-						gps_buf[nmeaIndex] = '\0';
-						if(readChar == '\n')
-						{
-							ggalenght=nmeaIndex;
-							ggaFound=true;
-						}
-					}
-				}
-				else if (ggaFound)
-				{
-					if(nmeaIndex <ggalenght + START_LENGTH) // if first 6 char of the frame corresponds to GXGGA, we keep recording. Otherwise we restart it.
-					{
-						if(readChar == STARTGPRMC[nmeaIndex-ggalenght] || readChar == STARTGNRMC[nmeaIndex-ggalenght])
-						{
-							gps_buf[nmeaIndex] = readChar;
-							nmeaIndex++;
-						}
-						else
-						{
-							nmeaIndex = ggalenght;
-						}
-					}
-					else // if the start was OK, we record the rest of the frame until the EOL
-					{
-						gps_buf[nmeaIndex] = readChar;
-						nmeaIndex++;
-						gps_buf[nmeaIndex] = '\0';
-						if(readChar == '\n')
-						{
-							ggaFound=false;
-							GPSManager_setGPSBitsFromISR(GPS_BIT_NMEA_AVAILABLE);
-							nmeaIndex = 0;
-						}
-					}
-				}
-				
-			}
+			receiveGpsBytes(&readChar, 1);
 		}
 	}
 	
 	UNUSED(io_descr);
 }
+#endif
 
 //void copy_ringbuffer(int *buf, const *char)
 uint16_t copy_ringbuffer(char *buf)
@@ -120,29 +226,75 @@ uint16_t copy_ringbuffer(char *buf)
 }
 
 
-static void rx_cb_SER2_GSM(const struct usart_async_descriptor *const io_descr)
+#if (UART_DMA_RX_ACTIVATED == 1)
+#define UART_DMA_RX_IDLE_POLLS	5 // number of polls without data before the line is considered idle
+
+static uint8_t _gpsDmaBuffer[UART_DMA_RX_BUFFER_SIZE];
+static uint8_t _gsmDmaBuffer[UART_DMA_RX_BUFFER_SIZE];
+static uint16_t _dmaReadIndexes[UART_DMA_RX_NB_CHANNELS];
+static uint8_t _dmaEmptyPolls[UART_DMA_RX_NB_CHANNELS];
+
+/* Hands the bytes written by the DMAC since the last poll to processBytes. Returns true when the line just became idle */
+static bool consumeDmaBuffer(uint8_t channel, uint8_t *buffer, void (*processBytes)(const uint8_t*, uint16_t))
 {
-	static int32_t  gsm_data_received;
-	
-	if(gsm_answer == 1){
-		gsm_data_received=0;
-		gsm_answer=2;
+	uint16_t writeIndex = UART_DMA_RX_getWriteIndex(channel);
+	uint16_t readIndex = _dmaReadIndexes[channel];
+
+	if(writeIndex == readIndex)
+	{
+		if(_dmaEmptyPolls[channel] < UART_DMA_RX_IDLE_POLLS)
+		{
+			_dmaEmptyPolls[channel]++;
+			return _dmaEmptyPolls[channel] == UART_DMA_RX_IDLE_POLLS;
+		}
+		return false;
 	}
 
-	if (gsm_answer>1)
+	if(writeIndex < readIndex) // the DMAC wrapped around the buffer
 	{
-		gsm_data_received += io_read(usart_gsm_io, &gsm_buf[gsm_data_received],  GSM_BUF_SIZE - gsm_data_received);
-		gsm_buf[gsm_data_received+1] ='\0';
+		processBytes(&buffer[readIndex], UART_DMA_RX_BUFFER_SIZE - readIndex);
+		readIndex = 0;
 	}
-	
-	if(gsm_data_received >= GSM_BUF_SIZE-1)
+	processBytes(&buffer[readIndex], writeIndex - readIndex);
+	_dmaReadIndexes[channel] = writeIndex;
+	_dmaEmptyPolls[channel] = 0;
+	return false;
+}
+
+static void pollDmaBuffers(const struct timer_task *const timer_task)
+{
+	UNUSED(timer_task);
+	consumeDmaBuffer(UART_DMA_RX_CHANNEL_SER1_GPS, _gpsDmaBuffer, receiveGpsBytes);
+	if(consumeDmaBuffer(UART_DMA_RX_CHANNEL_SER2_GSM, _gsmDmaBuffer, receiveGsmBytes) && seekiosManagerStarted)
 	{
-		gsm_answer = 0; // Reset received data counter
-		gsm_data_received = 0; // Reset received data counter
+		USARTManager_gsmUsartMaskSetBitsFromISR(GSM_USART_BIT_RX_IDLE);
 	}
+}
+
+static void startDmaReception(uint8_t channel, void *const hw, uint8_t triggerSource, uint8_t *buffer)
+{
+	_dmaReadIndexes[channel] = 0;
+	_dmaEmptyPolls[channel] = UART_DMA_RX_IDLE_POLLS;
+	UART_DMA_RX_start(channel, hw, triggerSource, buffer);
+}
+#else
+static void rx_cb_SER2_GSM(const struct usart_async_descriptor *const io_descr)
+{
+	uint8_t readBytes[16];
+	int32_t nbRead;
+	do
+	{
+		nbRead = io_read(usart_gsm_io, readBytes, sizeof(readBytes));
+		if(nbRead > 0)
+		{
+			receiveGsmBytes(readBytes, nbRead);
+		}
+	}while(nbRead == sizeof(readBytes));
 	UNUSED(io_descr);
 }
 
+#endif
+
 static void tx_cb_SER2_GSM(const struct usart_async_descriptor *const io_descr)
 {
 	UNUSED(io_descr);
@@ -157,10 +309,15 @@ void SER1_GPS_io_init(void)
 
 
 	//usart_async_register_callback(&SER1_GPS, USART_ASYNC_TXC_CB, tx_cb_SER1_GPS);
+	#if (UART_DMA_RX_ACTIVATED == 0)
 	usart_async_register_callback(&SER1_GPS, USART_ASYNC_RXC_CB, rx_cb_SER1_GPS_GGA);
+	#endif
 	//usart_async_register_callback(&SER1_GPS, USART_ASYNC_ERROR_CB, err_cb_SER1_GPS);*/ // IMPLEMENT ??????
 	usart_async_get_io_descriptor(&SER1_GPS, &usart_gps_io);
 	usart_async_enable(&SER1_GPS);
+	#if (UART_DMA_RX_ACTIVATED == 1)
+	startDmaReception(UART_DMA_RX_CHANNEL_SER1_GPS, SERCOM1, SERCOM1_DMAC_ID_RX, _gpsDmaBuffer);
+	#endif
 	io_write(usart_gps_io,(uint8_t*)"at\n\r\0", 12);
 
 }
@@ -168,10 +325,15 @@ void SER1_GPS_io_init(void)
 void  SER2_GSM_io_init(void)
 {
 	usart_async_register_callback(&SER2_GSM, USART_ASYNC_TXC_CB, tx_cb_SER2_GSM);
+	#if (UART_DMA_RX_ACTIVATED == 0)
 	usart_async_register_callback(&SER2_GSM, USART_ASYNC_RXC_CB, rx_cb_SER2_GSM);
+	#endif
 	//  usart_async_register_callback(&SER2_GSM, USART_ASYNC_ERROR_CB, err_cb_SER2_GSM);*/
 	usart_async_get_io_descriptor(&SER2_GSM, &usart_gsm_io);
 	usart_async_enable(&SER2_GSM);
+	#if (UART_DMA_RX_ACTIVATED == 1)
+	startDmaReception(UART_DMA_RX_CHANNEL_SER2_GSM, SERCOM2, SERCOM2_DMAC_ID_RX, _gsmDmaBuffer);
+	#endif
 	io_write(usart_gsm_io, (uint8_t*)"at\n\r\0", 5);
 }
 
@@ -195,8 +357,14 @@ void SER5_SPI_IMU_FLASH_io_init(void)
 
 void serial_io_init(void)
 {
+	#if (UART_DMA_RX_ACTIVATED == 1)
+	UART_DMA_RX_init();
+	#endif
 	SER1_GPS_io_init();
 	SER2_GSM_io_init();
 	SER3_DEBUG_io_init();
 	SER5_SPI_IMU_FLASH_io_init();
+	#if (UART_DMA_RX_ACTIVATED == 1)
+	UART_DMA_RX_startPolling(pollDmaBuffers);
+	#endif
 }
\ No newline at end of file
@@ -21,6 +21,8 @@ void serial_io_init(void);
 void SER5_SPI_IMU_FLASH_io_init(void);
 void SER4_BLE_io_init(void);
 void process_data(const uint8_t *text);
+void serial_injectGpsBytes(const uint8_t *data, uint16_t length);
+void serial_injectGsmBytes(const uint8_t *data, uint16_t length);
 
 
 #define GPS_BUF_SIZE  256
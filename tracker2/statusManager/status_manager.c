@@ -166,6 +166,16 @@ uint8_t statusManager_getRunningConfigCoordinates(Coordinate coordinates[NB_MAX_
 	return nbCoordinates;
 }
 
+/* Copies the zone of the running config, ready for the position checks */
+void statusManager_getRunningConfigCompiledZone(CompiledZone* zonePtr){
+	zonePtr->nbVertices = 0;
+	if(xSemaphoreTakeRecursive(_runningModeSemaphore, LONG_WAIT)==pdPASS)
+	{
+		memcpy(zonePtr, &_runningMode.modeParameters.compiledZone, sizeof(CompiledZone));
+		xSemaphoreGiveRecursive(_runningModeSemaphore);
+	}
+}
+
 static void printRunningMode()
 {
 	if(xSemaphoreTakeRecursive(_runningModeSemaphore, LONG_WAIT)==pdPASS)
@@ -275,6 +285,7 @@ static void initParameter(ModeParameters* parameter){
 	uint8_t i = 0;
 	parameter->refreshRate = 0;
 	parameter->nbCoordinates = 0;
+	parameter->compiledZone.nbVertices = 0;
 	parameter->modeID = 0;
 	parameter->useExtraOptions = 0;
 	for (i = 0; i < NB_MAX_COORDINATES; i++)
@@ -371,6 +382,7 @@ static void copyConfig(ModeConfig* dest, ModeConfig* src){
 	dest->modeStatus.state = src->modeStatus.state;
 	memcpy(dest->modeParameters.coordinates,src->modeParameters.coordinates,NB_MAX_COORDINATES*sizeof(Coordinate));
 	dest->modeParameters.nbCoordinates = src->modeParameters.nbCoordinates;
+	memcpy(&dest->modeParameters.compiledZone, &src->modeParameters.compiledZone, sizeof(CompiledZone));
 }
 
 /* Met  jour les paramtres et les statuts du last parsed config et anciens en fonction
@@ -488,7 +500,7 @@ static char* isolateMessageParameters(char* message){
 	return message + 4;
 }
 
-void parseZoneMode(char *msg,int nbPoints, Coordinate *coordinates)
+void parseZoneMode(char *msg,int nbPoints, Coordinate *coordinates, CompiledZone *compiledZonePtr)
 {
 	char *token = NULL;
 	uint8_t itemCounter=0;
@@ -516,6 +528,8 @@ void parseZoneMode(char *msg,int nbPoints, Coordinate *coordinates)
 			isEven=true;
 		}
 	}
+
+	geolocationTools_compileZone(compiledZonePtr, coordinates, nbPoints);
 }
 
 /*
@@ -583,7 +597,7 @@ static uint8_t buildLastParsedParameters(char *parameterStr, E_MODE_STATUS statu
 			_lastParsedMode.modeStatus.state = ZONE_STATE_SUSPEND;
 		}
 		
-		parseZoneMode(parameterStr,_lastParsedMode.modeParameters.nbCoordinates,_lastParsedMode.modeParameters.coordinates);
+		parseZoneMode(parameterStr,_lastParsedMode.modeParameters.nbCoordinates,_lastParsedMode.modeParameters.coordinates,&_lastParsedMode.modeParameters.compiledZone);
 	}
 	return FUNCTION_SUCCESS;
 }
@@ -12,8 +12,9 @@ TODO : les fonctions de parsage devraient ausi 
 #include <tools/string_helper.h>
 #include <seekiosManager/power_state_manager.h>
 #include <seekiosManager/seekios_info_manager.h>
+#include <tools/geolocation_tools.h>
 
-#define NB_MAX_COORDINATES 10
+#define NB_MAX_COORDINATES ZONE_MAX_VERTICES
 #define NB_MAX_DECIMALS_IN_COORDINATES 9
 
 #define DONT_MOVE_STATE_RAS				0 // slope detection activated, waiting for a tap
@@ -41,6 +42,7 @@ typedef struct {
 	uint16_t refreshRate; // in MINUTES
 	Coordinate coordinates[NB_MAX_COORDINATES];
 	uint8_t nbCoordinates;
+	CompiledZone compiledZone; // computed from the coordinates when the zone mode is parsed
 	bool useExtraOptions; // use extra option in some mode, for exemple in the don't move mode, use the BLE to detect user proximity
 }ModeParameters;
 
@@ -78,6 +80,7 @@ bool statusManager_isOnDemandRequest(void);
 char* statusManager_getCurrentStatusString(char*);
 uint8_t statusManager_getRunningStatusState(void);
 uint8_t statusManager_getRunningConfigCoordinates(Coordinate coordinates[NB_MAX_COORDINATES]);
+void statusManager_getRunningConfigCompiledZone(CompiledZone* zonePtr);
 uint32_t statusManager_getRunningConfigModeId(void);
 void statusManager_setRunningConfigStatusState(uint8_t state);
 void statusManager_getLastParsedStatus(ModeStatus* seekiosStatus);
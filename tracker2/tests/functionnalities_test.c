@@ -253,7 +253,7 @@ static bool updateLastTestResults(TickType_t timeout)
 
 	// TODO : check if charging
 	uint16_t voltages[2];
-	ADC_read_BAT_USB(voltages);
+	batteryManager_readADCVoltages(voltages);
 	_lastTestReport.adcTestReport.ADCUSBVoltage = voltages[1];
 	_lastTestReport.adcTestReport.ADCBatVoltage = voltages[0];
 
@@ -274,7 +274,7 @@ static void waitUSBUnplugging()
 	uint16_t voltages[2];
 	do
 	{
-		ADC_read_BAT_USB(voltages);
+		batteryManager_readADCVoltages(voltages);
 		vTaskDelay(500);
 	}while(voltages[1] > USB_LEVEL_MINIMUM_CHARGE_VOLTAGE);
 }
@@ -418,6 +418,53 @@ static void serializeADCTestReport(uint8_t* res, ADCTestReport* adcTestReport)
 	strcat(res,"\r\n");
 }
 
+/* Binary version of the TEST_RES_* lines, for the test stations. The flags of each test are bits, in the order of the text version :
+UID (10), version (10), GSM flags, RSSI samples (RSSI_SAMPLES_COUNT), IMEI (20), IMSI (20), battery voltage (2), GPS flags,
+BLE flags, MAC address (15), IMU flag, accelerations (3), LED flag, button flag, DataFlash flags, calendar flags,
+ADC USB voltage (4), ADC battery voltage (4), voltage min (2), voltage max (2) */
+void functionalitiesTest_sendReportFrame(uint8_t frameId)
+{
+	uint8_t payload[128];
+	uint8_t* payloadPtr = payload;
+	TestReport* report = &_lastTestReport;
+
+	memcpy(payloadPtr, report->seekiosTestReport.UID, sizeof(report->seekiosTestReport.UID));
+	payloadPtr += sizeof(report->seekiosTestReport.UID);
+	memcpy(payloadPtr, report->seekiosTestReport.versionName, sizeof(report->seekiosTestReport.versionName));
+	payloadPtr += sizeof(report->seekiosTestReport.versionName);
+
+	*payloadPtr++ = report->gsmTestReport.isGSMPoweringOn | (report->gsmTestReport.isNetworkWorking << 1) | (report->gsmTestReport.isGPRSWorking << 2);
+	memcpy(payloadPtr, report->gsmTestReport.RSSISamples, RSSI_SAMPLES_COUNT);
+	payloadPtr += RSSI_SAMPLES_COUNT;
+	memcpy(payloadPtr, report->gsmTestReport.IMEI, sizeof(report->gsmTestReport.IMEI));
+	payloadPtr += sizeof(report->gsmTestReport.IMEI);
+	memcpy(payloadPtr, report->gsmTestReport.IMSI, sizeof(report->gsmTestReport.IMSI));
+	payloadPtr += sizeof(report->gsmTestReport.IMSI);
+	payloadPtr = monitorFrame_putUint16(payloadPtr, report->gsmTestReport.batteryVoltage);
+
+	*payloadPtr++ = report->gpsTestReport.isUSARTWorking | (report->gpsTestReport.isFramesWorking << 1) | (report->gpsTestReport.isPositionWorking << 2);
+
+	*payloadPtr++ = report->bleTestReport.isBLEConfigured | (report->bleTestReport.isAdvertising << 1) | (report->bleTestReport.isBLEConnectionWorking << 2);
+	memcpy(payloadPtr, report->bleTestReport.MACAddress, sizeof(report->bleTestReport.MACAddress));
+	payloadPtr += sizeof(report->bleTestReport.MACAddress);
+
+	*payloadPtr++ = report->imuTestReport.isInterruptionWorking;
+	memcpy(payloadPtr, report->imuTestReport.accelerations, sizeof(report->imuTestReport.accelerations));
+	payloadPtr += sizeof(report->imuTestReport.accelerations);
+
+	*payloadPtr++ = report->ledTestReport.isLEDsWorking;
+	*payloadPtr++ = report->buttonTestReport.isButtonWorking;
+	*payloadPtr++ = report->dfTestReport.isReadWorking | (report->dfTestReport.isWriteWorking << 1);
+	*payloadPtr++ = report->calendarTestReport.isTimeWorking | (report->calendarTestReport.isAlarmWorking << 1);
+
+	payloadPtr = monitorFrame_putUint32(payloadPtr, report->adcTestReport.ADCUSBVoltage);
+	payloadPtr = monitorFrame_putUint32(payloadPtr, report->adcTestReport.ADCBatVoltage);
+	payloadPtr = monitorFrame_putUint16(payloadPtr, report->adcTestReport.voltageMin);
+	payloadPtr = monitorFrame_putUint16(payloadPtr, report->adcTestReport.voltageMax);
+
+	monitorFrame_send(frameId, payload, payloadPtr - payload);
+}
+
 /* tests the GSM powering on */
 void task_testGSM()
 {
@@ -459,7 +506,7 @@ void task_testGSM()
 static void testADC()
 {
 	uint16_t voltages[2];
-	ADC_read_BAT_USB(voltages);
+	batteryManager_readADCVoltages(voltages);
 
 	if(voltages[0] > BATTERY_LEVEL_0_VOLTAGE)
 	{
@@ -27,6 +27,7 @@
 #include <sgs/port_sgs.h>
 #include <hpl_calendar.h>
 #include <peripheralManager/USB_manager.h>
+#include <tests/monitor_frame.h>
 
 /* Bit orders for the SHR */
 // FUNCTIONALITY_BIT_GSM_USART				0 // GSM to MCU USART communication
@@ -127,6 +128,7 @@ void functionalitiesTest_setFunctionnalitiesMaskBitsFromISR(EventBits_t bits);
 void functionalitiesTest_init(void);
 void functionalitiesTest_runTests(bool isProductionTest);
 void functionalitiesTest_testBLE(void);
+void functionalitiesTest_sendReportFrame(uint8_t frameId);
 void task_testBLE(void);
 void task_testGSM(void);
 void task_testGPS(void);
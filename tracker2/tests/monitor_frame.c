@@ -0,0 +1,97 @@
+/*
+ * monitor_frame.c
+ *
+ * Content : binary frames of the USB test monitor, alongside the text commands.
+ * Decoded by monitor_protocol/monitor_client.py
+ */ 
+
+#include <tests/monitor_frame.h>
+#include <peripheralManager/USB_manager.h>
+
+static uint16_t computeCrc16(const uint8_t* data, uint16_t length);
+
+static uint8_t _frameBuf[MONITOR_FRAME_HEADER_SIZE + MONITOR_FRAME_MAX_PAYLOAD + MONITOR_FRAME_CRC_SIZE];
+static uint16_t _nbDroppedFrames; // answer frames dropped since the last END frame
+
+bool monitorFrame_isFrame(const uint8_t* buf){
+	return buf[0] == MONITOR_FRAME_SYNC;
+}
+
+/* Checks the length and the CRC of the frame received in buf. The payload is left in place */
+E_MONITOR_FRAME_STATUS monitorFrame_decode(uint8_t* buf, uint16_t bufLength, uint8_t* idPtr, uint8_t** payloadPtr, uint16_t* payloadLengthPtr){
+	*idPtr = buf[1];
+	uint16_t payloadLength = monitorFrame_getUint16(&buf[2]);
+	if(payloadLength > MONITOR_FRAME_MAX_PAYLOAD || MONITOR_FRAME_HEADER_SIZE + payloadLength + MONITOR_FRAME_CRC_SIZE > bufLength)
+	{
+		return MONITOR_FRAME_STATUS_WRONG_LENGTH;
+	}
+	uint16_t crc = computeCrc16(&buf[1], MONITOR_FRAME_HEADER_SIZE - 1 + payloadLength);
+	if(crc != monitorFrame_getUint16(&buf[MONITOR_FRAME_HEADER_SIZE + payloadLength]))
+	{
+		return MONITOR_FRAME_STATUS_WRONG_CRC;
+	}
+	*payloadPtr = &buf[MONITOR_FRAME_HEADER_SIZE];
+	*payloadLengthPtr = payloadLength;
+	return MONITOR_FRAME_STATUS_OK;
+}
+
+/* Only called by the USB monitor task. Returns false if the frame is dropped : the next END frame will report it */
+bool monitorFrame_send(uint8_t id, const uint8_t* payload, uint16_t payloadLength){
+	if(payloadLength > MONITOR_FRAME_MAX_PAYLOAD)
+	{
+		_nbDroppedFrames++;
+		return false;
+	}
+	_frameBuf[0] = MONITOR_FRAME_SYNC;
+	_frameBuf[1] = id;
+	monitorFrame_putUint16(&_frameBuf[2], payloadLength);
+	memcpy(&_frameBuf[MONITOR_FRAME_HEADER_SIZE], payload, payloadLength);
+	uint16_t crc = computeCrc16(&_frameBuf[1], MONITOR_FRAME_HEADER_SIZE - 1 + payloadLength);
+	monitorFrame_putUint16(&_frameBuf[MONITOR_FRAME_HEADER_SIZE + payloadLength], crc);
+	if(!USBManager_write(_frameBuf, MONITOR_FRAME_HEADER_SIZE + payloadLength + MONITOR_FRAME_CRC_SIZE))
+	{
+		_nbDroppedFrames++;
+		return false;
+	}
+	return true;
+}
+
+/* A command whose answer lost a frame ends with MONITOR_FRAME_STATUS_FRAME_DROPPED instead of MONITOR_FRAME_STATUS_OK */
+void monitorFrame_sendEnd(uint8_t commandId, E_MONITOR_FRAME_STATUS status){
+	if(status == MONITOR_FRAME_STATUS_OK && _nbDroppedFrames > 0)
+	{
+		status = MONITOR_FRAME_STATUS_FRAME_DROPPED;
+	}
+	_nbDroppedFrames = 0;
+	uint8_t payload[2] = { commandId, status };
+	monitorFrame_send(MONITOR_FRAME_ID_END, payload, sizeof(payload));
+}
+
+uint8_t* monitorFrame_putUint16(uint8_t* buf, uint16_t value){
+	buf[0] = value & 0xFF;
+	buf[1] = value >> 8;
+	return &buf[2];
+}
+
+uint8_t* monitorFrame_putUint32(uint8_t* buf, uint32_t value){
+	buf = monitorFrame_putUint16(buf, value & 0xFFFF);
+	return monitorFrame_putUint16(buf, value >> 16);
+}
+
+uint16_t monitorFrame_getUint16(const uint8_t* buf){
+	return buf[0] | ((uint16_t)buf[1] << 8);
+}
+
+/* CRC16 CCITT (polynom 0x1021), as the outbox slots of the DataFlash */
+static uint16_t computeCrc16(const uint8_t* data, uint16_t length){
+	uint16_t crc = 0xFFFF;
+	for(uint16_t i = 0; i < length; i++)
+	{
+		crc ^= (uint16_t)data[i] << 8;
+		for(uint8_t bit = 0; bit < 8; bit++)
+		{
+			crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+		}
+	}
+	return crc;
+}
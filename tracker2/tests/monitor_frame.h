@@ -0,0 +1,59 @@
+/*
+ * monitor_frame.h
+ *
+ * Content : binary frames of the USB test monitor, alongside the text commands.
+ * A frame is { MONITOR_FRAME_SYNC, id, payload length (2 bytes), payload, CRC16 CCITT of the id, length and payload (2 bytes) },
+ * little endian. Each command is answered by zero or more frames with the same id, then by a MONITOR_FRAME_ID_END frame
+ * { command id, E_MONITOR_FRAME_STATUS }. Decoded by monitor_protocol/monitor_client.py
+ */ 
+
+
+#ifndef MONITOR_FRAME_H_
+#define MONITOR_FRAME_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#define MONITOR_FRAME_SYNC			0xA5 // never the first char of a text command
+#define MONITOR_FRAME_HEADER_SIZE	4
+#define MONITOR_FRAME_CRC_SIZE		2
+#define MONITOR_FRAME_MAX_PAYLOAD	320
+
+/* Keep the values in sync with monitor_client.py */
+typedef enum{
+	MONITOR_FRAME_ID_GET_STATUS			= 0x01, // answer : version, subversion, request mask, running mask, interrupt mask, tick
+	MONITOR_FRAME_ID_GET_TELEMETRY		= 0x02, // answer : see telemetry_sendFrame
+	MONITOR_FRAME_ID_GET_TRACE			= 0x03, // answer : see trace_sendFrames
+	MONITOR_FRAME_ID_READ_FLASH			= 0x04, // payload : first page, number of pages (2 bytes each), within EXT_FLASH_NB_USED_PAGES. Answer : one frame per page { page, data }
+	MONITOR_FRAME_ID_GET_TEST_REPORT	= 0x05, // answer : see functionalitiesTest_sendReportFrame
+	MONITOR_FRAME_ID_TRIGGER			= 0x06, // payload : E_MONITOR_TRIGGER, then the instruction for MONITOR_TRIGGER_INSTRUCTION
+	MONITOR_FRAME_ID_END				= 0x7F,
+}E_MONITOR_FRAME_ID;
+
+typedef enum{
+	MONITOR_FRAME_STATUS_OK					= 0,
+	MONITOR_FRAME_STATUS_WRONG_CRC			= 1,
+	MONITOR_FRAME_STATUS_WRONG_LENGTH		= 2,
+	MONITOR_FRAME_STATUS_UNKNOWN_COMMAND	= 3,
+	MONITOR_FRAME_STATUS_DISABLED			= 4, // the feature is not compiled in this version
+	MONITOR_FRAME_STATUS_WRONG_PARAMETER	= 5,
+	MONITOR_FRAME_STATUS_FRAME_DROPPED		= 6, // an answer frame could not be written to the USB, the answer is incomplete
+}E_MONITOR_FRAME_STATUS;
+
+typedef enum{
+	MONITOR_TRIGGER_BUTTON_SOS			= 1,
+	MONITOR_TRIGGER_BUTTON_ACTION_OFF	= 2,
+	MONITOR_TRIGGER_BUTTON_ACTION_ON	= 3,
+	MONITOR_TRIGGER_INSTRUCTION			= 4,
+}E_MONITOR_TRIGGER;
+
+bool monitorFrame_isFrame(const uint8_t* buf);
+E_MONITOR_FRAME_STATUS monitorFrame_decode(uint8_t* buf, uint16_t bufLength, uint8_t* idPtr, uint8_t** payloadPtr, uint16_t* payloadLengthPtr);
+bool monitorFrame_send(uint8_t id, const uint8_t* payload, uint16_t payloadLength);
+void monitorFrame_sendEnd(uint8_t commandId, E_MONITOR_FRAME_STATUS status);
+uint8_t* monitorFrame_putUint16(uint8_t* buf, uint16_t value);
+uint8_t* monitorFrame_putUint32(uint8_t* buf, uint32_t value);
+uint16_t monitorFrame_getUint16(const uint8_t* buf);
+
+#endif /* MONITOR_FRAME_H_ */
@@ -1,6 +1,23 @@
 #include <tests/test_monitor.h>
+#include <seekiosManager/task_management_utilities.h>
+#include <seekiosCore/telemetry.h>
+#include <seekiosCore/trace.h>
+#include <seekiosCore/energy_profiler.h>
+#include <tests/uart_replay.h>
+#include <tests/monitor_frame.h>
+#include <tests/functionnalities_test.h>
+#include <peripheralManager/dataflash_manager.h>
 
 static void triggerTest(char* triggerName);
+static void processFrame(uint8_t* frame, uint16_t frameLength);
+static void sendStatusFrame(uint8_t frameId);
+static E_MONITOR_FRAME_STATUS readFlashFrame(uint8_t* payload, uint16_t payloadLength);
+static void sendFlashPage(unsigned int pageAdr, unsigned char* page);
+static E_MONITOR_FRAME_STATUS triggerFrameTest(uint8_t* payload, uint16_t payloadLength);
+static void setLogFilter(char* frame);
+#if (ENERGY_PROFILER_ACTIVATED == 1)
+static void setEnergyCurrent(char* frame);
+#endif
 
 #define MONITOR_BUF_LENGTH 512
 
@@ -16,12 +33,68 @@ void task_testMonitor(void* param)
 				
 		if(read == USB_OK)
 		{
-			if(strstr(monitorBuf,RX_GET_STATUS)) // Return current status of the Seekios
+			if(monitorFrame_isFrame(monitorBuf))
+			{
+				processFrame(monitorBuf, MONITOR_BUF_LENGTH);
+				monitorBuf[0] = '\0'; // the frame must not be processed twice
+			}
+			else if(strstr(monitorBuf,RX_GET_STATUS)) // Return current status of the Seekios
 			{
 				strcpy(monitorBuf, TX_SEND_STATUS_FUNCTIONALITIES_TEST_SCENARIO);
 				strcat(monitorBuf, "\r\n");
 				USBManager_print(monitorBuf);
 			}
+			else if(strstr(monitorBuf, RX_GET_TELEMETRY))
+			{
+				taskManagementUtilities_recordPersistentTasksStack();
+				telemetry_printReport();
+			}
+			#if (TRACE_ACTIVATED == 1)
+			else if(strstr(monitorBuf, RX_GET_TRACE))
+			{
+				trace_printDump();
+			}
+			#endif
+			#if (ENERGY_PROFILER_ACTIVATED == 1)
+			else if(strstr(monitorBuf, RX_GET_ENERGY))
+			{
+				energyProfiler_printReport();
+			}
+			else if(strstr(monitorBuf, RX_RESET_ENERGY))
+			{
+				energyProfiler_reset();
+			}
+			else if(strstr(monitorBuf, RX_SET_ENERGY_CURRENT))
+			{
+				setEnergyCurrent(monitorBuf);
+			}
+			#endif
+			#if (UART_REPLAY_ACTIVATED == 1)
+			else if(strstr(monitorBuf, RX_REPLAY_INJECT))
+			{
+				if(!uartReplay_inject(monitorBuf))
+				{
+					USARTManager_printUsbWait("Replay not started\r\n");
+				}
+				monitorBuf[0] = '\0'; // the lines must not be injected twice
+			}
+			else if(strstr(monitorBuf, RX_REPLAY_RECORD))
+			{
+				uartReplay_start(UART_REPLAY_STATE_RECORDING);
+			}
+			else if(strstr(monitorBuf, RX_REPLAY_START))
+			{
+				uartReplay_start(UART_REPLAY_STATE_REPLAYING);
+			}
+			else if(strstr(monitorBuf, RX_REPLAY_STOP))
+			{
+				uartReplay_stop();
+			}
+			#endif
+			else if(strstr(monitorBuf, RX_SET_LOG_FILTER))
+			{
+				setLogFilter(monitorBuf);
+			}
 			else if(strstr(monitorBuf, RX_TEST_TRIGGER))
 			{
 				USARTManager_printUsbWait("Test trigger received : ");
@@ -31,6 +104,14 @@ void task_testMonitor(void* param)
 			}
 		}
 
+		#if (UART_REPLAY_ACTIVATED == 1)
+		if(uartReplay_isActive()) // the lines are printed and injected with a short latency
+		{
+			uartReplay_printLines();
+			vTaskDelay(UART_REPLAY_MONITOR_PERIOD);
+			continue;
+		}
+		#endif
 		vTaskDelay(100);
 	}
 	maskUtilities_clearRunningMaskBits(RUNNING_BIT_USB_MONITOR);
@@ -69,6 +150,155 @@ static void triggerTest(char* triggerFrame)
 	return;
 }
 
+/* Binary commands (see monitor_frame.h) : the answer frames are always followed by an END frame with the status */
+static void processFrame(uint8_t* frame, uint16_t frameLength)
+{
+	uint8_t frameId;
+	uint8_t* payload;
+	uint16_t payloadLength;
+	E_MONITOR_FRAME_STATUS status = monitorFrame_decode(frame, frameLength, &frameId, &payload, &payloadLength);
+	if(status != MONITOR_FRAME_STATUS_OK)
+	{
+		monitorFrame_sendEnd(frameId, status);
+		return;
+	}
+
+	switch(frameId)
+	{
+		case MONITOR_FRAME_ID_GET_STATUS:
+			sendStatusFrame(frameId);
+			break;
+		case MONITOR_FRAME_ID_GET_TELEMETRY:
+			taskManagementUtilities_recordPersistentTasksStack();
+			telemetry_sendFrame(frameId);
+			break;
+		case MONITOR_FRAME_ID_GET_TRACE:
+			#if (TRACE_ACTIVATED == 1)
+			trace_sendFrames(frameId);
+			#else
+			status = MONITOR_FRAME_STATUS_DISABLED;
+			#endif
+			break;
+		case MONITOR_FRAME_ID_READ_FLASH:
+			status = readFlashFrame(payload, payloadLength);
+			break;
+		case MONITOR_FRAME_ID_GET_TEST_REPORT:
+			functionalitiesTest_sendReportFrame(frameId);
+			break;
+		case MONITOR_FRAME_ID_TRIGGER:
+			status = triggerFrameTest(payload, payloadLength);
+			break;
+		default:
+			status = MONITOR_FRAME_STATUS_UNKNOWN_COMMAND;
+			break;
+	}
+	monitorFrame_sendEnd(frameId, status);
+}
+
+/* Version, subversion, request mask, running mask, interrupt mask, tick */
+static void sendStatusFrame(uint8_t frameId)
+{
+	uint8_t payload[18];
+	uint8_t* payloadPtr = payload;
+	*payloadPtr++ = SEEKIOS_VERSION;
+	*payloadPtr++ = SEEKIOS_SUBVERSION;
+	payloadPtr = monitorFrame_putUint32(payloadPtr, maskUtilities_getRequestMask());
+	payloadPtr = monitorFrame_putUint32(payloadPtr, maskUtilities_getRunningMask());
+	payloadPtr = monitorFrame_putUint32(payloadPtr, maskUtilities_getInterruptMask());
+	payloadPtr = monitorFrame_putUint32(payloadPtr, xTaskGetTickCount());
+	monitorFrame_send(frameId, payload, payloadPtr - payload);
+}
+
+/* First page, number of pages : the range must be within the pages used by the firmware */
+static E_MONITOR_FRAME_STATUS readFlashFrame(uint8_t* payload, uint16_t payloadLength)
+{
+	if(payloadLength != 4)
+	{
+		return MONITOR_FRAME_STATUS_WRONG_PARAMETER;
+	}
+	uint16_t firstPage = monitorFrame_getUint16(payload);
+	uint16_t nbPages = monitorFrame_getUint16(&payload[2]);
+	if(nbPages == 0 || firstPage >= EXT_FLASH_NB_USED_PAGES || nbPages > EXT_FLASH_NB_USED_PAGES - firstPage)
+	{
+		return MONITOR_FRAME_STATUS_WRONG_PARAMETER;
+	}
+	static uint8_t page[EXT_FLASH_PAGE_SIZE];
+	dataflashManager_readPages(firstPage, nbPages, page, sendFlashPage);
+	return MONITOR_FRAME_STATUS_OK;
+}
+
+/* Page index (2 bytes), then the page */
+static void sendFlashPage(unsigned int pageAdr, unsigned char* page)
+{
+	static uint8_t payload[2 + EXT_FLASH_PAGE_SIZE];
+	monitorFrame_putUint16(payload, pageAdr);
+	memcpy(&payload[2], page, EXT_FLASH_PAGE_SIZE);
+	monitorFrame_send(MONITOR_FRAME_ID_READ_FLASH, payload, sizeof(payload));
+}
+
+/* Same triggers as the TRIGGER_* text commands */
+static E_MONITOR_FRAME_STATUS triggerFrameTest(uint8_t* payload, uint16_t payloadLength)
+{
+	if(payloadLength == 0)
+	{
+		return MONITOR_FRAME_STATUS_WRONG_PARAMETER;
+	}
+
+	switch(payload[0])
+	{
+		case MONITOR_TRIGGER_BUTTON_SOS:
+			maskUtilities_setRequestMaskBits(REQUEST_BIT_SOS);
+			break;
+		case MONITOR_TRIGGER_BUTTON_ACTION_OFF:
+			maskUtilities_setRequestMaskBits(REQUEST_BIT_SEEKIOS_TURN_OFF);
+			break;
+		case MONITOR_TRIGGER_BUTTON_ACTION_ON:
+			maskUtilities_setRequestMaskBits(REQUEST_BIT_SEEKIOS_TURN_ON);
+			break;
+		case MONITOR_TRIGGER_INSTRUCTION:
+			if(payloadLength < 2)
+			{
+				return MONITOR_FRAME_STATUS_WRONG_PARAMETER;
+			}
+			payload[payloadLength] = '\0'; // overwrites the CRC, already checked
+			statusManager_processMessage((char*)&payload[1]);
+			break;
+		default:
+			return MONITOR_FRAME_STATUS_WRONG_PARAMETER;
+	}
+	return MONITOR_FRAME_STATUS_OK;
+}
+
+/* SET_LOG_FILTER:max level:module mask. Only the levels kept at compile time can be printed */
+static void setLogFilter(char* frame)
+{
+	strtok(frame, ":");
+	char* maxLevel = strtok(NULL, ":");
+	char* moduleMask = strtok(NULL, ":\r\n");
+	if(maxLevel == NULL || moduleMask == NULL)
+	{
+		USARTManager_printUsbWait("Wrong log filter\r\n");
+		return;
+	}
+	debugLog_setFilter(atoi(maxLevel), atoi(moduleMask));
+}
+
+#if (ENERGY_PROFILER_ACTIVATED == 1)
+/* SET_ENERGY_CURRENT:domain:state:current in uA, with the names of the energy report */
+static void setEnergyCurrent(char* frame)
+{
+	strtok(frame, ":");
+	char* domainName = strtok(NULL, ":");
+	char* stateName = strtok(NULL, ":");
+	char* current = strtok(NULL, ":\r\n");
+	if(domainName == NULL || stateName == NULL || current == NULL
+	|| !energyProfiler_setCurrent(domainName, stateName, atoi(current)))
+	{
+		USARTManager_printUsbWait("Unknown energy state\r\n");
+	}
+}
+#endif
+
 void testMonitor_raiseEvent(const char* eventName)
 {
 	if(maskUtilities_getRequestMask() & REQUEST_BIT_USB_DEBUGGING)
@@ -0,0 +1,178 @@
+/*
+ * uart_replay.c
+ *
+ * Content : records the lines received from the GPS and the GSM and the AT commands sent to the GSM,
+ * or replays a transcript : the received lines are injected in the reception path and the AT commands
+ * are kept from the modem. Driven over the USB by replay_harness/uart_replay.py
+ */ 
+
+#include <tests/uart_replay.h>
+
+#if (UART_REPLAY_ACTIVATED == 1)
+
+#include <peripheralManager/USB_manager.h>
+#include <peripheralManager/USART_manager.h>
+#include <tools/string_helper.h>
+#include <serial_sgs.h>
+
+static void pushPartialLine(UartReplayLine* partialLine);
+
+static const char* const _channelNames[UART_REPLAY_NB_CHANNELS] = { "GPS", "GSM_RX", "GSM_TX" };
+
+static UartReplayLine _replayLines[UART_REPLAY_NB_LINES];
+static uint8_t _replayLinesStart;
+static uint8_t _nbReplayLines;
+static uint16_t _nbLostLines;
+static UartReplayLine _partialLines[UART_REPLAY_NB_CHANNELS]; // line being received on each channel
+static volatile E_UART_REPLAY_STATE _replayState;
+
+/* Starts recording the real lines, or replaying : the real received bytes are dropped from then on */
+void uartReplay_start(E_UART_REPLAY_STATE state){
+	UBaseType_t savedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+	_replayLinesStart = 0;
+	_nbReplayLines = 0;
+	_nbLostLines = 0;
+	for(uint8_t i = 0; i < UART_REPLAY_NB_CHANNELS; i++)
+	{
+		_partialLines[i].channel = i;
+		_partialLines[i].length = 0;
+	}
+	_replayState = state;
+	portCLEAR_INTERRUPT_MASK_FROM_ISR(savedInterruptStatus);
+}
+
+/* Prints the last lines, the number of lost lines, then RPL_OVER */
+void uartReplay_stop(){
+	char line[24];
+	char buff[12];
+	_replayState = UART_REPLAY_STATE_OFF;
+	uartReplay_printLines();
+	if(_nbLostLines > 0)
+	{
+		strcpy(line, TX_REPLAY_LOST);
+		strcat(line, ":");
+		strcat(line, stringHelper_intToString(_nbLostLines, (uint8_t*)buff));
+		USBManager_println(line);
+	}
+	USBManager_println(TX_REPLAY_OVER);
+}
+
+bool uartReplay_isReplaying(){
+	return _replayState == UART_REPLAY_STATE_REPLAYING;
+}
+
+bool uartReplay_isActive(){
+	return _replayState != UART_REPLAY_STATE_OFF;
+}
+
+/* Cuts the bytes in lines, without the CR and LF. Can be called from the tasks and the interrupts */
+void uartReplay_record(E_UART_REPLAY_CHANNEL channel, const uint8_t* data, uint16_t length){
+	if(_replayState == UART_REPLAY_STATE_OFF)
+	{
+		return;
+	}
+	UBaseType_t savedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+	UartReplayLine* partialLine = &_partialLines[channel];
+	for(uint16_t i = 0; i < length; i++)
+	{
+		if(data[i] == '\r' || data[i] == '\n')
+		{
+			if(partialLine->length > 0)
+			{
+				pushPartialLine(partialLine);
+			}
+			continue;
+		}
+		partialLine->data[partialLine->length++] = data[i];
+		if(partialLine->length == UART_REPLAY_LINE_SIZE)
+		{
+			pushPartialLine(partialLine);
+		}
+	}
+	portCLEAR_INTERRUPT_MASK_FROM_ISR(savedInterruptStatus);
+}
+
+/* Called with the interrupts masked */
+static void pushPartialLine(UartReplayLine* partialLine){
+	partialLine->tick = xTaskGetTickCountFromISR();
+	if(_nbReplayLines < UART_REPLAY_NB_LINES)
+	{
+		memcpy(&_replayLines[(_replayLinesStart + _nbReplayLines) % UART_REPLAY_NB_LINES], partialLine, sizeof(UartReplayLine));
+		_nbReplayLines++;
+	}
+	else if(_nbLostLines < UINT16_MAX)
+	{
+		_nbLostLines++;
+	}
+	partialLine->length = 0;
+}
+
+/* Injects every REPLAY_INJECT:GPS|GSM:line of the USB frame, with the CRLF, in the reception path.
+Returns false when nothing was injected : the replay must be started first */
+bool uartReplay_inject(char* frame){
+	bool isInjected = false;
+	char* command = strstr(frame, RX_REPLAY_INJECT);
+	while(command != NULL && _replayState == UART_REPLAY_STATE_REPLAYING)
+	{
+		char* channelName = command + strlen(RX_REPLAY_INJECT) + 1;
+		char* line = strchr(channelName, ':');
+		if(line == NULL)
+		{
+			break;
+		}
+		line++;
+		uint16_t lineLength = strcspn(line, "\r\n");
+		if(strncmp(channelName, "GPS:", 4) == 0)
+		{
+			uartReplay_record(UART_REPLAY_CHANNEL_GPS_RX, (uint8_t*)line, lineLength);
+			uartReplay_record(UART_REPLAY_CHANNEL_GPS_RX, (uint8_t*)CRLF, 2);
+			serial_injectGpsBytes((uint8_t*)line, lineLength);
+			serial_injectGpsBytes((uint8_t*)CRLF, 2);
+			isInjected = true;
+		}
+		else if(strncmp(channelName, "GSM:", 4) == 0)
+		{
+			uartReplay_record(UART_REPLAY_CHANNEL_GSM_RX, (uint8_t*)line, lineLength);
+			uartReplay_record(UART_REPLAY_CHANNEL_GSM_RX, (uint8_t*)CRLF, 2);
+			serial_injectGsmBytes((uint8_t*)line, lineLength);
+			serial_injectGsmBytes((uint8_t*)CRLF, 2);
+			isInjected = true;
+		}
+		command = strstr(&line[lineLength], RX_REPLAY_INJECT);
+	}
+	return isInjected;
+}
+
+/* Sends the recorded lines, oldest first, as RPL_LINE:tick:channel:line */
+void uartReplay_printLines(){
+	char line[32 + UART_REPLAY_LINE_SIZE];
+	char buff[12];
+	UartReplayLine replayLine;
+
+	while(1)
+	{
+		UBaseType_t savedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+		if(_nbReplayLines == 0)
+		{
+			portCLEAR_INTERRUPT_MASK_FROM_ISR(savedInterruptStatus);
+			break;
+		}
+		memcpy(&replayLine, &_replayLines[_replayLinesStart], sizeof(UartReplayLine));
+		_replayLinesStart = (_replayLinesStart + 1) % UART_REPLAY_NB_LINES;
+		_nbReplayLines--;
+		portCLEAR_INTERRUPT_MASK_FROM_ISR(savedInterruptStatus);
+
+		strcpy(line, TX_REPLAY_LINE);
+		strcat(line, ":");
+		strcat(line, stringHelper_intToString(replayLine.tick, (uint8_t*)buff));
+		strcat(line, ":");
+		strcat(line, _channelNames[replayLine.channel]);
+		strcat(line, ":");
+		uint16_t lineLength = strlen(line);
+		memcpy(&line[lineLength], replayLine.data, replayLine.length);
+		line[lineLength + replayLine.length] = '\0';
+		USBManager_println(line);
+	}
+}
+
+#endif
@@ -0,0 +1,53 @@
+/*
+ * uart_replay.h
+ *
+ * Content : records the lines received from the GPS and the GSM and the AT commands sent to the GSM,
+ * or replays a transcript : the received lines are injected in the reception path and the AT commands
+ * are kept from the modem. Driven over the USB by replay_harness/uart_replay.py
+ */
+
+
+#ifndef UART_REPLAY_H_
+#define UART_REPLAY_H_
+
+#include <seekiosCore/seekios.h>
+#include <FreeRTOS.h>
+#include <task.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#define UART_REPLAY_NB_LINES		12 // lines waiting to be printed on the USB
+#define UART_REPLAY_LINE_SIZE		72 // longer lines are split
+#define UART_REPLAY_MONITOR_PERIOD	10 // in ms, period of the USB monitor while recording or replaying
+
+/* Keep the names in sync with uart_replay.py */
+typedef enum{
+	UART_REPLAY_CHANNEL_GPS_RX	= 0,
+	UART_REPLAY_CHANNEL_GSM_RX	= 1,
+	UART_REPLAY_CHANNEL_GSM_TX	= 2,
+	UART_REPLAY_NB_CHANNELS
+}E_UART_REPLAY_CHANNEL;
+
+typedef enum{
+	UART_REPLAY_STATE_OFF		= 0,
+	UART_REPLAY_STATE_RECORDING	= 1, // the real lines are recorded
+	UART_REPLAY_STATE_REPLAYING	= 2, // the real received bytes are dropped, the injected lines and the AT commands are recorded
+}E_UART_REPLAY_STATE;
+
+typedef struct{
+	uint32_t tick; // of the last byte of the line
+	uint8_t channel;
+	uint8_t length;
+	uint8_t data[UART_REPLAY_LINE_SIZE];
+}UartReplayLine;
+
+void uartReplay_start(E_UART_REPLAY_STATE state);
+void uartReplay_stop(void);
+bool uartReplay_isReplaying(void);
+bool uartReplay_isActive(void);
+void uartReplay_record(E_UART_REPLAY_CHANNEL channel, const uint8_t* data, uint16_t length);
+bool uartReplay_inject(char* frame);
+void uartReplay_printLines(void);
+
+#endif /* UART_REPLAY_H_ */
@@ -358,6 +358,30 @@ size_t xPortGetMinimumEverFreeHeapSize( void )
 }
 /*-----------------------------------------------------------*/
 
+size_t xPortGetLargestFreeBlockSize( void )
+{
+BlockLink_t *pxBlock;
+size_t xLargestFreeBlockSize = 0;
+
+	vTaskSuspendAll();
+	{
+		if( pxEnd != NULL )
+		{
+			for( pxBlock = xStart.pxNextFreeBlock; pxBlock != pxEnd; pxBlock = pxBlock->pxNextFreeBlock )
+			{
+				if( pxBlock->xBlockSize > xLargestFreeBlockSize )
+				{
+					xLargestFreeBlockSize = pxBlock->xBlockSize;
+				}
+			}
+		}
+	}
+	( void ) xTaskResumeAll();
+
+	return xLargestFreeBlockSize;
+}
+/*-----------------------------------------------------------*/
+
 void vPortInitialiseBlocks( void )
 {
 	/* This just exists to keep the linker quiet. */
@@ -2,138 +2,177 @@
 #define _USE_MATH_DEFINES //l'ordre doit etre conserv
 #include <math.h>
 static double DDtoRad(double coordinateToRAD);
-static int crossProduct(Vector vector1,Vector vector2);
+static uint32_t squareRoot(uint64_t value);
+static int32_t clampToInt32(double value);
 
-void geolocationTools_constructVectors(Vector *vectors,int nbVectors, Coordinate *coordinates)
+/* Prepares a zone for geolocationTools_isPointInCompiledZone and geolocationTools_getDistanceToCompiledZone.
+The vertices are projected in meters on a plane tangent at the center of the zone (equirectangular projection),
+which is precise enough for zones of a few kilometers */
+void geolocationTools_compileZone(CompiledZone* zonePtr, Coordinate* zoneCoordinates, uint8_t nbCoordinates)
 {
-	for (int i=0;i<nbVectors;i++)
+	if(nbCoordinates > ZONE_MAX_VERTICES)
 	{
-		if(i<(nbVectors-1))
-		{
-			vectors[i].x=(coordinates[i+1].lat-coordinates[i].lat);
-			vectors[i].y=(coordinates[i+1].lon-coordinates[i].lon);
-		}
-		else
-		{
-			vectors[i].x=(coordinates[0].lat-coordinates[i].lat);
-			vectors[i].y=(coordinates[0].lon-coordinates[i].lon);
-		}
+		nbCoordinates = ZONE_MAX_VERTICES;
+	}
+	zonePtr->nbVertices = nbCoordinates;
+	if(nbCoordinates == 0)
+	{
+		return;
 	}
-}
 
-//Returns true if the location is in the zone, false otherwise
-bool geolocationTools_isPositionInZone(Coordinate *seekiosLocationPtr, int nbCoordinates, Coordinate *zoneCoordinates)
-{
-	Vector zoneVectors[NB_MAX_COORDINATES];
-	geolocationTools_constructVectors(zoneVectors, nbCoordinates, zoneCoordinates);
-	
-	Vector condition2_1;
-	Vector condition2_2;
-	Vector condition3_1;
-	Vector condition3_2;
-	Vector seekios;
-		
-	int index=0;
-	/* Le point pris arbitrairement en dehors de la zone est le point de lat=0 et long =0.
-	Les composantes du vecteur entre le Seekios et ce point sont donc gales aux coord
-	du Seekios lui mme. Il en est de meme pour le vecteur "condition3_1"
-	*/
-	seekios.x=-(seekiosLocationPtr->lat);
-	seekios.y=-(seekiosLocationPtr->lon);
-	volatile uint32_t zoneWm = uxTaskGetStackHighWaterMark(NULL);
-	UNUSED(zoneWm);
-	
-	for (int i=0;i<nbCoordinates;i++)
+	double minLat = zoneCoordinates[0].lat;
+	double maxLat = zoneCoordinates[0].lat;
+	double minLon = zoneCoordinates[0].lon;
+	double maxLon = zoneCoordinates[0].lon;
+	for(uint8_t i = 1; i < nbCoordinates; i++)
 	{
-		//Cration de vecteurs temporaires dpendant de i
-		condition2_2.x=zoneCoordinates[i].lat-seekiosLocationPtr->lat;
-		condition2_2.y=zoneCoordinates[i].lon-seekiosLocationPtr->lon;
-		condition3_1.x=-zoneCoordinates[i].lat;
-		condition3_1.y=-zoneCoordinates[i].lon;
-		condition3_2.x=seekiosLocationPtr->lat-zoneCoordinates[i].lat;
-		condition3_2.y=seekiosLocationPtr->lon-zoneCoordinates[i].lon;
-		condition2_1.x=zoneCoordinates[(i+1)%nbCoordinates].lat-seekiosLocationPtr->lat;
-		condition2_1.y=zoneCoordinates[(i+1)%nbCoordinates].lon-seekiosLocationPtr->lon;
-		
-		zoneWm = uxTaskGetStackHighWaterMark(NULL);
-		if(crossProduct(seekios,zoneVectors[i])!=0
-		&& (crossProduct(seekios,condition2_1)*crossProduct(seekios,condition2_2))<=0
-		&&(crossProduct(zoneVectors[i],condition3_1)*crossProduct(zoneVectors[i],condition3_2))<=0)
-		{
-			index++;
-		}
+		if(zoneCoordinates[i].lat < minLat) minLat = zoneCoordinates[i].lat;
+		if(zoneCoordinates[i].lat > maxLat) maxLat = zoneCoordinates[i].lat;
+		if(zoneCoordinates[i].lon < minLon) minLon = zoneCoordinates[i].lon;
+		if(zoneCoordinates[i].lon > maxLon) maxLon = zoneCoordinates[i].lon;
 	}
-volatile uint32_t wm=uxTaskGetStackHighWaterMark(NULL);
-	return !((index%2)==0); // nombre d'intersections pair : seekios OUT, impair : IN
-}
+	zonePtr->originLat = (minLat + maxLat) / 2;
+	zonePtr->originLon = (minLon + maxLon) / 2;
+	zonePtr->metersPerDegreeLat = DDtoRad(1) * EARTH_RADIUS;
+	zonePtr->metersPerDegreeLon = zonePtr->metersPerDegreeLat * cos(DDtoRad(zonePtr->originLat));
 
+	for(uint8_t i = 0; i < nbCoordinates; i++)
+	{
+		geolocationTools_projectOnZone(zonePtr, &zoneCoordinates[i], &zonePtr->vertices[i]);
+	}
 
-/* Gets the shortest distance between a point and a zone */
-double geolocationTools_getShortestDistanceToZone(Coordinate* zoneCoordinates, uint8_t nbCoordinates, Coordinate* pointPtr){
-	double shortestDistance = geolocationTools_getShortestDistanceFromEdge(zoneCoordinates[0].lat, zoneCoordinates[0].lon, zoneCoordinates[1].lat, zoneCoordinates[1].lon, pointPtr);
-	uint8_t nbEdges = nbCoordinates;
-	for(int i=1; i<nbEdges; i++){
-		volatile double distance = geolocationTools_getShortestDistanceFromEdge(
-			zoneCoordinates[i].lat,
-			zoneCoordinates[i].lon,
-			zoneCoordinates[(i+1)%nbEdges].lat,
-			zoneCoordinates[(i+1)%nbEdges].lon,
-			pointPtr
-		);
+	zonePtr->minPoint = zonePtr->vertices[0];
+	zonePtr->maxPoint = zonePtr->vertices[0];
+	for(uint8_t i = 0; i < nbCoordinates; i++)
+	{
+		LocalPoint* vertexPtr = &zonePtr->vertices[i];
+		LocalPoint* nextVertexPtr = &zonePtr->vertices[(i+1)%nbCoordinates];
+		if(vertexPtr->x < zonePtr->minPoint.x) zonePtr->minPoint.x = vertexPtr->x;
+		if(vertexPtr->x > zonePtr->maxPoint.x) zonePtr->maxPoint.x = vertexPtr->x;
+		if(vertexPtr->y < zonePtr->minPoint.y) zonePtr->minPoint.y = vertexPtr->y;
+		if(vertexPtr->y > zonePtr->maxPoint.y) zonePtr->maxPoint.y = vertexPtr->y;
 
-		if(distance < shortestDistance){
-			shortestDistance = distance;
-		}
+		zonePtr->edges[i].x = nextVertexPtr->x - vertexPtr->x;
+		zonePtr->edges[i].y = nextVertexPtr->y - vertexPtr->y;
+		zonePtr->edgeSquareLengths[i] = (int64_t)zonePtr->edges[i].x * zonePtr->edges[i].x + (int64_t)zonePtr->edges[i].y * zonePtr->edges[i].y;
+		zonePtr->edgeLengths[i] = squareRoot(zonePtr->edgeSquareLengths[i] << (2 * ZONE_EDGE_LENGTH_SHIFT));
 	}
-	return shortestDistance;
 }
 
-/* Gets the shortest distance from a point to an edge of a zone*/
-double geolocationTools_getShortestDistanceFromEdge(double xA, double yA, double xB, double yB, Coordinate* point){
-	double A = point->lat - xA;
-	double B = point->lon - yA;
-	double C = xB - xA;
-	double D = yB - yA;
+/* Converts a coordinate to the local frame of the zone */
+void geolocationTools_projectOnZone(const CompiledZone* zonePtr, const Coordinate* coordinatePtr, LocalPoint* resultPtr)
+{
+	resultPtr->x = clampToInt32((coordinatePtr->lon - zonePtr->originLon) * zonePtr->metersPerDegreeLon);
+	resultPtr->y = clampToInt32((coordinatePtr->lat - zonePtr->originLat) * zonePtr->metersPerDegreeLat);
+}
 
-	double dot = A*C + B*D;
-	double squareLength = C*C + D*D;
-	double param = -1;
-	if(squareLength != 0) // edge length = 0
+/* Returns true if the point is in the zone. Bounding box check, then ray casting to the east */
+bool geolocationTools_isPointInCompiledZone(const CompiledZone* zonePtr, const LocalPoint* pointPtr)
+{
+	if(zonePtr->nbVertices < 3
+	|| pointPtr->x < zonePtr->minPoint.x || pointPtr->x > zonePtr->maxPoint.x
+	|| pointPtr->y < zonePtr->minPoint.y || pointPtr->y > zonePtr->maxPoint.y)
 	{
-		param = dot/squareLength;
+		return false;
 	}
 
-	double xH, yH;
-	if(param < 0){
-		xH = xA;
-		yH = yA;
-		} else if(param > 1){
-		xH = xB;
-		yH = yB;
-		} else {
-		xH = xA + param * C;
-		yH = yA + param * D;
+	bool isInZone = false;
+	for(uint8_t i = 0; i < zonePtr->nbVertices; i++)
+	{
+		const LocalPoint* vertexPtr = &zonePtr->vertices[i];
+		const LocalPoint* edgePtr = &zonePtr->edges[i];
+		bool isVertexAbove = vertexPtr->y > pointPtr->y;
+		bool isNextVertexAbove = (vertexPtr->y + edgePtr->y) > pointPtr->y;
+		if(isVertexAbove != isNextVertexAbove)
+		{
+			// the edge crosses the horizontal line of the point : is the crossing on the east of the point ?
+			int64_t pointSide = (int64_t)(pointPtr->x - vertexPtr->x) * edgePtr->y;
+			int64_t crossingSide = (int64_t)(pointPtr->y - vertexPtr->y) * edgePtr->x;
+			if(edgePtr->y > 0 ? pointSide < crossingSide : pointSide > crossingSide)
+			{
+				isInZone = !isInZone;
+			}
+		}
 	}
-
-	double distanceFromEdge = geolocationTools_geoCoordinateToMeterDistance(point->lat, point->lon, xH, yH);
-	return distanceFromEdge;
+	return isInZone;
 }
 
-/* From the geographical coordinates (lat and lon), converts it to a metrical distance */
-double geolocationTools_geoCoordinateToMeterDistance(double xA, double yA, double xB, double yB){
+/* Returns 0 if the point is in the zone, or the distance in meters between the point and the closest edge */
+uint32_t geolocationTools_getDistanceToCompiledZone(const CompiledZone* zonePtr, const LocalPoint* pointPtr)
+{
+	if(zonePtr->nbVertices == 0)
+	{
+		return UINT32_MAX;
+	}
+	if(geolocationTools_isPointInCompiledZone(zonePtr, pointPtr))
+	{
+		return 0;
+	}
 
-	double xA_rad = DDtoRad(xA);
-	double xB_rad = DDtoRad(xB);
-	double yA_rad = DDtoRad(yA);
-	double yB_rad = DDtoRad(yB);
+	uint32_t minDistance = UINT32_MAX;
+	for(uint8_t i = 0; i < zonePtr->nbVertices; i++)
+	{
+		const LocalPoint* edgePtr = &zonePtr->edges[i];
+		int64_t dx = (int64_t)pointPtr->x - zonePtr->vertices[i].x;
+		int64_t dy = (int64_t)pointPtr->y - zonePtr->vertices[i].y;
+		int64_t dot = dx * edgePtr->x + dy * edgePtr->y;
+		uint32_t distance;
+		if(dot <= 0 || zonePtr->edgeLengths[i] == 0) // closest to the first vertex
+		{
+			distance = squareRoot(dx * dx + dy * dy);
+		}
+		else if(dot >= zonePtr->edgeSquareLengths[i]) // closest to the second vertex
+		{
+			dx -= edgePtr->x;
+			dy -= edgePtr->y;
+			distance = squareRoot(dx * dx + dy * dy);
+		}
+		else // closest to the projection on the edge
+		{
+			int64_t cross = dx * edgePtr->y - dy * edgePtr->x;
+			distance = (((cross < 0 ? -cross : cross) << ZONE_EDGE_LENGTH_SHIFT) + zonePtr->edgeLengths[i] / 2) / zonePtr->edgeLengths[i];
+		}
+		if(distance < minDistance)
+		{
+			minDistance = distance;
+		}
+	}
+	return minDistance;
+}
 
-	double sinXA = sin(xA_rad);
-	double sinXB = sin(xB_rad);
-	double cosXA = cos(xA_rad);
-	double cosXB = cos(xB_rad);
-	double cosDiffYAYB = cos(yA_rad	- yB_rad);
+static uint32_t squareRoot(uint64_t value)
+{
+	uint64_t result = 0;
+	uint64_t bit = (uint64_t)1 << 62;
+	while(bit > value)
+	{
+		bit >>= 2;
+	}
+	while(bit != 0)
+	{
+		if(value >= result + bit)
+		{
+			value -= result + bit;
+			result = (result >> 1) + bit;
+		}
+		else
+		{
+			result >>= 1;
+		}
+		bit >>= 2;
+	}
+	if(value > result) // value is now the remainder : rounded to the nearest
+	{
+		result++;
+	}
+	return (uint32_t)result;
+}
 
-	return	abs(acos(sinXA*sinXB+cosXA*cosXB*cosDiffYAYB)*6371*1000);
+static int32_t clampToInt32(double value)
+{
+	if(value > INT32_MAX / 2) return INT32_MAX / 2; // keeps the differences of two points in an int32
+	if(value < -(INT32_MAX / 2)) return -(INT32_MAX / 2);
+	return (int32_t)lround(value);
 }
 
 //On convertit une coordonne en RADIAN
@@ -144,18 +183,3 @@ static double DDtoRad(double coordinateToRAD)
 	
 	return res;
 }
-
-/* Effectue un produit en croix. Retourne -1 si rsultat < 0, 1 si rsultat > 1 */
-static int crossProduct(Vector vector1,Vector vector2)
-{
-	double result=vector1.x*vector2.y-vector1.y*vector2.x;
-	if(result<0)
-	{
-		return -1;
-	}
-	else if (result>0)
-	{
-		return 1;
-	}
-	else return 0;
-}
\ No newline at end of file
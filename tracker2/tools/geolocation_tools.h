@@ -3,14 +3,37 @@
 
 #include <seekiosCore/seekios.h>
 #include <peripheralManager/GPS_manager.h>
-#include <statusManager/status_manager.h>
 #include <stdbool.h>
 
-void geolocationTools_constructVectors(Vector *vectors,int nbVectors, Coordinate *coordinates);
-bool geolocationTools_isPositionInZone(Coordinate *seekiosLocationPtr,int nbCoordinates, Coordinate *zoneCoordinates);
-double geolocationTools_getShortestDistanceFromEdge(double xA, double yA, double xB, double yB, Coordinate* point);
-double geolocationTools_geoCoordinateToMeterDistance(double xA, double yA, double xB, double yB);
-double geolocationTools_getShortestDistanceToZone(Coordinate* zoneCoordinates, uint8_t nbCoordinates, Coordinate* pointPtr);
+#define ZONE_MAX_VERTICES	10
+#define EARTH_RADIUS		6371000 // in meters
+#define ZONE_EDGE_LENGTH_SHIFT	8 // the edge lengths are in 1/256 m, rounding a short edge to the meter would distort the distances to it. Edges up to 8000 km
+
+/* Point in the local frame of a zone, in meters : x to the east and y to the north of the zone center */
+typedef struct{
+	int32_t x;
+	int32_t y;
+}LocalPoint;
+
+/* Zone prepared once when it is received, so that the position checks only use integer maths */
+typedef struct{
+	double originLat;
+	double originLon;
+	double metersPerDegreeLat;
+	double metersPerDegreeLon;
+	LocalPoint minPoint; // bounding box
+	LocalPoint maxPoint;
+	LocalPoint vertices[ZONE_MAX_VERTICES];
+	LocalPoint edges[ZONE_MAX_VERTICES]; // vertices[i+1] - vertices[i]
+	int64_t edgeSquareLengths[ZONE_MAX_VERTICES];
+	uint32_t edgeLengths[ZONE_MAX_VERTICES]; // in 1/(1 << ZONE_EDGE_LENGTH_SHIFT) m
+	uint8_t nbVertices;
+}CompiledZone;
+
+void geolocationTools_compileZone(CompiledZone* zonePtr, Coordinate* zoneCoordinates, uint8_t nbCoordinates);
+void geolocationTools_projectOnZone(const CompiledZone* zonePtr, const Coordinate* coordinatePtr, LocalPoint* resultPtr);
+bool geolocationTools_isPointInCompiledZone(const CompiledZone* zonePtr, const LocalPoint* pointPtr);
+uint32_t geolocationTools_getDistanceToCompiledZone(const CompiledZone* zonePtr, const LocalPoint* pointPtr);
 
 
 #endif /* GEOLOCATION_TOOLS_H_ */
\ No newline at end of file
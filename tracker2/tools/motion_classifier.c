@@ -0,0 +1,73 @@
+/*
+ * motion_classifier.c
+ *
+ * Content : movement detection on the BMA222 samples, from the variance of a sliding window on each axis.
+ * The profiles are compared with motion_benchmark/motion_benchmark.py
+ */ 
+
+#include <tools/motion_classifier.h>
+
+/* Keep in sync with motion_benchmark/motion_benchmark.py. On its synthetic traces (seeds 1 to 20), PET detects all the moves
+but wakes about 27 times per hour at rest (knocks, parked vehicle). LUGGAGE never wakes at rest and only misses the slow
+rolling of a pet, which the former detection missed too : LUGGAGE is the default MOTION_DETECTION_PROFILE */
+static const MotionProfile _motionProfiles[MOTION_PROFILE_COUNT] = {
+	{ .maxStableVariance = 3, .nbMovingSamples = 2 },	// MOTION_PROFILE_PET
+	{ .maxStableVariance = 4, .nbMovingSamples = 24 },	// MOTION_PROFILE_LUGGAGE : a knock stays less than 24 samples in the window
+	{ .maxStableVariance = 6, .nbMovingSamples = 24 },	// MOTION_PROFILE_VEHICLE
+};
+
+void motionClassifier_init(MotionClassifier* classifierPtr, E_MOTION_PROFILE profile){
+	for(uint8_t axis=0; axis<3; axis++)
+	{
+		classifierPtr->sums[axis] = 0;
+		classifierPtr->squareSums[axis] = 0;
+	}
+	classifierPtr->nextSampleIndex = 0;
+	classifierPtr->nbSamples = 0;
+	classifierPtr->nbMovingSamples = 0;
+	classifierPtr->profilePtr = &_motionProfiles[profile < MOTION_PROFILE_COUNT ? profile : MOTION_PROFILE_PET];
+}
+
+/* Adds the sample in place of the oldest one. Returns true when the movement is detected */
+bool motionClassifier_addSample(MotionClassifier* classifierPtr, int8_t const sample[3]){
+	uint8_t index = classifierPtr->nextSampleIndex;
+	bool windowFull = classifierPtr->nbSamples == MOTION_CLASSIFIER_WINDOW;
+	for(uint8_t axis=0; axis<3; axis++)
+	{
+		if(windowFull)
+		{
+			int8_t oldestSample = classifierPtr->samples[axis][index];
+			classifierPtr->sums[axis] -= oldestSample;
+			classifierPtr->squareSums[axis] -= oldestSample * oldestSample;
+		}
+		classifierPtr->samples[axis][index] = sample[axis];
+		classifierPtr->sums[axis] += sample[axis];
+		classifierPtr->squareSums[axis] += sample[axis] * sample[axis];
+	}
+	classifierPtr->nextSampleIndex = (index + 1) % MOTION_CLASSIFIER_WINDOW;
+	if(!windowFull)
+	{
+		classifierPtr->nbSamples++;
+		if(classifierPtr->nbSamples < MOTION_CLASSIFIER_WINDOW)
+		{
+			return false;
+		}
+	}
+
+	bool moving = false;
+	for(uint8_t axis=0; axis<3; axis++)
+	{
+		if(motionClassifier_getVariance(classifierPtr, axis) > (uint32_t)classifierPtr->profilePtr->maxStableVariance * MOTION_CLASSIFIER_WINDOW * MOTION_CLASSIFIER_WINDOW)
+		{
+			moving = true;
+		}
+	}
+	classifierPtr->nbMovingSamples = moving ? classifierPtr->nbMovingSamples + 1 : 0;
+	return classifierPtr->nbMovingSamples >= classifierPtr->profilePtr->nbMovingSamples;
+}
+
+/* Variance of the window multiplied by MOTION_CLASSIFIER_WINDOW, to stay in integers */
+uint32_t motionClassifier_getVariance(MotionClassifier* classifierPtr, uint8_t axis){
+	int32_t sum = classifierPtr->sums[axis];
+	return MOTION_CLASSIFIER_WINDOW * classifierPtr->squareSums[axis] - (uint32_t)(sum * sum);
+}
@@ -0,0 +1,45 @@
+/*
+ * motion_classifier.h
+ *
+ * Content : movement detection on the BMA222 samples, from the variance of a sliding window on each axis.
+ * The profiles are compared with motion_benchmark/motion_benchmark.py
+ */ 
+
+
+#ifndef MOTION_CLASSIFIER_H_
+#define MOTION_CLASSIFIER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define MOTION_CLASSIFIER_WINDOW	16 // number of samples per axis on which the variance is computed
+
+/* Sensitivity of the movement detection, selected with MOTION_DETECTION_PROFILE in seekios.h */
+typedef enum{
+	MOTION_PROFILE_PET		= 0, // gentle moves are detected, but a knock or a parked vehicle wakes it up : not for the don't move mode
+	MOTION_PROFILE_LUGGAGE	= 1, // a single knock is ignored, no false wake at rest. A slow rolling is not detected
+	MOTION_PROFILE_VEHICLE	= 2, // the vibrations of a parked vehicle are ignored
+	MOTION_PROFILE_COUNT
+}E_MOTION_PROFILE;
+
+typedef struct{
+	uint16_t maxStableVariance;	// in LSB (15.6mg per LSB). Above it on one axis, the window is a movement
+	uint8_t nbMovingSamples;	// number of consecutive moving windows before the movement is detected
+}MotionProfile;
+
+/* Sliding window on the 3 axes, with its sums kept up to date : each sample is classified in constant time */
+typedef struct{
+	int8_t samples[3][MOTION_CLASSIFIER_WINDOW];
+	int16_t sums[3];
+	uint32_t squareSums[3];
+	uint8_t nextSampleIndex;
+	uint8_t nbSamples;
+	uint8_t nbMovingSamples;
+	MotionProfile const* profilePtr;
+}MotionClassifier;
+
+void motionClassifier_init(MotionClassifier* classifierPtr, E_MOTION_PROFILE profile);
+bool motionClassifier_addSample(MotionClassifier* classifierPtr, int8_t const sample[3]);
+uint32_t motionClassifier_getVariance(MotionClassifier* classifierPtr, uint8_t axis);
+
+#endif /* MOTION_CLASSIFIER_H_ */
@@ -120,6 +120,52 @@ char* stringHelper_doubleToString(double val, char* resultBuff, int nbDecimal){
 	return resultBuff;
 }
 
+/* Powers of ten of the digits of an uint32_t, most significant first */
+static const uint32_t _powersOfTen[10] = {1000000000, 100000000, 10000000, 1000000, 100000, 10000, 1000, 100, 10, 1};
+
+/*
+Writes the fixed-point value val, in 1/10^nbDecimal units, with nbDecimal digits after the point.
+Each digit is found by subtracting its power of ten : no floating point and no division, which are both
+software routines on the Cortex-M0+. The leading zeros of the integer part are skipped.
+*/
+char* stringHelper_fixedPointToString(int32_t val, char* resultBuff, uint8_t nbDecimal){
+	char* p = resultBuff;
+	uint32_t magnitude = (uint32_t)val;
+	if(nbDecimal > STRING_HELPER_MAX_FIXED_POINT_DECIMALS) nbDecimal = STRING_HELPER_MAX_FIXED_POINT_DECIMALS;
+	if(val < 0) {
+		*p++ = '-';
+		magnitude = 0 - magnitude; // also right for INT32_MIN
+	}
+
+	uint8_t firstDecimal = 10 - nbDecimal;
+	uint8_t isPrinting = 0;
+	for(uint8_t i = 0; i < 10; i++)
+	{
+		uint8_t digit = 0;
+		while(magnitude >= _powersOfTen[i]) {
+			magnitude -= _powersOfTen[i];
+			digit++;
+		}
+		if(i == firstDecimal) {
+			if(!isPrinting) *p++ = '0';
+			*p++ = '.';
+			isPrinting = 1;
+		}
+		if(digit != 0 || isPrinting || i == 9) {
+			*p++ = digit + '0';
+			isPrinting = 1;
+		}
+	}
+	*p = '\0';
+
+	return resultBuff;
+}
+
+int32_t stringHelper_toFixedPoint(double val, uint8_t nbDecimal){
+	if(nbDecimal > STRING_HELPER_MAX_FIXED_POINT_DECIMALS) nbDecimal = STRING_HELPER_MAX_FIXED_POINT_DECIMALS;
+	return (int32_t)lround(val * _powersOfTen[9 - nbDecimal]);
+}
+
 /*
 Transforme l'entier pass en paramtre en string, et le stocke dans resultBuff
 Le pointeur retourn est aussi le pointeur de resultBuff
@@ -309,4 +355,21 @@ char *strtok_single (char * str, char const * delims)
 	}
 
 	return ret;
-}
\ No newline at end of file
+}
+
+char* stringHelper_bytesToBase64Url(const uint8_t bytes[], uint16_t nbBytes, char string[]){
+	char const digit[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+	uint16_t length = 0;
+	for(uint16_t i=0; i<nbBytes; i+=3)
+	{
+		uint32_t group = (uint32_t)bytes[i] << 16;
+		if(i+1 < nbBytes) group |= (uint32_t)bytes[i+1] << 8;
+		if(i+2 < nbBytes) group |= bytes[i+2];
+		string[length++] = digit[(group >> 18) & 0x3F];
+		string[length++] = digit[(group >> 12) & 0x3F];
+		if(i+1 < nbBytes) string[length++] = digit[(group >> 6) & 0x3F];
+		if(i+2 < nbBytes) string[length++] = digit[group & 0x3F];
+	}
+	string[length] = '\0';
+	return string;
+}
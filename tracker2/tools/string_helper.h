@@ -40,6 +40,19 @@ Transforme le double pass
 */
 char* stringHelper_doubleToString(double val, char*, int nbDecimal);
 
+#define STRING_HELPER_MAX_FIXED_POINT_DECIMALS	9
+
+/*
+Writes the fixed-point value val, in 1/10^nbDecimal units, with nbDecimal digits after the point (at most STRING_HELPER_MAX_FIXED_POINT_DECIMALS)
+Integer operations only : 123456789 with 7 decimals gives "12.3456789"
+*/
+char* stringHelper_fixedPointToString(int32_t val, char* resultBuff, uint8_t nbDecimal);
+
+/*
+Rounds the value to the nearest 1/10^nbDecimal unit, for stringHelper_fixedPointToString
+*/
+int32_t stringHelper_toFixedPoint(double val, uint8_t nbDecimal);
+
 /*
 Transforme l'entier pass en paramtre en string
 */
@@ -64,4 +77,9 @@ char *strtok_single (char * str, char const * delims);
 
 char* stringHelper_byteToHexString(uint8_t byte, uint8_t b[]);
 
+/*
+Encodes the bytes in base64url (RFC 4648, '-' and '_' instead of '+' and '/'), without padding
+*/
+char* stringHelper_bytesToBase64Url(const uint8_t bytes[], uint16_t nbBytes, char string[]);
+
 #endif /* STRING_HELPER_H_ */
\ No newline at end of file
@@ -0,0 +1,501 @@
+/*
+ * compact_uplink_check.c
+ *
+ * Content : host check of the compact uplink frames. The real messageSender/compact_uplink.c and tools/string_helper.c
+ * (base64url) are built in this file :
+ *   gcc -O2 -I../tracker2 -o compact_uplink_check compact_uplink_check.c -lm
+ * Usage : ./compact_uplink_check [vectors] [--write-vectors]
+ *
+ * Each message is encoded by compactUplink_catFrame, then decoded back by the reference decoder below (same algorithm as
+ * uplink_codec.py). The check asserts that the decoded fields are the encoded ones, within the fixed point step for the
+ * coordinate, that no frame is larger than COMPACT_UPLINK_MAX_FRAME_SIZE and that a frame with 5-byte varints only is
+ * exactly COMPACT_UPLINK_MAX_FRAME_SIZE bytes long. The messages are edge cases (poles, antimeridian, negative altitudes
+ * and hDOP, largest varints) then random ones. The base64url encoder is checked on the RFC 4648 vectors and on random bytes.
+ * Then the frames of compact_uplink_vectors.txt (used by default) are encoded again from their decoded fields, they must
+ * give the same string. The same file is checked by the decoder and the encoder of uplink_codec.py :
+ *   python uplink_codec.py check compact_uplink_vectors.txt
+ * --write-vectors rewrites the file from the edge cases and a few random messages, after a change of the frame format.
+ * Returns 1 if a check fails.
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+/* The firmware headers that need the ASF are skipped : their guards are defined, the declarations used by the files follow */
+#define GPS_MANAGER_H_
+
+#include "../tracker2/tools/string_helper.h"
+
+/* Keep in sync with GPS_manager.h */
+typedef struct {
+	double lat;
+	double lon;
+	float alt;	// in meter
+} Coordinate;
+
+typedef enum{
+	FIX_QUALITY_INVALID = 0,
+	FIX_QUALITY_GPS		= 1,
+	FIX_QUALITY_DGPS	= 2
+}E_FIX_QUALITY;
+
+typedef struct{
+	Coordinate coordinate;
+	float hDOP;
+	uint8_t satellitesNumber;
+	E_FIX_QUALITY fixQuality;
+	float speed;
+	float trackAngle;
+} SatelliteCoordinate;
+
+#include "../tracker2/tools/string_helper.c"
+#include "../tracker2/messageSender/compact_uplink.c"
+
+#define DEFAULT_VECTORS_FILE	"compact_uplink_vectors.txt"
+#define NB_RANDOM_MESSAGES		100000
+#define NB_RANDOM_VECTORS		20
+#define NB_RANDOM_BYTE_STRINGS	10000
+#define MAX_VECTOR_LINE_SIZE	256
+
+/* Fields of a frame as decoded by the server, the coordinate in fixed point */
+typedef struct{
+	uint8_t version;
+	uint8_t messageType;
+	uint8_t battery;
+	uint8_t signal;
+	uint32_t timestamp; // seconds since COMPACT_UPLINK_EPOCH
+	bool hasCoordinate;
+	int32_t lat;
+	int32_t lon;
+	int32_t alt;
+	uint32_t hDOP;
+	bool hasModeId;
+	uint32_t modeId;
+}DecodedFrame;
+
+typedef struct{
+	const char* name;
+	CompactUplinkMessage message;
+	bool hasCoordinate;
+	SatelliteCoordinate coordinate;
+	uint8_t expectedFrameSize; // 0 if not checked
+}Example;
+
+static uint32_t _nbChecks = 0;
+static uint32_t _nbFailures = 0;
+
+static void check(bool isValid, const char* name, const char* what){
+	_nbChecks++;
+	if(!isValid)
+	{
+		_nbFailures++;
+		if(_nbFailures <= 20)
+		{
+			printf("FAILED %s : %s\n", name, what);
+		}
+	}
+}
+
+/* Reference decoder, the algorithm of uplink_codec.py. Returns false if the frame is truncated or too long */
+static bool decodeVarint(const uint8_t* frame, uint8_t frameSize, uint8_t* indexPtr, uint32_t* valuePtr){
+	uint32_t value = 0;
+	for(uint8_t shift = 0; shift < 35; shift += 7)
+	{
+		if(*indexPtr >= frameSize)
+		{
+			return false;
+		}
+		uint8_t byte = frame[(*indexPtr)++];
+		value |= (uint32_t)(byte & 0x7F) << shift;
+		if(!(byte & 0x80))
+		{
+			*valuePtr = value;
+			return true;
+		}
+	}
+	return false;
+}
+
+static bool decodeZigzagVarint(const uint8_t* frame, uint8_t frameSize, uint8_t* indexPtr, int32_t* valuePtr){
+	uint32_t value;
+	if(!decodeVarint(frame, frameSize, indexPtr, &value))
+	{
+		return false;
+	}
+	*valuePtr = (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+	return true;
+}
+
+static bool decodeFrame(const uint8_t* frame, uint8_t frameSize, DecodedFrame* decodedPtr){
+	memset(decodedPtr, 0, sizeof(DecodedFrame));
+	if(frameSize < 5)
+	{
+		return false;
+	}
+	decodedPtr->version = frame[0] >> 4;
+	decodedPtr->hasCoordinate = frame[0] & COMPACT_UPLINK_FLAG_COORDINATE;
+	decodedPtr->hasModeId = frame[0] & COMPACT_UPLINK_FLAG_MODE_ID;
+	decodedPtr->messageType = frame[1];
+	decodedPtr->battery = frame[2];
+	decodedPtr->signal = frame[3];
+	uint8_t index = 4;
+	bool isValid = decodeVarint(frame, frameSize, &index, &decodedPtr->timestamp);
+	if(isValid && decodedPtr->hasCoordinate)
+	{
+		isValid = decodeZigzagVarint(frame, frameSize, &index, &decodedPtr->lat)
+			&& decodeZigzagVarint(frame, frameSize, &index, &decodedPtr->lon)
+			&& decodeZigzagVarint(frame, frameSize, &index, &decodedPtr->alt)
+			&& decodeVarint(frame, frameSize, &index, &decodedPtr->hDOP);
+	}
+	if(isValid && decodedPtr->hasModeId)
+	{
+		isValid = decodeVarint(frame, frameSize, &index, &decodedPtr->modeId);
+	}
+	return isValid && index == frameSize;
+}
+
+/* Returns the number of bytes, -1 on a character outside the base64url alphabet or a dangling character */
+static int16_t base64UrlToBytes(const char* string, uint8_t* bytes){
+	const char digit[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+	size_t length = strlen(string);
+	if(length % 4 == 1)
+	{
+		return -1;
+	}
+	uint32_t group = 0;
+	int16_t nbBytes = 0;
+	for(size_t i = 0; i < length; i++)
+	{
+		const char* digitPtr = strchr(digit, string[i]);
+		if(digitPtr == NULL || string[i] == '\0')
+		{
+			return -1;
+		}
+		group = (group << 6) | (uint32_t)(digitPtr - digit);
+		if(i % 4 == 3)
+		{
+			bytes[nbBytes++] = group >> 16;
+			bytes[nbBytes++] = group >> 8;
+			bytes[nbBytes++] = group;
+			group = 0;
+		}
+	}
+	if(length % 4 == 2)
+	{
+		bytes[nbBytes++] = group >> 4;
+	}
+	else if(length % 4 == 3)
+	{
+		bytes[nbBytes++] = group >> 10;
+		bytes[nbBytes++] = group >> 2;
+	}
+	return nbBytes;
+}
+
+/* Encodes the message in base64url like the firmware, then decodes it back. Returns the frame size, 0 on failure */
+static uint8_t roundTrip(CompactUplinkMessage* messagePtr, const char* name, char* string, DecodedFrame* decodedPtr){
+	char buffer[COMPACT_UPLINK_MAX_STRING_SIZE + 8];
+	memset(buffer, '#', sizeof(buffer));
+	strcpy(buffer, "CMPT/");
+	compactUplink_catFrame(buffer, messagePtr);
+	size_t length = strlen(buffer + 5);
+	check(length < COMPACT_UPLINK_MAX_STRING_SIZE, name, "the string is larger than COMPACT_UPLINK_MAX_STRING_SIZE");
+	check(buffer[5 + length + 1] == '#', name, "written after the end of the string");
+	if(string != NULL)
+	{
+		strcpy(string, buffer + 5);
+	}
+
+	uint8_t frame[COMPACT_UPLINK_MAX_FRAME_SIZE + 4];
+	int16_t frameSize = base64UrlToBytes(buffer + 5, frame);
+	check(frameSize > 0 && frameSize <= COMPACT_UPLINK_MAX_FRAME_SIZE, name, "the frame is larger than COMPACT_UPLINK_MAX_FRAME_SIZE");
+	if(frameSize <= 0 || frameSize > COMPACT_UPLINK_MAX_FRAME_SIZE)
+	{
+		return 0;
+	}
+	bool isDecoded = decodeFrame(frame, (uint8_t)frameSize, decodedPtr);
+	check(isDecoded, name, "the frame cannot be decoded");
+	if(!isDecoded)
+	{
+		return 0;
+	}
+
+	check(decodedPtr->version == COMPACT_UPLINK_VERSION, name, "wrong version");
+	check(decodedPtr->messageType == messagePtr->messageType, name, "wrong message type");
+	check(decodedPtr->battery == messagePtr->battery, name, "wrong battery");
+	check(decodedPtr->signal == messagePtr->signal, name, "wrong signal");
+	time_t expectedTimestamp = messagePtr->timestamp > COMPACT_UPLINK_EPOCH ? messagePtr->timestamp - COMPACT_UPLINK_EPOCH : 0;
+	check(decodedPtr->timestamp == expectedTimestamp, name, "wrong timestamp");
+	check(decodedPtr->hasCoordinate == (messagePtr->coordinatePtr != NULL), name, "wrong coordinate flag");
+	if(decodedPtr->hasCoordinate && messagePtr->coordinatePtr != NULL)
+	{
+		SatelliteCoordinate* coordinatePtr = messagePtr->coordinatePtr;
+		double step = 1.0 / COMPACT_UPLINK_COORDINATE_SCALE;
+		check(fabs((double)decodedPtr->lat * step - coordinatePtr->coordinate.lat) <= step / 2 * (1 + 1e-9), name, "wrong latitude");
+		check(fabs((double)decodedPtr->lon * step - coordinatePtr->coordinate.lon) <= step / 2 * (1 + 1e-9), name, "wrong longitude");
+		check(fabs(decodedPtr->alt - coordinatePtr->coordinate.alt) <= 0.5, name, "wrong altitude");
+		double expectedHDOP = coordinatePtr->hDOP > 0 ? coordinatePtr->hDOP : 0;
+		check(fabs((double)decodedPtr->hDOP / COMPACT_UPLINK_HDOP_SCALE - expectedHDOP) <= 0.5 / COMPACT_UPLINK_HDOP_SCALE, name, "wrong hDOP");
+	}
+	check(decodedPtr->hasModeId == messagePtr->hasModeId, name, "wrong mode id flag");
+	if(decodedPtr->hasModeId && messagePtr->hasModeId)
+	{
+		check(decodedPtr->modeId == messagePtr->modeId, name, "wrong mode id");
+	}
+	return (uint8_t)frameSize;
+}
+
+#define EXAMPLE(exampleName, type, bat, sig, time, withCoordinate, latitude, longitude, altitude, dop, hasMode, mode, size) \
+	{ .name = exampleName, .message = { .messageType = type, .battery = bat, .signal = sig, .timestamp = time, \
+	.hasModeId = hasMode, .modeId = mode }, .hasCoordinate = withCoordinate, .coordinate = { .coordinate = { .lat = latitude, .lon = longitude, .alt = altitude }, .hDOP = dop }, .expectedFrameSize = size }
+
+static Example _examples[] = {
+	EXAMPLE("no position",				4,		100,	0,		1500000000,	false,	0,				0,				0,		0,		false,	0,			8),
+	EXAMPLE("timestamp before epoch",	9,		0,		100,	0,			false,	0,				0,				0,		0,		true,	0,			6),
+	EXAMPLE("timestamp at epoch",		9,		0,		100,	COMPACT_UPLINK_EPOCH,	false,	0,	0,				0,		0,		false,	0,			5),
+	EXAMPLE("anglet",					9,		87,		64,		1508160000,	true,	43.48971,		-1.53452,		53.9f,	1.2f,	true,	1234,		0),
+	EXAMPLE("north pole",				12,		50,		50,		1508160000,	true,	90,				0,				2,		0.7f,	false,	0,			0),
+	EXAMPLE("south pole",				12,		50,		50,		1508160000,	true,	-90,			0,				2810,	0.7f,	false,	0,			0),
+	EXAMPLE("antimeridian east",		13,		1,		2,		1508160000,	true,	-16.5,			180,			0,		0.9f,	true,	7,			0),
+	EXAMPLE("antimeridian west",		13,		1,		2,		1508160000,	true,	65.7,			-180,			0,		0.9f,	true,	7,			0),
+	EXAMPLE("half a step",				10,		20,		30,		1508160000,	true,	0.000005,		-0.000005,		-0.5f,	0.05f,	false,	0,			0),
+	EXAMPLE("under half a step",		10,		20,		30,		1508160000,	true,	0.0000049,		-0.0000049,		0.49f,	0.04f,	false,	0,			0),
+	EXAMPLE("dead sea",					11,		20,		30,		1508160000,	true,	31.5,			35.5,			-430,	3.5f,	false,	0,			0),
+	EXAMPLE("everest",					11,		20,		30,		1508160000,	true,	27.98805,		86.92528,		8848,	25.5f,	false,	0,			0),
+	EXAMPLE("negative hDOP",			7,		20,		30,		1508160000,	true,	-33.86785,		151.20732,		58,		-1.0f,	false,	0,			0),
+	EXAMPLE("max-length frame",			255,	255,	255,	(time_t)COMPACT_UPLINK_EPOCH + UINT32_MAX,	true,	-21474.83648,	21474.83647,	-2147483648.0f,	2.0e8f,	true,	UINT32_MAX,	COMPACT_UPLINK_MAX_FRAME_SIZE),
+};
+
+static uint64_t _randomState = 0xC0117AC7;
+
+static uint32_t randomUint32(void){
+	_randomState = _randomState * 6364136223846793005ULL + 1442695040888963407ULL;
+	return (uint32_t)(_randomState >> 32);
+}
+
+static double randomUniform(double min, double max){
+	return min + (max - min) * (double)randomUint32() / 4294967296.0;
+}
+
+static void randomMessage(CompactUplinkMessage* messagePtr, SatelliteCoordinate* coordinatePtr){
+	memset(messagePtr, 0, sizeof(CompactUplinkMessage));
+	memset(coordinatePtr, 0, sizeof(SatelliteCoordinate));
+	messagePtr->messageType = randomUint32() % 32;
+	messagePtr->battery = randomUint32() % 101;
+	messagePtr->signal = randomUint32() % 101;
+	messagePtr->timestamp = COMPACT_UPLINK_EPOCH + (time_t)randomUniform(-1e6, 5e8);
+	if(randomUint32() % 4 != 0)
+	{
+		coordinatePtr->coordinate.lat = randomUniform(-90, 90);
+		coordinatePtr->coordinate.lon = randomUniform(-180, 180);
+		coordinatePtr->coordinate.alt = (float)randomUniform(-500, 9000);
+		coordinatePtr->hDOP = (float)randomUniform(0, 50);
+		messagePtr->coordinatePtr = coordinatePtr;
+	}
+	messagePtr->hasModeId = randomUint32() % 2;
+	messagePtr->modeId = randomUint32() >> (randomUint32() % 32);
+}
+
+static void checkExamples(void){
+	printf("Edge cases\n");
+	for(uint8_t i = 0; i < sizeof(_examples) / sizeof(_examples[0]); i++)
+	{
+		Example* examplePtr = &_examples[i];
+		examplePtr->message.coordinatePtr = examplePtr->hasCoordinate ? &examplePtr->coordinate : NULL;
+		char string[COMPACT_UPLINK_MAX_STRING_SIZE];
+		DecodedFrame decoded;
+		uint8_t frameSize = roundTrip(&examplePtr->message, examplePtr->name, string, &decoded);
+		if(examplePtr->expectedFrameSize != 0)
+		{
+			check(frameSize == examplePtr->expectedFrameSize, examplePtr->name, "unexpected frame size");
+		}
+		if(examplePtr->expectedFrameSize == COMPACT_UPLINK_MAX_FRAME_SIZE)
+		{
+			check(strlen(string) == COMPACT_UPLINK_MAX_STRING_SIZE - 1, examplePtr->name, "COMPACT_UPLINK_MAX_STRING_SIZE is not the size of the largest frame");
+		}
+		printf("    %-24s %2d bytes  %s\n", examplePtr->name, frameSize, string);
+	}
+}
+
+static void checkRandomMessages(void){
+	uint32_t nbBytes = 0;
+	uint8_t largestFrameSize = 0;
+	for(uint32_t i = 0; i < NB_RANDOM_MESSAGES; i++)
+	{
+		CompactUplinkMessage message;
+		SatelliteCoordinate coordinate;
+		randomMessage(&message, &coordinate);
+		DecodedFrame decoded;
+		uint8_t frameSize = roundTrip(&message, "random message", NULL, &decoded);
+		nbBytes += frameSize;
+		if(frameSize > largestFrameSize)
+		{
+			largestFrameSize = frameSize;
+		}
+	}
+	printf("%d random messages : %.1f bytes per frame on average, %d at most\n", NB_RANDOM_MESSAGES, (double)nbBytes / NB_RANDOM_MESSAGES, largestFrameSize);
+}
+
+static void checkBase64Url(void){
+	static const char* const rfc4648Vectors[][2] = {
+		{ "", "" }, { "f", "Zg" }, { "fo", "Zm8" }, { "foo", "Zm9v" }, { "foob", "Zm9vYg" }, { "fooba", "Zm9vYmE" }, { "foobar", "Zm9vYmFy" },
+		{ "\xfb\xff", "-_8" }, { "\xff\xff\xfe", "___-" },
+	};
+	for(uint8_t i = 0; i < sizeof(rfc4648Vectors) / sizeof(rfc4648Vectors[0]); i++)
+	{
+		char string[16];
+		stringHelper_bytesToBase64Url((const uint8_t*)rfc4648Vectors[i][0], strlen(rfc4648Vectors[i][0]), string);
+		check(strcmp(string, rfc4648Vectors[i][1]) == 0, rfc4648Vectors[i][1], "wrong base64url");
+	}
+	for(uint32_t i = 0; i < NB_RANDOM_BYTE_STRINGS; i++)
+	{
+		uint8_t bytes[COMPACT_UPLINK_MAX_FRAME_SIZE];
+		uint8_t nbBytes = randomUint32() % (COMPACT_UPLINK_MAX_FRAME_SIZE + 1);
+		for(uint8_t j = 0; j < nbBytes; j++)
+		{
+			bytes[j] = randomUint32();
+		}
+		char string[COMPACT_UPLINK_MAX_STRING_SIZE];
+		stringHelper_bytesToBase64Url(bytes, nbBytes, string);
+		uint8_t decodedBytes[COMPACT_UPLINK_MAX_FRAME_SIZE + 4];
+		check(strlen(string) == (nbBytes * 4 + 2) / 3u, "random bytes", "wrong base64url length");
+		check(base64UrlToBytes(string, decodedBytes) == nbBytes && memcmp(bytes, decodedBytes, nbBytes) == 0, "random bytes", "base64url round trip");
+	}
+	printf("base64url : %d RFC 4648 vectors and %d random byte strings\n", (int)(sizeof(rfc4648Vectors) / sizeof(rfc4648Vectors[0])), NB_RANDOM_BYTE_STRINGS);
+}
+
+/* Vector line : <frame> <messageType> <battery> <signal> <timestamp> <lat lon alt hDOP | -> <modeId | -> */
+static void writeVector(FILE* file, CompactUplinkMessage* messagePtr){
+	char string[COMPACT_UPLINK_MAX_STRING_SIZE];
+	DecodedFrame decoded;
+	roundTrip(messagePtr, "vector", string, &decoded);
+	fprintf(file, "%s %d %d %d %" PRIu64, string, decoded.messageType, decoded.battery, decoded.signal, (uint64_t)decoded.timestamp + COMPACT_UPLINK_EPOCH);
+	if(decoded.hasCoordinate)
+	{
+		fprintf(file, " %.5f %.5f %" PRId32 " %.1f", (double)decoded.lat / COMPACT_UPLINK_COORDINATE_SCALE, (double)decoded.lon / COMPACT_UPLINK_COORDINATE_SCALE, decoded.alt, (double)decoded.hDOP / COMPACT_UPLINK_HDOP_SCALE);
+	}
+	else
+	{
+		fprintf(file, " -");
+	}
+	if(decoded.hasModeId)
+	{
+		fprintf(file, " %" PRIu32 "\n", decoded.modeId);
+	}
+	else
+	{
+		fprintf(file, " -\n");
+	}
+}
+
+static bool writeVectors(const char* path){
+	FILE* file = fopen(path, "w");
+	if(file == NULL)
+	{
+		printf("Cannot write %s\n", path);
+		return false;
+	}
+	for(uint8_t i = 0; i < sizeof(_examples) / sizeof(_examples[0]); i++)
+	{
+		writeVector(file, &_examples[i].message);
+	}
+	for(uint8_t i = 0; i < NB_RANDOM_VECTORS; i++)
+	{
+		CompactUplinkMessage message;
+		SatelliteCoordinate coordinate;
+		randomMessage(&message, &coordinate);
+		writeVector(file, &message);
+	}
+	fclose(file);
+	printf("%s written\n", path);
+	return true;
+}
+
+/* The frames of the file are encoded again from their decoded fields : the firmware must give the same string */
+static bool checkVectors(const char* path){
+	FILE* file = fopen(path, "r");
+	if(file == NULL)
+	{
+		printf("Cannot read %s\n", path);
+		return false;
+	}
+	char line[MAX_VECTOR_LINE_SIZE];
+	uint32_t nbVectors = 0;
+	while(fgets(line, sizeof(line), file) != NULL)
+	{
+		char* fields[10];
+		uint8_t nbFields = 0;
+		for(char* field = strtok(line, " \r\n"); field != NULL && nbFields < 10; field = strtok(NULL, " \r\n"))
+		{
+			fields[nbFields++] = field;
+		}
+		if(nbFields == 0)
+		{
+			continue;
+		}
+		nbVectors++;
+		bool hasCoordinate = nbFields == 10;
+		check(nbFields == (hasCoordinate ? 10 : 7), fields[0], "malformed vector line");
+		if(nbFields != 7 && nbFields != 10)
+		{
+			continue;
+		}
+
+		CompactUplinkMessage message = { 0 };
+		SatelliteCoordinate coordinate = { 0 };
+		message.messageType = atoi(fields[1]);
+		message.battery = atoi(fields[2]);
+		message.signal = atoi(fields[3]);
+		message.timestamp = (time_t)strtoll(fields[4], NULL, 10);
+		if(hasCoordinate)
+		{
+			coordinate.coordinate.lat = strtod(fields[5], NULL);
+			coordinate.coordinate.lon = strtod(fields[6], NULL);
+			coordinate.coordinate.alt = strtof(fields[7], NULL);
+			coordinate.hDOP = strtof(fields[8], NULL);
+			message.coordinatePtr = &coordinate;
+		}
+		const char* modeId = fields[nbFields - 1];
+		message.hasModeId = strcmp(modeId, "-") != 0;
+		message.modeId = message.hasModeId ? (uint32_t)strtoul(modeId, NULL, 10) : 0;
+
+		char string[COMPACT_UPLINK_MAX_STRING_SIZE];
+		DecodedFrame decoded;
+		roundTrip(&message, fields[0], string, &decoded);
+		check(strcmp(string, fields[0]) == 0, fields[0], "the firmware encodes the decoded fields of the vector differently");
+	}
+	fclose(file);
+	printf("%s : %" PRIu32 " frames\n", path, nbVectors);
+	check(nbVectors > 0, path, "no vector");
+	return true;
+}
+
+int main(int argc, char* argv[]){
+	const char* vectorsPath = DEFAULT_VECTORS_FILE;
+	bool isWriting = false;
+	for(int i = 1; i < argc; i++)
+	{
+		if(strcmp(argv[i], "--write-vectors") == 0)
+		{
+			isWriting = true;
+		}
+		else
+		{
+			vectorsPath = argv[i];
+		}
+	}
+
+	checkExamples();
+	checkRandomMessages();
+	checkBase64Url();
+	bool isValid = isWriting ? writeVectors(vectorsPath) : checkVectors(vectorsPath);
+	isValid &= _nbFailures == 0;
+	printf("\n%" PRIu32 " checks, %" PRIu32 " failed\n%s\n", _nbChecks, _nbFailures, isValid ? "OK" : "FAILED");
+	return isValid ? 0 : 1;
+}
@@ -0,0 +1,176 @@
+# Encodes and decodes the compact frames sent by the Seekios to the CMPT endpoint (COMPACT_UPLINK_ACTIVATED).
+# Usage : python uplink_codec.py decode <URL or base64url frame>
+#         python uplink_codec.py encode <messageType> <battery> <signal> <timestamp> [lat lon alt hDOP] [modeId=<id>]
+#         python uplink_codec.py check <vectors file>
+# The vectors file is written by compact_uplink_check.c from the frames of the firmware encoder : compact_uplink_vectors.txt
+# Keep in sync with messageSender/compact_uplink.h
+
+import base64
+import sys
+
+COMPACT_UPLINK_VERSION			= 1
+COMPACT_UPLINK_EPOCH			= 1483228800
+COMPACT_UPLINK_COORDINATE_SCALE	= 100000
+COMPACT_UPLINK_HDOP_SCALE		= 10
+
+FLAG_COORDINATE	= 1 << 0
+FLAG_MODE_ID	= 1 << 1
+
+# E_MESSAGE_TYPE in messageSender/message_sender.h
+MESSAGE_TYPE_NAMES = {
+	4 : "ON_DEMAND",
+	7 : "SOS_LOCATION",
+	9 : "TRACKING",
+	10 : "DONT_MOVE",
+	11 : "DONT_MOVE_TRACKING",
+	12 : "OUT_OF_ZONE",
+	13 : "ZONE_TRACKING",
+	22 : "POWER_SAVING_DISABLED",
+}
+
+def encodeVarint(value):
+	result = bytearray()
+	while value >= 0x80:
+		result.append((value & 0x7F) | 0x80)
+		value >>= 7
+	result.append(value)
+	return result
+
+def decodeVarint(frame, index):
+	value = 0
+	shift = 0
+	while True:
+		byte = frame[index]
+		index += 1
+		value |= (byte & 0x7F) << shift
+		shift += 7
+		if not byte & 0x80:
+			return value, index
+
+def encodeZigzag(value):
+	return encodeVarint(((value << 1) ^ (value >> 31)) & 0xFFFFFFFF)
+
+def decodeZigzag(frame, index):
+	value, index = decodeVarint(frame, index)
+	return (value >> 1) ^ -(value & 1), index
+
+# Same rounding as lround() on the Seekios : half away from zero
+def toFixedPoint(value, scale):
+	scaled = abs(value) * scale
+	rounded = int(scaled + 0.5)
+	return rounded if value >= 0 else -rounded
+
+def encodeFrame(message):
+	flags = 0
+	if message.get("coordinate") is not None:
+		flags |= FLAG_COORDINATE
+	if message.get("modeId") is not None:
+		flags |= FLAG_MODE_ID
+	frame = bytearray([(COMPACT_UPLINK_VERSION << 4) | flags, message["messageType"], message["battery"], message["signal"]])
+	frame += encodeVarint(max(message["timestamp"] - COMPACT_UPLINK_EPOCH, 0))
+	if flags & FLAG_COORDINATE:
+		lat, lon, alt, hDOP = message["coordinate"]
+		frame += encodeZigzag(toFixedPoint(lat, COMPACT_UPLINK_COORDINATE_SCALE))
+		frame += encodeZigzag(toFixedPoint(lon, COMPACT_UPLINK_COORDINATE_SCALE))
+		frame += encodeZigzag(toFixedPoint(alt, 1))
+		frame += encodeVarint(max(toFixedPoint(hDOP, COMPACT_UPLINK_HDOP_SCALE), 0))
+	if flags & FLAG_MODE_ID:
+		frame += encodeVarint(message["modeId"])
+	return bytes(frame)
+
+def decodeFrame(frame):
+	version = frame[0] >> 4
+	if version != COMPACT_UPLINK_VERSION:
+		raise ValueError("Unknown frame version %d" % version)
+	flags = frame[0] & 0x0F
+	message = {"messageType" : frame[1], "battery" : frame[2], "signal" : frame[3], "coordinate" : None, "modeId" : None}
+	timestamp, index = decodeVarint(frame, 4)
+	message["timestamp"] = timestamp + COMPACT_UPLINK_EPOCH
+	if flags & FLAG_COORDINATE:
+		lat, index = decodeZigzag(frame, index)
+		lon, index = decodeZigzag(frame, index)
+		alt, index = decodeZigzag(frame, index)
+		hDOP, index = decodeVarint(frame, index)
+		message["coordinate"] = (float(lat) / COMPACT_UPLINK_COORDINATE_SCALE, float(lon) / COMPACT_UPLINK_COORDINATE_SCALE, alt, float(hDOP) / COMPACT_UPLINK_HDOP_SCALE)
+	if flags & FLAG_MODE_ID:
+		message["modeId"], index = decodeVarint(frame, index)
+	if index != len(frame):
+		raise ValueError("%d unexpected bytes at the end of the frame" % (len(frame) - index))
+	return message
+
+def toBase64Url(frame):
+	return base64.urlsafe_b64encode(frame).decode("ascii").rstrip("=")
+
+def fromBase64Url(string):
+	# Only the last field of an URL is the frame : CMPT/<Seekios_ID>/<frame>
+	string = string.strip().rstrip("/").split("/")[-1]
+	return base64.urlsafe_b64decode(string + "=" * (-len(string) % 4))
+
+def printMessage(message):
+	print("Type       : %d (%s)" % (message["messageType"], MESSAGE_TYPE_NAMES.get(message["messageType"], "?")))
+	print("Battery    : %d %%" % message["battery"])
+	print("Signal     : %d %%" % message["signal"])
+	print("Timestamp  : %d" % message["timestamp"])
+	if message["coordinate"] is not None:
+		print("Coordinate : lat %.5f lon %.5f alt %d m hDOP %.1f" % message["coordinate"])
+	if message["modeId"] is not None:
+		print("Mode id    : %d" % message["modeId"])
+
+# Vector line : <frame> <messageType> <battery> <signal> <timestamp> <lat lon alt hDOP | -> <modeId | ->
+def parseVector(line):
+	fields = line.split()
+	if len(fields) not in (7, 10):
+		raise ValueError("Malformed vector line : %s" % line)
+	message = {"messageType" : int(fields[1]), "battery" : int(fields[2]), "signal" : int(fields[3]), "timestamp" : int(fields[4]), "coordinate" : None, "modeId" : None}
+	if len(fields) == 10:
+		message["coordinate"] = (float(fields[5]), float(fields[6]), int(fields[7]), float(fields[8]))
+	if fields[-1] != "-":
+		message["modeId"] = int(fields[-1])
+	return fields[0], message
+
+# Each frame of the firmware must decode to the fields of its line, and these fields must encode to the same frame
+def checkVectors(path):
+	nbVectors = 0
+	nbFailures = 0
+	with open(path) as file:
+		for line in file:
+			if not line.strip():
+				continue
+			frame, expected = parseVector(line)
+			nbVectors += 1
+			decoded = decodeFrame(bytearray(fromBase64Url(frame)))
+			if decoded != expected:
+				nbFailures += 1
+				print("FAILED %s : decoded as %s" % (frame, decoded))
+			encoded = toBase64Url(encodeFrame(expected))
+			if encoded != frame:
+				nbFailures += 1
+				print("FAILED %s : encoded as %s" % (frame, encoded))
+	print("%s : %d frames, %d failed" % (path, nbVectors, nbFailures))
+	return nbVectors > 0 and nbFailures == 0
+
+def main(args):
+	if len(args) == 2 and args[0] == "decode":
+		printMessage(decodeFrame(bytearray(fromBase64Url(args[1]))))
+		return 0
+	if len(args) == 2 and args[0] == "check":
+		isValid = checkVectors(args[1])
+		print("OK" if isValid else "FAILED")
+		return 0 if isValid else 1
+	if len(args) >= 5 and args[0] == "encode":
+		message = {"messageType" : int(args[1]), "battery" : int(args[2]), "signal" : int(args[3]), "timestamp" : int(args[4]), "coordinate" : None, "modeId" : None}
+		values = args[5:]
+		if values and values[-1].startswith("modeId="):
+			message["modeId"] = int(values.pop().split("=")[1])
+		if len(values) == 4:
+			message["coordinate"] = tuple(float(value) for value in values)
+		elif values:
+			print("A coordinate is lat lon alt hDOP")
+			return 1
+		print(toBase64Url(encodeFrame(message)))
+		return 0
+	print("Usage : python uplink_codec.py decode <URL or frame> | encode <messageType> <battery> <signal> <timestamp> [lat lon alt hDOP] [modeId=<id>] | check <vectors file>")
+	return 1
+
+if __name__ == "__main__":
+	sys.exit(main(sys.argv[1:]))